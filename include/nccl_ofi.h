@@ -15,10 +15,12 @@
 #include <rdma/fi_rma.h>
 #include <nccl/net.h>
 
+#include "nccl_ofi_api.h"
 #include "nccl_ofi_log.h"
 #include "nccl_ofi_topo.h"
 #include "nccl_ofi_idpool.h"
 #include "nccl_ofi_mr.h"
+#include "nccl_ofi_shm.h"
 
 /*
  * NCCL_NET_HANDLE_MAXSIZE is a limited resource (and defined in NCCL).
@@ -74,6 +76,13 @@
 /* Initial number of entries in the MR cache of a device */
 #define NCCL_OFI_MR_CACHE_INIT_SIZE     128
 
+/* Maximum number of devices fused into a virtual device, as in
+ * NCCL_NET_MAX_DEVS_PER_NIC of the v9 interface */
+#define NCCL_OFI_MAX_DEVS_PER_VDEV	(4)
+
+/* Maximum number of virtual devices a plugin can create */
+#define NCCL_OFI_MAX_VIRTUAL_DEVICES	(64)
+
 /* Indicates if GPUDirect is supported by libfabric provider */
 enum gdr_support_level_t {GDR_UNKNOWN, GDR_SUPPORTED, GDR_UNSUPPORTED};
 extern enum gdr_support_level_t support_gdr;
@@ -157,6 +166,22 @@ struct nccl_net_ofi_req {
 	int (*test)(nccl_net_ofi_req_t *req, int *done, int *size);
 };
 
+/*
+ * Request returned by sends that completed by the time they were
+ * posted, so that NCCL does not need a freelist entry and a completion
+ * queue poll to learn about it. Testing it always reports completion;
+ * it is shared and never freed.
+ *
+ * Only used for operations whose completion size is not consumed, as
+ * it reports a size of 0.
+ */
+extern nccl_net_ofi_req_t nccl_net_ofi_req_complete;
+
+static inline bool nccl_net_ofi_req_is_complete(const nccl_net_ofi_req_t *req)
+{
+	return req == &nccl_net_ofi_req_complete;
+}
+
 /* Various stages of connection establishment */
 typedef enum nccl_ofi_comm_stage {
 	COMM_CREATE_START = 0,
@@ -178,15 +203,22 @@ typedef struct nccl_ofi_connection_info {
 	uint64_t ep_namelen;
 	uint64_t connect_to_self;
 	nccl_net_ofi_req_t* req;
+	/* Shared-memory channel carrying the data of the connection,
+	 * empty to use the network (see SHM_TRANSPORT) */
+	char shm_name[NCCL_OFI_SHM_NAME_LEN];
 } nccl_ofi_connection_info_t;
 /* Since this is a message on the wire, check that it has the expected size */
-static_assert(sizeof(nccl_ofi_connection_info_t) == 80, "Wrong size for SENDRECV connect message");
+static_assert(sizeof(nccl_ofi_connection_info_t) == 112, "Wrong size for SENDRECV connect message");
 
 typedef struct nccl_net_ofi_conn_handle {
 	char ep_name[MAX_EP_ADDR];
 	uint32_t comm_id;
 	/* Save temporary communicator state when creating send communicator */
 	save_comm_state_t state;
+	/* Shared-memory domain of the listening process, 0 if it does
+	 * not accept shared-memory connections. Not part of the v4
+	 * handle, where it reads as 0. */
+	uint64_t shm_host_id;
 } nccl_net_ofi_conn_handle_t;
 
 /**
@@ -225,6 +257,9 @@ typedef struct nccl_ofi_properties {
 	size_t max_p2p_bytes;
 	/** Max transfer size for collective operations **/
 	size_t max_coll_bytes;
+	/** Devices fused into a virtual device, 0 for a physical device **/
+	int num_member_devs;
+	int member_devs[NCCL_OFI_MAX_DEVS_PER_VDEV];
 } nccl_ofi_properties_t;
 
 /**
@@ -253,6 +288,11 @@ struct nccl_net_ofi_device {
 	 */
 	bool need_mr_rkey_pool;
 
+	/* Devices fused into this device by make_virtual_device(), 0
+	 * for a physical device */
+	int num_member_devs;
+	int member_devs[NCCL_OFI_MAX_DEVS_PER_VDEV];
+
 	int (*get_properties)(nccl_net_ofi_device_t *base_dev,
 			      nccl_ofi_properties_t *props);
 
@@ -530,6 +570,15 @@ struct nccl_net_ofi_send_comm {
 		     uint64_t dest, uint64_t mr_key, nccl_net_ofi_req_t **req);
 	int (*write_inline)(nccl_net_ofi_send_comm_t *, void* src, size_t size,
 			    uint64_t dest, uint64_t mr_key, nccl_net_ofi_req_t **request);
+
+	/*
+	 * @brief	Post up to NCCL_OFI_MAX_RMA_BATCH writes as one request
+	 *
+	 * The request completes once all writes completed. Optional,
+	 * may be NULL.
+	 */
+	int (*write_batch)(nccl_net_ofi_send_comm_t *send_comm, nccl_ofi_rma_desc_t *descs,
+			   int num_descs, nccl_net_ofi_req_t **req);
 };
 
 struct nccl_net_ofi_recv_comm {
@@ -564,6 +613,15 @@ struct nccl_net_ofi_recv_comm {
 
 	int (*read)(nccl_net_ofi_recv_comm_t *recv_comm, void* dest, size_t size, void* dest_mhandle,
 		    uint64_t src, uint64_t mr_key, nccl_net_ofi_req_t **req);
+
+	/*
+	 * @brief	Post up to NCCL_OFI_MAX_RMA_BATCH reads as one request
+	 *
+	 * The request completes once all reads completed. Optional,
+	 * may be NULL.
+	 */
+	int (*read_batch)(nccl_net_ofi_recv_comm_t *recv_comm, nccl_ofi_rma_desc_t *descs,
+			  int num_descs, nccl_net_ofi_req_t **req);
 };
 
 /**
@@ -598,6 +656,19 @@ struct nccl_net_ofi_plugin {
 
 	size_t (*get_num_devices)(nccl_net_ofi_plugin_t *plugin);
 
+	/**
+	 * Create a device whose rails span the NICs of `num_devs'
+	 * existing devices, and append it to the devices array
+	 *
+	 * NULL if the transport cannot fuse devices. Not thread-safe
+	 * against itself.
+	 *
+	 * @param	dev_id
+	 *		Index of the new device
+	 */
+	int (*make_virtual_device)(nccl_net_ofi_plugin_t *plugin, const int *dev_ids,
+				   int num_devs, int *dev_id);
+
 	int (*release_plugin)(nccl_net_ofi_plugin_t *plugin);
 
 	/*
@@ -614,6 +685,10 @@ struct nccl_net_ofi_plugin {
 
 	/* Number of devices in devs array */
 	size_t p_num_devs;
+
+	/* Capacity of devs array, which leaves room for virtual
+	 * devices so that it is never reallocated */
+	size_t p_max_devs;
 };
 
 
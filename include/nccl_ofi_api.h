@@ -6,14 +6,78 @@
 #ifndef NET_OFI_API_H_
 #define NET_OFI_API_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <nccl/err.h>
 #include <nccl/net.h>
 
 struct nccl_ofi_properties;
 
+/* Maximum number of operations in a batched one-sided write or read */
+#define NCCL_OFI_MAX_RMA_BATCH	(64)
+
+/*
+ * One operation of a batched one-sided write or read
+ *
+ * `local' is the source of a write and the destination of a read and
+ * must be covered by `mhandle'. `remote' and `mr_key' describe the
+ * peer buffer as returned by getMrKey() on the peer.
+ */
+typedef struct nccl_ofi_rma_desc {
+	void *local;
+	void *mhandle;
+	uint64_t remote;
+	uint64_t mr_key;
+	size_t size;
+} nccl_ofi_rma_desc_t;
+
+/*
+ * Batched one-sided operations
+ *
+ * The Neuron net interface has no slot for batched operations, so the
+ * plugin exports this table next to ncclNetPlugin_v5 for callers to
+ * look up with dlsym(). Each call posts up to NCCL_OFI_MAX_RMA_BATCH
+ * operations and returns a single request, which completes with the
+ * last of them and is tested with the regular test() function.
+ */
+typedef struct {
+	const char *name;
+	ncclResult_t (*iwriteBatch)(void *sComm, nccl_ofi_rma_desc_t *descs, int n, void **request);
+	ncclResult_t (*ireadBatch)(void *rComm, nccl_ofi_rma_desc_t *descs, int n, void **request);
+} nccl_ofi_rma_batch_v1_t;
+
+/*
+ * Data path entry points specialized for the protocol of the plugin
+ *
+ * Same semantics as the generic nccl_net_ofi_isend(), irecv(), test()
+ * and their v9 variants, without the indirect calls through the
+ * communicator and request objects. Argument validation is only done
+ * in debug builds.
+ */
+typedef struct nccl_ofi_api_data_path {
+	ncclResult_t (*isend)(void *sendComm, void *data, int size, int tag, void *mhandle,
+			      void **request);
+	ncclResult_t (*isend_v9)(void *sendComm, void *data, size_t size, int tag, void *mhandle,
+				 void **request);
+	ncclResult_t (*irecv)(void *recvComm, int n, void **buffers, int *sizes, int *tags,
+			      void **mhandles, void **request);
+	ncclResult_t (*irecv_v9)(void *recvComm, int n, void **buffers, size_t *sizes, int *tags,
+				 void **mhandles, void **request);
+	ncclResult_t (*test)(void *request, int *done, int *size);
+} nccl_ofi_api_data_path_t;
+
+/*
+ * @brief	Data path entry points of the protocol selected at init
+ *
+ * @return	Entry points, or NULL if the plugin is not initialized
+ */
+const nccl_ofi_api_data_path_t *nccl_net_ofi_get_data_path(void);
+
 ncclResult_t nccl_net_ofi_init(ncclDebugLogger_t logFunction);
 ncclResult_t nccl_net_ofi_devices(int *ndev);
 ncclResult_t nccl_net_ofi_get_properties(int dev, struct nccl_ofi_properties *ofi_properties);
+ncclResult_t nccl_net_ofi_make_vdevice(int *dev, int num_devs, const int *devs);
 ncclResult_t nccl_net_ofi_listen(int dev, void *handle, void **listenComm);
 ncclResult_t nccl_net_ofi_listen_v4(int dev, void* handle, void** listenComm);
 ncclResult_t nccl_net_ofi_connect(int dev, void* handle, void** sendComm);
@@ -46,5 +110,7 @@ ncclResult_t nccl_net_ofi_iwrite_inline(void* sComm, void* src, size_t size,
 					uint64_t dest, uint64_t mr_key, void** req);
 ncclResult_t nccl_net_ofi_iread(void* rComm, void* dest, size_t size, void* mhandle,
 				uint64_t src, uint64_t mr_key, void** req);
+ncclResult_t nccl_net_ofi_iwrite_batch(void* sComm, nccl_ofi_rma_desc_t* descs, int n, void** req);
+ncclResult_t nccl_net_ofi_iread_batch(void* rComm, nccl_ofi_rma_desc_t* descs, int n, void** req);
 
 #endif // End NET_OFI_API_H_
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#ifndef NCCL_OFI_COLLNET_H_
+#define NCCL_OFI_COLLNET_H_
+
+#include <stddef.h>
+
+#include <nccl/err.h>
+#include <nccl/net.h>
+
+/*
+ * Software collective network
+ *
+ * Implements allreduce on host buffers as a ring over the point-to-point
+ * communicators of the plugin: a reduce-scatter followed by an
+ * allgather, reducing received chunks with nccl_ofi_reduce(). Buffers
+ * are processed in segments of NCCL_OFI_COLLNET_CHUNK_SIZE bytes per
+ * rank, staged through buffers registered at connection time. The
+ * allreduces of a communicator share these buffers and run one after
+ * the other in the order they were issued.
+ *
+ * Enabled with OFI_NCCL_COLLNET. Otherwise, no device is reported.
+ */
+
+/* Size in bytes of the chunks exchanged between ring neighbors */
+#define NCCL_OFI_COLLNET_CHUNK_SIZE	(1024 * 1024)
+
+ncclResult_t nccl_net_ofi_collnet_init(ncclDebugLogger_t logFunction);
+ncclResult_t nccl_net_ofi_collnet_devices(int *ndev);
+ncclResult_t nccl_net_ofi_collnet_listen(int dev, void *handle, void **listenComm);
+ncclResult_t nccl_net_ofi_collnet_connect(void *handles[], int nranks, int rank,
+					  void *listenComm, void **collComm);
+/* `dtype' and `op' are ncclDataType_t and ncclRedOp_t values */
+ncclResult_t nccl_net_ofi_collnet_reduce_support(int dtype, int op, int *supported);
+ncclResult_t nccl_net_ofi_collnet_regMr(void *collComm, void *data, size_t size, int type,
+					void **mhandle);
+ncclResult_t nccl_net_ofi_collnet_deregMr(void *collComm, void *mhandle);
+ncclResult_t nccl_net_ofi_collnet_iallreduce(void *collComm, void *sendData, void *recvData,
+					     size_t count, int dtype, int op, void **request);
+ncclResult_t nccl_net_ofi_collnet_iflush(void *collComm, void *data, int size, void *mhandle,
+					 void **request);
+ncclResult_t nccl_net_ofi_collnet_test(void *request, int *done, int *size);
+ncclResult_t nccl_net_ofi_collnet_closeColl(void *collComm);
+ncclResult_t nccl_net_ofi_collnet_closeListen(void *listenComm);
+
+#endif // End NCCL_OFI_COLLNET_H_
@@ -7,6 +7,7 @@
 
 #include <assert.h>
 #include <pthread.h>
+#include <atomic>
 
 #include "nccl_ofi_pthread.h"
 
@@ -247,4 +248,184 @@ static inline nccl_ofi_deque_elem_t *nccl_ofi_deque_get_next(nccl_ofi_deque_t *d
 	    (elem) = next \
 	)
 
+/*
+ * Internal: MPSC queue element structure
+ *
+ * The caller is expected to provide storage for queue elements, but should
+ * treat this structure as a black box.
+ */
+struct nccl_ofi_mpsc_queue_elem_t {
+	std::atomic<struct nccl_ofi_mpsc_queue_elem_t *> next;
+};
+typedef struct nccl_ofi_mpsc_queue_elem_t nccl_ofi_mpsc_queue_elem_t;
+
+/*
+ * Lock-free intrusive multi-producer single-consumer queue
+ *
+ * Any thread may push elements to the back of the queue. Only a single
+ * thread at a time may pop elements from the front or push elements
+ * back to the front (see nccl_ofi_mpsc_queue_consumer_enter()).
+ *
+ * The queue is a singly linked list following Dmitry Vyukov's
+ * intrusive MPSC queue. Producers atomically swap themselves into
+ * `head' and then link the previous element to themselves. `tail' is
+ * owned by the consumer and points to the next element to pop, or to
+ * `stub', a placeholder element that keeps the list non-empty.
+ *
+ * This structure should be considered opaque to users of the queue
+ * interface.
+ */
+struct nccl_ofi_mpsc_queue_t {
+	/* Most recently pushed element (producer side) */
+	std::atomic<nccl_ofi_mpsc_queue_elem_t *> head;
+	/* Next element to pop (consumer side). Atomic only so that
+	 * nccl_ofi_mpsc_queue_isempty() may be called by any thread. */
+	std::atomic<nccl_ofi_mpsc_queue_elem_t *> tail;
+	nccl_ofi_mpsc_queue_elem_t stub;
+	/* Set while a thread acts as the consumer */
+	std::atomic<bool> consumer_active;
+};
+typedef struct nccl_ofi_mpsc_queue_t nccl_ofi_mpsc_queue_t;
+
+/*
+ * Initialize MPSC queue structure.
+ *
+ * @return zero on success, non-zero on non-success.
+ */
+int nccl_ofi_mpsc_queue_init(nccl_ofi_mpsc_queue_t **queue_p);
+
+/*
+ * Finalize an MPSC queue
+ *
+ * @return zero on success, non-zero on non-success.
+ */
+int nccl_ofi_mpsc_queue_finalize(nccl_ofi_mpsc_queue_t *queue);
+
+/*
+ * Try to become the consumer of the queue
+ *
+ * Callers that cannot guarantee that a single thread consumes the queue
+ * must bracket pop and push_front calls with consumer_enter and
+ * consumer_exit.
+ *
+ * @return true if the caller is now the consumer, false if another
+ *         thread currently is
+ */
+static inline bool nccl_ofi_mpsc_queue_consumer_enter(nccl_ofi_mpsc_queue_t *queue)
+{
+	return !queue->consumer_active.exchange(true, std::memory_order_acquire);
+}
+
+/*
+ * Stop being the consumer of the queue
+ */
+static inline void nccl_ofi_mpsc_queue_consumer_exit(nccl_ofi_mpsc_queue_t *queue)
+{
+	queue->consumer_active.store(false, std::memory_order_release);
+}
+
+/*
+ * Push an element to the back of the queue. May be called by any thread.
+ *
+ * @param elem	user-allocated storage space for queue entry
+ * @return zero
+ */
+static inline int nccl_ofi_mpsc_queue_push(nccl_ofi_mpsc_queue_t *queue, nccl_ofi_mpsc_queue_elem_t *elem)
+{
+	assert(queue);
+	assert(elem);
+
+	elem->next.store(NULL, std::memory_order_relaxed);
+	nccl_ofi_mpsc_queue_elem_t *prev = queue->head.exchange(elem, std::memory_order_acq_rel);
+	/* Between the exchange and this store, the element is not yet
+	 * reachable by the consumer */
+	prev->next.store(elem, std::memory_order_release);
+
+	return 0;
+}
+
+/*
+ * Push an element back to the front of the queue, e.g., to retry a
+ * popped element first. Consumer only.
+ *
+ * @param elem	user-allocated storage space for queue entry
+ * @return zero
+ */
+static inline int nccl_ofi_mpsc_queue_push_front(nccl_ofi_mpsc_queue_t *queue, nccl_ofi_mpsc_queue_elem_t *elem)
+{
+	assert(queue);
+	assert(elem);
+
+	/* The consumer owns `tail', and `tail' is never NULL */
+	elem->next.store(queue->tail.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	queue->tail.store(elem, std::memory_order_relaxed);
+
+	return 0;
+}
+
+/*
+ * Check if the queue is empty. May be called by any thread, in which
+ * case the result is a hint only.
+ *
+ * @return true if empty, false if not
+ */
+static inline bool nccl_ofi_mpsc_queue_isempty(nccl_ofi_mpsc_queue_t *queue)
+{
+	return queue->tail.load(std::memory_order_relaxed) == &queue->stub &&
+		queue->head.load(std::memory_order_acquire) == &queue->stub;
+}
+
+/*
+ * Pop an element from the front of the queue. Consumer only.
+ *
+ * The queue may transiently appear empty while a producer is in the
+ * middle of a push; such elements are returned by a later call.
+ *
+ * @param elem	returned element; NULL if queue is empty
+ * @return zero
+ */
+static inline int nccl_ofi_mpsc_queue_pop(nccl_ofi_mpsc_queue_t *queue, nccl_ofi_mpsc_queue_elem_t **elem)
+{
+	assert(queue);
+	assert(elem);
+
+	nccl_ofi_mpsc_queue_elem_t *tail = queue->tail.load(std::memory_order_relaxed);
+	nccl_ofi_mpsc_queue_elem_t *next = tail->next.load(std::memory_order_acquire);
+
+	*elem = NULL;
+
+	if (tail == &queue->stub) {
+		if (next == NULL) {
+			return 0;
+		}
+		/* Skip the stub */
+		queue->tail.store(next, std::memory_order_relaxed);
+		tail = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+
+	if (next != NULL) {
+		queue->tail.store(next, std::memory_order_relaxed);
+		*elem = tail;
+		return 0;
+	}
+
+	if (tail != queue->head.load(std::memory_order_acquire)) {
+		/* A producer is linking a new element behind `tail' */
+		return 0;
+	}
+
+	/* `tail' is the last element. Re-insert the stub behind it so
+	 * that `tail' can be unlinked. */
+	nccl_ofi_mpsc_queue_push(queue, &queue->stub);
+
+	next = tail->next.load(std::memory_order_acquire);
+	if (next != NULL) {
+		queue->tail.store(next, std::memory_order_relaxed);
+		*elem = tail;
+	}
+
+	return 0;
+}
+
 #endif // End NCCL_OFI_DEQUE_H
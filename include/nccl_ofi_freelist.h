@@ -105,7 +105,7 @@ struct nccl_ofi_freelist_t {
 	nccl_ofi_freelist_entry_init_fn entry_init_fn;
 	nccl_ofi_freelist_entry_fini_fn entry_fini_fn;
 
-	pthread_mutex_t lock;
+	nccl_net_ofi_adaptive_mutex_t lock;
 };
 typedef struct nccl_ofi_freelist_t nccl_ofi_freelist_t;
 
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#ifndef NCCL_OFI_FREELIST_TYPED_H
+#define NCCL_OFI_FREELIST_TYPED_H
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <algorithm>
+
+#include "nccl_ofi.h"
+#include "nccl_ofi_freelist.h"
+#include "nccl_ofi_log.h"
+#include "nccl_ofi_math.h"
+#include "nccl_ofi_memcheck.h"
+#include "nccl_ofi_pthread.h"
+
+/*
+ * Typed freelist
+ *
+ * Freelist of objects of type T with entry size and alignment known at
+ * compile time. Unlike nccl_ofi_freelist_t, entries are stored inline
+ * in the block memory: each slot consists of a memcheck redzone, a
+ * small slot header holding the intrusive next pointer and the memory
+ * registration handle of the block, and the object itself. Allocation
+ * returns a pointer to the object, so callers neither dereference a
+ * separate nccl_ofi_freelist_elem_t nor cast its `ptr'.
+ *
+ * The slot header is never overlapped by the object, so state set up
+ * by the entry init callback is preserved across allocations, matching
+ * the semantics of nccl_ofi_freelist_t.
+ *
+ * Objects are not constructed or destructed by the freelist; T must be
+ * trivially usable from raw memory, with any setup done by the entry
+ * init and fini callbacks.
+ */
+template <typename T, size_t ALIGN = alignof(T)>
+class nccl_ofi_freelist_typed_t {
+public:
+	/* Called once on every newly allocated entry */
+	typedef int (*entry_init_fn)(T *entry);
+
+	/* Called once on every entry before its memory is released */
+	typedef void (*entry_fini_fn)(T *entry);
+
+	/*
+	 * Create a freelist
+	 *
+	 * Semantics of the entry counts and callbacks match
+	 * nccl_ofi_freelist_init_mr(). regmr_fn and deregmr_fn may be
+	 * NULL, in which case entry_mr_handle() returns NULL.
+	 */
+	static int init(size_t initial_entry_count,
+			size_t increase_entry_count,
+			size_t max_entry_count,
+			entry_init_fn init_fn,
+			entry_fini_fn fini_fn,
+			nccl_ofi_freelist_regmr_fn regmr_fn,
+			nccl_ofi_freelist_deregmr_fn deregmr_fn,
+			void *regmr_opaque,
+			nccl_ofi_freelist_typed_t **freelist_p)
+	{
+		int ret;
+		nccl_ofi_freelist_typed_t *freelist =
+			(nccl_ofi_freelist_typed_t *)calloc(1, sizeof(nccl_ofi_freelist_typed_t));
+		if (freelist == NULL) {
+			NCCL_OFI_WARN("Allocating typed freelist failed");
+			return -ENOMEM;
+		}
+
+		freelist->increase_entry_count = page_padded_entry_count(increase_entry_count);
+		freelist->max_entry_count = max_entry_count;
+		freelist->entry_init = init_fn;
+		freelist->entry_fini = fini_fn;
+		freelist->regmr_fn = regmr_fn;
+		freelist->deregmr_fn = deregmr_fn;
+		freelist->regmr_opaque = regmr_opaque;
+
+		ret = nccl_net_ofi_mutex_init(&freelist->lock, NCCL_NET_OFI_LOCK_CLASS_FREELIST);
+		if (ret != 0) {
+			NCCL_OFI_WARN("Mutex initialization failed: %s", strerror(ret));
+			free(freelist);
+			return -ret;
+		}
+
+		ret = freelist->add(page_padded_entry_count(initial_entry_count));
+		if (ret != 0) {
+			NCCL_OFI_WARN("Allocating initial freelist entries failed: %d", ret);
+			fini(freelist);
+			return ret;
+		}
+
+		*freelist_p = freelist;
+		return 0;
+	}
+
+	/*
+	 * Release a freelist and all of its memory, including entries
+	 * that have not been returned.
+	 */
+	static int fini(nccl_ofi_freelist_typed_t *freelist)
+	{
+		int ret = 0;
+
+		assert(freelist);
+
+		while (freelist->blocks) {
+			block_t *block = freelist->blocks;
+			freelist->blocks = block->next;
+
+			if (freelist->entry_fini != NULL) {
+				for (size_t i = 0; i < block->num_entries; ++i) {
+					T *entry = slot_entry(block->memory + i * slot_size);
+					nccl_net_ofi_mem_defined(entry, entry_size);
+					freelist->entry_fini(entry);
+				}
+			}
+
+			if (freelist->deregmr_fn != NULL) {
+				int rc = freelist->deregmr_fn(block->mr_handle);
+				if (rc != 0) {
+					NCCL_OFI_WARN("Could not deregister freelist buffer %p with handle %p",
+						      block->memory, block->mr_handle);
+					ret = rc;
+				}
+			}
+
+			/* Reset memcheck guards, see nccl_ofi_freelist_fini() */
+			nccl_net_ofi_mem_undefined(block->memory, block->memory_size);
+			int rc = nccl_net_ofi_dealloc_mr_buffer(block->memory, block->memory_size);
+			if (rc != 0) {
+				NCCL_OFI_WARN("Unable to deallocate MR buffer(%d)", rc);
+			}
+			free(block);
+		}
+
+		nccl_net_ofi_mutex_destroy(&freelist->lock);
+		free(freelist);
+
+		return ret;
+	}
+
+	/*
+	 * Allocate an entry
+	 *
+	 * Returns NULL if the freelist reached its maximum size or
+	 * could not grow. Locking is not required by the caller.
+	 */
+	inline T *entry_alloc()
+	{
+		T *entry = NULL;
+
+		nccl_net_ofi_mutex_lock(&lock);
+
+		if (OFI_UNLIKELY(free_head == NULL)) {
+			int ret = add(increase_entry_count);
+			if (ret != 0) {
+				NCCL_OFI_WARN("Could not extend freelist: %d", ret);
+				goto unlock;
+			}
+		}
+
+		entry = header_entry(free_head);
+		free_head = free_head->next;
+
+		/* Entry is accessible but undefined for the user */
+		nccl_net_ofi_mem_undefined(entry, entry_size);
+
+	unlock:
+		nccl_net_ofi_mutex_unlock(&lock);
+		return entry;
+	}
+
+	/*
+	 * Return an entry to the freelist
+	 *
+	 * The entry must not be accessed after this call.
+	 */
+	inline void entry_free(T *entry)
+	{
+		assert(entry);
+		slot_header_t *header = entry_header(entry);
+
+		nccl_net_ofi_mutex_lock(&lock);
+
+		header->next = free_head;
+		free_head = header;
+		nccl_net_ofi_mem_noaccess(entry, entry_size);
+
+		nccl_net_ofi_mutex_unlock(&lock);
+	}
+
+	/*
+	 * Memory registration handle of the block holding `entry', or
+	 * NULL if the freelist does not register its memory
+	 */
+	static inline void *entry_mr_handle(T *entry)
+	{
+		return entry_header(entry)->mr_handle;
+	}
+
+	/* Distance in bytes between two adjacent entries */
+	static constexpr size_t entry_stride()
+	{
+		return slot_size;
+	}
+
+private:
+	struct slot_header_t {
+		slot_header_t *next;
+		void *mr_handle;
+	};
+
+	struct block_t {
+		block_t *next;
+		char *memory;
+		size_t memory_size;
+		void *mr_handle;
+		size_t num_entries;
+	};
+
+	static_assert(NCCL_OFI_IS_POWER_OF_TWO(ALIGN), "Entry alignment must be a power of two");
+
+	/* Alignment of every part of a slot */
+	static constexpr size_t slot_align =
+		std::max({ALIGN, static_cast<size_t>(MEMCHECK_GRANULARITY), alignof(slot_header_t)});
+
+	static constexpr size_t redzone_size =
+		NCCL_OFI_ROUND_UP(static_cast<size_t>(MEMCHECK_REDZONE_SIZE), slot_align);
+	static constexpr size_t header_size = NCCL_OFI_ROUND_UP(sizeof(slot_header_t), slot_align);
+	static constexpr size_t entry_size = NCCL_OFI_ROUND_UP(sizeof(T), slot_align);
+	static constexpr size_t slot_size = redzone_size + header_size + entry_size;
+
+	/* Slot header immediately precedes the entry */
+	static inline slot_header_t *entry_header(T *entry)
+	{
+		return reinterpret_cast<slot_header_t *>(reinterpret_cast<char *>(entry) -
+							 sizeof(slot_header_t));
+	}
+
+	static inline T *header_entry(slot_header_t *header)
+	{
+		return reinterpret_cast<T *>(reinterpret_cast<char *>(header) + sizeof(slot_header_t));
+	}
+
+	static inline T *slot_entry(char *slot)
+	{
+		return reinterpret_cast<T *>(slot + redzone_size + header_size);
+	}
+
+	/* Number of entries that fit into the full pages covering
+	 * `entry_count' entries */
+	static inline size_t page_padded_entry_count(size_t entry_count)
+	{
+		return NCCL_OFI_ROUND_UP(slot_size * entry_count, system_page_size) / slot_size;
+	}
+
+	/* Grow the freelist. Lock must be held or not needed. */
+	int add(size_t num_entries)
+	{
+		int ret;
+		char *memory = NULL;
+		block_t *block = NULL;
+		slot_header_t *head = free_head;
+
+		if (max_entry_count > 0 && max_entry_count - num_allocated_entries < num_entries) {
+			num_entries = max_entry_count - num_allocated_entries;
+		}
+		if (num_entries == 0) {
+			NCCL_OFI_WARN("freelist %p is full", this);
+			return -ENOMEM;
+		}
+
+		size_t memory_size = NCCL_OFI_ROUND_UP(slot_size * num_entries, system_page_size);
+		ret = nccl_net_ofi_alloc_mr_buffer(memory_size, (void **)&memory);
+		if (OFI_UNLIKELY(ret != 0)) {
+			NCCL_OFI_WARN("freelist extension allocation failed (%d)", ret);
+			return ret;
+		}
+
+		block = (block_t *)calloc(1, sizeof(block_t));
+		if (block == NULL) {
+			NCCL_OFI_WARN("Failed to allocate freelist block metadata");
+			ret = -ENOMEM;
+			goto error;
+		}
+		block->memory = memory;
+		block->memory_size = memory_size;
+
+		if (regmr_fn != NULL) {
+			ret = regmr_fn(regmr_opaque, memory, memory_size, &block->mr_handle);
+			if (ret != 0) {
+				NCCL_OFI_WARN("freelist extension registration failed: %d", ret);
+				goto error;
+			}
+		}
+
+		/* Only the slot headers stay accessible */
+		nccl_net_ofi_mem_noaccess(memory, memory_size);
+
+		for (size_t i = 0; i < num_entries; ++i) {
+			char *slot = memory + i * slot_size;
+			T *entry = slot_entry(slot);
+			slot_header_t *header = entry_header(entry);
+
+			nccl_net_ofi_mem_undefined(slot + redzone_size, header_size);
+			header->mr_handle = block->mr_handle;
+
+			if (entry_init != NULL) {
+				nccl_net_ofi_mem_undefined(entry, entry_size);
+				ret = entry_init(entry);
+				if (ret != 0) {
+					/* Finalize entries initialized so far */
+					for (size_t j = 0; entry_fini != NULL && j < i; ++j) {
+						T *prev = slot_entry(memory + j * slot_size);
+						nccl_net_ofi_mem_defined(prev, entry_size);
+						entry_fini(prev);
+					}
+					if (regmr_fn != NULL && deregmr_fn != NULL) {
+						deregmr_fn(block->mr_handle);
+					}
+					goto error;
+				}
+				nccl_net_ofi_mem_noaccess(entry, entry_size);
+			}
+
+			header->next = head;
+			head = header;
+		}
+
+		free_head = head;
+		block->num_entries = num_entries;
+		block->next = blocks;
+		blocks = block;
+		num_allocated_entries += num_entries;
+
+		return 0;
+
+	error:
+		free(block);
+		nccl_net_ofi_mem_undefined(memory, memory_size);
+		nccl_net_ofi_dealloc_mr_buffer(memory, memory_size);
+		return ret;
+	}
+
+	slot_header_t *free_head;
+	block_t *blocks;
+
+	size_t num_allocated_entries;
+	size_t max_entry_count;
+	size_t increase_entry_count;
+
+	entry_init_fn entry_init;
+	entry_fini_fn entry_fini;
+
+	nccl_ofi_freelist_regmr_fn regmr_fn;
+	nccl_ofi_freelist_deregmr_fn deregmr_fn;
+	void *regmr_opaque;
+
+	nccl_net_ofi_adaptive_mutex_t lock;
+};
+
+#endif // End NCCL_OFI_FREELIST_TYPED_H
@@ -6,6 +6,10 @@
 #ifndef NCCL_OFI_LOG_H_
 #define NCCL_OFI_LOG_H_
 
+#include <atomic>
+#include <inttypes.h>
+#include <stdint.h>
+
 #include <nccl/net.h>
 
 // GCC is happy with this hint to identify printf string code
@@ -16,20 +20,151 @@ typedef ncclDebugLogger_t nccl_ofi_logger_t __attribute__ ((format (printf, 5, 6
 // Logger Function
 extern nccl_ofi_logger_t ofi_log_function;
 
+/*
+ * Most verbose level compiled into the plugin, as a ncclDebugLogLevel
+ * value. Messages of more verbose levels are removed at compile time,
+ * including the formatting of their arguments. Set by configure
+ * --with-log-level; defaults to trace with --enable-trace and info
+ * otherwise.
+ */
+#ifndef NCCL_OFI_LOG_LEVEL
+#if OFI_NCCL_TRACE
+#define NCCL_OFI_LOG_LEVEL 5
+#else
+#define NCCL_OFI_LOG_LEVEL 3
+#endif
+#endif
+
+/*
+ * Rate limiting state of a logging call site. Zero-initialized as a
+ * static variable.
+ */
+typedef struct nccl_ofi_log_site {
+	/* Start of the current window, in nanoseconds */
+	std::atomic<uint64_t> window_start;
+	/* Messages logged in the current window */
+	std::atomic<uint32_t> count;
+	/* Messages dropped since the last one logged */
+	std::atomic<uint64_t> suppressed;
+} nccl_ofi_log_site_t;
+
+/*
+ * Maximum number of messages per second logged by a call site, 0 for
+ * no limit. Set by nccl_ofi_log_init().
+ */
+extern std::atomic<uint32_t> nccl_ofi_log_rate_limit;
+
+/* True if messages are handed to the drain thread */
+extern std::atomic<bool> nccl_ofi_log_async;
+
+/*
+ * @brief	Apply the logging parameters and start the drain thread if
+ *		asynchronous logging is enabled
+ *
+ * Must be called after ofi_log_function is set.
+ */
+void nccl_ofi_log_init(void);
+
+/*
+ * @brief	Stop the drain thread, logging the messages still queued
+ *
+ * Messages logged afterwards are passed to ofi_log_function directly.
+ */
+void nccl_ofi_log_fini(void);
+
+/*
+ * @brief	Log the messages queued by all threads
+ *
+ * Called before aborting, so that the reason is not lost.
+ */
+void nccl_ofi_log_flush(void);
+
+/*
+ * @brief	Slow path of nccl_ofi_log_site_allow()
+ */
+bool nccl_ofi_log_site_allow_limited(nccl_ofi_log_site_t *site, uint32_t limit,
+				     uint64_t *suppressed);
+
+/*
+ * @brief	Check if the rate limit of a call site allows a message
+ *
+ * @param	suppressed
+ *		Set to the number of messages dropped since the previous
+ *		message of the call site was allowed
+ */
+static inline bool nccl_ofi_log_site_allow(nccl_ofi_log_site_t *site, uint64_t *suppressed)
+{
+	uint32_t limit = nccl_ofi_log_rate_limit.load(std::memory_order_relaxed);
+
+	*suppressed = 0;
+	if (OFI_LIKELY(limit == 0)) {
+		return true;
+	}
+	return nccl_ofi_log_site_allow_limited(site, limit, suppressed);
+}
+
+/*
+ * @brief	Format a message into the ring of the calling thread
+ *
+ * Messages above the level of NCCL_DEBUG are dropped without being
+ * formatted. Falls back to ofi_log_function if the thread has no ring.
+ */
+void nccl_ofi_log_enqueue(ncclDebugLogLevel level, unsigned long flags, const char *filefunc,
+			  int line, const char *fmt, ...) __attribute__ ((format (printf, 5, 6)));
+
+/* Never called, keeps compiled-out messages type checked */
+static inline void nccl_ofi_log_discard(const char *fmt, ...) __attribute__ ((format (printf, 1, 2)));
+static inline void nccl_ofi_log_discard(const char *fmt, ...)
+{
+}
+
+#define NCCL_OFI_LOG_EMIT(level, flags, fmt, ...)				\
+	do {									\
+		if (nccl_ofi_log_async.load(std::memory_order_relaxed)) {	\
+			nccl_ofi_log_enqueue(level, flags, __PRETTY_FUNCTION__,	\
+					     __LINE__, fmt, ##__VA_ARGS__);	\
+		} else {							\
+			(*ofi_log_function)(level, flags, __PRETTY_FUNCTION__,	\
+					    __LINE__, fmt, ##__VA_ARGS__);	\
+		}								\
+	} while (0)
+
+#define NCCL_OFI_LOG_LIMITED(level, flags, fmt, ...)				\
+	do {									\
+		static nccl_ofi_log_site_t nccl_ofi_log_site_state;		\
+		uint64_t nccl_ofi_log_suppressed;				\
+		if (nccl_ofi_log_site_allow(&nccl_ofi_log_site_state,		\
+					    &nccl_ofi_log_suppressed)) {	\
+			if (OFI_UNLIKELY(nccl_ofi_log_suppressed > 0)) {	\
+				NCCL_OFI_LOG_EMIT(level, flags,			\
+						  "NET/OFI Suppressed %" PRIu64 " messages", \
+						  nccl_ofi_log_suppressed);	\
+			}							\
+			NCCL_OFI_LOG_EMIT(level, flags, "NET/OFI " fmt,		\
+					  ##__VA_ARGS__);			\
+		}								\
+	} while (0)
+
 #define NCCL_OFI_WARN(fmt, ...)							\
-	(*ofi_log_function)(NCCL_LOG_WARN, NCCL_ALL, __PRETTY_FUNCTION__,	\
-	__LINE__, "NET/OFI " fmt, ##__VA_ARGS__)
+	NCCL_OFI_LOG_LIMITED(NCCL_LOG_WARN, NCCL_ALL, fmt, ##__VA_ARGS__)
 
-#define NCCL_OFI_INFO(flags, fmt, ...)				\
-	(*ofi_log_function)(NCCL_LOG_INFO, flags,		\
-	__PRETTY_FUNCTION__, __LINE__, "NET/OFI " fmt,		\
-	##__VA_ARGS__)
+#if NCCL_OFI_LOG_LEVEL >= 3
+#define NCCL_OFI_INFO(flags, fmt, ...)						\
+	NCCL_OFI_LOG_LIMITED(NCCL_LOG_INFO, flags, fmt, ##__VA_ARGS__)
+#else
+#define NCCL_OFI_INFO(flags, fmt, ...)						\
+	do {									\
+		if (0) {							\
+			(void)(flags);						\
+			nccl_ofi_log_discard(fmt, ##__VA_ARGS__);		\
+		}								\
+	} while (0)
+#endif
 
-#if OFI_NCCL_TRACE
-#define NCCL_OFI_TRACE(flags, fmt, ...)				\
-	(*ofi_log_function)(NCCL_LOG_TRACE, flags,		\
-	__PRETTY_FUNCTION__, __LINE__, "NET/OFI " fmt,		\
-	##__VA_ARGS__)
+/* Trace messages are not rate limited, so that traces are complete */
+#if NCCL_OFI_LOG_LEVEL >= 5
+#define NCCL_OFI_TRACE(flags, fmt, ...)						\
+	NCCL_OFI_LOG_EMIT(NCCL_LOG_TRACE, flags, "NET/OFI " fmt, ##__VA_ARGS__)
 #define NCCL_OFI_TRACE_WHEN(criteria, flags, fmt, ...)			\
 	do {								\
 		if (OFI_UNLIKELY(criteria)) {				\
@@ -221,4 +221,20 @@ int nccl_ofi_mr_cache_insert_entry(nccl_ofi_mr_cache_t *cache, nccl_ofi_mr_ckey_
  */
 int nccl_ofi_mr_cache_del_entry(nccl_ofi_mr_cache_t *cache, void *handle);
 
+/**
+ * Account a libfabric memory registration of the plugin, or its
+ * release. Called by the transports for all registrations, including
+ * the internal ones of freelists and control buffers.
+ */
+void nccl_ofi_mr_count_reg(void);
+void nccl_ofi_mr_count_dereg(void);
+
+/**
+ * Return the number of libfabric memory registrations issued so far
+ * and the number of them that are still registered. Exported for
+ * tests, which look it up in the loaded plugin.
+ */
+extern "C" NCCL_OFI_EXPORT_SYMBOL void nccl_ofi_mr_get_reg_counts(uint64_t *num_regs,
+								  uint64_t *num_live);
+
 #endif  // End NCCL_OFI_MR_H_
@@ -8,6 +8,8 @@
 #include <pthread.h>
 #include <stdint.h>
 
+#include "nccl_ofi_pthread.h"
+
 /**
  * A "modified circular buffer" used to track in-flight (or INPROGRESS) messages.
  * Messages are identified by a wrapping sequence number (with bit width chosen during
@@ -64,7 +66,9 @@ typedef enum {
 	/* Request */
 	NCCL_OFI_MSGBUFF_REQ,
 	/* Rx buffer */
-	NCCL_OFI_MSGBUFF_BUFF
+	NCCL_OFI_MSGBUFF_BUFF,
+	/* Receive ring slot granted by a credit message */
+	NCCL_OFI_MSGBUFF_RING_SLOT
 } nccl_ofi_msgbuff_elemtype_t;
 
 /* Internal buffer storage type, used to keep status of elements currently stored in
@@ -95,7 +99,7 @@ typedef struct {
 	// Points to the message after the inserted message with highest sequence number.
 	uint16_t msg_next;
 	// Mutex for this msg buffer -- locks all non-init operations
-	pthread_mutex_t lock;
+	nccl_net_ofi_adaptive_mutex_t lock;
 } nccl_ofi_msgbuff_t;
 
 /**
@@ -15,12 +15,18 @@ int nccl_ofi_ofiutils_get_providers(const char *prov_include,
 /*
  * @brief	Allocates and initialises libfabric endpoint and AV.
  *
+ * If `write_cntr' is not NULL, it is bound to the endpoint for
+ * FI_WRITE events and the CQ is bound with FI_SELECTIVE_COMPLETION for
+ * transmit operations, i.e., only operations posted with
+ * FI_COMPLETION generate a completion entry. `info' must then include
+ * FI_COMPLETION in its default tx op_flags.
+ *
  * @return	Endpoint ep
  * @return	Address vector av
  */
 int nccl_ofi_ofiutils_init_connection(struct fi_info *info, struct fid_domain *domain,
 				      struct fid_ep **ep,   struct fid_av **av,
-				      struct fid_cq **cq);
+				      struct fid_cq **cq, struct fid_cntr *write_cntr);
 
 /*
  * @brief	Release libfabric endpoint and address vector
@@ -6,13 +6,66 @@
 #define NCCL_OFI_PARAM_H_
 
 #include <assert.h>
+#include <atomic>
 #include <errno.h>
 #include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <type_traits>
 
 #include "nccl_ofi_log.h"
 #include "nccl_ofi_pthread.h"
 
+/*
+ * Dynamic parameters
+ *
+ * Parameters declared with OFI_NCCL_PARAM_*_DYNAMIC are read from the
+ * environment like the others, but can also be changed while the
+ * plugin runs. Their new values are read from the control file (see
+ * CONTROL_FILE), one OFI_NCCL_<NAME>=<value> assignment per line, with
+ * '#' starting a comment. Values are stored in atomics, so readers
+ * never observe a torn value.
+ *
+ * Every change increments the parameter epoch. Code that derives
+ * state from dynamic parameters keeps the epoch it derived the state
+ * at, and re-derives it once the epoch moved. Checking costs one
+ * atomic load.
+ */
+extern std::atomic<uint64_t> nccl_ofi_param_epoch;
+
+static inline uint64_t nccl_ofi_param_get_epoch(void)
+{
+	return nccl_ofi_param_epoch.load(std::memory_order_acquire);
+}
+
+/*
+ * @brief	Apply the assignments of the control file at `path'
+ *
+ * Assignments of unknown or non-dynamic parameters and invalid values
+ * are reported and skipped.
+ *
+ * @return	Number of parameters whose value changed, on success
+ *		negative errno, if the file cannot be read
+ */
+int nccl_ofi_param_reload(const char *path);
+
+/*
+ * @brief	Start watching the control file, if CONTROL_FILE is set
+ *
+ * The file is applied right away if it exists, and again whenever its
+ * modification time changes.
+ *
+ * @return	0, on success
+ *		negative errno, on error
+ */
+int nccl_ofi_param_watch_start(void);
+
+/*
+ * @brief	Stop watching the control file
+ */
+void nccl_ofi_param_watch_stop(void);
+
 /*
  * This is an ugly hack.  The original implementation of
  * nccl_ofi_param created inline functions to access each environment
@@ -41,8 +94,108 @@ int64_t ofi_nccl_##name(void)
 #define OFI_NCCL_PARAM_STR(name, env, default_value) \
 const char *ofi_nccl_##name(void)
 
+#define OFI_NCCL_PARAM_UINT_DYNAMIC(name, env, default_value) \
+uint64_t ofi_nccl_##name(void)
+
+#define OFI_NCCL_PARAM_INT_DYNAMIC(name, env, default_value) \
+int64_t ofi_nccl_##name(void)
+
 #else
 
+/*
+ * Registry entry of a dynamic parameter. Entries link themselves into
+ * a list when the library is loaded.
+ */
+class nccl_ofi_param_dynamic_base {
+public:
+	nccl_ofi_param_dynamic_base(const char *env_name_arg);
+	virtual ~nccl_ofi_param_dynamic_base() = default;
+
+	/* Parse `str' and store it. Returns 1 if the value changed, 0
+	 * if not, -EINVAL if `str' is not a valid value. */
+	virtual int set(const char *str) = 0;
+
+	/* Find the parameter named `env_name', NULL if none */
+	static nccl_ofi_param_dynamic_base *find(const char *env_name);
+
+	const char *const env_name;
+
+private:
+	nccl_ofi_param_dynamic_base *next;
+	static nccl_ofi_param_dynamic_base *head;
+};
+
+template <typename T>
+class nccl_ofi_param_dynamic : public nccl_ofi_param_dynamic_base {
+public:
+	nccl_ofi_param_dynamic(const char *env_name_arg, T default_value)
+		: nccl_ofi_param_dynamic_base(env_name_arg), value(default_value), initialized(false)
+	{
+	}
+
+	T get()
+	{
+		if (OFI_UNLIKELY(!initialized.load(std::memory_order_acquire))) {
+			init();
+		}
+		return value.load(std::memory_order_relaxed);
+	}
+
+	int set(const char *str) override
+	{
+		T v;
+
+		if (!parse(str, &v)) {
+			return -EINVAL;
+		}
+
+		/* Environment must not override the new value later */
+		get();
+		return (value.exchange(v, std::memory_order_relaxed) != v) ? 1 : 0;
+	}
+
+private:
+	static bool parse(const char *str, T *v)
+	{
+		char *endptr;
+
+		errno = 0;
+		if (std::is_signed<T>::value) {
+			*v = (T)strtoll(str, &endptr, 0);
+		} else {
+			*v = (T)strtoull(str, &endptr, 0);
+		}
+		return !(errno || str == endptr || *endptr != '\0');
+	}
+
+	void init()
+	{
+		nccl_net_ofi_mutex_lock(&lock);
+		if (!initialized.load(std::memory_order_relaxed)) {
+			const char *str = getenv(env_name);
+			T v;
+
+			if (str && strlen(str) > 0) {
+				if (parse(str, &v)) {
+					value.store(v, std::memory_order_relaxed);
+					NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "Setting %s environment variable to %s",
+						      env_name, str);
+				} else {
+					NCCL_OFI_INFO(NCCL_INIT | NCCL_NET,
+						      "Invalid value %s provided for %s environment variable, using default",
+						      str, env_name);
+				}
+			}
+			initialized.store(true, std::memory_order_release);
+		}
+		nccl_net_ofi_mutex_unlock(&lock);
+	}
+
+	std::atomic<T> value;
+	std::atomic<bool> initialized;
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+};
+
 #define OFI_NCCL_PARAM_UINT(name, env, default_value)                                                                       \
 	uint64_t ofi_nccl_##name(void);                                                                                     \
 	static pthread_mutex_t ofi_nccl_param_lock_##name = PTHREAD_MUTEX_INITIALIZER;                                      \
@@ -146,6 +299,22 @@ const char *ofi_nccl_##name() { \
     return value; \
 }
 
+#define OFI_NCCL_PARAM_UINT_DYNAMIC(name, env, default_value)                                                \
+	uint64_t ofi_nccl_##name(void);                                                                      \
+	static nccl_ofi_param_dynamic<uint64_t> ofi_nccl_param_dynamic_##name("OFI_NCCL_" env, default_value); \
+	uint64_t ofi_nccl_##name(void)                                                                       \
+	{                                                                                                    \
+		return ofi_nccl_param_dynamic_##name.get();                                                  \
+	}
+
+#define OFI_NCCL_PARAM_INT_DYNAMIC(name, env, default_value)                                                 \
+	int64_t ofi_nccl_##name(void);                                                                       \
+	static nccl_ofi_param_dynamic<int64_t> ofi_nccl_param_dynamic_##name("OFI_NCCL_" env, default_value); \
+	int64_t ofi_nccl_##name(void)                                                                        \
+	{                                                                                                    \
+		return ofi_nccl_param_dynamic_##name.get();                                                  \
+	}
+
 #endif
 
 /*
@@ -221,9 +390,9 @@ OFI_NCCL_PARAM_INT(mr_cache_disable, "MR_CACHE_DISABLE",
 
 /*
  * Maximum number of cq entries to read in a single call to
- * fi_cq_read.
+ * fi_cq_read. Dynamic for the rdma protocol, which caps it at 64.
  */
-OFI_NCCL_PARAM_INT(cq_read_count, "CQ_READ_COUNT", 4);
+OFI_NCCL_PARAM_INT_DYNAMIC(cq_read_count, "CQ_READ_COUNT", 4);
 
 /*
  * Protocol to use for send/recv operations.  Valid options are
@@ -278,9 +447,10 @@ OFI_NCCL_PARAM_INT(disable_gdr_required_check, "DISABLE_GDR_REQUIRED_CHECK", 0);
 OFI_NCCL_PARAM_INT(disable_dmabuf, "DISABLE_DMABUF", 1);
 
 /*
- * Messages sized larger than this threshold will be striped across multiple rails
+ * Messages sized larger than this threshold will be striped across
+ * multiple rails. Dynamic.
  */
-OFI_NCCL_PARAM_UINT(min_stripe_size, "MIN_STRIPE_SIZE", (128 * 1024));
+OFI_NCCL_PARAM_UINT_DYNAMIC(min_stripe_size, "MIN_STRIPE_SIZE", (128 * 1024));
 
 /*
  * Minimum rx buffers (ctrl/eager) posted per endpoint. The plugin will attempt
@@ -288,15 +458,16 @@ OFI_NCCL_PARAM_UINT(min_stripe_size, "MIN_STRIPE_SIZE", (128 * 1024));
  * buffers if needed.
  *
  * Note: the parameter is called "bounce buffer" for backward compatibility.
+ * Dynamic.
  */
-OFI_NCCL_PARAM_INT(rdma_min_posted_bounce_buffers, "RDMA_MIN_POSTED_BOUNCE_BUFFERS", 64);
+OFI_NCCL_PARAM_INT_DYNAMIC(rdma_min_posted_bounce_buffers, "RDMA_MIN_POSTED_BOUNCE_BUFFERS", 64);
 
 /*
  * Maximum rx buffers posted per endpoint. The plugin will not attempt to
  * post more rx buffers if we reach this threshold, returning available
- * buffers to the free list if needed
+ * buffers to the free list if needed. Dynamic.
  */
-OFI_NCCL_PARAM_INT(rdma_max_posted_bounce_buffers, "RDMA_MAX_POSTED_BOUNCE_BUFFERS", 128);
+OFI_NCCL_PARAM_INT_DYNAMIC(rdma_max_posted_bounce_buffers, "RDMA_MAX_POSTED_BOUNCE_BUFFERS", 128);
 
 /*
  * Whether to spread the control message across multiple rails in round robin fashion or
@@ -313,8 +484,10 @@ OFI_NCCL_PARAM_INT(net_latency, "NET_LATENCY", -1);
 /*
  * Eager message size limit when using RDMA protocol. Message sizes greater than
  * this limit will always be sent using RDMA write instead of eagerly.
+ * Dynamic, but rx buffers are sized at startup, so a new value only takes
+ * effect up to the startup value.
  */
-OFI_NCCL_PARAM_INT(eager_max_size, "EAGER_MAX_SIZE", -1);
+OFI_NCCL_PARAM_INT_DYNAMIC(eager_max_size, "EAGER_MAX_SIZE", -1);
 
 /*
  * Decide whether or not mutexes should default to errorcheck mode.
@@ -329,6 +502,14 @@ OFI_NCCL_PARAM_INT(eager_max_size, "EAGER_MAX_SIZE", -1);
 OFI_NCCL_PARAM_INT(errorcheck_mutex, "ERRORCHECK_MUTEX",
 		   OFI_NCCL_PARAM_ERRORCHECK_MUTEX_DEFAULT);
 
+/*
+ * Comma separated list of lock classes which use the adaptive
+ * spin-then-park mutex instead of a pthread mutex. Valid classes are
+ * "freelist", "msgbuff" and "scheduler", or "all". Ignored for locks
+ * created while errorcheck mutexes are enabled.
+ */
+OFI_NCCL_PARAM_STR(adaptive_mutex, "ADAPTIVE_MUTEX", "");
+
 /*
  * If 0, create a Libfabric endpoint per domain, shared across all
  * communicators.  If non-0, create a Libfabric endpoint per
@@ -384,6 +565,17 @@ OFI_NCCL_PARAM_INT(tuner_net_comp_overhead, "TUNER_NET_COMP_OVERHEAD", 3);
  */
 OFI_NCCL_PARAM_INT(use_low_lat_tc, "USE_LOW_LATENCY_TC", 1);
 
+/*
+ * Maximum size of messages the rdma transport sends with the
+ * LOW_LATENCY traffic class. When non-zero, every data rail gets a
+ * second, transmit-only endpoint with that traffic class, and eager
+ * sends, RDMA writes and one-sided writes of at most this many bytes
+ * are posted to it instead of queuing behind bulk transfers on the
+ * default traffic class. Ignored with RDMA_WRITE_CNTR. 0 disables the
+ * low-latency data endpoints.
+ */
+OFI_NCCL_PARAM_UINT(low_lat_data_max_size, "LOW_LATENCY_DATA_MAX_SIZE", 0);
+
 /*
  * Number of rails that the rdma transport should build.  If the
  * number of rails is more than the number of NICs, then the number of
@@ -396,7 +588,135 @@ OFI_NCCL_PARAM_INT(force_num_rails, "FORCE_NUM_RAILS", 0);
  * Default at -1 to follow the data progress model, given that 
  * early completion feature is contigent on FI_PROGRESS_AUTO data progress model
  * i.e. enabled when FI_PROGRESS_AUTO, otherwise disabled
+ * Applies to receives NCCL marks as NCCL_NET_OPTIONAL_RECV_COMPLETION with
+ * both the RDMA and SENDRECV protocols.
  */
 OFI_NCCL_PARAM_INT(early_completion, "EARLY_COMPLETION", -1);
 
+/*
+ * 1 to enable the pre-advertised receive ring of the RDMA protocol, 0
+ * to disable it. When enabled on both peers, receives that reuse the
+ * buffer previously advertised for their ring slot are announced to
+ * the sender with batched credit messages instead of a full control
+ * message per receive.
+ */
+OFI_NCCL_PARAM_INT(rdma_recv_ring, "RDMA_RECV_RING", 0);
+
+/*
+ * 1 to track completion of the RDMA writes of send() with a libfabric
+ * counter per endpoint rail instead of a completion queue entry per
+ * write, 0 to disable it. Counters do not identify the completed
+ * write, so a send request completes once all writes posted on its
+ * rails up to its last write have completed.
+ */
+OFI_NCCL_PARAM_INT(rdma_write_cntr, "RDMA_WRITE_CNTR", 0);
+
+/*
+ * With RDMA_WRITE_CNTR, number of writes posted on a rail that are not
+ * known to be complete after which new writes on the rail are held
+ * back until the counter caught up. Bounds how long a send waits for
+ * unrelated writes on a busy rail.
+ */
+OFI_NCCL_PARAM_UINT(rdma_write_cntr_fence_interval, "RDMA_WRITE_CNTR_FENCE_INTERVAL", 64);
+
+/*
+ * Poll the completion queue of an RDMA endpoint rail without
+ * outstanding operations only on every N-th progress call. Rails with
+ * locally posted operations in flight, and rails that may receive
+ * data or control messages for in-flight send and receive requests,
+ * are always polled. 0 polls every rail on every progress call.
+ */
+OFI_NCCL_PARAM_UINT(rdma_idle_cq_poll_interval, "RDMA_IDLE_CQ_POLL_INTERVAL", 0);
+
+/*
+ * 1 to return RDMA send communicators from connect() as soon as the
+ * connect message is posted, 0 (default) to wait for the connect
+ * response. Sends issued before the response arrives are queued and
+ * posted once it does.
+ */
+OFI_NCCL_PARAM_INT(rdma_zero_rtt_connect, "RDMA_ZERO_RTT_CONNECT", 0);
+
+/*
+ * 1 to send eager messages of the RDMA protocol from host memory with
+ * fi_injectdata when they fit the provider's inject size, 0 to always
+ * use fi_senddata. Injected messages complete at post time instead of
+ * through a send completion entry.
+ */
+OFI_NCCL_PARAM_INT(eager_inject, "EAGER_INJECT", 1);
+
+/*
+ * Number of times the RDMA protocol posts the stripes of a send
+ * request again after they completed with a transient error, possibly
+ * on another rail, before the request fails. 0 fails the request on
+ * the first error. Not supported with RDMA_WRITE_CNTR.
+ */
+OFI_NCCL_PARAM_UINT(stripe_retry_max, "STRIPE_RETRY_MAX", 3);
+
+/*
+ * Delay in microseconds before a failed stripe is posted again. The
+ * delay doubles with each further attempt of the same request.
+ */
+OFI_NCCL_PARAM_UINT(stripe_retry_backoff_us, "STRIPE_RETRY_BACKOFF_US", 10);
+
+/*
+ * Debugging aid, only honored by debug builds: fail every N-th RDMA
+ * write of send requests as if the provider had reported a transient
+ * error, to exercise STRIPE_RETRY_MAX. The write is not posted and is
+ * posted again like a write whose completion reported the error.
+ * 0 (default) disables error injection.
+ */
+OFI_NCCL_PARAM_UINT_DYNAMIC(inject_stripe_errors, "INJECT_STRIPE_ERRORS", 0);
+
+/*
+ * 1 to move the data of SENDRECV communicators between processes of
+ * the same host through a shared-memory ring instead of the NIC, 0 to
+ * disable it. Both peers must use the same setting. Data is copied by
+ * the CPU, so communicators using it only support host buffers.
+ */
+OFI_NCCL_PARAM_INT(shm_transport, "SHM_TRANSPORT", 0);
+
+/*
+ * Size in bytes of the ring of a shared-memory communicator. Rounded
+ * up to a power of two of at least a page.
+ */
+OFI_NCCL_PARAM_UINT(shm_ring_size, "SHM_RING_SIZE", (1024 * 1024));
+
+/*
+ * Path of the control file changing dynamic parameters at runtime.
+ * NULL (default) to only read parameters from the environment.
+ */
+OFI_NCCL_PARAM_STR(control_file, "CONTROL_FILE", NULL);
+
+/*
+ * Interval in milliseconds at which the control file is checked for
+ * modifications.
+ */
+OFI_NCCL_PARAM_UINT(control_file_interval_ms, "CONTROL_FILE_INTERVAL_MS", 1000);
+
+/*
+ * 1 to format log messages into per-thread rings that a background
+ * thread passes to NCCL's logger, 0 (default) to call the logger
+ * directly. Keeps threads from blocking on the logger's lock and I/O,
+ * at the cost of dropping messages when a thread logs faster than
+ * they are drained. Messages above the level of NCCL_DEBUG are
+ * discarded without being formatted.
+ */
+OFI_NCCL_PARAM_INT(log_async, "LOG_ASYNC", 0);
+
+/*
+ * Maximum number of warning and info messages per second logged from
+ * a single call site, 0 (default) for no limit. Messages above the
+ * limit are counted, and the count is logged with the next message of
+ * the call site.
+ */
+OFI_NCCL_PARAM_UINT(log_rate_limit, "LOG_RATE_LIMIT", 0);
+
+/*
+ * 1 to report the devices of the plugin to NCCL as a software
+ * collective network (CollNet) that reduces host buffers over rings of
+ * point-to-point communicators, 0 (default) to report no collective
+ * network device.
+ */
+OFI_NCCL_PARAM_INT(collnet, "COLLNET", 0);
+
 #endif // End NCCL_OFI_PARAM_H_
@@ -7,7 +7,11 @@
 
 #include <errno.h>
 #include <pthread.h>
+#include <stdint.h>
 #include <string.h>
+#include <time.h>
+
+#include <atomic>
 
 #include "nccl_ofi_log.h"
 
@@ -37,6 +41,48 @@ int nccl_net_ofi_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *a
 int nccl_net_ofi_mutex_destroy(pthread_mutex_t *mutex);
 
 
+#if NCCL_OFI_MUTEX_PROFILING
+/**
+ * Record acquisition of a mutex
+ *
+ * Called by the lock wrappers once `mutex' has been acquired at
+ * `file':`line'. `wait_ns' is the time spent blocked on the mutex,
+ * and `contended' is true if the initial trylock failed.
+ */
+void nccl_net_ofi_mutex_prof_acquired(const void *mutex, const char *file, size_t line,
+				      bool contended, uint64_t wait_ns);
+
+/**
+ * Record release of a mutex, accounting its hold time to the site
+ * that acquired it
+ */
+void nccl_net_ofi_mutex_prof_released(const void *mutex);
+
+/**
+ * Monotonic clock in nanoseconds, used for wait time measurement
+ */
+static inline uint64_t nccl_net_ofi_mutex_prof_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+
+/**
+ * Print the per lock site contention report
+ *
+ * Sites are sorted by total wait time. Only has an effect if the
+ * plugin was configured with --enable-mutex-profiling.
+ */
+#if NCCL_OFI_MUTEX_PROFILING
+void nccl_net_ofi_mutex_prof_report(void);
+#else
+static inline void nccl_net_ofi_mutex_prof_report(void) {}
+#endif
+
+
 /**
  * Lock a mutex
  *
@@ -46,7 +92,22 @@ int nccl_net_ofi_mutex_destroy(pthread_mutex_t *mutex);
 static inline void
 nccl_net_ofi_mutex_lock_impl(pthread_mutex_t *mutex, const char *file, size_t line)
 {
+#if NCCL_OFI_MUTEX_PROFILING
+	/* Only time the acquisitions that actually block */
+	int ret = pthread_mutex_trylock(mutex);
+	if (OFI_LIKELY(ret == 0)) {
+		nccl_net_ofi_mutex_prof_acquired(mutex, file, line, false, 0);
+		return;
+	}
+	uint64_t start = nccl_net_ofi_mutex_prof_now();
+	ret = pthread_mutex_lock(mutex);
+	if (OFI_LIKELY(ret == 0)) {
+		nccl_net_ofi_mutex_prof_acquired(mutex, file, line, true,
+						 nccl_net_ofi_mutex_prof_now() - start);
+	}
+#else
 	int ret = pthread_mutex_lock(mutex);
+#endif
 	if (OFI_UNLIKELY(ret != 0)) {
 		(*ofi_log_function)(NCCL_LOG_WARN, NCCL_ALL, file, line,
 				    "NET/OFI pthread_mutex_lock failed: %s",
@@ -75,6 +136,11 @@ nccl_net_ofi_mutex_trylock_impl(pthread_mutex_t *mutex, const char *file, size_t
 				    strerror(ret));
 		abort();
 	}
+#if NCCL_OFI_MUTEX_PROFILING
+	if (ret == 0) {
+		nccl_net_ofi_mutex_prof_acquired(mutex, file, line, false, 0);
+	}
+#endif
      return ret;
 }
 #define nccl_net_ofi_mutex_trylock(mutex) nccl_net_ofi_mutex_trylock_impl(mutex, __FILE__, __LINE__);
@@ -89,6 +155,9 @@ nccl_net_ofi_mutex_trylock_impl(pthread_mutex_t *mutex, const char *file, size_t
 static inline void
 nccl_net_ofi_mutex_unlock_impl(pthread_mutex_t *mutex, const char *file, size_t line)
 {
+#if NCCL_OFI_MUTEX_PROFILING
+	nccl_net_ofi_mutex_prof_released(mutex);
+#endif
 	int ret = pthread_mutex_unlock(mutex);
 	if (OFI_UNLIKELY(ret != 0)) {
 		(*ofi_log_function)(NCCL_LOG_WARN, NCCL_ALL, file, line,
@@ -99,4 +168,153 @@ nccl_net_ofi_mutex_unlock_impl(pthread_mutex_t *mutex, const char *file, size_t
 }
 #define nccl_net_ofi_mutex_unlock(mutex) nccl_net_ofi_mutex_unlock_impl(mutex, __FILE__, __LINE__);
 
+
+
+/**
+ * Lock classes which may use the adaptive mutex
+ *
+ * Selected at runtime through OFI_NCCL_ADAPTIVE_MUTEX.
+ */
+typedef enum {
+	NCCL_NET_OFI_LOCK_CLASS_FREELIST = 0,
+	NCCL_NET_OFI_LOCK_CLASS_MSGBUFF,
+	NCCL_NET_OFI_LOCK_CLASS_SCHEDULER,
+	NCCL_NET_OFI_LOCK_CLASS_NUM,
+} nccl_net_ofi_lock_class_t;
+
+
+/**
+ * Adaptive spin-then-park mutex
+ *
+ * Intended for very short critical sections on the hot path, where
+ * parking a contended waiter in the kernel costs more than the
+ * critical section itself. A contended lock spins with exponential
+ * backoff for a bounded number of rounds before sleeping on a futex.
+ *
+ * The state word is 0 if unlocked, 1 if locked and 2 if locked with
+ * possibly sleeping waiters. If the lock class is not configured to
+ * be adaptive, all operations are forwarded to `mutex'.
+ */
+typedef struct {
+	std::atomic<uint32_t> state;
+	bool adaptive;
+	pthread_mutex_t mutex;
+} nccl_net_ofi_adaptive_mutex_t;
+
+
+/**
+ * Create an adaptive mutex of the given lock class
+ *
+ * The mutex is a plain pthread mutex, see nccl_net_ofi_mutex_init(),
+ * unless the lock class is listed in OFI_NCCL_ADAPTIVE_MUTEX and
+ * errorcheck mutexes are disabled.
+ *
+ * See pthread_mutex_init() for possible return codes
+ */
+int nccl_net_ofi_mutex_init(nccl_net_ofi_adaptive_mutex_t *mutex, nccl_net_ofi_lock_class_t lock_class);
+
+
+/**
+ * Free resources allocated for an adaptive mutex
+ *
+ * Returns EBUSY if the mutex is locked.
+ */
+int nccl_net_ofi_mutex_destroy(nccl_net_ofi_adaptive_mutex_t *mutex);
+
+
+/**
+ * Contended acquisition of an adaptive mutex: spin with backoff,
+ * then park on the futex until the mutex is acquired.
+ */
+void nccl_net_ofi_adaptive_mutex_lock_slow(nccl_net_ofi_adaptive_mutex_t *mutex);
+
+
+/**
+ * Contended release of an adaptive mutex: wake a parked waiter, or
+ * abort if the mutex was not locked.
+ */
+void nccl_net_ofi_adaptive_mutex_unlock_slow(nccl_net_ofi_adaptive_mutex_t *mutex,
+					     uint32_t prev_state, const char *file, size_t line);
+
+
+static inline bool nccl_net_ofi_adaptive_mutex_try(nccl_net_ofi_adaptive_mutex_t *mutex)
+{
+	uint32_t unlocked = 0;
+	return mutex->state.compare_exchange_strong(unlocked, 1, std::memory_order_acquire,
+						    std::memory_order_relaxed);
+}
+
+
+/**
+ * Lock an adaptive mutex
+ */
+static inline void
+nccl_net_ofi_mutex_lock_impl(nccl_net_ofi_adaptive_mutex_t *mutex, const char *file, size_t line)
+{
+	if (!mutex->adaptive) {
+		nccl_net_ofi_mutex_lock_impl(&mutex->mutex, file, line);
+		return;
+	}
+
+#if NCCL_OFI_MUTEX_PROFILING
+	if (OFI_LIKELY(nccl_net_ofi_adaptive_mutex_try(mutex))) {
+		nccl_net_ofi_mutex_prof_acquired(mutex, file, line, false, 0);
+		return;
+	}
+	uint64_t start = nccl_net_ofi_mutex_prof_now();
+	nccl_net_ofi_adaptive_mutex_lock_slow(mutex);
+	nccl_net_ofi_mutex_prof_acquired(mutex, file, line, true,
+					 nccl_net_ofi_mutex_prof_now() - start);
+#else
+	if (OFI_UNLIKELY(!nccl_net_ofi_adaptive_mutex_try(mutex))) {
+		nccl_net_ofi_adaptive_mutex_lock_slow(mutex);
+	}
+#endif
+}
+
+
+/**
+ * Attempt to lock an adaptive mutex without blocking
+ *
+ * Returns 0 if the lock is acquired and EBUSY otherwise.
+ */
+static inline int
+nccl_net_ofi_mutex_trylock_impl(nccl_net_ofi_adaptive_mutex_t *mutex, const char *file, size_t line)
+{
+	if (!mutex->adaptive) {
+		return nccl_net_ofi_mutex_trylock_impl(&mutex->mutex, file, line);
+	}
+
+	if (!nccl_net_ofi_adaptive_mutex_try(mutex)) {
+		return EBUSY;
+	}
+#if NCCL_OFI_MUTEX_PROFILING
+	nccl_net_ofi_mutex_prof_acquired(mutex, file, line, false, 0);
+#endif
+	return 0;
+}
+
+
+/**
+ * Unlock an adaptive mutex
+ *
+ * Aborts the current process if the mutex was not locked.
+ */
+static inline void
+nccl_net_ofi_mutex_unlock_impl(nccl_net_ofi_adaptive_mutex_t *mutex, const char *file, size_t line)
+{
+	if (!mutex->adaptive) {
+		nccl_net_ofi_mutex_unlock_impl(&mutex->mutex, file, line);
+		return;
+	}
+
+#if NCCL_OFI_MUTEX_PROFILING
+	nccl_net_ofi_mutex_prof_released(mutex);
+#endif
+	uint32_t prev_state = mutex->state.exchange(0, std::memory_order_release);
+	if (OFI_UNLIKELY(prev_state != 1)) {
+		nccl_net_ofi_adaptive_mutex_unlock_slow(mutex, prev_state, file, line);
+	}
+}
+
 #endif // End NCCL_OFI_PTHREAD_H
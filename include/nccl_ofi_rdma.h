@@ -6,14 +6,18 @@
 #define NCCL_OFI_RDMA_H_
 #include "config.h"
 
+#include <atomic>
+
 #include <rdma/fabric.h>
 
 #include "nccl_ofi.h"
 #include "nccl_ofi_deque.h"
 #include "nccl_ofi_ep_addr_list.h"
 #include "nccl_ofi_freelist.h"
+#include "nccl_ofi_freelist_typed.h"
 #include "nccl_ofi_idpool.h"
 #include "nccl_ofi_log.h"
+#include "nccl_ofi_math.h"
 #include "nccl_ofi_msgbuff.h"
 #include "nccl_ofi_scheduler.h"
 #include "nccl_ofi_topo.h"
@@ -50,6 +54,49 @@
  */
 #define NCCL_OFI_RDMA_SEQ_BITS     (10)
 
+/*
+ * @brief	Number of slots of the pre-advertised receive ring
+ *
+ * Message with sequence number `msg_seq_num' is mapped to ring slot
+ * `msg_seq_num % NCCL_OFI_RDMA_RECV_RING_DEPTH'. Matches NCCL_STEPS,
+ * the number of buffer slots NCCL cycles through per channel.
+ */
+#define NCCL_OFI_RDMA_RECV_RING_DEPTH (8)
+static_assert(((1 << NCCL_OFI_RDMA_SEQ_BITS) % NCCL_OFI_RDMA_RECV_RING_DEPTH) == 0,
+	      "Receive ring depth must divide the message sequence number space");
+
+/*
+ * @brief	Upper bound of CQ_READ_COUNT
+ *
+ * Completion entries are read into a buffer of this size on the stack.
+ */
+#define NCCL_OFI_RDMA_MAX_CQ_READ_COUNT (64)
+
+/*
+ * RMA key handles (NCCL_OFI_RDMA_RMA_KEY_TABLE mode)
+ *
+ * A key handle returned by get_mr_key() carries the provider key of
+ * rail 0 in its low 32 bits, the slot of the registration in the key
+ * table of the device in the bits from
+ * NCCL_OFI_RDMA_RMA_KEY_SLOT_SHIFT, a generation count of the slot in
+ * the bits from NCCL_OFI_RDMA_RMA_KEY_GEN_SHIFT, and
+ * NCCL_OFI_RDMA_RMA_KEY_HANDLE_FLAG. Keys without the flag are only
+ * valid on rail 0.
+ */
+#define NCCL_OFI_RDMA_RMA_KEY_HANDLE_FLAG (1ULL << 63)
+#define NCCL_OFI_RDMA_RMA_KEY_SLOT_SHIFT (32)
+#define NCCL_OFI_RDMA_RMA_KEY_SLOT_BITS (16)
+#define NCCL_OFI_RDMA_RMA_KEY_GEN_SHIFT (48)
+#define NCCL_OFI_RDMA_RMA_KEY_GEN_BITS (15)
+
+/* Number of entries of the RMA key table of a device */
+#define NCCL_OFI_RDMA_RMA_KEY_TABLE_SIZE (1 << 14)
+static_assert(NCCL_OFI_RDMA_RMA_KEY_TABLE_SIZE <= (1 << NCCL_OFI_RDMA_RMA_KEY_SLOT_BITS),
+	      "RMA key table slots must fit into a key handle");
+
+/* Number of remote RMA key table entries cached by a communicator */
+#define NCCL_OFI_RDMA_RMA_KEY_CACHE_SIZE (128)
+
 typedef enum nccl_net_ofi_rdma_req_state {
 	NCCL_OFI_RDMA_REQ_CREATED = 0,
 	NCCL_OFI_RDMA_REQ_PENDING,
@@ -71,6 +118,8 @@ typedef enum nccl_net_ofi_rdma_req_type {
 	NCCL_OFI_RDMA_SEND_CTRL,
 	/* Send close request. */
 	NCCL_OFI_RDMA_SEND_CLOSE,
+	/* Send receive ring credit request. */
+	NCCL_OFI_RDMA_SEND_CREDIT,
 	/* Receive segments request. Subrequest of NCCL_OFI_RDMA_RECV */
 	NCCL_OFI_RDMA_RECV_SEGMS,
 	/* Eager local copy request. Subrequest of NCCL_OFI_RDMA_RECV */
@@ -100,6 +149,8 @@ enum nccl_ofi_rdma_msg_type {
 	NCCL_OFI_RDMA_MSG_EAGER,
 	NCCL_OFI_RDMA_MSG_CLOSE,
 	NCCL_OFI_RDMA_MSG_CTRL_NO_COMPLETION,
+	NCCL_OFI_RDMA_MSG_CTRL_RING_ADV,
+	NCCL_OFI_RDMA_MSG_CREDIT,
 	NCCL_OFI_RDMA_MSG_INVALID = 15,
 	NCCL_OFI_RDMA_MSG_MAX = NCCL_OFI_RDMA_MSG_INVALID,
 };
@@ -124,10 +175,57 @@ typedef struct nccl_net_ofi_rdma_mr_handle {
 	/* value of mr key id, if keys must be requested */
 	int mr_key;
 
+	/* Type of registered memory (NCCL_PTR_*) */
+	int type;
+
+	/* Key handle assigned by get_mr_key() in
+	 * NCCL_OFI_RDMA_RMA_KEY_TABLE mode, 0 if none */
+	uint64_t rma_key;
+
 	/* Array of size `num_rails' */
 	struct fid_mr **mr;
 } nccl_net_ofi_rdma_mr_handle_t;
 
+/*
+ * @brief	Entry of the RMA key table of a device
+ *
+ * Initiators fetch entries of their peer's table with fi_read, so the
+ * layout is fixed.
+ */
+typedef struct nccl_net_ofi_rdma_rma_key_entry {
+	/* Key handle of the registration, 0 if the slot is unused */
+	uint64_t handle;
+	/* Provider key of each rail */
+	uint32_t keys[MAX_NUM_RAILS];
+} nccl_net_ofi_rdma_rma_key_entry_t;
+static_assert(sizeof(nccl_net_ofi_rdma_rma_key_entry_t) == 8 + 4 * MAX_NUM_RAILS,
+	      "Wrong size for RMA key table entry");
+
+typedef enum nccl_net_ofi_rdma_rma_key_cache_state {
+	NCCL_OFI_RDMA_RMA_KEY_CACHE_EMPTY = 0,
+	/* A request is fetching the entry */
+	NCCL_OFI_RDMA_RMA_KEY_CACHE_FETCHING,
+	NCCL_OFI_RDMA_RMA_KEY_CACHE_VALID,
+} nccl_net_ofi_rdma_rma_key_cache_state_t;
+
+/*
+ * @brief	Entries of the peer's RMA key table known to a communicator
+ *
+ * Direct-mapped by table slot. The first RMA request that misses a
+ * key handle fetches its entry, and the entry becomes valid once that
+ * request completed. Until then, requests using the handle stay on
+ * rail 0.
+ */
+typedef struct nccl_net_ofi_rdma_rma_key_cache {
+	/* Key table of the peer, from its connect (response) message */
+	uint64_t remote_table_addr;
+	uint64_t remote_table_key;
+	/* Registered page holding the fetched entries */
+	nccl_net_ofi_rdma_rma_key_entry_t *entries;
+	nccl_net_ofi_rdma_mr_handle_t *mr_handle;
+	uint8_t state[NCCL_OFI_RDMA_RMA_KEY_CACHE_SIZE];
+} nccl_net_ofi_rdma_rma_key_cache_t;
+
 
 /* Contents of ctrl message sent from receiver to sender to advertise
    destination buffer */
@@ -167,6 +265,52 @@ static inline size_t nccl_net_ofi_rdma_ctrl_msg_size(size_t num_rails, bool use_
 	return offsetof(nccl_net_ofi_rdma_ctrl_msg_t, short_buff_mr_key) + num_rails * rkey_len;
 }
 
+/* Number of entries in the per-communicator control message descriptor
+ * cache. NCCL uses NCCL_STEPS (8) buffer slots per channel. */
+#define NCCL_OFI_RDMA_CTRL_DESC_CACHE_SIZE (16)
+static_assert(NCCL_OFI_IS_POWER_OF_TWO(NCCL_OFI_RDMA_CTRL_DESC_CACHE_SIZE),
+	      "Control message descriptor cache size must be a power of two");
+
+/*
+ * @brief	Pre-built control message for a receive buffer
+ *
+ * Holds the buffer address, remote comm ID and per-rail rkeys of the
+ * control message advertising a (buffer, memory registration) pair. An
+ * entry is unused if mr_handle is NULL.
+ */
+typedef struct nccl_net_ofi_rdma_ctrl_desc {
+	void *buff;
+	nccl_net_ofi_rdma_mr_handle_t *mr_handle;
+	nccl_net_ofi_rdma_ctrl_msg_t msg;
+} nccl_net_ofi_rdma_ctrl_desc_t;
+
+/*
+ * @brief	Receive ring credit message
+ *
+ * Sent from receiver to sender to announce that receives for
+ * `num_msgs' consecutive messages starting at `msg_seq_num' have been
+ * posted into the buffers previously advertised for their ring slots
+ * (see NCCL_OFI_RDMA_MSG_CTRL_RING_ADV). The sender writes these
+ * messages without waiting for individual control messages.
+ */
+typedef struct nccl_net_ofi_rdma_credit_msg {
+	/* Message type, must be NCCL_OFI_RDMA_MSG_CREDIT */
+	uint32_t type:NCCL_OFI_RDMA_CTRL_TYPE_BITS;
+
+	/* Sequence number of first granted message */
+	uint32_t msg_seq_num:NCCL_OFI_RDMA_SEQ_BITS;
+
+	/* A comm identitifer that uniquely identifies the comm
+	 * on the receiver side */
+	uint32_t remote_comm_id:NCCL_OFI_RDMA_COMM_ID_BITS;
+
+	/* Number of granted messages */
+	uint32_t num_msgs;
+} nccl_net_ofi_rdma_credit_msg_t;
+/* Since this is a message on the wire, check that it has the expected size */
+static_assert(sizeof(nccl_net_ofi_rdma_credit_msg_t) == 8,
+	      "Wrong size for RDMA Credit message");
+
 /* Message from receiver to sender indicating sender can close resources */
 typedef struct nccl_net_ofi_rdma_close_msg {
 	/* Message type, must be NCCL_OFI_RDMA_MSG_CLOSE */
@@ -210,25 +354,71 @@ typedef struct {
 	nccl_net_ofi_rdma_ep_t *ep;
 } rdma_req_rx_buff_data_t;
 
+/*
+ * One operation of a one-sided RMA request
+ */
 typedef struct {
 	/* Remote destination buffer address */
 	uint64_t remote_buff;
-	/* Remote MR key */
-	uint64_t remote_mr_key;
-	/* Number of rails where we have successfully posted the network xfer.
-	 * Used mostly when the network xfer is sliced across multiple rails */
-	uint64_t xferred_rail_id;
+	/* Remote MR key of each rail, derived from the key returned by
+	 * get_mr_key(), see rma_key_mode */
+	uint64_t remote_mr_key[MAX_NUM_RAILS];
 	/* Application-provided local src/dst buffer */
 	void *buff;
 	/* Length of application-provided buffer */
 	size_t buff_len;
-	/* First rail descriptor from memory registration of `buff' */
-	void *desc;
+	/* Memory region descriptors associated to `buff', NULL for
+	 * inline writes */
+	nccl_net_ofi_rdma_mr_handle_t *buff_mr_handle;
+	/* Schedule striping the operation across rails */
+	nccl_net_ofi_schedule_t *schedule;
+} nccl_net_ofi_rdma_rma_op_t;
+
+/*
+ * Operations of a batched one-sided RMA request. Allocated from the
+ * endpoint since they do not fit into every request.
+ */
+typedef struct {
+	nccl_net_ofi_rdma_rma_op_t ops[NCCL_OFI_MAX_RMA_BATCH];
+} nccl_net_ofi_rdma_rma_batch_t;
+
+typedef nccl_ofi_freelist_typed_t<nccl_net_ofi_rdma_rma_batch_t> nccl_net_ofi_rdma_rma_batch_fl_t;
+
+typedef struct {
+	/* Operation of a single iwrite/iread */
+	nccl_net_ofi_rdma_rma_op_t op;
+	/* Operations of a batched request, NULL otherwise */
+	nccl_net_ofi_rdma_rma_batch_t *batch;
+	/* `op' or the operations of `batch' */
+	nccl_net_ofi_rdma_rma_op_t *ops;
+	/* Number of operations */
+	size_t num_ops;
+	/* Operation that is posted next */
+	size_t op_idx;
+	/* Number of stripes of the current operation that were
+	 * successfully posted */
+	uint64_t xferred_rail_id;
+	/* Number of stripes still to be posted on each rail. Stripes
+	 * are posted with FI_MORE while later ones follow on the same
+	 * rail. */
+	uint16_t rail_posts_left[MAX_NUM_RAILS];
 	/* Additional flags */
 	uint64_t flags;
-	/* Total number of completions. Expect one completion for receiving the
-	 * control message and one completion for each send segment. */
+	/* Entry of the RMA key cache this request fetches, -1 if none.
+	 * The fetch is posted before the stripes and completes like
+	 * one of them. */
+	int key_fetch_idx;
+	/* Key handle fetched into `key_fetch_idx' */
+	uint64_t key_fetch_handle;
+	bool key_fetch_posted;
+	/* Total number of completions. Expect one completion for each
+	 * stripe of each operation, and one for the key fetch. */
 	int total_num_compls;
+	/* Number of operations posted so far, and number of them that
+	 * completed with error. A failed request is freed only once
+	 * all posted operations completed. */
+	int num_posted_compls;
+	int num_err_compls;
 } rdma_req_rma_op_data_t;
 
 typedef struct {
@@ -263,6 +453,18 @@ typedef struct {
 	 * True to use fi_write instead of fi_writedata in send() 
 	 */
 	bool no_target_completion;
+	/* Value the write counter of each rail must have drained to
+	 * before the writes of this request are complete. Only used
+	 * if the endpoint tracks writes with counters. */
+	uint64_t write_cntr_threshold[MAX_NUM_RAILS];
+	/* Bitmask of the stripes of the schedule that failed with a
+	 * transient error and are to be posted again */
+	uint32_t retry_xfers;
+	/* Number of times stripes of this request were posted again */
+	uint32_t num_retries;
+	/* Monotonic time in nanoseconds before which failed stripes
+	 * are not posted again */
+	uint64_t retry_time;
 #if HAVE_NVTX_TRACING
 	nvtxRangeId_t trace_id;
 	nvtxRangeId_t seg_trace_id[MAX_NUM_RAILS];
@@ -298,6 +500,28 @@ typedef struct {
 	nccl_net_ofi_schedule_t *ctrl_schedule;
 } rdma_req_send_close_data_t;
 
+/*
+ * @brief	Data of request responsible for sending a receive ring credit message
+ */
+typedef struct {
+	/* Pointer to the allocated control buffer from freelist */
+	nccl_ofi_freelist_elem_t *ctrl_fl_elem;
+	/* Number of messages granted by the credit message */
+	uint16_t num_msgs;
+} rdma_req_send_credit_data_t;
+
+/*
+ * @brief	How a receive buffer was announced to the sender
+ */
+typedef enum nccl_net_ofi_rdma_recv_ring_mode {
+	/* Regular control message; ring slot is not touched */
+	NCCL_OFI_RDMA_RECV_RING_NONE = 0,
+	/* Control message that also (re-)advertises the ring slot */
+	NCCL_OFI_RDMA_RECV_RING_ADV,
+	/* Buffer matches the advertised ring slot; only a credit is sent */
+	NCCL_OFI_RDMA_RECV_RING_CREDIT,
+} nccl_net_ofi_rdma_recv_ring_mode_t;
+
 typedef struct {
 	/* Pointer to rx buffer containing eager data */
 	nccl_net_ofi_rdma_req_t *eager_rx_buff_req;
@@ -334,8 +558,13 @@ typedef struct {
 	 * segments have arrived.
 	 *
 	 * For eager messages, the second completion will be received
-	 * when the local read into the destination buffer is complete */
+	 * when the local read into the destination buffer is complete.
+	 *
+	 * For receives announced by a credit message, the credit
+	 * message completion replaces the send ctrl completion */
 	int total_num_compls;
+	/* How the destination buffer was announced to the sender */
+	nccl_net_ofi_rdma_recv_ring_mode_t ring_mode;
 #if HAVE_NVTX_TRACING
 	nvtxRangeId_t trace_id;
 #endif
@@ -375,7 +604,7 @@ typedef struct nccl_net_ofi_rdma_req {
 	 * Associated deque element object, used when request is in pending request
 	 * queue
 	 */
-	nccl_ofi_deque_elem_t pending_reqs_elem;
+	nccl_ofi_mpsc_queue_elem_t pending_reqs_elem;
 
 	/* Number of arrived request completions */
 	int ncompls;
@@ -386,6 +615,7 @@ typedef struct nccl_net_ofi_rdma_req {
 		rdma_req_recv_data_t recv_data;
 		rdma_req_send_ctrl_data_t send_ctrl_data;
 		rdma_req_send_close_data_t send_close_data;
+		rdma_req_send_credit_data_t send_credit_data;
 		rdma_req_eager_copy_data_t eager_copy_data;
 		rdma_req_recv_segms_data_t recv_segms_data;
 		rdma_req_flush_data_t flush_data;
@@ -407,9 +637,6 @@ typedef struct nccl_net_ofi_rdma_req {
 	/* Type of request */
 	nccl_net_ofi_rdma_req_type_t type;
 
-	/* Backpointer to freelist element */
-	nccl_ofi_freelist_elem_t *elem;
-
 	/* Deinitialzie and free request. This function returns error
 	 * in cases where cleanup fails. This function may also return
 	 * error if the owner of the request has to deallocate the
@@ -419,6 +646,9 @@ typedef struct nccl_net_ofi_rdma_req {
 
 } nccl_net_ofi_rdma_req_t;
 
+/* Freelist of RDMA requests */
+typedef nccl_ofi_freelist_typed_t<nccl_net_ofi_rdma_req_t> nccl_net_ofi_rdma_req_fl_t;
+
 /*
  * Rdma endpoint name
  *
@@ -440,7 +670,11 @@ typedef struct nccl_ofi_rdma_connection_info {
 	 * either NCCL_OFI_RDMA_MSG_CONN or NCCL_OFI_RDMA_MSG_CONN_RESP
 	 */
 	uint16_t type:NCCL_OFI_RDMA_CTRL_TYPE_BITS;
-	uint16_t pad:(16 - NCCL_OFI_RDMA_CTRL_TYPE_BITS);
+
+	/* Connect message only: sender accepts receive ring
+	 * advertisements and credit messages */
+	uint16_t recv_ring:1;
+	uint16_t pad:(16 - NCCL_OFI_RDMA_CTRL_TYPE_BITS - 1);
 
 	/* Number of rails */
 	uint16_t num_rails;
@@ -454,6 +688,11 @@ typedef struct nccl_ofi_rdma_connection_info {
 	 * on the receiver side */
 	uint32_t remote_comm_id;
 
+	/* RMA key table of the device of the sending side in
+	 * NCCL_OFI_RDMA_RMA_KEY_TABLE mode, zero otherwise */
+	uint64_t rma_key_table_addr;
+	uint64_t rma_key_table_key;
+
 	/* Arrays of `MAX_NUM_RAILS` `nccl_ofi_rdma_ep_name_t`
 	 * structs. The member `num_rails` and `num_control_rails` indicate
 	 * the number of entries that are in use. */
@@ -461,7 +700,7 @@ typedef struct nccl_ofi_rdma_connection_info {
 	nccl_ofi_rdma_ep_name_t ep_names[MAX_NUM_RAILS];
 } nccl_ofi_rdma_connection_info_t;
 /* Since this is a message on the wire, check that it has the expected size */
-static_assert(sizeof(nccl_ofi_rdma_connection_info_t) == 528,
+static_assert(sizeof(nccl_ofi_rdma_connection_info_t) == 544,
 			  "Wrong size for RDMA connect message");
 
 /*
@@ -494,7 +733,7 @@ typedef struct nccl_net_ofi_rdma_send_comm {
 	uint64_t num_inflight_reqs;
 	uint64_t num_inflight_writes;
 
-	nccl_ofi_freelist_t *nccl_ofi_reqs_fl;
+	nccl_net_ofi_rdma_req_fl_t *nccl_ofi_reqs_fl;
 
 	/* Comm ID provided by the local endpoint */
 	uint32_t local_comm_id;
@@ -509,6 +748,17 @@ typedef struct nccl_net_ofi_rdma_send_comm {
 	/* free list item containing a nccl_ofi_rdma_connection_info_t */
 	nccl_ofi_freelist_elem_t *conn_msg;
 
+	/* Request sending the connect message. Connect may return before
+	 * its send completed, in which case it is released later. */
+	nccl_net_ofi_rdma_req_t *conn_req;
+
+	/* True once the connect response arrived, all rails are
+	 * initialized and the sends issued before were posted. Those
+	 * sends wait in the message buffer. Only set under conn_lock,
+	 * see send_comm_is_connected(). */
+	std::atomic<bool> connected;
+	pthread_mutex_t conn_lock;
+
 	uint16_t next_msg_seq_num;
 
 	nccl_ofi_msgbuff_t *msgbuff;
@@ -539,12 +789,25 @@ typedef struct nccl_net_ofi_rdma_send_comm {
 	uint64_t n_ctrl_received;
 	uint64_t n_ctrl_expected;
 
+	/* Control messages advertising the receiver's ring slots. A
+	 * slot is only overwritten by the receiver after all messages
+	 * using the previous advertisement have been written. */
+	nccl_net_ofi_rdma_ctrl_msg_t recv_ring[NCCL_OFI_RDMA_RECV_RING_DEPTH];
+
 	bool comm_active;
 
 	/* Array of `num_rails` communicator rails */
 	nccl_net_ofi_rdma_send_comm_rail_t *rails;
 	/* Array of `num_control_rails` communicator rails */
 	nccl_net_ofi_rdma_send_comm_rail_t *control_rails;
+	/* Array of `num_rails` communicator rails of the low-latency
+	 * data endpoints, NULL if disabled. They address the same
+	 * remote endpoints as `rails'. */
+	nccl_net_ofi_rdma_send_comm_rail_t *ll_rails;
+
+	/* Remote key table entries for iwrite, NULL unless in
+	 * NCCL_OFI_RDMA_RMA_KEY_TABLE mode */
+	nccl_net_ofi_rdma_rma_key_cache_t *rma_key_cache;
 
 } nccl_net_ofi_rdma_send_comm_t;
 
@@ -574,6 +837,23 @@ typedef struct nccl_net_ofi_rdma_flush_buffer {
 	nccl_net_ofi_rdma_mr_handle_t *mr_handle;
 } nccl_net_ofi_rdma_flush_buffer_t;
 
+/*
+ * @brief	Receiver state of a pre-advertised receive ring slot
+ */
+typedef struct nccl_net_ofi_rdma_recv_ring_slot {
+	/* Advertised buffer, length and memory registration. The slot
+	 * is unused if mr_handle is NULL */
+	void *buff;
+	size_t buff_len;
+	nccl_net_ofi_rdma_mr_handle_t *mr_handle;
+	/* True once the receive that advertised the slot has
+	 * completed, i.e., the sender knows the advertised buffer */
+	bool adv_completed;
+	/* Number of posted receives mapped to this slot that have not
+	 * been freed yet */
+	int num_inflight;
+} nccl_net_ofi_rdma_recv_ring_slot_t;
+
 /*
  * @brief	RDMA receive communicator
  *
@@ -587,7 +867,7 @@ typedef struct nccl_net_ofi_rdma_recv_comm {
 	nccl_net_ofi_recv_comm_t base;
 
 	uint64_t num_inflight_reqs;
-	nccl_ofi_freelist_t *nccl_ofi_reqs_fl;
+	nccl_net_ofi_rdma_req_fl_t *nccl_ofi_reqs_fl;
 
 	/* Comm ID provided by the local endpoint */
 	uint32_t local_comm_id;
@@ -602,6 +882,10 @@ typedef struct nccl_net_ofi_rdma_recv_comm {
 	/* Free list to track control buffers, for sending RDMA control messages */
 	nccl_ofi_freelist_t *ctrl_buff_fl;
 
+	/* Direct-mapped cache of control messages keyed by receive
+	 * buffer and memory registration */
+	nccl_net_ofi_rdma_ctrl_desc_t ctrl_desc_cache[NCCL_OFI_RDMA_CTRL_DESC_CACHE_SIZE];
+
 #if HAVE_NVTX_TRACING
 	nvtxDomainHandle_t nvtx_domain[NCCL_OFI_N_NVTX_DOMAIN_PER_COMM];
 #endif
@@ -614,6 +898,17 @@ typedef struct nccl_net_ofi_rdma_recv_comm {
 	uint64_t n_ctrl_sent;
 	uint64_t n_ctrl_delivered;
 
+	/* Pre-advertised receive ring. Enabled if both sides set
+	 * OFI_NCCL_RDMA_RECV_RING */
+	bool recv_ring_enabled;
+	nccl_net_ofi_rdma_recv_ring_slot_t recv_ring[NCCL_OFI_RDMA_RECV_RING_DEPTH];
+	/* Granted messages waiting for the next credit message and
+	 * number of credit messages in flight. Guarded by
+	 * ctrl_counter_lock. */
+	uint16_t credit_first_msg_seq_num;
+	uint16_t credit_num_pending;
+	int num_credits_inflight;
+
 	/* Number of rails */
 	int num_rails;
 	/* Number of control rails */
@@ -628,6 +923,10 @@ typedef struct nccl_net_ofi_rdma_recv_comm {
 	nccl_net_ofi_rdma_recv_comm_rail_t *rails;
 	/* Array of `num_control_rails` communicator rails */
 	nccl_net_ofi_rdma_recv_comm_rail_t *control_rails;
+
+	/* Remote key table entries for iread, NULL unless in
+	 * NCCL_OFI_RDMA_RMA_KEY_TABLE mode */
+	nccl_net_ofi_rdma_rma_key_cache_t *rma_key_cache;
 } nccl_net_ofi_rdma_recv_comm_t;
 
 typedef struct nccl_net_ofi_rdma_listen_comm {
@@ -681,6 +980,34 @@ struct nccl_net_ofi_ep_rail {
 	/* Completion Queue handle */
 	struct fid_cq *cq;
 
+	/* Number of locally initiated operations posted to the
+	 * endpoint of this rail, or to the control or low-latency
+	 * endpoints sharing its completion queue, whose completion entry has
+	 * not been read yet. Only maintained for data rails and only
+	 * used as a polling hint. */
+	int64_t num_cq_ops_inflight;
+
+	/*
+	 * Write counter of data rails (see RDMA_WRITE_CNTR). NULL if
+	 * writes generate completion queue entries.
+	 */
+	struct fid_cntr *write_cntr;
+	/* Number of writes posted with counter completion */
+	uint64_t write_cntr_posted;
+	/* Largest number of posted writes for which the counter was
+	 * observed to have caught up, i.e., all writes up to it are
+	 * complete */
+	uint64_t write_cntr_drained;
+	/* Value of the error counter when it was last read */
+	uint64_t write_cntr_errors;
+	/* Writes after write_cntr_good up to write_cntr_bad were not
+	 * drained when a write failed and are considered failed.
+	 * write_cntr_failed is true until the counter drained past
+	 * write_cntr_bad; later writes are not affected. */
+	bool write_cntr_failed;
+	uint64_t write_cntr_good;
+	uint64_t write_cntr_bad;
+
 	/*
 	 * Rx buffer management
 	 */
@@ -699,6 +1026,41 @@ struct nccl_net_ofi_ep_rail {
 						      nccl_net_ofi_ep_rail_t *rail);
 };
 
+/*
+ * @brief	Rail count and rkey width specialized fast path
+ *
+ * The per-rail loops of the control message and flush paths, and the
+ * stripe loops of sends and one-sided RMA requests, are instantiated
+ * for the common rail counts (1, 2 and 4) and for short and long
+ * rkeys. The endpoint selects its instance once at creation
+ * time, falling back to a generic instance that reads the rail count
+ * at runtime.
+ */
+typedef struct nccl_net_ofi_rdma_fast_path {
+	/* Fill rkeys of `mr_handle' into control message `msg'. Returns
+	 * -ENOENT if the buffer is not registered on all rails and
+	 * -ENOTSUP if an rkey does not fit into the control message. */
+	int (*fill_ctrl_rkeys)(nccl_net_ofi_rdma_ep_t *ep,
+			       nccl_net_ofi_rdma_ctrl_msg_t *msg,
+			       nccl_net_ofi_rdma_mr_handle_t *mr_handle);
+
+	/* Copy rkeys of received control message into send request data */
+	void (*copy_remote_rkeys)(nccl_net_ofi_rdma_ep_t *ep,
+				  rdma_req_send_data_t *send_data,
+				  const nccl_net_ofi_rdma_ctrl_msg_t *msg);
+
+	/* Post local RDMA reads of a flush request on all rails */
+	int (*post_flush)(nccl_net_ofi_rdma_req_t *req);
+
+	/* Post the stripes of a send request that were not posted yet */
+	int (*post_send_stripes)(nccl_net_ofi_rdma_req_t *req);
+
+	/* Post the stripes of an RMA write or read request that were
+	 * not posted yet */
+	int (*post_rma_write)(nccl_net_ofi_rdma_req_t *req);
+	int (*post_rma_read)(nccl_net_ofi_rdma_req_t *req);
+} nccl_net_ofi_rdma_fast_path_t;
+
 /*
  * @brief	RDMA Endpoint
  *
@@ -730,19 +1092,73 @@ struct nccl_net_ofi_rdma_ep {
 	/* Array of `num_control_rails` endpoint rails */
 	nccl_net_ofi_ep_rail_t *control_rails;
 
+	/* Array of `num_rails` transmit-only endpoint rails with the
+	 * low-latency traffic class, sharing the completion queue of
+	 * the data rail with the same index. NULL if disabled (see
+	 * LOW_LATENCY_DATA_MAX_SIZE). */
+	nccl_net_ofi_ep_rail_t *ll_rails;
+	/* Largest message posted to `ll_rails' */
+	size_t ll_data_max_size;
+
 	bool use_long_rkeys;
 
+	/* Fast path specialized for `num_rails' and `use_long_rkeys' */
+	const nccl_net_ofi_rdma_fast_path_t *fast_path;
+
+	/* Length of a control message on the wire */
+	size_t ctrl_msg_size;
+
+	/* True if RDMA writes of send() are tracked with per-rail
+	 * counters instead of completion queue entries */
+	bool use_write_cntr;
+	/* Number of undrained writes per rail after which new writes
+	 * are held back until the write counter caught up (see
+	 * RDMA_WRITE_CNTR_FENCE_INTERVAL) */
+	uint64_t write_cntr_fence_interval;
+
+	/* Number of times the stripes of a send request that failed
+	 * are posted again before the request fails (see
+	 * STRIPE_RETRY_MAX). 0 if writes are tracked with counters,
+	 * which do not tell which write failed. */
+	unsigned int stripe_retry_max;
+	/* Delay before a failed stripe is posted again, doubled with
+	 * each further attempt of the request */
+	uint64_t stripe_retry_backoff_ns;
+#ifndef NDEBUG
+	/* Fail every N-th write stripe of send requests (see
+	 * INJECT_STRIPE_ERRORS), 0 to disable */
+	uint64_t inject_stripe_errors;
+	/* Number of write stripes of send requests eligible for error
+	 * injection */
+	uint64_t num_send_stripes;
+#endif
+
+	/* Idle rails are only polled every `idle_cq_poll_interval'
+	 * calls of ofi_process_cq(). 0 to poll all rails on every call
+	 * (see RDMA_IDLE_CQ_POLL_INTERVAL). */
+	unsigned int idle_cq_poll_interval;
+	/* Number of calls of ofi_process_cq() */
+	uint64_t num_cq_polls;
+	/* Number of in-flight receive requests, i.e., requests that
+	 * expect incoming data on any data rail */
+	uint64_t num_recvs_inflight;
+	/* Number of in-flight send requests, i.e., requests that
+	 * expect incoming control messages on the control rails */
+	uint64_t num_sends_inflight;
+
 	/* Pending requests queue */
-	nccl_ofi_deque_t *pending_reqs_queue;
+	nccl_ofi_mpsc_queue_t *pending_reqs_queue;
 
 	/* Free list of ctrl rx buffers */
 	nccl_ofi_freelist_t *ctrl_rx_buff_fl;
 	/* Free list of eager rx buffers */
 	nccl_ofi_freelist_t *eager_rx_buff_fl;
 	/* Free list of rx buffer requests */
-	nccl_ofi_freelist_t *rx_buff_reqs_fl;
+	nccl_net_ofi_rdma_req_fl_t *rx_buff_reqs_fl;
 	/* Free list for connection messages */
 	nccl_ofi_freelist_t *conn_msg_fl;
+	/* Free list of operations of batched RMA requests */
+	nccl_net_ofi_rdma_rma_batch_fl_t *rma_batch_fl;
 	/* Size of ctrl rx buffers */
 	size_t ctrl_rx_buff_size;
 	/* Size of eager rx buffers.  Will be -1 if eager is entirely
@@ -759,6 +1175,20 @@ struct nccl_net_ofi_rdma_ep {
 	 */
 	ssize_t eager_send_size;
 
+	/* Largest eager message sent from host memory with
+	 * fi_injectdata, which completes at post time. 0 if disabled
+	 * (see EAGER_INJECT). */
+	size_t eager_inject_size;
+
+	/* Maximum number of completion entries read per fi_cq_read()
+	 * call (see CQ_READ_COUNT), at most
+	 * NCCL_OFI_RDMA_MAX_CQ_READ_COUNT */
+	size_t cq_read_count;
+
+	/* Parameter epoch that eager_send_size, cq_read_count and the
+	 * rx buffer bounds of the rails were derived at */
+	uint64_t param_epoch;
+
 	/* true if the current endpoint is a endpoint_per_communicator
 	   receive communicator */
 	bool is_endpoint_per_communicator_ep;
@@ -782,6 +1212,26 @@ typedef struct nccl_net_ofi_rdma_device_rail {
 	struct fid_fabric *fabric;
 } nccl_net_ofi_rdma_device_rail_t;
 
+/*
+ * @brief	How the remote key of one-sided RMA operations covers the rails
+ *
+ * iwrite/iread take a single 64-bit remote key obtained from
+ * get_mr_key(). Operations are striped across rails if that key is
+ * valid on every rail.
+ */
+typedef enum nccl_net_ofi_rdma_rma_key_mode {
+	/* Registrations use the same plugin-assigned key on every rail */
+	NCCL_OFI_RDMA_RMA_KEY_SHARED = 0,
+	/* Provider keys of all rails are packed into the 64-bit key */
+	NCCL_OFI_RDMA_RMA_KEY_PACKED,
+	/* The key is a handle into the RMA key table of the device,
+	 * which holds the provider keys of all rails */
+	NCCL_OFI_RDMA_RMA_KEY_TABLE,
+	/* Provider keys are too wide for a key handle; only rail 0 is
+	 * used */
+	NCCL_OFI_RDMA_RMA_KEY_SINGLE_RAIL,
+} nccl_net_ofi_rdma_rma_key_mode_t;
+
 /*
  * @brief	RDMA Device
  *
@@ -815,6 +1265,10 @@ typedef struct nccl_net_ofi_rdma_device {
 	/* Number of rails */
 	int num_rails;
 
+	/* Number of NICs backing the rails, which scales the reported
+	 * speed */
+	int num_nics;
+
 	/* Array of 'num_rails' device rails */
 	nccl_net_ofi_rdma_device_rail_t *device_rails;
 
@@ -830,6 +1284,22 @@ typedef struct nccl_net_ofi_rdma_device {
 
 	bool use_long_rkeys;
 
+	/* How the key returned by get_mr_key() covers the rails */
+	nccl_net_ofi_rdma_rma_key_mode_t rma_key_mode;
+
+	/* Width in bits of each rail key in NCCL_OFI_RDMA_RMA_KEY_PACKED mode */
+	unsigned int rma_key_bits;
+
+	/* Key table of NCCL_OFI_RDMA_RMA_KEY_TABLE mode, registered in
+	 * every domain of the device, NULL in other modes */
+	nccl_net_ofi_rdma_rma_key_entry_t *rma_key_table;
+	/* Free slots of `rma_key_table' */
+	nccl_ofi_idpool_t rma_key_pool;
+	/* Generation count of each slot of `rma_key_table' */
+	uint16_t *rma_key_gen;
+	/* Serializes key handle assignment in get_mr_key() */
+	pthread_mutex_t rma_key_lock;
+
 #if HAVE_NVTX_TRACING
 	nvtxDomainHandle_t nvtx_domain[MAX_NUM_RAILS];
 #endif
@@ -853,6 +1323,10 @@ typedef struct nccl_net_ofi_rdma_domain {
 	/* The flush buffer */
 	nccl_net_ofi_rdma_flush_buffer_t flush_buff;
 
+	/* Registration of the RMA key table of the device, NULL unless
+	 * in NCCL_OFI_RDMA_RMA_KEY_TABLE mode */
+	nccl_net_ofi_rdma_mr_handle_t *rma_key_table_mr;
+
 	/* List of endpoints and set of addresses they have connections to */
 	nccl_ofi_ep_addr_list_t *ep_addr_list;
 } nccl_net_ofi_rdma_domain_t;
@@ -866,6 +1340,19 @@ struct nccl_net_ofi_rdma_plugin {
 typedef struct nccl_net_ofi_rdma_plugin nccl_net_ofi_rdma_plugin_t;
 
 
+/*
+ * @brief	Data path of RDMA communicators and requests
+ *
+ * Same as their send(), recv() and test() function pointers, for
+ * callers that know the protocol.
+ */
+int nccl_net_ofi_rdma_send(nccl_net_ofi_send_comm_t *send_comm, void *data, int size, int tag,
+			   nccl_net_ofi_mr_handle_t *mhandle, nccl_net_ofi_req_t **base_req);
+int nccl_net_ofi_rdma_recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
+			   int *sizes, int *tags, nccl_net_ofi_mr_handle_t **mhandles,
+			   nccl_net_ofi_req_t **base_req);
+int nccl_net_ofi_rdma_req_test(nccl_net_ofi_req_t *base_req, int *done, int *size);
+
 /*
  * @brief	Initialize plugin with rdma protocol structures
  */
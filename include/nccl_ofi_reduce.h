@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#ifndef NCCL_OFI_REDUCE_H_
+#define NCCL_OFI_REDUCE_H_
+
+#include <stddef.h>
+
+/*
+ * @brief	Element types of host-side reductions
+ *
+ * Values match ncclDataType_t.
+ */
+typedef enum nccl_ofi_reduce_dtype {
+	NCCL_OFI_REDUCE_INT8 = 0,
+	NCCL_OFI_REDUCE_UINT8,
+	NCCL_OFI_REDUCE_INT32,
+	NCCL_OFI_REDUCE_UINT32,
+	NCCL_OFI_REDUCE_INT64,
+	NCCL_OFI_REDUCE_UINT64,
+	NCCL_OFI_REDUCE_FLOAT16,
+	NCCL_OFI_REDUCE_FLOAT32,
+	NCCL_OFI_REDUCE_FLOAT64,
+	NCCL_OFI_REDUCE_BFLOAT16,
+	NCCL_OFI_REDUCE_NUM_DTYPES,
+} nccl_ofi_reduce_dtype_t;
+
+/*
+ * @brief	Reduction operators
+ *
+ * Values match ncclRedOp_t.
+ */
+typedef enum nccl_ofi_reduce_op {
+	NCCL_OFI_REDUCE_SUM = 0,
+	NCCL_OFI_REDUCE_PROD,
+	NCCL_OFI_REDUCE_MAX,
+	NCCL_OFI_REDUCE_MIN,
+	NCCL_OFI_REDUCE_NUM_OPS,
+} nccl_ofi_reduce_op_t;
+
+/*
+ * @brief	Size of an element of type `dtype' in bytes, 0 for
+ *		unknown types
+ */
+size_t nccl_ofi_reduce_dtype_size(nccl_ofi_reduce_dtype_t dtype);
+
+/*
+ * @brief	Accumulate `src' into `dst' element-wise
+ *
+ * Computes dst[i] = dst[i] op src[i] for `count' elements. Kernels
+ * are vectorized for the widest SIMD extension of the CPU (AVX-512,
+ * AVX2 or the baseline, e.g. NEON on aarch64). Float16 and bfloat16
+ * elements are reduced in single precision and rounded to nearest
+ * even. Integer sums and products wrap around.
+ *
+ * `dst' and `src' must not overlap.
+ *
+ * @return	0, on success
+ *		-EINVAL, for unknown types or operators
+ */
+int nccl_ofi_reduce(void *dst, const void *src, size_t count,
+		    nccl_ofi_reduce_dtype_t dtype, nccl_ofi_reduce_op_t op);
+
+#endif // End NCCL_OFI_REDUCE_H_
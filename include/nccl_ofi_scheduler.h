@@ -91,9 +91,10 @@ typedef struct nccl_net_ofi_threshold_scheduler {
 	/* Round robin counter */
 	unsigned int rr_counter;
 	/* Lock for round robin counter */
-	pthread_mutex_t rr_lock;
+	nccl_net_ofi_adaptive_mutex_t rr_lock;
 	/* Minimum size of the message in bytes before message is
-	 * multiplexed */
+	 * multiplexed. Accessed atomically, since it may change at
+	 * runtime (see MIN_STRIPE_SIZE). */
 	size_t min_stripe_size;
 } nccl_net_ofi_threshold_scheduler_t;
 
@@ -117,4 +118,12 @@ void nccl_net_ofi_release_schedule(nccl_net_ofi_scheduler_t *scheduler,
  */
 int nccl_net_ofi_threshold_scheduler_init(int num_rails, size_t min_stripe_size, nccl_net_ofi_scheduler_t **scheduler);
 
+/*
+ * brief	Change the minimum stripe size of a threshold scheduler
+ *
+ * Schedules created afterwards use the new size.
+ */
+void nccl_net_ofi_threshold_scheduler_set_min_stripe_size(nccl_net_ofi_scheduler_t *scheduler,
+							  size_t min_stripe_size);
+
 #endif // End NCCL_OFI_SCHEDULER_H_
@@ -41,6 +41,22 @@ typedef struct nccl_net_ofi_sendrecv_listen_comm {
 	nccl_ofi_freelist_elem_t *conn_info;
 } nccl_net_ofi_sendrecv_listen_comm_t;
 
+struct nccl_net_ofi_sendrecv_req;
+
+/*
+ * Shared-memory transport of a communicator whose peer runs on the
+ * same host. Messages are streamed through the channel as a 64-bit
+ * length followed by the payload, in the order requests were posted.
+ */
+typedef struct nccl_net_ofi_sendrecv_shm {
+	nccl_ofi_shm_chan_t chan;
+
+	/* Posted requests not yet completed, oldest first. Only the
+	 * oldest one is being copied. */
+	struct nccl_net_ofi_sendrecv_req *head;
+	struct nccl_net_ofi_sendrecv_req *tail;
+} nccl_net_ofi_sendrecv_shm_t;
+
 typedef struct nccl_net_ofi_sendrecv_send_comm {
 	/* This base send communicator must be the first member of this
 	 * struct. This allows casting between pointers of this struct
@@ -57,6 +73,9 @@ typedef struct nccl_net_ofi_sendrecv_send_comm {
 
 	/* connecting peer information (nccl_ofi_connection_info_t) */
 	nccl_ofi_freelist_elem_t *conn_info;
+
+	/* Shared-memory transport, NULL if messages go through the NIC */
+	nccl_net_ofi_sendrecv_shm_t *shm;
 } nccl_net_ofi_sendrecv_send_comm_t;
 
 /* Metadata about dummy flush buffer */
@@ -82,6 +101,15 @@ typedef struct nccl_net_ofi_sendrecv_recv_comm {
 	struct fid_ep *local_ep;
 
 	nccl_net_ofi_sendrecv_flush_buffer_t flush_buff;
+
+	/* Shared-memory transport, NULL if messages go through the NIC */
+	nccl_net_ofi_sendrecv_shm_t *shm;
+
+	/* Receives completed early for NCCL whose completion entry is
+	 * still to be processed (see NCCL_NET_OPTIONAL_RECV_COMPLETION),
+	 * and whether one of them failed */
+	uint64_t num_optional_recvs;
+	bool optional_recv_error;
 } nccl_net_ofi_sendrecv_recv_comm_t;
 
 /**
@@ -206,6 +234,18 @@ typedef struct nccl_net_ofi_sendrecv_req {
 
 	/* Backpointer to freelist elem (for cleanup) */
 	nccl_ofi_freelist_elem_t *elem;
+
+	/* Receive reported complete to NCCL when posted, released by
+	 * completion processing */
+	bool recv_completion_optional;
+
+	/* Shared-memory transport only: next posted request, user
+	 * buffer, bytes of length and payload copied so far, and
+	 * message length */
+	struct nccl_net_ofi_sendrecv_req *shm_next;
+	void *shm_buff;
+	size_t shm_offset;
+	uint64_t shm_msg_size;
 } nccl_net_ofi_sendrecv_req_t;
 
 
@@ -217,6 +257,19 @@ struct nccl_net_ofi_sendrecv_plugin {
 typedef struct nccl_net_ofi_sendrecv_plugin nccl_net_ofi_sendrecv_plugin_t;
 
 
+/*
+ * @brief	Data path of SENDRECV communicators and requests
+ *
+ * Same as their send(), recv() and test() function pointers, for
+ * callers that know the protocol.
+ */
+int nccl_net_ofi_sendrecv_send(nccl_net_ofi_send_comm_t *send_comm, void *data, int size, int tag,
+			       nccl_net_ofi_mr_handle_t *mhandle, nccl_net_ofi_req_t **base_req);
+int nccl_net_ofi_sendrecv_recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
+			       int *sizes, int *tags, nccl_net_ofi_mr_handle_t **mhandles,
+			       nccl_net_ofi_req_t **base_req);
+int nccl_net_ofi_sendrecv_req_test(nccl_net_ofi_req_t *base_req, int *done, int *size);
+
 /*
  * @brief	Initialize plugin with sendrecv protocol structures
  */
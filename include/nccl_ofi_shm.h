@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#ifndef NCCL_OFI_SHM_H_
+#define NCCL_OFI_SHM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum length of a channel name, including the terminating null byte */
+#define NCCL_OFI_SHM_NAME_LEN	(32)
+
+struct nccl_ofi_shm_ring;
+typedef struct nccl_ofi_shm_ring nccl_ofi_shm_ring_t;
+
+/*
+ * @brief	Shared-memory channel
+ *
+ * Single-producer single-consumer byte stream between two processes
+ * of the same host, backed by a ring buffer in a POSIX shared memory
+ * object. The producer creates the channel and passes its name to the
+ * consumer, which attaches to it. Bytes are read in the order they
+ * were written, and writes and reads copy as much as the ring allows
+ * without blocking.
+ */
+typedef struct nccl_ofi_shm_chan {
+	/* Mapped ring */
+	nccl_ofi_shm_ring_t *ring;
+	/* Size of the mapping in bytes */
+	size_t map_size;
+	/* Capacity of the ring in bytes, a power of two */
+	size_t ring_size;
+	/* Name of the shared memory object */
+	char name[NCCL_OFI_SHM_NAME_LEN];
+	/* True if this side created the shared memory object */
+	bool owner;
+} nccl_ofi_shm_chan_t;
+
+/*
+ * @brief	Identifier of the shared memory domain of this process
+ *
+ * Processes with the same identifier run on the same kernel instance
+ * and IPC namespace and can attach to each other's channels.
+ *
+ * @return	Identifier, or 0 if it cannot be determined
+ */
+uint64_t nccl_ofi_shm_host_id(void);
+
+/*
+ * @brief	Create a channel with a ring of at least `ring_size' bytes
+ *
+ * @return	0, on success
+ *		negative errno, on error
+ */
+int nccl_ofi_shm_chan_create(nccl_ofi_shm_chan_t *chan, size_t ring_size);
+
+/*
+ * @brief	Attach to the channel named `name' created by a peer
+ *
+ * The name of the shared memory object is removed, so that it is
+ * released once both sides closed the channel.
+ *
+ * @return	0, on success
+ *		negative errno, on error
+ */
+int nccl_ofi_shm_chan_attach(nccl_ofi_shm_chan_t *chan, const char *name);
+
+/*
+ * @brief	Unmap the channel, and remove its name if still present
+ *
+ * @return	0, on success
+ *		negative errno, on error
+ */
+int nccl_ofi_shm_chan_close(nccl_ofi_shm_chan_t *chan);
+
+/*
+ * @brief	Copy up to `len' bytes of `buf' into the channel
+ *
+ * Must only be called by the producer.
+ *
+ * @return	Number of bytes copied
+ */
+size_t nccl_ofi_shm_chan_write(nccl_ofi_shm_chan_t *chan, const void *buf, size_t len);
+
+/*
+ * @brief	Number of bytes the channel can take before a write copies
+ *		less than asked
+ *
+ * Must only be called by the producer.
+ */
+size_t nccl_ofi_shm_chan_space(const nccl_ofi_shm_chan_t *chan);
+
+/*
+ * @brief	Copy up to `len' bytes out of the channel into `buf'
+ *
+ * Must only be called by the consumer.
+ *
+ * @return	Number of bytes copied
+ */
+size_t nccl_ofi_shm_chan_read(nccl_ofi_shm_chan_t *chan, void *buf, size_t len);
+
+#endif // End NCCL_OFI_SHM_H_
@@ -10,6 +10,9 @@
 #include "nccl_ofi.h"
 #include "nccl_ofi_api.h"
 #include "nccl_ofi_param.h"
+#include "nccl_ofi_pthread.h"
+#include "nccl_ofi_rdma.h"
+#include "nccl_ofi_sendrecv.h"
 
 
 static_assert(sizeof(nccl_net_ofi_conn_handle_t) <= NCCL_NET_HANDLE_MAXSIZE,
@@ -89,6 +92,7 @@ static ncclResult_t nccl_net_ofi_retval_translate_impl(int retval)
 		ncclResult_t check_return_retval = retval;		\
 		if (abort_on_error && check_return_retval != ncclSuccess) { \
 			NCCL_OFI_WARN("Aborting due to call failure with return %d", check_return_retval); \
+			nccl_ofi_log_flush();				\
 			abort();					\
 		}							\
 		check_return_retval;					\
@@ -128,6 +132,8 @@ static inline ncclResult_t msg_length_verify_max_size(const size_t *sizes, const
 
 static void nccl_net_ofi_fini(void)
 {
+	nccl_ofi_param_watch_stop();
+
 	if (plugin != NULL) {
 		int ret = plugin->release_plugin(plugin);
 		if (ret != 0) {
@@ -135,6 +141,10 @@ static void nccl_net_ofi_fini(void)
 		}
 		plugin = NULL;
 	}
+
+	nccl_net_ofi_mutex_prof_report();
+
+	nccl_ofi_log_fini();
 }
 
 
@@ -147,6 +157,7 @@ ncclResult_t nccl_net_ofi_init(ncclDebugLogger_t logFunction)
 	}
 
 	ofi_log_function = logFunction;
+	nccl_ofi_log_init();
 
 	abort_on_error = (ofi_nccl_abort_on_error() != 0);
 
@@ -201,6 +212,48 @@ ncclResult_t nccl_net_ofi_get_properties(int dev_id, nccl_ofi_properties_t *ofi_
 	}
 
 	int ret = device->get_properties(device, ofi_properties);
+	if (ret == 0) {
+		ofi_properties->num_member_devs = device->num_member_devs;
+		for (int i = 0; i < device->num_member_devs; i++) {
+			ofi_properties->member_devs[i] = device->member_devs[i];
+		}
+	}
+	return nccl_net_ofi_retval_translate(ret);
+}
+
+
+ncclResult_t nccl_net_ofi_make_vdevice(int *dev_id, int num_devs, const int *dev_ids)
+{
+	static pthread_mutex_t vdevice_lock = PTHREAD_MUTEX_INITIALIZER;
+	int ret;
+
+	/* Validate plugin */
+	if (OFI_UNLIKELY(plugin == NULL)) {
+		NCCL_OFI_WARN("Error accessing plugin. Plugin has not been initialized yet.");
+		return check_return(ncclInvalidArgument);
+	}
+
+	if (OFI_UNLIKELY(dev_id == NULL || dev_ids == NULL)) {
+		NCCL_OFI_WARN("Invalid virtual device arguments");
+		return check_return(ncclInvalidArgument);
+	}
+
+	if (num_devs < 1 || num_devs > NCCL_OFI_MAX_DEVS_PER_VDEV) {
+		NCCL_OFI_WARN("Unable to fuse %d devices into a virtual device (maximum %d)",
+			      num_devs, NCCL_OFI_MAX_DEVS_PER_VDEV);
+		return check_return(ncclInvalidArgument);
+	}
+
+	if (plugin->make_virtual_device == NULL) {
+		NCCL_OFI_WARN("Virtual devices are not supported by protocol %s",
+			      nccl_ofi_selected_protocol);
+		return check_return(ncclInvalidUsage);
+	}
+
+	nccl_net_ofi_mutex_lock(&vdevice_lock);
+	ret = plugin->make_virtual_device(plugin, dev_ids, num_devs, dev_id);
+	nccl_net_ofi_mutex_unlock(&vdevice_lock);
+
 	return nccl_net_ofi_retval_translate(ret);
 }
 
@@ -565,16 +618,10 @@ error:
 }
 
 
-ncclResult_t nccl_net_ofi_isend(void *sComm, void* data, int size,
-				int tag, void *mhandle, void** req)
+static inline ncclResult_t isend_validate(void *sComm, void **req)
 {
-	nccl_net_ofi_send_comm_t *send_comm =
-		(nccl_net_ofi_send_comm_t *)sComm;
-	nccl_net_ofi_mr_handle_t *handle = (nccl_net_ofi_mr_handle_t *)mhandle;
-	nccl_net_ofi_req_t **base_req = (nccl_net_ofi_req_t **)req;
-
 	/* Validate send_comm */
-	if (OFI_UNLIKELY(send_comm == NULL)) {
+	if (OFI_UNLIKELY(sComm == NULL)) {
 		NCCL_OFI_WARN("Invalid communicator object provided");
 		return check_return(ncclInternalError);
 	}
@@ -585,11 +632,28 @@ ncclResult_t nccl_net_ofi_isend(void *sComm, void* data, int size,
 	 * registration and the buffer is a host buffer.
 	 */
 
-	if (OFI_UNLIKELY(base_req == NULL)) {
+	if (OFI_UNLIKELY(req == NULL)) {
 		NCCL_OFI_WARN("Invalid request provided");
 		return check_return(ncclInternalError);
 	}
 
+	return ncclSuccess;
+}
+
+
+ncclResult_t nccl_net_ofi_isend(void *sComm, void* data, int size,
+				int tag, void *mhandle, void** req)
+{
+	nccl_net_ofi_send_comm_t *send_comm =
+		(nccl_net_ofi_send_comm_t *)sComm;
+	nccl_net_ofi_mr_handle_t *handle = (nccl_net_ofi_mr_handle_t *)mhandle;
+	nccl_net_ofi_req_t **base_req = (nccl_net_ofi_req_t **)req;
+
+	ncclResult_t validation_result = isend_validate(sComm, req);
+	if (OFI_UNLIKELY(validation_result != ncclSuccess)) {
+		return validation_result;
+	}
+
 	int ret = send_comm->send(send_comm, data, size, tag, handle, base_req);
 	return nccl_net_ofi_retval_translate(ret);
 }
@@ -705,6 +769,84 @@ ncclResult_t nccl_net_ofi_iread(void* rComm, void* dest, size_t size, void* mhan
 	return nccl_net_ofi_retval_translate(ret);
 }
 
+ncclResult_t nccl_net_ofi_iwrite_batch(void* sComm, nccl_ofi_rma_desc_t* descs, int n, void** req)
+{
+	nccl_net_ofi_send_comm_t *send_comm =
+		(nccl_net_ofi_send_comm_t *)sComm;
+	nccl_net_ofi_req_t **base_req = (nccl_net_ofi_req_t **)req;
+
+	/* Validate send_comm */
+	if (OFI_UNLIKELY(send_comm == NULL)) {
+		NCCL_OFI_WARN("Invalid communicator object provided");
+		return check_return(ncclInternalError);
+	}
+
+	if (OFI_UNLIKELY(send_comm->write_batch == NULL)) {
+		NCCL_OFI_WARN("Protocol does not support iwriteBatch API function");
+		return check_return(ncclInternalError);
+	}
+
+	if (OFI_UNLIKELY(descs == NULL || n <= 0 || n > NCCL_OFI_MAX_RMA_BATCH)) {
+		NCCL_OFI_WARN("Invalid batch of %d writes provided, expected 1 to %d",
+			      n, NCCL_OFI_MAX_RMA_BATCH);
+		return check_return(ncclInvalidArgument);
+	}
+
+	for (int i = 0; i < n; i++) {
+		if (OFI_UNLIKELY(descs[i].mhandle == NULL)) {
+			NCCL_OFI_WARN("Invalid memory handle provided for operation %d of batch", i);
+			return check_return(ncclInvalidArgument);
+		}
+	}
+
+	if (OFI_UNLIKELY(base_req == NULL)) {
+		NCCL_OFI_WARN("Invalid request provided");
+		return check_return(ncclInternalError);
+	}
+
+	int ret = send_comm->write_batch(send_comm, descs, n, base_req);
+	return nccl_net_ofi_retval_translate(ret);
+}
+
+ncclResult_t nccl_net_ofi_iread_batch(void* rComm, nccl_ofi_rma_desc_t* descs, int n, void** req)
+{
+	nccl_net_ofi_recv_comm_t *recv_comm =
+		(nccl_net_ofi_recv_comm_t *)rComm;
+	nccl_net_ofi_req_t **base_req = (nccl_net_ofi_req_t **)req;
+
+	/* Validate recv_comm */
+	if (OFI_UNLIKELY(recv_comm == NULL)) {
+		NCCL_OFI_WARN("Invalid communicator object provided");
+		return check_return(ncclInternalError);
+	}
+
+	if (OFI_UNLIKELY(recv_comm->read_batch == NULL)) {
+		NCCL_OFI_WARN("Protocol does not support ireadBatch API function");
+		return check_return(ncclInternalError);
+	}
+
+	if (OFI_UNLIKELY(descs == NULL || n <= 0 || n > NCCL_OFI_MAX_RMA_BATCH)) {
+		NCCL_OFI_WARN("Invalid batch of %d reads provided, expected 1 to %d",
+			      n, NCCL_OFI_MAX_RMA_BATCH);
+		return check_return(ncclInvalidArgument);
+	}
+
+	for (int i = 0; i < n; i++) {
+		if (OFI_UNLIKELY(descs[i].mhandle == NULL)) {
+			NCCL_OFI_WARN("Invalid memory handle provided for operation %d of batch", i);
+			return check_return(ncclInvalidArgument);
+		}
+	}
+
+	if (OFI_UNLIKELY(base_req == NULL)) {
+		NCCL_OFI_WARN("Invalid request provided");
+		return check_return(ncclInternalError);
+	}
+
+	int ret = recv_comm->read_batch(recv_comm, descs, n, base_req);
+	return nccl_net_ofi_retval_translate(ret);
+}
+
 
 ncclResult_t nccl_net_ofi_isend_v4(void* sendComm, void* data, int size,
 			  void* mhandle, void** request)
@@ -725,15 +867,9 @@ ncclResult_t nccl_net_ofi_isend_v9(void* sendComm, void* data, size_t size,
 }
 
 
-ncclResult_t nccl_net_ofi_irecv(void* rComm, int n, void** buffers, int* sizes,
-				int *tags, void** mhandles, void** req)
+static inline ncclResult_t irecv_validate(void *rComm, int n, void **mhandles, void **req)
 {
-	nccl_net_ofi_recv_comm_t *recv_comm =
-		(nccl_net_ofi_recv_comm_t *)rComm;
-	nccl_net_ofi_mr_handle_t **handles = (nccl_net_ofi_mr_handle_t **)mhandles;
-	nccl_net_ofi_req_t **base_req = (nccl_net_ofi_req_t **)req;
-
-	if (OFI_UNLIKELY(recv_comm == NULL)) {
+	if (OFI_UNLIKELY(rComm == NULL)) {
 		NCCL_OFI_WARN("Invalid communicator object provided");
 		return check_return(ncclInternalError);
 	}
@@ -744,7 +880,7 @@ ncclResult_t nccl_net_ofi_irecv(void* rComm, int n, void** buffers, int* sizes,
 		return check_return(ncclInternalError);
 	}
 
-	if (OFI_UNLIKELY(handles == NULL)) {
+	if (OFI_UNLIKELY(mhandles == NULL)) {
 		NCCL_OFI_WARN("Invalid memory handle provided");
 		return check_return(ncclInternalError);
 	}
@@ -755,11 +891,28 @@ ncclResult_t nccl_net_ofi_irecv(void* rComm, int n, void** buffers, int* sizes,
 	 * registration and the buffer is a host buffer.
 	 */
 
-	if (OFI_UNLIKELY(base_req == NULL)) {
+	if (OFI_UNLIKELY(req == NULL)) {
 		NCCL_OFI_WARN("Invalid request provided");
 		return check_return(ncclInternalError);
 	}
 
+	return ncclSuccess;
+}
+
+
+ncclResult_t nccl_net_ofi_irecv(void* rComm, int n, void** buffers, int* sizes,
+				int *tags, void** mhandles, void** req)
+{
+	nccl_net_ofi_recv_comm_t *recv_comm =
+		(nccl_net_ofi_recv_comm_t *)rComm;
+	nccl_net_ofi_mr_handle_t **handles = (nccl_net_ofi_mr_handle_t **)mhandles;
+	nccl_net_ofi_req_t **base_req = (nccl_net_ofi_req_t **)req;
+
+	ncclResult_t validation_result = irecv_validate(rComm, n, mhandles, req);
+	if (OFI_UNLIKELY(validation_result != ncclSuccess)) {
+		return validation_result;
+	}
+
 	int ret = recv_comm->recv(recv_comm, n, buffers, sizes, tags, handles, base_req);
 	return nccl_net_ofi_retval_translate(ret);
 }
@@ -774,8 +927,8 @@ ncclResult_t nccl_net_ofi_irecv_v4(void* recvComm, void* data, int size,
 }
 
 
-ncclResult_t nccl_net_ofi_irecv_v9(void* recvComm, int n, void** data,
-				size_t* sizes, int* tags, void** mhandles, void** request)
+static inline ncclResult_t irecv_v9_validate(void *recvComm, int n, void **data, size_t *sizes,
+					     int *tags, void **mhandles, void **request)
 {
 	if (OFI_UNLIKELY(recvComm == NULL || data == NULL ||
 					sizes == NULL || tags == NULL ||
@@ -789,7 +942,20 @@ ncclResult_t nccl_net_ofi_irecv_v9(void* recvComm, int n, void** data,
 		return check_return(ncclInvalidArgument);
 	}
 
-	ncclResult_t validation_result = msg_length_verify_max_size(sizes, n);
+	return ncclSuccess;
+}
+
+
+ncclResult_t nccl_net_ofi_irecv_v9(void* recvComm, int n, void** data,
+				size_t* sizes, int* tags, void** mhandles, void** request)
+{
+	ncclResult_t validation_result = irecv_v9_validate(recvComm, n, data, sizes, tags,
+							   mhandles, request);
+	if (validation_result != ncclSuccess) {
+		return validation_result;
+	}
+
+	validation_result = msg_length_verify_max_size(sizes, n);
 	if (validation_result != ncclSuccess) {
 		return check_return(validation_result);
 	}
@@ -803,6 +969,19 @@ ncclResult_t nccl_net_ofi_irecv_v9(void* recvComm, int n, void** data,
 }
 
 
+/*
+ * @brief	Test the request of an operation that completed when it
+ *		was posted, without a call into the protocol
+ */
+static inline ncclResult_t api_req_complete_test(int *done, int *size)
+{
+	*done = 1;
+	if (size != NULL) {
+		*size = 0;
+	}
+	return ncclSuccess;
+}
+
 ncclResult_t nccl_net_ofi_test(void* req, int* done, int* size)
 {
 	/* Validate request */
@@ -811,11 +990,165 @@ ncclResult_t nccl_net_ofi_test(void* req, int* done, int* size)
 	}
 
 	nccl_net_ofi_req_t *base_req = (nccl_net_ofi_req_t *)req;
+	if (nccl_net_ofi_req_is_complete(base_req)) {
+		return api_req_complete_test(done, size);
+	}
+
 	int ret = base_req->test(base_req, done, size);
 	return nccl_net_ofi_retval_translate(ret);
 }
 
 
+/*
+ * Protocol-specialized data path
+ *
+ * The protocol is fixed once the plugin is initialized, so the
+ * interfaces replace the isend/irecv/test entry points of their
+ * exported tables with these, which call the protocol implementation
+ * directly rather than through the communicator and request function
+ * pointers. Their argument validation is only compiled into debug
+ * builds; misuse of the API in release builds is caught by the generic
+ * entry points used before initialization and by older interfaces.
+ */
+#ifndef NDEBUG
+#define API_VALIDATE_DATA_PATH 1
+#else
+#define API_VALIDATE_DATA_PATH 0
+#endif
+
+typedef int (*api_send_fn_t)(nccl_net_ofi_send_comm_t *send_comm, void *data, int size, int tag,
+			     nccl_net_ofi_mr_handle_t *mhandle, nccl_net_ofi_req_t **base_req);
+typedef int (*api_recv_fn_t)(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
+			     int *sizes, int *tags, nccl_net_ofi_mr_handle_t **mhandles,
+			     nccl_net_ofi_req_t **base_req);
+typedef int (*api_test_fn_t)(nccl_net_ofi_req_t *base_req, int *done, int *size);
+
+static inline ncclResult_t api_data_path_retval(int ret)
+{
+	if (OFI_LIKELY(ret == 0)) {
+		return ncclSuccess;
+	}
+	return nccl_net_ofi_retval_translate(ret);
+}
+
+template <api_send_fn_t send_fn>
+static ncclResult_t isend_direct(void *sComm, void *data, int size, int tag,
+				 void *mhandle, void **req)
+{
+	if (API_VALIDATE_DATA_PATH) {
+		ncclResult_t validation_result = isend_validate(sComm, req);
+		if (OFI_UNLIKELY(validation_result != ncclSuccess)) {
+			return validation_result;
+		}
+	}
+
+	return api_data_path_retval(send_fn((nccl_net_ofi_send_comm_t *)sComm, data, size, tag,
+					    (nccl_net_ofi_mr_handle_t *)mhandle,
+					    (nccl_net_ofi_req_t **)req));
+}
+
+template <api_send_fn_t send_fn>
+static ncclResult_t isend_v9_direct(void *sComm, void *data, size_t size, int tag,
+				    void *mhandle, void **req)
+{
+	/* Not an argument check, sizes above INT_MAX would be truncated */
+	if (OFI_UNLIKELY(size > INT_MAX)) {
+		return check_return(msg_length_verify_max_size(&size, 1));
+	}
+
+	return isend_direct<send_fn>(sComm, data, (int)size, tag, mhandle, req);
+}
+
+template <api_recv_fn_t recv_fn>
+static ncclResult_t irecv_direct(void *rComm, int n, void **buffers, int *sizes, int *tags,
+				 void **mhandles, void **req)
+{
+	if (API_VALIDATE_DATA_PATH) {
+		ncclResult_t validation_result = irecv_validate(rComm, n, mhandles, req);
+		if (OFI_UNLIKELY(validation_result != ncclSuccess)) {
+			return validation_result;
+		}
+	}
+
+	return api_data_path_retval(recv_fn((nccl_net_ofi_recv_comm_t *)rComm, n, buffers, sizes,
+					    tags, (nccl_net_ofi_mr_handle_t **)mhandles,
+					    (nccl_net_ofi_req_t **)req));
+}
+
+template <api_recv_fn_t recv_fn>
+static ncclResult_t irecv_v9_direct(void *rComm, int n, void **buffers, size_t *sizes,
+				    int *tags, void **mhandles, void **req)
+{
+	int sizes_int[NCCL_OFI_MAX_RECVS];
+
+	if (API_VALIDATE_DATA_PATH) {
+		ncclResult_t validation_result = irecv_v9_validate(rComm, n, buffers, sizes,
+								   tags, mhandles, req);
+		if (OFI_UNLIKELY(validation_result != ncclSuccess)) {
+			return validation_result;
+		}
+	}
+
+	for (int i = 0; i < n; i++) {
+		if (OFI_UNLIKELY(sizes[i] > INT_MAX)) {
+			return check_return(msg_length_verify_max_size(sizes, n));
+		}
+		sizes_int[i] = (int)sizes[i];
+	}
+
+	return irecv_direct<recv_fn>(rComm, n, buffers, sizes_int, tags, mhandles, req);
+}
+
+template <api_test_fn_t test_fn>
+static ncclResult_t test_direct(void *req, int *done, int *size)
+{
+	if (API_VALIDATE_DATA_PATH) {
+		if (OFI_UNLIKELY(req == NULL)) {
+			return check_return(ncclInternalError);
+		}
+	}
+
+	/* Not a request of the protocol */
+	if (nccl_net_ofi_req_is_complete((nccl_net_ofi_req_t *)req)) {
+		return api_req_complete_test(done, size);
+	}
+
+	return api_data_path_retval(test_fn((nccl_net_ofi_req_t *)req, done, size));
+}
+
+#define API_DATA_PATH(send_fn, recv_fn, test_fn)	\
+	{						\
+		.isend = isend_direct<send_fn>,		\
+		.isend_v9 = isend_v9_direct<send_fn>,	\
+		.irecv = irecv_direct<recv_fn>,		\
+		.irecv_v9 = irecv_v9_direct<recv_fn>,	\
+		.test = test_direct<test_fn>,		\
+	}
+
+static const nccl_ofi_api_data_path_t rdma_data_path =
+	API_DATA_PATH(nccl_net_ofi_rdma_send, nccl_net_ofi_rdma_recv, nccl_net_ofi_rdma_req_test);
+
+static const nccl_ofi_api_data_path_t sendrecv_data_path =
+	API_DATA_PATH(nccl_net_ofi_sendrecv_send, nccl_net_ofi_sendrecv_recv,
+		      nccl_net_ofi_sendrecv_req_test);
+
+
+const nccl_ofi_api_data_path_t *nccl_net_ofi_get_data_path(void)
+{
+	if (OFI_UNLIKELY(plugin == NULL || nccl_ofi_selected_protocol == NULL)) {
+		return NULL;
+	}
+
+	if (0 == strcasecmp(nccl_ofi_selected_protocol, "RDMA")) {
+		return &rdma_data_path;
+	} else if (0 == strcasecmp(nccl_ofi_selected_protocol, "SENDRECV")) {
+		return &sendrecv_data_path;
+	}
+
+	return NULL;
+}
+
+
 ncclResult_t nccl_net_ofi_iflush(void* rComm, int n, void** buffers, int* sizes,
 				 void** mhandles, void** req)
 {
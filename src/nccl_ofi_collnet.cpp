@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nccl_ofi_api.h"
+#include "nccl_ofi_collnet.h"
+#include "nccl_ofi_log.h"
+#include "nccl_ofi_param.h"
+#include "nccl_ofi_reduce.h"
+
+/* Tag of the messages exchanged between ring neighbors */
+#define COLLNET_TAG	(0)
+
+typedef struct nccl_ofi_collnet_listen_comm {
+	int dev;
+	/* Point-to-point listen communicator accepting the connection
+	 * of the previous rank of the ring */
+	void *listen_comm;
+} nccl_ofi_collnet_listen_comm_t;
+
+struct nccl_ofi_collnet_req;
+
+typedef struct nccl_ofi_collnet_comm {
+	int rank;
+	int nranks;
+	/* Point-to-point communicators to the next rank and from the
+	 * previous rank of the ring */
+	void *send_comm;
+	void *recv_comm;
+	/* Staging buffers of NCCL_OFI_COLLNET_CHUNK_SIZE bytes */
+	char *send_buff;
+	char *recv_buff;
+	void *send_mhandle;
+	void *recv_mhandle;
+	/* Allreduces that have not completed yet, oldest first. They
+	 * share the staging buffers and the tag, so only the oldest
+	 * one is progressed. */
+	struct nccl_ofi_collnet_req *head;
+	struct nccl_ofi_collnet_req *tail;
+} nccl_ofi_collnet_comm_t;
+
+typedef struct nccl_ofi_collnet_req {
+	nccl_ofi_collnet_comm_t *comm;
+	char *data;
+	size_t count;
+	size_t elem_size;
+	nccl_ofi_reduce_dtype_t dtype;
+	nccl_ofi_reduce_op_t op;
+	/* Number of elements of the segments completed so far */
+	size_t seg_start;
+	/* Step of the ring within the segment. Steps below nranks - 1
+	 * reduce-scatter, the following ones allgather. */
+	int step;
+	/* Point-to-point requests of the step, NULL until posted */
+	void *send_req;
+	void *recv_req;
+	bool send_done;
+	bool recv_done;
+	/* Next allreduce of the communicator */
+	struct nccl_ofi_collnet_req *next;
+} nccl_ofi_collnet_req_t;
+
+static bool collnet_enabled = false;
+
+ncclResult_t nccl_net_ofi_collnet_init(ncclDebugLogger_t logFunction)
+{
+	/* The point-to-point plugin, which the rings are built on, is
+	 * initialized by NCCL before the collective network */
+	collnet_enabled = (ofi_nccl_collnet() != 0);
+	if (collnet_enabled) {
+		NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "Software collective network enabled");
+	}
+	return ncclSuccess;
+}
+
+ncclResult_t nccl_net_ofi_collnet_devices(int *ndev)
+{
+	if (!collnet_enabled) {
+		*ndev = 0;
+		return ncclSuccess;
+	}
+	return nccl_net_ofi_devices(ndev);
+}
+
+ncclResult_t nccl_net_ofi_collnet_listen(int dev, void *handle, void **listenComm)
+{
+	nccl_ofi_collnet_listen_comm_t *l_comm =
+		(nccl_ofi_collnet_listen_comm_t *)calloc(1, sizeof(nccl_ofi_collnet_listen_comm_t));
+	if (l_comm == NULL) {
+		NCCL_OFI_WARN("Unable to allocate collective network listen communicator");
+		return ncclSystemError;
+	}
+
+	ncclResult_t ret = nccl_net_ofi_listen(dev, handle, &l_comm->listen_comm);
+	if (ret != ncclSuccess) {
+		free(l_comm);
+		return ret;
+	}
+	l_comm->dev = dev;
+
+	*listenComm = l_comm;
+	return ncclSuccess;
+}
+
+ncclResult_t nccl_net_ofi_collnet_closeListen(void *listenComm)
+{
+	nccl_ofi_collnet_listen_comm_t *l_comm = (nccl_ofi_collnet_listen_comm_t *)listenComm;
+	ncclResult_t ret = nccl_net_ofi_closeListen(l_comm->listen_comm);
+	free(l_comm);
+	return ret;
+}
+
+static ncclResult_t collnet_comm_free(nccl_ofi_collnet_comm_t *comm)
+{
+	ncclResult_t ret = ncclSuccess;
+
+	if (comm->send_mhandle != NULL) {
+		ret = nccl_net_ofi_deregMr(comm->send_comm, comm->send_mhandle);
+	}
+	if (comm->recv_mhandle != NULL && ret == ncclSuccess) {
+		ret = nccl_net_ofi_deregMr(comm->recv_comm, comm->recv_mhandle);
+	}
+	if (comm->send_comm != NULL && ret == ncclSuccess) {
+		ret = nccl_net_ofi_closeSend(comm->send_comm);
+	}
+	if (comm->recv_comm != NULL && ret == ncclSuccess) {
+		ret = nccl_net_ofi_closeRecv(comm->recv_comm);
+	}
+	free(comm->send_buff);
+	free(comm->recv_buff);
+	free(comm);
+
+	return ret;
+}
+
+ncclResult_t nccl_net_ofi_collnet_connect(void *handles[], int nranks, int rank,
+					  void *listenComm, void **collComm)
+{
+	ncclResult_t ret = ncclSuccess;
+	nccl_ofi_collnet_listen_comm_t *l_comm = (nccl_ofi_collnet_listen_comm_t *)listenComm;
+	char handle[NCCL_NET_HANDLE_MAXSIZE];
+
+	nccl_ofi_collnet_comm_t *comm =
+		(nccl_ofi_collnet_comm_t *)calloc(1, sizeof(nccl_ofi_collnet_comm_t));
+	if (comm == NULL) {
+		NCCL_OFI_WARN("Unable to allocate collective network communicator");
+		return ncclSystemError;
+	}
+	comm->rank = rank;
+	comm->nranks = nranks;
+
+	if (nranks > 1) {
+		/* The plugin keeps the connection state in the handle */
+		memcpy(handle, handles[(rank + 1) % nranks], sizeof(handle));
+
+		/* Connect and accept are non-blocking, and the neighbors
+		 * establish their connections concurrently */
+		while (comm->send_comm == NULL || comm->recv_comm == NULL) {
+			if (comm->send_comm == NULL) {
+				ret = nccl_net_ofi_connect(l_comm->dev, handle, &comm->send_comm);
+				if (ret != ncclSuccess) {
+					goto error;
+				}
+			}
+			if (comm->recv_comm == NULL) {
+				ret = nccl_net_ofi_accept(l_comm->listen_comm, &comm->recv_comm);
+				if (ret != ncclSuccess) {
+					goto error;
+				}
+			}
+		}
+
+		comm->send_buff = (char *)malloc(NCCL_OFI_COLLNET_CHUNK_SIZE);
+		comm->recv_buff = (char *)malloc(NCCL_OFI_COLLNET_CHUNK_SIZE);
+		if (comm->send_buff == NULL || comm->recv_buff == NULL) {
+			NCCL_OFI_WARN("Unable to allocate collective network staging buffers");
+			ret = ncclSystemError;
+			goto error;
+		}
+
+		ret = nccl_net_ofi_regMr(comm->send_comm, comm->send_buff, NCCL_OFI_COLLNET_CHUNK_SIZE,
+					 NCCL_PTR_HOST, &comm->send_mhandle);
+		if (ret != ncclSuccess) {
+			goto error;
+		}
+		ret = nccl_net_ofi_regMr(comm->recv_comm, comm->recv_buff, NCCL_OFI_COLLNET_CHUNK_SIZE,
+					 NCCL_PTR_HOST, &comm->recv_mhandle);
+		if (ret != ncclSuccess) {
+			goto error;
+		}
+	}
+
+	*collComm = comm;
+	return ncclSuccess;
+
+ error:
+	collnet_comm_free(comm);
+	return ret;
+}
+
+ncclResult_t nccl_net_ofi_collnet_closeColl(void *collComm)
+{
+	return collnet_comm_free((nccl_ofi_collnet_comm_t *)collComm);
+}
+
+ncclResult_t nccl_net_ofi_collnet_reduce_support(int dtype, int op, int *supported)
+{
+	*supported = (dtype >= 0 && dtype < NCCL_OFI_REDUCE_NUM_DTYPES &&
+		      op >= 0 && op < NCCL_OFI_REDUCE_NUM_OPS);
+	return ncclSuccess;
+}
+
+ncclResult_t nccl_net_ofi_collnet_regMr(void *collComm, void *data, size_t size, int type,
+					void **mhandle)
+{
+	/* User buffers are copied to and from the staging buffers, so
+	 * they do not need a registration */
+	if (type != NCCL_PTR_HOST) {
+		NCCL_OFI_WARN("Collective network only supports host buffers, got type %d", type);
+		return ncclInvalidArgument;
+	}
+	*mhandle = collComm;
+	return ncclSuccess;
+}
+
+ncclResult_t nccl_net_ofi_collnet_deregMr(void *collComm, void *mhandle)
+{
+	return ncclSuccess;
+}
+
+ncclResult_t nccl_net_ofi_collnet_iflush(void *collComm, void *data, int size, void *mhandle,
+					 void **request)
+{
+	/* Host buffers are written by the CPU */
+	*request = NULL;
+	return ncclSuccess;
+}
+
+ncclResult_t nccl_net_ofi_collnet_iallreduce(void *collComm, void *sendData, void *recvData,
+					     size_t count, int dtype, int op, void **request)
+{
+	nccl_ofi_collnet_comm_t *comm = (nccl_ofi_collnet_comm_t *)collComm;
+	int supported = 0;
+
+	nccl_net_ofi_collnet_reduce_support(dtype, op, &supported);
+	if (!supported) {
+		NCCL_OFI_WARN("Unsupported reduction of type %d with operator %d", dtype, op);
+		return ncclInvalidArgument;
+	}
+
+	nccl_ofi_collnet_req_t *req = (nccl_ofi_collnet_req_t *)calloc(1, sizeof(nccl_ofi_collnet_req_t));
+	if (req == NULL) {
+		NCCL_OFI_WARN("Unable to allocate collective network request");
+		return ncclSystemError;
+	}
+	req->comm = comm;
+	req->data = (char *)recvData;
+	req->count = count;
+	req->dtype = (nccl_ofi_reduce_dtype_t)dtype;
+	req->op = (nccl_ofi_reduce_op_t)op;
+	req->elem_size = nccl_ofi_reduce_dtype_size(req->dtype);
+
+	/* The ring reduces in place */
+	if (sendData != recvData) {
+		memcpy(recvData, sendData, count * req->elem_size);
+	}
+	if (comm->nranks == 1) {
+		req->seg_start = count;
+	}
+
+	/* Queue behind the allreduces still in progress */
+	if (req->seg_start < req->count) {
+		if (comm->tail != NULL) {
+			comm->tail->next = req;
+		} else {
+			comm->head = req;
+		}
+		comm->tail = req;
+	}
+
+	*request = req;
+	return ncclSuccess;
+}
+
+/*
+ * @brief	Range of the elements of chunk `chunk' of the current
+ *		segment, relative to the start of the buffer
+ */
+static inline void collnet_chunk_range(nccl_ofi_collnet_req_t *req, int chunk,
+				       size_t *start, size_t *count)
+{
+	int nranks = req->comm->nranks;
+	size_t seg_count = NCCL_OFI_COLLNET_CHUNK_SIZE / req->elem_size * nranks;
+	if (seg_count > req->count - req->seg_start) {
+		seg_count = req->count - req->seg_start;
+	}
+	size_t chunk_count = (seg_count + nranks - 1) / nranks;
+	size_t chunk_start = chunk * chunk_count;
+
+	*start = req->seg_start + (chunk_start < seg_count ? chunk_start : seg_count);
+	*count = (chunk_start < seg_count) ?
+		((seg_count - chunk_start < chunk_count) ? seg_count - chunk_start : chunk_count) : 0;
+}
+
+/*
+ * @brief	Post the point-to-point operations of the current step
+ *		and complete the step once both are done
+ *
+ * In step `s' of the reduce-scatter, a rank sends chunk `rank - s' and
+ * reduces chunk `rank - s - 1' received from the previous rank, so it
+ * owns the reduced chunk `rank + 1' at the end. In step `s' of the
+ * allgather, it forwards chunk `rank + 1 - s' and receives chunk
+ * `rank - s'.
+ */
+static ncclResult_t collnet_progress(nccl_ofi_collnet_req_t *req)
+{
+	ncclResult_t ret;
+	nccl_ofi_collnet_comm_t *comm = req->comm;
+	int nranks = comm->nranks;
+
+	while (req->seg_start < req->count) {
+		bool gather = (req->step >= nranks - 1);
+		int s = gather ? req->step - (nranks - 1) : req->step;
+		int send_chunk = (comm->rank + (gather ? 1 : 0) - s + 2 * nranks) % nranks;
+		int recv_chunk = (comm->rank - s - (gather ? 0 : 1) + 2 * nranks) % nranks;
+		size_t send_start, send_count, recv_start, recv_count;
+		int done, size;
+
+		collnet_chunk_range(req, send_chunk, &send_start, &send_count);
+		collnet_chunk_range(req, recv_chunk, &recv_start, &recv_count);
+
+		if (req->send_req == NULL && !req->send_done) {
+			memcpy(comm->send_buff, req->data + send_start * req->elem_size,
+			       send_count * req->elem_size);
+			ret = nccl_net_ofi_isend(comm->send_comm, comm->send_buff,
+						 (int)(send_count * req->elem_size), COLLNET_TAG,
+						 comm->send_mhandle, &req->send_req);
+			if (ret != ncclSuccess) {
+				return ret;
+			}
+		}
+		if (req->recv_req == NULL && !req->recv_done) {
+			void *buff = comm->recv_buff;
+			int sizes = NCCL_OFI_COLLNET_CHUNK_SIZE;
+			int tags = COLLNET_TAG;
+			ret = nccl_net_ofi_irecv(comm->recv_comm, 1, &buff, &sizes, &tags,
+						 &comm->recv_mhandle, &req->recv_req);
+			if (ret != ncclSuccess) {
+				return ret;
+			}
+		}
+
+		if (req->send_req != NULL) {
+			ret = nccl_net_ofi_test(req->send_req, &done, &size);
+			if (ret != ncclSuccess) {
+				return ret;
+			}
+			if (done) {
+				req->send_req = NULL;
+				req->send_done = true;
+			}
+		}
+		if (req->recv_req != NULL) {
+			ret = nccl_net_ofi_test(req->recv_req, &done, &size);
+			if (ret != ncclSuccess) {
+				return ret;
+			}
+			if (done) {
+				req->recv_req = NULL;
+				req->recv_done = true;
+				if ((size_t)size != recv_count * req->elem_size) {
+					NCCL_OFI_WARN("Received chunk of %d bytes, expected %zu",
+						      size, recv_count * req->elem_size);
+					return ncclInternalError;
+				}
+				char *dst = req->data + recv_start * req->elem_size;
+				if (gather) {
+					memcpy(dst, comm->recv_buff, size);
+				} else if (nccl_ofi_reduce(dst, comm->recv_buff, recv_count,
+							   req->dtype, req->op) != 0) {
+					return ncclInternalError;
+				}
+			}
+		}
+
+		if (!req->send_done || !req->recv_done) {
+			/* Not ready yet */
+			return ncclSuccess;
+		}
+
+		req->send_done = false;
+		req->recv_done = false;
+		if (++req->step == 2 * (nranks - 1)) {
+			size_t seg_count = NCCL_OFI_COLLNET_CHUNK_SIZE / req->elem_size * nranks;
+			req->step = 0;
+			req->seg_start += (seg_count < req->count - req->seg_start) ?
+				seg_count : req->count - req->seg_start;
+		}
+	}
+
+	return ncclSuccess;
+}
+
+/*
+ * @brief	Progress the allreduces of `comm' in order
+ *
+ * Completed allreduces leave the queue and are freed by their own
+ * test call.
+ */
+static ncclResult_t collnet_progress_queue(nccl_ofi_collnet_comm_t *comm)
+{
+	while (comm->head != NULL) {
+		nccl_ofi_collnet_req_t *req = comm->head;
+
+		ncclResult_t ret = collnet_progress(req);
+		if (ret != ncclSuccess) {
+			return ret;
+		}
+		if (req->seg_start < req->count) {
+			return ncclSuccess;
+		}
+
+		comm->head = req->next;
+		if (comm->head == NULL) {
+			comm->tail = NULL;
+		}
+	}
+
+	return ncclSuccess;
+}
+
+ncclResult_t nccl_net_ofi_collnet_test(void *request, int *done, int *size)
+{
+	nccl_ofi_collnet_req_t *req = (nccl_ofi_collnet_req_t *)request;
+
+	ncclResult_t ret = collnet_progress_queue(req->comm);
+	if (ret != ncclSuccess) {
+		return ret;
+	}
+
+	*done = (req->seg_start == req->count);
+	if (*done) {
+		if (size != NULL) {
+			*size = (int)(req->count * req->elem_size);
+		}
+		free(req);
+	}
+
+	return ncclSuccess;
+}
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <new>
 #include <pthread.h>
 
 #include "nccl_ofi_deque.h"
@@ -51,3 +52,32 @@ int nccl_ofi_deque_finalize(nccl_ofi_deque_t *deque)
 	free(deque);
 	return 0;
 }
+
+int nccl_ofi_mpsc_queue_init(nccl_ofi_mpsc_queue_t **queue_p)
+{
+	nccl_ofi_mpsc_queue_t *queue = new (std::nothrow) nccl_ofi_mpsc_queue_t;
+
+	if (queue == NULL) {
+		NCCL_OFI_WARN("Failed to allocate MPSC queue");
+		return -ENOMEM;
+	}
+
+	queue->stub.next.store(NULL, std::memory_order_relaxed);
+	queue->head.store(&queue->stub, std::memory_order_relaxed);
+	queue->tail.store(&queue->stub, std::memory_order_relaxed);
+	queue->consumer_active.store(false, std::memory_order_relaxed);
+
+	assert(queue_p);
+	*queue_p = queue;
+
+	return 0;
+}
+
+int nccl_ofi_mpsc_queue_finalize(nccl_ofi_mpsc_queue_t *queue)
+{
+	assert(queue);
+
+	/* Elements are user-allocated, nothing to release but the queue */
+	delete queue;
+	return 0;
+}
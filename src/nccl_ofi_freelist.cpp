@@ -108,7 +108,7 @@ static int freelist_init_internal(size_t entry_size,
 	freelist->entry_init_fn = entry_init_fn;
 	freelist->entry_fini_fn = entry_fini_fn;
 
-	ret = pthread_mutex_init(&freelist->lock, NULL);
+	ret = nccl_net_ofi_mutex_init(&freelist->lock, NCCL_NET_OFI_LOCK_CLASS_FREELIST);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Mutex initialization failed: %s", strerror(ret));
 		free(freelist);
@@ -118,7 +118,7 @@ static int freelist_init_internal(size_t entry_size,
 	ret = nccl_ofi_freelist_add(freelist, initial_entry_count);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Allocating initial freelist entries failed: %d", ret);
-		pthread_mutex_destroy(&freelist->lock);
+		nccl_net_ofi_mutex_destroy(&freelist->lock);
 		free(freelist);
 		return ret;
 
@@ -226,7 +226,7 @@ int nccl_ofi_freelist_fini(nccl_ofi_freelist_t *freelist)
 	freelist->entry_size = 0;
 	freelist->entries = NULL;
 
-	pthread_mutex_destroy(&freelist->lock);
+	nccl_net_ofi_mutex_destroy(&freelist->lock);
 
 	free(freelist);
 
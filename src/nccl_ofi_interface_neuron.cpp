@@ -22,6 +22,8 @@ static ncclResult_t init_v4(ncclDebugLogger_t logFunction)
 	return nccl_net_ofi_init(logFunction);
 }
 
+static ncclResult_t init_v5(ncclDebugLogger_t logFunction);
+
 static ncclResult_t getProperties_v5(int dev_id, ncclNetProperties_v5_t* props)
 {
 	nccl_ofi_properties_t ofi_properties;
@@ -88,7 +90,7 @@ extern "C" {
 
 NCCL_OFI_EXPORT_SYMBOL ncclNet_v5_t ncclNetPlugin_v5 = {
 	.name = "AWS Libfabric",
-	.init = nccl_net_ofi_init,
+	.init = init_v5,
 	.devices = nccl_net_ofi_devices,
 	.getProperties = getProperties_v5,
 	.listen = nccl_net_ofi_listen,
@@ -110,6 +112,12 @@ NCCL_OFI_EXPORT_SYMBOL ncclNet_v5_t ncclNetPlugin_v5 = {
 	.iread = nccl_net_ofi_iread,
 };
 
+NCCL_OFI_EXPORT_SYMBOL nccl_ofi_rma_batch_v1_t ncclNetPluginRmaBatch_v1 = {
+	.name = "AWS Libfabric",
+	.iwriteBatch = nccl_net_ofi_iwrite_batch,
+	.ireadBatch = nccl_net_ofi_iread_batch,
+};
+
 static ncclResult_t getProperties_v4(int dev_id, ncclNetProperties_v4_t *props)
 {
 	nccl_ofi_properties_t ofi_properties;
@@ -152,3 +160,27 @@ NCCL_OFI_EXPORT_SYMBOL ncclNet_v4_t ncclNetPlugin_v4 = {
 };
 
 } /* extern "C" */
+
+
+/*
+ * Replace the data path entry points of the v5 table with the ones
+ * specialized for the protocol selected at init
+ */
+static ncclResult_t init_v5(ncclDebugLogger_t logFunction)
+{
+	ncclResult_t ret = nccl_net_ofi_init(logFunction);
+	if (ret != ncclSuccess) {
+		return ret;
+	}
+
+	const nccl_ofi_api_data_path_t *data_path = nccl_net_ofi_get_data_path();
+	if (data_path == NULL) {
+		return ncclSuccess;
+	}
+
+	ncclNetPlugin_v5.isend = data_path->isend;
+	ncclNetPlugin_v5.irecv = data_path->irecv;
+	ncclNetPlugin_v5.test = data_path->test;
+
+	return ncclSuccess;
+}
@@ -6,6 +6,7 @@
 
 #include "nccl_ofi.h"
 #include "nccl_ofi_api.h"
+#include "nccl_ofi_collnet.h"
 
 
 static ncclResult_t getProperties_v9(int dev_id, ncclNetProperties_v9_t* props)
@@ -55,8 +56,15 @@ static ncclResult_t getProperties_v9(int dev_id, ncclNetProperties_v9_t* props)
 	props->maxRecvs = ofi_properties.max_group_receives;
 	props->netDeviceType = NCCL_NET_DEVICE_HOST;
 	props->netDeviceVersion = NCCL_NET_DEVICE_INVALID_VERSION;
-	props->vProps.ndevs = 1;
-	props->vProps.devs[0] = dev_id;
+	if (ofi_properties.num_member_devs > 0) {
+		props->vProps.ndevs = ofi_properties.num_member_devs;
+		for (int i = 0; i < ofi_properties.num_member_devs; i++) {
+			props->vProps.devs[i] = ofi_properties.member_devs[i];
+		}
+	} else {
+		props->vProps.ndevs = 1;
+		props->vProps.devs[0] = dev_id;
+	}
 	props->maxP2pBytes = ofi_properties.max_p2p_bytes;
 	props->maxCollBytes = ofi_properties.max_coll_bytes;
 
@@ -234,6 +242,73 @@ static ncclResult_t accept_v7(void* listenComm, void** recvComm,
 }
 
 
+static ncclResult_t makeVDevice_v9(int* d, ncclNetVDeviceProps_v9_t* props)
+{
+	static_assert(NCCL_NET_MAX_DEVS_PER_NIC_V9 <= NCCL_OFI_MAX_DEVS_PER_VDEV,
+		      "Plugin cannot fuse as many devices as NCCL asks for");
+	if (props == NULL) {
+		return ncclInvalidArgument;
+	}
+	return nccl_net_ofi_make_vdevice(d, props->ndevs, props->devs);
+}
+
+
+static ncclResult_t getProperties_collnet_v8(int dev_id, ncclNetProperties_v8_t* props)
+{
+	ncclResult_t ret = getProperties_v8(dev_id, props);
+	if (ret != ncclSuccess) {
+		return ret;
+	}
+
+	/* The collective network stages data through host memory */
+	props->ptrSupport = NCCL_PTR_HOST;
+	props->regIsGlobal = 0;
+
+	return ncclSuccess;
+}
+
+
+static ncclResult_t reduceSupport_v8(ncclDataType_t dataType, ncclRedOp_t redOp, int* supported)
+{
+	return nccl_net_ofi_collnet_reduce_support(dataType, redOp, supported);
+}
+
+
+static ncclResult_t iallreduce_v8(void* collComm, void* sendData, void* recvData, int count,
+				  ncclDataType_t dataType, ncclRedOp_t redOp, void* sendMhandle,
+				  void* recvMhandle, void** request)
+{
+	if (count < 0) {
+		return ncclInvalidArgument;
+	}
+	return nccl_net_ofi_collnet_iallreduce(collComm, sendData, recvData, count,
+					       dataType, redOp, request);
+}
+
+
+static ncclResult_t iallgather_v8(void* collComm, void* sendData, int nRecvParts,
+				  ncclNetSGE_v8_t* recvParts, size_t bytesPerRank,
+				  size_t windowOffset, size_t windowBytes,
+				  void* sendMhandle, void** request)
+{
+	NCCL_OFI_WARN("Allgather is not supported by the collective network");
+	return ncclInvalidUsage;
+}
+
+
+static ncclResult_t ireducescatter_v8(void* collComm, int nSendParts, ncclNetSGE_v8_t* sendParts,
+				      void* recvData, size_t bytesPerRank, size_t windowOffset,
+				      size_t windowBytes, ncclDataType_t dataType, ncclRedOp_t redOp,
+				      void* recvMhandle, void** request)
+{
+	NCCL_OFI_WARN("Reduce-scatter is not supported by the collective network");
+	return ncclInvalidUsage;
+}
+
+
+static ncclResult_t init_data_path(ncclDebugLogger_t logFunction);
+
+
 extern "C" {
 
 NCCL_OFI_EXPORT_SYMBOL ncclNet_v2_t ncclNetPlugin_v2 = {
@@ -296,7 +371,7 @@ NCCL_OFI_EXPORT_SYMBOL ncclNet_v4_t ncclNetPlugin_v4 = {
 
 NCCL_OFI_EXPORT_SYMBOL ncclNet_v5_t ncclNetPlugin_v5 = {
 	.name = "Libfabric",
-	.init = nccl_net_ofi_init,
+	.init = init_data_path,
 	.devices = nccl_net_ofi_devices,
 	.getProperties = getProperties_v6,
 	.listen = nccl_net_ofi_listen,
@@ -315,7 +390,7 @@ NCCL_OFI_EXPORT_SYMBOL ncclNet_v5_t ncclNetPlugin_v5 = {
 
 NCCL_OFI_EXPORT_SYMBOL ncclNet_v6_t ncclNetPlugin_v6 = {
         .name = "Libfabric",
-        .init = nccl_net_ofi_init,
+        .init = init_data_path,
         .devices = nccl_net_ofi_devices,
         .getProperties = getProperties_v6,
         .listen = nccl_net_ofi_listen,
@@ -335,7 +410,7 @@ NCCL_OFI_EXPORT_SYMBOL ncclNet_v6_t ncclNetPlugin_v6 = {
 
 NCCL_OFI_EXPORT_SYMBOL ncclNet_v7_t ncclNetPlugin_v7 = {
         .name = "Libfabric",
-        .init = nccl_net_ofi_init,
+        .init = init_data_path,
         .devices = nccl_net_ofi_devices,
         .getProperties = getProperties_v7,
         .listen = nccl_net_ofi_listen,
@@ -357,7 +432,7 @@ NCCL_OFI_EXPORT_SYMBOL ncclNet_v7_t ncclNetPlugin_v7 = {
 
 NCCL_OFI_EXPORT_SYMBOL ncclNet_v8_t ncclNetPlugin_v8 = {
         .name = "Libfabric",
-        .init = nccl_net_ofi_init,
+        .init = init_data_path,
         .devices = nccl_net_ofi_devices,
         .getProperties = getProperties_v8,
         .listen = nccl_net_ofi_listen,
@@ -379,7 +454,7 @@ NCCL_OFI_EXPORT_SYMBOL ncclNet_v8_t ncclNetPlugin_v8 = {
 
 NCCL_OFI_EXPORT_SYMBOL ncclNet_v9_t ncclNetPlugin_v9 = {
         .name = "Libfabric",
-        .init = nccl_net_ofi_init,
+        .init = init_data_path,
         .devices = nccl_net_ofi_devices,
         .getProperties = getProperties_v9,
         .listen = nccl_net_ofi_listen,
@@ -397,12 +472,70 @@ NCCL_OFI_EXPORT_SYMBOL ncclNet_v9_t ncclNetPlugin_v9 = {
         .closeListen = nccl_net_ofi_closeListen,
         .getDeviceMr = NULL,
         .irecvConsumed = NULL,
-        .makeVDevice = NULL,
+        .makeVDevice = makeVDevice_v9,
+};
+
+NCCL_OFI_EXPORT_SYMBOL ncclCollNet_v8_t ncclCollNetPlugin_v8 = {
+	.name = "Libfabric",
+	.init = nccl_net_ofi_collnet_init,
+	.devices = nccl_net_ofi_collnet_devices,
+	.getProperties = getProperties_collnet_v8,
+	.listen = nccl_net_ofi_collnet_listen,
+	.connect = nccl_net_ofi_collnet_connect,
+	.reduceSupport = reduceSupport_v8,
+	.regMr = nccl_net_ofi_collnet_regMr,
+	.regMrDmaBuf = NULL,
+	.deregMr = nccl_net_ofi_collnet_deregMr,
+	.iallreduce = iallreduce_v8,
+	.iallgather = iallgather_v8,
+	.ireducescatter = ireducescatter_v8,
+	.iflush = nccl_net_ofi_collnet_iflush,
+	.test = nccl_net_ofi_collnet_test,
+	.closeColl = nccl_net_ofi_collnet_closeColl,
+	.closeListen = nccl_net_ofi_collnet_closeListen,
 };
 
 } /* extern "C" */
 
 
+/*
+ * Replace the data path entry points of the tables with the ones
+ * specialized for the protocol selected at init. NCCL versions that
+ * copy the entry points before calling init() keep using the generic
+ * ones, which behave the same.
+ */
+static ncclResult_t init_data_path(ncclDebugLogger_t logFunction)
+{
+	ncclResult_t ret = nccl_net_ofi_init(logFunction);
+	if (ret != ncclSuccess) {
+		return ret;
+	}
+
+	const nccl_ofi_api_data_path_t *data_path = nccl_net_ofi_get_data_path();
+	if (data_path == NULL) {
+		return ncclSuccess;
+	}
+
+	ncclNetPlugin_v5.isend = data_path->isend;
+	ncclNetPlugin_v5.irecv = data_path->irecv;
+	ncclNetPlugin_v5.test = data_path->test;
+	ncclNetPlugin_v6.isend = data_path->isend;
+	ncclNetPlugin_v6.irecv = data_path->irecv;
+	ncclNetPlugin_v6.test = data_path->test;
+	ncclNetPlugin_v7.isend = data_path->isend;
+	ncclNetPlugin_v7.irecv = data_path->irecv;
+	ncclNetPlugin_v7.test = data_path->test;
+	ncclNetPlugin_v8.isend = data_path->isend;
+	ncclNetPlugin_v8.irecv = data_path->irecv;
+	ncclNetPlugin_v8.test = data_path->test;
+	ncclNetPlugin_v9.isend = data_path->isend_v9;
+	ncclNetPlugin_v9.irecv = data_path->irecv_v9;
+	ncclNetPlugin_v9.test = data_path->test;
+
+	return ncclSuccess;
+}
+
+
 /*
  * Versions 1.11.0 and prior of the plugin set the name to
  * "AWS Libfabric", requiring NCCL_NET be set to "AWS Libfabric",
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include "nccl_ofi.h"
+#include "nccl_ofi_log.h"
+#include "nccl_ofi_param.h"
+#include "nccl_ofi_pthread.h"
+
+/* Longest message NCCL logs */
+#define LOG_MSG_LEN (1024)
+/* Messages a thread can queue before the drain thread catches up */
+#define LOG_RING_ENTRIES (64)
+/* Interval at which the drain thread logs queued messages */
+#define LOG_DRAIN_INTERVAL_MS (10)
+/* Window of the per call site rate limit */
+#define LOG_RATE_WINDOW_NS (1000000000ULL)
+
+std::atomic<uint32_t> nccl_ofi_log_rate_limit(0);
+std::atomic<bool> nccl_ofi_log_async(false);
+
+/* Most verbose level queued, following NCCL_DEBUG */
+static std::atomic<int> log_level(NCCL_LOG_WARN);
+
+typedef struct log_entry {
+	ncclDebugLogLevel level;
+	unsigned long flags;
+	/* __PRETTY_FUNCTION__ of the call site, which has static storage */
+	const char *filefunc;
+	int line;
+	char msg[LOG_MSG_LEN];
+} log_entry_t;
+
+/*
+ * Messages of a thread. The thread produces entries and the drain
+ * thread, or a thread flushing the rings, consumes them under
+ * rings_lock.
+ */
+typedef struct log_ring {
+	log_entry_t entries[LOG_RING_ENTRIES];
+	alignas(NCCL_OFI_DEFAULT_CPU_CACHE_LINE_SIZE) std::atomic<uint64_t> head;
+	alignas(NCCL_OFI_DEFAULT_CPU_CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+	/* Messages dropped because the ring was full */
+	std::atomic<uint64_t> dropped;
+	/* Set when the thread exits, so that the ring is freed once drained */
+	std::atomic<bool> orphaned;
+	struct log_ring *next;
+} log_ring_t;
+
+/* Rings of all threads that logged asynchronously */
+static pthread_mutex_t rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static log_ring_t *rings = NULL;
+
+/* Ring of the calling thread, handed over to the drain thread at exit */
+struct log_thread_ring {
+	log_ring_t *ring = NULL;
+
+	~log_thread_ring()
+	{
+		if (ring != NULL) {
+			ring->orphaned.store(true, std::memory_order_release);
+			ring = NULL;
+		}
+	}
+};
+static thread_local log_thread_ring thread_ring;
+
+/* State of the drain thread */
+static pthread_mutex_t drain_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t drain_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t drain_thread;
+static bool drain_running = false;
+static bool drain_stop = false;
+
+bool nccl_ofi_log_site_allow_limited(nccl_ofi_log_site_t *site, uint32_t limit,
+				     uint64_t *suppressed)
+{
+	struct timespec now_ts;
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now_ts);
+	uint64_t now = (uint64_t)now_ts.tv_sec * 1000000000ULL + now_ts.tv_nsec;
+	uint64_t start = site->window_start.load(std::memory_order_relaxed);
+
+	if (now - start >= LOG_RATE_WINDOW_NS) {
+		/* A single thread opens the new window */
+		if (site->window_start.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+			site->count.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	if (site->count.fetch_add(1, std::memory_order_relaxed) >= limit) {
+		site->suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	*suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+	return true;
+}
+
+static log_ring_t *log_get_thread_ring(void)
+{
+	log_ring_t *ring = thread_ring.ring;
+
+	if (OFI_LIKELY(ring != NULL)) {
+		return ring;
+	}
+
+	ring = (log_ring_t *)calloc(1, sizeof(log_ring_t));
+	if (ring == NULL) {
+		return NULL;
+	}
+
+	nccl_net_ofi_mutex_lock(&rings_lock);
+	ring->next = rings;
+	rings = ring;
+	nccl_net_ofi_mutex_unlock(&rings_lock);
+
+	thread_ring.ring = ring;
+	return ring;
+}
+
+void nccl_ofi_log_enqueue(ncclDebugLogLevel level, unsigned long flags, const char *filefunc,
+			  int line, const char *fmt, ...)
+{
+	log_ring_t *ring;
+	va_list args;
+
+	if ((int)level > log_level.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	ring = log_get_thread_ring();
+	if (OFI_UNLIKELY(ring == NULL || !nccl_ofi_log_async.load(std::memory_order_relaxed))) {
+		char msg[LOG_MSG_LEN];
+
+		va_start(args, fmt);
+		vsnprintf(msg, sizeof(msg), fmt, args);
+		va_end(args);
+		(*ofi_log_function)(level, flags, filefunc, line, "%s", msg);
+		return;
+	}
+
+	uint64_t head = ring->head.load(std::memory_order_relaxed);
+	uint64_t tail = ring->tail.load(std::memory_order_acquire);
+	if (OFI_UNLIKELY(head - tail == LOG_RING_ENTRIES)) {
+		ring->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	log_entry_t *entry = &ring->entries[head % LOG_RING_ENTRIES];
+	entry->level = level;
+	entry->flags = flags;
+	entry->filefunc = filefunc;
+	entry->line = line;
+	va_start(args, fmt);
+	vsnprintf(entry->msg, sizeof(entry->msg), fmt, args);
+	va_end(args);
+
+	ring->head.store(head + 1, std::memory_order_release);
+}
+
+/*
+ * @brief	Log the queued messages of all rings, and free the rings of
+ *		exited threads
+ */
+static void log_drain_rings(void)
+{
+	nccl_net_ofi_mutex_lock(&rings_lock);
+
+	log_ring_t **prev = &rings;
+	while (*prev != NULL) {
+		log_ring_t *ring = *prev;
+		/* Read before draining, so that an orphaned ring is empty
+		 * once drained */
+		bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+		uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+		uint64_t head = ring->head.load(std::memory_order_acquire);
+
+		for (; tail != head; tail++) {
+			log_entry_t *entry = &ring->entries[tail % LOG_RING_ENTRIES];
+			(*ofi_log_function)(entry->level, entry->flags, entry->filefunc,
+					    entry->line, "%s", entry->msg);
+		}
+		ring->tail.store(tail, std::memory_order_release);
+
+		uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+		if (dropped > 0) {
+			(*ofi_log_function)(NCCL_LOG_WARN, NCCL_ALL, __PRETTY_FUNCTION__, __LINE__,
+					    "NET/OFI Dropped %" PRIu64 " log messages of a thread", dropped);
+		}
+
+		if (orphaned) {
+			*prev = ring->next;
+			free(ring);
+		} else {
+			prev = &ring->next;
+		}
+	}
+
+	nccl_net_ofi_mutex_unlock(&rings_lock);
+}
+
+static void *log_drain_thread_fn(void *arg)
+{
+	nccl_net_ofi_mutex_lock(&drain_lock);
+	while (!drain_stop) {
+		nccl_net_ofi_mutex_unlock(&drain_lock);
+		log_drain_rings();
+		nccl_net_ofi_mutex_lock(&drain_lock);
+
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_nsec += LOG_DRAIN_INTERVAL_MS * 1000000;
+		if (deadline.tv_nsec >= 1000000000) {
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000;
+		}
+		while (!drain_stop && pthread_cond_timedwait(&drain_cond, &drain_lock, &deadline) == 0) {
+		}
+	}
+	nccl_net_ofi_mutex_unlock(&drain_lock);
+
+	return NULL;
+}
+
+/*
+ * @brief	Most verbose level NCCL logs, so that messages it would
+ *		discard are not formatted
+ *
+ * Warnings are kept when NCCL_DEBUG is not set, as the logger of the
+ * application may not follow it.
+ */
+static int log_level_from_env(void)
+{
+	const char *env = getenv("NCCL_DEBUG");
+
+	if (env == NULL) {
+		return NCCL_LOG_WARN;
+	} else if (strcasecmp(env, "VERSION") == 0) {
+		return NCCL_LOG_VERSION;
+	} else if (strcasecmp(env, "INFO") == 0) {
+		return NCCL_LOG_INFO;
+	} else if (strcasecmp(env, "ABORT") == 0) {
+		return NCCL_LOG_ABORT;
+	} else if (strcasecmp(env, "TRACE") == 0) {
+		return NCCL_LOG_TRACE;
+	}
+	return NCCL_LOG_WARN;
+}
+
+void nccl_ofi_log_init(void)
+{
+	uint64_t rate_limit = ofi_nccl_log_rate_limit();
+	int ret;
+
+	nccl_ofi_log_rate_limit.store((uint32_t)std::min(rate_limit, (uint64_t)UINT32_MAX),
+				      std::memory_order_relaxed);
+
+	if (ofi_nccl_log_async() == 0) {
+		return;
+	}
+
+	log_level.store(log_level_from_env(), std::memory_order_relaxed);
+
+	nccl_net_ofi_mutex_lock(&drain_lock);
+	if (!drain_running) {
+		drain_stop = false;
+		ret = pthread_create(&drain_thread, NULL, log_drain_thread_fn, NULL);
+		if (ret != 0) {
+			NCCL_OFI_WARN("Unable to start log drain thread: %s", strerror(ret));
+		} else {
+			drain_running = true;
+			nccl_ofi_log_async.store(true, std::memory_order_relaxed);
+		}
+	}
+	nccl_net_ofi_mutex_unlock(&drain_lock);
+}
+
+void nccl_ofi_log_fini(void)
+{
+	nccl_ofi_log_async.store(false, std::memory_order_relaxed);
+
+	nccl_net_ofi_mutex_lock(&drain_lock);
+	if (!drain_running) {
+		nccl_net_ofi_mutex_unlock(&drain_lock);
+		return;
+	}
+	drain_stop = true;
+	pthread_cond_signal(&drain_cond);
+	nccl_net_ofi_mutex_unlock(&drain_lock);
+
+	pthread_join(drain_thread, NULL);
+
+	nccl_net_ofi_mutex_lock(&drain_lock);
+	drain_running = false;
+	nccl_net_ofi_mutex_unlock(&drain_lock);
+
+	/* Rings of live threads are kept, as the threads still point to
+	 * them */
+	log_drain_rings();
+}
+
+void nccl_ofi_log_flush(void)
+{
+	log_drain_rings();
+}
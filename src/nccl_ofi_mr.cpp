@@ -7,9 +7,15 @@
 #include <errno.h>
 #include <stdlib.h>
 
+#include <atomic>
+
 #include "nccl_ofi_mr.h"
 #include "nccl_ofi_pthread.h"
 
+/* Registrations issued and released by all transports */
+static std::atomic<uint64_t> mr_num_regs(0);
+static std::atomic<uint64_t> mr_num_deregs(0);
+
 nccl_ofi_mr_cache_t *nccl_ofi_mr_cache_init(size_t init_num_entries,
 					    size_t mr_cache_page_size)
 {
@@ -274,3 +280,23 @@ int nccl_ofi_mr_cache_del_entry(nccl_ofi_mr_cache_t *cache, void *handle)
 out:
 	return ret;
 }
+
+void nccl_ofi_mr_count_reg(void)
+{
+	mr_num_regs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void nccl_ofi_mr_count_dereg(void)
+{
+	mr_num_deregs.fetch_add(1, std::memory_order_relaxed);
+}
+
+extern "C" NCCL_OFI_EXPORT_SYMBOL void nccl_ofi_mr_get_reg_counts(uint64_t *num_regs,
+								  uint64_t *num_live)
+{
+	uint64_t deregs = mr_num_deregs.load(std::memory_order_relaxed);
+	uint64_t regs = mr_num_regs.load(std::memory_order_relaxed);
+
+	*num_regs = regs;
+	*num_live = regs - deregs;
+}
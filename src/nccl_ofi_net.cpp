@@ -72,6 +72,17 @@ size_t system_page_size = 0;
 /* Alignment used for MR cache and key creation */
 size_t mr_cache_alignment = 0;
 
+static int req_complete_test(nccl_net_ofi_req_t *req, int *done, int *size)
+{
+	*done = 1;
+	if (size != NULL) {
+		*size = 0;
+	}
+	return 0;
+}
+
+nccl_net_ofi_req_t nccl_net_ofi_req_complete = { .test = req_complete_test };
+
 /*
  * @brief	Allocate memory region for memory registration
  *
@@ -329,6 +340,9 @@ int nccl_net_ofi_create_plugin(nccl_net_ofi_plugin_t **plugin_p)
 		goto exit;
 	}
 
+	/* Failing to watch the control file only loses runtime tuning */
+	(void)nccl_ofi_param_watch_start();
+
 	*plugin_p = plugin;
 
  exit:
@@ -661,11 +675,15 @@ static int nccl_net_ofi_plugin_assign_device(nccl_net_ofi_plugin_t *plugin,
 					     size_t device_index,
 					     nccl_net_ofi_device_t *device)
 {
-	if (device_index >= plugin->p_num_devs) {
+	/* Devices are appended after the initial ones */
+	if (device_index > plugin->p_num_devs || device_index >= plugin->p_max_devs) {
 		return -ENOSPC;
 	}
 
 	plugin->p_devs[device_index] = device;
+	if (device_index == plugin->p_num_devs) {
+		plugin->p_num_devs++;
+	}
 
 	return 0;
 }
@@ -692,8 +710,10 @@ static size_t nccl_net_ofi_plugin_get_num_devices(nccl_net_ofi_plugin_t *plugin)
 int nccl_net_ofi_plugin_init(nccl_net_ofi_plugin_t *plugin,
 			     size_t num_devices)
 {
+	size_t max_devices = num_devices + NCCL_OFI_MAX_VIRTUAL_DEVICES;
+
 	plugin->p_devs =
-		(nccl_net_ofi_device_t **)calloc(num_devices, sizeof(nccl_net_ofi_device_t *));
+		(nccl_net_ofi_device_t **)calloc(max_devices, sizeof(nccl_net_ofi_device_t *));
 	if (plugin->p_devs == NULL) {
 		NCCL_OFI_WARN("Unable to allocate "
 			      "nccl_net_ofi_device_t pointer array");
@@ -701,10 +721,12 @@ int nccl_net_ofi_plugin_init(nccl_net_ofi_plugin_t *plugin,
 	}
 
 	plugin->p_num_devs = num_devices;
+	plugin->p_max_devs = max_devices;
 
 	plugin->assign_device = nccl_net_ofi_plugin_assign_device;
 	plugin->get_device = nccl_net_ofi_plugin_get_device;
 	plugin->get_num_devices = nccl_net_ofi_plugin_get_num_devices;
+	plugin->make_virtual_device = NULL;
 	plugin->release_plugin = nccl_net_ofi_plugin_fini;
 
 	return 0;
@@ -822,6 +844,8 @@ int nccl_net_ofi_device_init(nccl_net_ofi_device_t *device, nccl_net_ofi_plugin_
 		goto exit;
 	}
 
+	device->num_member_devs = 0;
+
 	device->get_properties = NULL;
 	device->get_domain = nccl_net_ofi_device_get_domain;
 	device->get_ep = nccl_net_ofi_device_get_ep;
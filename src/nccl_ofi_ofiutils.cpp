@@ -220,7 +220,8 @@ int nccl_ofi_ofiutils_get_providers(const char *prov_include,
 
 
 int nccl_ofi_ofiutils_init_connection(struct fi_info *info, struct fid_domain *domain,
-				      struct fid_ep **ep, struct fid_av **av, struct fid_cq **cq)
+				      struct fid_ep **ep, struct fid_av **av, struct fid_cq **cq,
+				      struct fid_cntr *write_cntr)
 {
 	int ret = 0;
 	struct fi_av_attr av_attr = {};
@@ -258,13 +259,30 @@ int nccl_ofi_ofiutils_init_connection(struct fi_info *info, struct fid_domain *d
 	}
 
 	/* Bind CQ to endpoint */
-	ret = fi_ep_bind(*ep, &((*cq)->fid), FI_SEND | FI_RECV);
+	if (write_cntr == NULL) {
+		ret = fi_ep_bind(*ep, &((*cq)->fid), FI_SEND | FI_RECV);
+	} else {
+		ret = fi_ep_bind(*ep, &((*cq)->fid), FI_TRANSMIT | FI_SELECTIVE_COMPLETION);
+		if (ret == 0) {
+			ret = fi_ep_bind(*ep, &((*cq)->fid), FI_RECV);
+		}
+	}
 	if (OFI_UNLIKELY(ret != 0)) {
 		NCCL_OFI_WARN("Couldn't bind EP-CQ. RC: %d, ERROR: %s",
 			      ret, fi_strerror(-ret));
 		goto error;
 	}
 
+	/* Bind write counter to endpoint */
+	if (write_cntr != NULL) {
+		ret = fi_ep_bind(*ep, &write_cntr->fid, FI_WRITE);
+		if (OFI_UNLIKELY(ret != 0)) {
+			NCCL_OFI_WARN("Couldn't bind EP-CNTR. RC: %d, ERROR: %s",
+				      ret, fi_strerror(-ret));
+			goto error;
+		}
+	}
+
 	/* Bind AV to endpoint */
 	ret = fi_ep_bind(*ep, &((*av)->fid), 0);
 	if (OFI_UNLIKELY(ret != 0)) {
@@ -23,3 +23,212 @@
  */
 #define OFI_NCCL_PARAM_DEFINE 1
 #include "nccl_ofi_param.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <time.h>
+
+std::atomic<uint64_t> nccl_ofi_param_epoch(0);
+
+nccl_ofi_param_dynamic_base *nccl_ofi_param_dynamic_base::head = NULL;
+
+nccl_ofi_param_dynamic_base::nccl_ofi_param_dynamic_base(const char *env_name_arg)
+	: env_name(env_name_arg)
+{
+	/* Constructed during static initialization, before any thread
+	 * can walk the list */
+	next = head;
+	head = this;
+}
+
+nccl_ofi_param_dynamic_base *nccl_ofi_param_dynamic_base::find(const char *name)
+{
+	for (nccl_ofi_param_dynamic_base *param = head; param != NULL; param = param->next) {
+		if (strcmp(param->env_name, name) == 0) {
+			return param;
+		}
+	}
+	return NULL;
+}
+
+/* Serializes reloads */
+static pthread_mutex_t reload_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static char *trim(char *str)
+{
+	char *end;
+
+	while (isspace((unsigned char)*str)) {
+		str++;
+	}
+	end = str + strlen(str);
+	while (end > str && isspace((unsigned char)end[-1])) {
+		end--;
+	}
+	*end = '\0';
+	return str;
+}
+
+int nccl_ofi_param_reload(const char *path)
+{
+	int num_changed = 0;
+	char *line = NULL;
+	size_t line_cap = 0;
+	unsigned int line_num = 0;
+	FILE *file;
+
+	file = fopen(path, "r");
+	if (file == NULL) {
+		int ret = -errno;
+		NCCL_OFI_WARN("Unable to open control file %s: %s", path, strerror(errno));
+		return ret;
+	}
+
+	nccl_net_ofi_mutex_lock(&reload_lock);
+
+	while (getline(&line, &line_cap, file) != -1) {
+		char name[128];
+		char *str = line;
+		char *value;
+		nccl_ofi_param_dynamic_base *param;
+		int ret;
+
+		line_num++;
+
+		str[strcspn(str, "#\n")] = '\0';
+		str = trim(str);
+		if (*str == '\0') {
+			continue;
+		}
+
+		value = strchr(str, '=');
+		if (value == NULL) {
+			NCCL_OFI_WARN("Control file %s:%u: expected NAME=VALUE", path, line_num);
+			continue;
+		}
+		*value++ = '\0';
+		value = trim(value);
+		str = trim(str);
+
+		/* The prefix is optional */
+		snprintf(name, sizeof(name), "%s%s",
+			 (strncmp(str, "OFI_NCCL_", strlen("OFI_NCCL_")) == 0) ? "" : "OFI_NCCL_", str);
+
+		param = nccl_ofi_param_dynamic_base::find(name);
+		if (param == NULL) {
+			NCCL_OFI_WARN("Control file %s:%u: %s is not a dynamic parameter",
+				      path, line_num, name);
+			continue;
+		}
+
+		ret = param->set(value);
+		if (ret < 0) {
+			NCCL_OFI_WARN("Control file %s:%u: invalid value %s for %s",
+				      path, line_num, value, name);
+		} else if (ret > 0) {
+			NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "Setting %s to %s from control file",
+				      name, value);
+			num_changed++;
+		}
+	}
+
+	/* Publish the new values */
+	if (num_changed > 0) {
+		nccl_ofi_param_epoch.fetch_add(1, std::memory_order_release);
+	}
+
+	nccl_net_ofi_mutex_unlock(&reload_lock);
+
+	free(line);
+	fclose(file);
+	return num_changed;
+}
+
+/* State of the control file watcher */
+static pthread_mutex_t watch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t watch_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t watch_thread;
+static bool watch_running = false;
+static bool watch_stop = false;
+
+static void *watch_thread_fn(void *arg)
+{
+	const char *path = (const char *)arg;
+	uint64_t interval_ms = ofi_nccl_control_file_interval_ms();
+	struct timespec last_mtime = {};
+	bool first = true;
+
+	nccl_net_ofi_mutex_lock(&watch_lock);
+	while (!watch_stop) {
+		struct stat st;
+
+		/* Unchanged files, including missing ones, are skipped */
+		if (stat(path, &st) == 0 &&
+		    (first || st.st_mtim.tv_sec != last_mtime.tv_sec ||
+		     st.st_mtim.tv_nsec != last_mtime.tv_nsec)) {
+			last_mtime = st.st_mtim;
+			nccl_net_ofi_mutex_unlock(&watch_lock);
+			nccl_ofi_param_reload(path);
+			nccl_net_ofi_mutex_lock(&watch_lock);
+		}
+		first = false;
+
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += interval_ms / 1000;
+		deadline.tv_nsec += (interval_ms % 1000) * 1000000;
+		if (deadline.tv_nsec >= 1000000000) {
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000;
+		}
+		while (!watch_stop && pthread_cond_timedwait(&watch_cond, &watch_lock, &deadline) == 0) {
+		}
+	}
+	nccl_net_ofi_mutex_unlock(&watch_lock);
+
+	return NULL;
+}
+
+int nccl_ofi_param_watch_start(void)
+{
+	const char *path = ofi_nccl_control_file();
+	int ret = 0;
+
+	if (path == NULL || *path == '\0') {
+		return 0;
+	}
+
+	nccl_net_ofi_mutex_lock(&watch_lock);
+	if (!watch_running) {
+		watch_stop = false;
+		ret = -pthread_create(&watch_thread, NULL, watch_thread_fn, (void *)path);
+		if (ret != 0) {
+			NCCL_OFI_WARN("Unable to start control file watcher: %s", strerror(-ret));
+		} else {
+			watch_running = true;
+			NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "Watching control file %s", path);
+		}
+	}
+	nccl_net_ofi_mutex_unlock(&watch_lock);
+
+	return ret;
+}
+
+void nccl_ofi_param_watch_stop(void)
+{
+	nccl_net_ofi_mutex_lock(&watch_lock);
+	if (!watch_running) {
+		nccl_net_ofi_mutex_unlock(&watch_lock);
+		return;
+	}
+	watch_stop = true;
+	pthread_cond_signal(&watch_cond);
+	nccl_net_ofi_mutex_unlock(&watch_lock);
+
+	pthread_join(watch_thread, NULL);
+
+	nccl_net_ofi_mutex_lock(&watch_lock);
+	watch_running = false;
+	nccl_net_ofi_mutex_unlock(&watch_lock);
+}
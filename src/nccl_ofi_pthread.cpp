@@ -5,8 +5,19 @@
 
 #include "config.h"
 
+#include <assert.h>
+#include <linux/futex.h>
 #include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
 
 #include "nccl_ofi_param.h"
 #include "nccl_ofi_pthread.h"
@@ -14,6 +25,20 @@
 static pthread_once_t errorcheck_once = PTHREAD_ONCE_INIT;
 static pthread_mutexattr_t errorcheck_attr;
 
+static pthread_once_t adaptive_classes_once = PTHREAD_ONCE_INIT;
+static bool adaptive_classes[NCCL_NET_OFI_LOCK_CLASS_NUM];
+
+static const char *lock_class_names[NCCL_NET_OFI_LOCK_CLASS_NUM] = {
+	"freelist",
+	"msgbuff",
+	"scheduler",
+};
+
+/* Spin rounds of a contended adaptive mutex before parking; the
+ * pause count doubles every round up to the given maximum */
+#define ADAPTIVE_MUTEX_SPIN_ROUNDS (10)
+#define ADAPTIVE_MUTEX_MAX_PAUSES (64)
+
 
 static void errorcheck_init(void)
 {
@@ -76,3 +101,364 @@ nccl_net_ofi_mutex_destroy(pthread_mutex_t *mutex)
 
 	return ret;
 }
+
+
+static void adaptive_classes_init(void)
+{
+	const char *param = ofi_nccl_adaptive_mutex();
+	char *classes, *saveptr = NULL;
+
+	if (param == NULL || param[0] == '\0') {
+		return;
+	}
+
+	classes = strdup(param);
+	if (classes == NULL) {
+		NCCL_OFI_WARN("Unable to parse OFI_NCCL_ADAPTIVE_MUTEX, using pthread mutexes");
+		return;
+	}
+
+	for (char *name = strtok_r(classes, ",", &saveptr); name != NULL;
+	     name = strtok_r(NULL, ",", &saveptr)) {
+		bool found = false;
+		for (int i = 0; i < NCCL_NET_OFI_LOCK_CLASS_NUM; i++) {
+			if (strcmp(name, "all") == 0 || strcmp(name, lock_class_names[i]) == 0) {
+				adaptive_classes[i] = true;
+				found = true;
+			}
+		}
+		if (!found) {
+			NCCL_OFI_WARN("Ignoring unknown lock class \"%s\" in OFI_NCCL_ADAPTIVE_MUTEX", name);
+		}
+	}
+
+	free(classes);
+}
+
+
+int
+nccl_net_ofi_mutex_init(nccl_net_ofi_adaptive_mutex_t *mutex, nccl_net_ofi_lock_class_t lock_class)
+{
+	int ret;
+
+	assert(lock_class < NCCL_NET_OFI_LOCK_CLASS_NUM);
+
+	ret = pthread_once(&adaptive_classes_once, adaptive_classes_init);
+	if (ret != 0) {
+		NCCL_OFI_WARN("pthread_once failed: %s", strerror(ret));
+		return ret;
+	}
+
+	mutex->state.store(0, std::memory_order_relaxed);
+
+	/* Errorcheck mutexes catch misuse that the adaptive mutex
+	 * cannot, so they take precedence */
+	mutex->adaptive = adaptive_classes[lock_class] && ofi_nccl_errorcheck_mutex() == 0;
+	if (mutex->adaptive) {
+		NCCL_OFI_TRACE(NCCL_NET, "Using adaptive mutex for %s lock",
+			       lock_class_names[lock_class]);
+		return 0;
+	}
+
+	return nccl_net_ofi_mutex_init(&mutex->mutex, NULL);
+}
+
+
+int
+nccl_net_ofi_mutex_destroy(nccl_net_ofi_adaptive_mutex_t *mutex)
+{
+	if (!mutex->adaptive) {
+		return nccl_net_ofi_mutex_destroy(&mutex->mutex);
+	}
+
+	if (mutex->state.load(std::memory_order_relaxed) != 0) {
+		NCCL_OFI_WARN("Destroying locked adaptive mutex %p", mutex);
+		return EBUSY;
+	}
+
+	return 0;
+}
+
+
+static inline void adaptive_mutex_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield" ::: "memory");
+#else
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+
+static inline long adaptive_mutex_futex(std::atomic<uint32_t> *state, int op, uint32_t val)
+{
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+		      "futex word must be a plain 32 bit integer");
+	return syscall(SYS_futex, reinterpret_cast<uint32_t *>(state), op, val, NULL, NULL, 0);
+}
+
+
+void nccl_net_ofi_adaptive_mutex_lock_slow(nccl_net_ofi_adaptive_mutex_t *mutex)
+{
+	unsigned int pauses = 1;
+
+	for (int round = 0; round < ADAPTIVE_MUTEX_SPIN_ROUNDS; round++) {
+		for (unsigned int i = 0; i < pauses; i++) {
+			adaptive_mutex_pause();
+		}
+		/* Only attempt the atomic once the lock looks free to
+		 * keep the cache line shared while spinning */
+		if (mutex->state.load(std::memory_order_relaxed) == 0 &&
+		    nccl_net_ofi_adaptive_mutex_try(mutex)) {
+			return;
+		}
+		pauses = std::min(pauses * 2, (unsigned int)ADAPTIVE_MUTEX_MAX_PAUSES);
+	}
+
+	/* Announce a waiter and park until the lock was released. The
+	 * lock is then held in state 2, which may cause a spurious wake
+	 * up on unlock but never a lost one. */
+	while (mutex->state.exchange(2, std::memory_order_acquire) != 0) {
+		long ret = adaptive_mutex_futex(&mutex->state, FUTEX_WAIT_PRIVATE, 2);
+		if (OFI_UNLIKELY(ret != 0 && errno != EAGAIN && errno != EINTR)) {
+			NCCL_OFI_WARN("futex wait failed: %s", strerror(errno));
+			abort();
+		}
+	}
+}
+
+
+void nccl_net_ofi_adaptive_mutex_unlock_slow(nccl_net_ofi_adaptive_mutex_t *mutex,
+					     uint32_t prev_state, const char *file, size_t line)
+{
+	if (OFI_UNLIKELY(prev_state == 0)) {
+		(*ofi_log_function)(NCCL_LOG_WARN, NCCL_ALL, file, line,
+				    "NET/OFI unlock of unlocked adaptive mutex %p", mutex);
+		abort();
+	}
+
+	long ret = adaptive_mutex_futex(&mutex->state, FUTEX_WAKE_PRIVATE, 1);
+	if (OFI_UNLIKELY(ret < 0)) {
+		NCCL_OFI_WARN("futex wake failed: %s", strerror(errno));
+		abort();
+	}
+}
+
+
+#if NCCL_OFI_MUTEX_PROFILING
+
+/*
+ * Mutex contention profiler
+ *
+ * Statistics are kept per lock site, i.e. per file:line of the
+ * nccl_net_ofi_mutex_lock()/trylock() call. Sites are claimed lazily
+ * in a fixed size open addressing table so that the lock path never
+ * allocates or takes another lock. Wait and hold times are recorded
+ * in log2 nanosecond histograms.
+ */
+
+#define MUTEX_PROF_MAX_SITES (1024)
+#define MUTEX_PROF_HIST_BUCKETS (40)
+#define MUTEX_PROF_MAX_HELD (32)
+
+typedef struct {
+	std::atomic<const char *> file;
+	std::atomic<size_t> line;
+	std::atomic<uint64_t> acquisitions;
+	std::atomic<uint64_t> contended;
+	std::atomic<uint64_t> wait_ns;
+	std::atomic<uint64_t> max_wait_ns;
+	std::atomic<uint64_t> hold_ns;
+	std::atomic<uint64_t> max_hold_ns;
+	std::atomic<uint64_t> wait_hist[MUTEX_PROF_HIST_BUCKETS];
+	std::atomic<uint64_t> hold_hist[MUTEX_PROF_HIST_BUCKETS];
+} mutex_prof_site_t;
+
+/* Mutex currently held by this thread and when it was acquired */
+typedef struct {
+	const void *mutex;
+	mutex_prof_site_t *site;
+	uint64_t acquired_ns;
+} mutex_prof_held_t;
+
+static mutex_prof_site_t mutex_prof_sites[MUTEX_PROF_MAX_SITES];
+static std::atomic<uint64_t> mutex_prof_dropped_sites(0);
+
+static thread_local mutex_prof_held_t mutex_prof_held[MUTEX_PROF_MAX_HELD];
+static thread_local size_t mutex_prof_num_held = 0;
+
+
+static inline size_t mutex_prof_bucket(uint64_t ns)
+{
+	size_t bucket = (ns == 0) ? 0 : 64 - __builtin_clzll(ns);
+	return std::min(bucket, (size_t)MUTEX_PROF_HIST_BUCKETS - 1);
+}
+
+
+static inline void mutex_prof_update_max(std::atomic<uint64_t> &max, uint64_t val)
+{
+	uint64_t cur = max.load(std::memory_order_relaxed);
+	while (cur < val && !max.compare_exchange_weak(cur, val, std::memory_order_relaxed)) {
+	}
+}
+
+
+/*
+ * Find or claim the table entry of a lock site. File names are
+ * string literals, so the pointer identifies the file.
+ */
+static mutex_prof_site_t *mutex_prof_site(const char *file, size_t line)
+{
+	size_t hash = ((uintptr_t)file >> 3) * 31 + line;
+
+	for (size_t i = 0; i < MUTEX_PROF_MAX_SITES; i++) {
+		mutex_prof_site_t *site = &mutex_prof_sites[(hash + i) % MUTEX_PROF_MAX_SITES];
+		const char *site_file = site->file.load(std::memory_order_acquire);
+
+		if (site_file == NULL) {
+			/* Claim the line first so that concurrent lookups
+			 * of the same site never see a partial key */
+			size_t expected_line = 0;
+			if (site->line.compare_exchange_strong(expected_line, line,
+								std::memory_order_acq_rel)) {
+				site->file.store(file, std::memory_order_release);
+				return site;
+			}
+			/* Lost the race; wait for the winner to publish its file */
+			while ((site_file = site->file.load(std::memory_order_acquire)) == NULL) {
+			}
+		}
+
+		if (site_file == file && site->line.load(std::memory_order_relaxed) == line) {
+			return site;
+		}
+	}
+
+	return NULL;
+}
+
+
+void nccl_net_ofi_mutex_prof_acquired(const void *mutex, const char *file, size_t line,
+				      bool contended, uint64_t wait_ns)
+{
+	mutex_prof_site_t *site = mutex_prof_site(file, line);
+	if (OFI_UNLIKELY(site == NULL)) {
+		mutex_prof_dropped_sites.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+	if (contended) {
+		site->contended.fetch_add(1, std::memory_order_relaxed);
+		site->wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+		mutex_prof_update_max(site->max_wait_ns, wait_ns);
+	}
+	site->wait_hist[mutex_prof_bucket(wait_ns)].fetch_add(1, std::memory_order_relaxed);
+
+	if (OFI_LIKELY(mutex_prof_num_held < MUTEX_PROF_MAX_HELD)) {
+		mutex_prof_held_t *held = &mutex_prof_held[mutex_prof_num_held++];
+		held->mutex = mutex;
+		held->site = site;
+		held->acquired_ns = nccl_net_ofi_mutex_prof_now();
+	}
+}
+
+
+void nccl_net_ofi_mutex_prof_released(const void *mutex)
+{
+	/* Locks are usually released in reverse acquisition order */
+	for (size_t i = mutex_prof_num_held; i > 0; i--) {
+		mutex_prof_held_t *held = &mutex_prof_held[i - 1];
+		if (held->mutex != mutex) {
+			continue;
+		}
+
+		uint64_t hold_ns = nccl_net_ofi_mutex_prof_now() - held->acquired_ns;
+		mutex_prof_site_t *site = held->site;
+		site->hold_ns.fetch_add(hold_ns, std::memory_order_relaxed);
+		mutex_prof_update_max(site->max_hold_ns, hold_ns);
+		site->hold_hist[mutex_prof_bucket(hold_ns)].fetch_add(1, std::memory_order_relaxed);
+
+		*held = mutex_prof_held[--mutex_prof_num_held];
+		return;
+	}
+}
+
+
+/* Format the non-empty buckets of a histogram as "<=bound:count" pairs */
+static void mutex_prof_format_hist(const std::atomic<uint64_t> *hist, char *buf, size_t len)
+{
+	size_t off = 0;
+
+	buf[0] = '\0';
+	for (size_t i = 0; i < MUTEX_PROF_HIST_BUCKETS && off < len; i++) {
+		uint64_t count = hist[i].load(std::memory_order_relaxed);
+		if (count == 0) {
+			continue;
+		}
+		int ret = snprintf(buf + off, len - off, " <%" PRIu64 "ns:%" PRIu64,
+				   (uint64_t)1 << i, count);
+		if (ret < 0) {
+			break;
+		}
+		off += ret;
+	}
+}
+
+
+void nccl_net_ofi_mutex_prof_report(void)
+{
+	std::vector<mutex_prof_site_t *> sites;
+	char wait_hist[512];
+	char hold_hist[512];
+
+	for (size_t i = 0; i < MUTEX_PROF_MAX_SITES; i++) {
+		mutex_prof_site_t *site = &mutex_prof_sites[i];
+		if (site->file.load(std::memory_order_acquire) != NULL &&
+		    site->acquisitions.load(std::memory_order_relaxed) > 0) {
+			sites.push_back(site);
+		}
+	}
+
+	std::sort(sites.begin(), sites.end(),
+		  [](const mutex_prof_site_t *a, const mutex_prof_site_t *b) {
+			  return a->wait_ns.load(std::memory_order_relaxed) >
+				 b->wait_ns.load(std::memory_order_relaxed);
+		  });
+
+	NCCL_OFI_INFO(NCCL_INIT | NCCL_NET,
+		      "Mutex contention report: %zu lock sites, sorted by total wait time",
+		      sites.size());
+	for (mutex_prof_site_t *site : sites) {
+		uint64_t acquisitions = site->acquisitions.load(std::memory_order_relaxed);
+		uint64_t contended = site->contended.load(std::memory_order_relaxed);
+
+		NCCL_OFI_INFO(NCCL_INIT | NCCL_NET,
+			      "%s:%zu acquisitions %" PRIu64 " contended %" PRIu64 " (%.2f%%) "
+			      "wait total %" PRIu64 "ns max %" PRIu64 "ns "
+			      "hold total %" PRIu64 "ns max %" PRIu64 "ns",
+			      site->file.load(std::memory_order_relaxed),
+			      site->line.load(std::memory_order_relaxed),
+			      acquisitions, contended, 100.0 * contended / acquisitions,
+			      site->wait_ns.load(std::memory_order_relaxed),
+			      site->max_wait_ns.load(std::memory_order_relaxed),
+			      site->hold_ns.load(std::memory_order_relaxed),
+			      site->max_hold_ns.load(std::memory_order_relaxed));
+
+		mutex_prof_format_hist(site->wait_hist, wait_hist, sizeof(wait_hist));
+		mutex_prof_format_hist(site->hold_hist, hold_hist, sizeof(hold_hist));
+		NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "  wait histogram:%s", wait_hist);
+		NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "  hold histogram:%s", hold_hist);
+	}
+
+	uint64_t dropped = mutex_prof_dropped_sites.load(std::memory_order_relaxed);
+	if (dropped > 0) {
+		NCCL_OFI_INFO(NCCL_INIT | NCCL_NET,
+			      "Mutex contention report: %" PRIu64 " acquisitions not recorded, site table full",
+			      dropped);
+	}
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "nccl_ofi.h"
 #include "nccl_ofi_log.h"
@@ -124,15 +125,17 @@ static int post_rx_buffer(nccl_net_ofi_rdma_req_t *req,
 			      nccl_net_ofi_ep_rail_t *ep_rail,
 			      bool set_fi_more);
 
-static nccl_net_ofi_rdma_req_t *allocate_req(nccl_ofi_freelist_t *fl);
+static nccl_net_ofi_rdma_req_t *allocate_req(nccl_net_ofi_rdma_req_fl_t *fl);
 
 static inline int free_base_req(uint64_t *num_inflight_reqs,
-				nccl_ofi_freelist_t *nccl_ofi_reqs_fl,
+				nccl_net_ofi_rdma_req_fl_t *nccl_ofi_reqs_fl,
 				nccl_net_ofi_rdma_req_t *req,
 				bool dec_inflight_reqs);
 
 static inline int check_post_rx_buff_req(nccl_net_ofi_rdma_req_t *rx_buff_req);
 
+static int recv_ring_post_credit(nccl_net_ofi_rdma_recv_comm_t *r_comm);
+
 
 static nccl_net_ofi_rdma_domain_t *rdma_endpoint_get_domain(nccl_net_ofi_rdma_ep_t *ep)
 {
@@ -272,6 +275,15 @@ static nccl_net_ofi_rdma_close_msg_t *rdma_send_close_get_msg
 	return (nccl_net_ofi_rdma_close_msg_t *)send_close_data->ctrl_fl_elem->ptr;
 }
 
+/**
+ * Get credit message from send_credit_data
+ */
+static nccl_net_ofi_rdma_credit_msg_t *rdma_send_credit_get_msg
+	(rdma_req_send_credit_data_t *send_credit_data)
+{
+	return (nccl_net_ofi_rdma_credit_msg_t *)send_credit_data->ctrl_fl_elem->ptr;
+}
+
 /*
  * @brief Return send communicator rail with index `rail_id`
  */
@@ -283,6 +295,24 @@ static inline nccl_net_ofi_rdma_send_comm_rail_t *rdma_send_comm_get_rail(nccl_n
 	return &s_comm->rails[rail_id];
 }
 
+/*
+ * @brief Return send communicator rail with index `rail_id` to
+ * transfer a message of `size' bytes, i.e., the low-latency rail for
+ * small messages if enabled and the data rail otherwise
+ */
+static inline nccl_net_ofi_rdma_send_comm_rail_t *rdma_send_comm_get_rail_by_size(nccl_net_ofi_rdma_send_comm_t *s_comm,
+									       int rail_id, size_t size)
+{
+	if (s_comm->ll_rails != NULL) {
+		nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)s_comm->base.base.ep;
+		if (size <= ep->ll_data_max_size) {
+			assert(rail_id < s_comm->num_rails);
+			return &s_comm->ll_rails[rail_id];
+		}
+	}
+	return rdma_send_comm_get_rail(s_comm, rail_id);
+}
+
 /*
  * @brief Return send communicator control rail with index `rail_id`
  */
@@ -366,6 +396,25 @@ static inline nccl_net_ofi_ep_rail_t *rdma_endpoint_get_control_rail(nccl_net_of
 	return &ep->control_rails[rail_id];
 }
 
+/*
+ * @brief	Account an operation posted on rail `rail_id' that generates
+ *		a local completion entry
+ *
+ * Control rail `rail_id' shares the completion queue of data rail
+ * `rail_id', so both are accounted to the data rail. The endpoint of
+ * the request's communicator is used on post and on completion to
+ * keep the counts balanced.
+ */
+static inline void rdma_req_cq_op_posted(nccl_net_ofi_rdma_req_t *req, int rail_id)
+{
+	rdma_endpoint_get_rail(rdma_req_get_ep(req), rail_id)->num_cq_ops_inflight++;
+}
+
+static inline void rdma_req_cq_op_completed(nccl_net_ofi_rdma_req_t *req, int rail_id)
+{
+	rdma_endpoint_get_rail(rdma_req_get_ep(req), rail_id)->num_cq_ops_inflight--;
+}
+
 /*
  * @brief	Write topology to NCCL topology file
  *
@@ -495,7 +544,8 @@ static int set_mr_req_attr(uint64_t mr_key,
 
 	switch (type) {
 	case NCCL_PTR_HOST:
-		mr_attr->access |= FI_READ;
+		/* FI_REMOTE_READ for iread and the RMA key table */
+		mr_attr->access |= (FI_READ | FI_REMOTE_READ);
 		mr_attr->iface = FI_HMEM_SYSTEM;
 		break;
 #if HAVE_CUDA
@@ -572,7 +622,7 @@ static inline int get_properties(nccl_net_ofi_device_t *base_dev,
 	/* Scale speed by the total number of rails. Assume that all
 	 * reails have the same speed. */
 	if (ret == 0) {
-		props->port_speed *= plugin->topo->max_group_size;
+		props->port_speed *= device->num_nics;
 		static_assert(NCCL_OFI_RDMA_COMM_ID_BITS < 31,
 					  "NCCL_OFI_RDMA_COMM_ID_BITS must be less than 31 so max_communicators fits in an integer");
 		props->max_communicators = NCCL_OFI_RDMA_MAX_COMMS;
@@ -617,6 +667,39 @@ static inline rdma_req_rma_op_data_t *req_get_rma_op_data(nccl_net_ofi_rdma_req_
 	return &req->rma_op_data;
 }
 
+/*
+ * @brief	Slot of the RMA key table named by a key handle
+ */
+static inline size_t rma_key_handle_slot(uint64_t handle)
+{
+	return (handle >> NCCL_OFI_RDMA_RMA_KEY_SLOT_SHIFT) &
+		((1ULL << NCCL_OFI_RDMA_RMA_KEY_SLOT_BITS) - 1);
+}
+
+/*
+ * @brief	Size of the RMA key table of a device in bytes
+ */
+static inline size_t rma_key_table_size(void)
+{
+	return NCCL_OFI_ROUND_UP(NCCL_OFI_RDMA_RMA_KEY_TABLE_SIZE *
+				 sizeof(nccl_net_ofi_rdma_rma_key_entry_t),
+				 system_page_size);
+}
+
+/*
+ * @brief	RMA key cache of the communicator of an RMA write or read
+ *		request
+ */
+static inline nccl_net_ofi_rdma_rma_key_cache_t *rdma_req_get_rma_key_cache(nccl_net_ofi_rdma_req_t *req)
+{
+	if (req->type == NCCL_OFI_RDMA_WRITE) {
+		return ((nccl_net_ofi_rdma_send_comm_t *)req->comm)->rma_key_cache;
+	}
+
+	assert(req->type == NCCL_OFI_RDMA_READ);
+	return ((nccl_net_ofi_rdma_recv_comm_t *)req->comm)->rma_key_cache;
+}
+
 /*
  * @brief	Return send data struct of send request
  */
@@ -649,6 +732,14 @@ static inline rdma_req_send_close_data_t *req_get_send_close_data(nccl_net_ofi_r
 	return &req->send_close_data;
 }
 
+/*
+ * @brief	Return send credit data struct of send credit request
+ */
+static inline rdma_req_send_credit_data_t *req_get_send_credit_data(nccl_net_ofi_rdma_req_t *req) {
+	assert(req->type == NCCL_OFI_RDMA_SEND_CREDIT);
+	return &req->send_credit_data;
+}
+
 /*
  * @brief	Return eager local copy data struct of request
  */
@@ -831,6 +922,69 @@ static inline int set_send_ctrl_completed(nccl_net_ofi_rdma_req_t *req)
 	return inc_req_completion(recv_req, 0, recv_data->total_num_compls);
 }
 
+/*
+ * @brief	Set credit request to completed
+ *
+ * The credit message completion replaces the send ctrl completion of
+ * every receive request it granted. Increment completions of these
+ * receive requests, free the credit request, and post credits that
+ * were granted while this credit message was in flight.
+ *
+ * @param	req
+ *		Send credit request
+ * @return	0, on success
+ *		non-zero, on error
+ */
+static inline int set_send_credit_completed(nccl_net_ofi_rdma_req_t *req)
+{
+	assert(req->type == NCCL_OFI_RDMA_SEND_CREDIT);
+	int ret = 0;
+	uint16_t msg_seq_num = req->msg_seq_num;
+	uint16_t num_msgs = req_get_send_credit_data(req)->num_msgs;
+
+	assert(req->comm->type == NCCL_NET_OFI_RECV_COMM);
+	nccl_net_ofi_rdma_recv_comm_t *r_comm =
+		(nccl_net_ofi_rdma_recv_comm_t *)req->comm;
+
+	for (uint16_t i = 0; i != num_msgs; ++i) {
+		void *elem;
+		nccl_ofi_msgbuff_elemtype_t type;
+		nccl_ofi_msgbuff_status_t stat;
+		nccl_ofi_msgbuff_result_t mb_res = nccl_ofi_msgbuff_retrieve(r_comm->msgbuff, msg_seq_num,
+									     &elem, &type, &stat);
+		if (OFI_UNLIKELY(mb_res != NCCL_OFI_MSGBUFF_SUCCESS || type != NCCL_OFI_MSGBUFF_REQ)) {
+			NCCL_OFI_WARN("Invalid message retrieval result for credited msg %hu", msg_seq_num);
+			return -EINVAL;
+		}
+
+		nccl_net_ofi_rdma_req_t *recv_req = (nccl_net_ofi_rdma_req_t *)elem;
+		rdma_req_recv_data_t *recv_data = get_recv_data(recv_req);
+		assert(recv_data->ring_mode == NCCL_OFI_RDMA_RECV_RING_CREDIT);
+
+		/* Add completion to parent request */
+		ret = inc_req_completion(recv_req, 0, recv_data->total_num_compls);
+		if (OFI_UNLIKELY(ret != 0)) {
+			return ret;
+		}
+
+		msg_seq_num = (msg_seq_num + 1) & MSG_SEQ_NUM_MASK;
+	}
+
+	ret = req->free(req, false);
+	if (OFI_UNLIKELY(ret != 0)) {
+		NCCL_OFI_WARN("Failed to free send credit request");
+		return ret;
+	}
+
+	nccl_net_ofi_mutex_lock(&r_comm->ctrl_counter_lock);
+	r_comm->n_ctrl_delivered += 1;
+	assert(r_comm->num_credits_inflight > 0);
+	r_comm->num_credits_inflight--;
+	nccl_net_ofi_mutex_unlock(&r_comm->ctrl_counter_lock);
+
+	return recv_ring_post_credit(r_comm);
+}
+
 /*
  * @brief	Increment segment completions of receive segment request
  *
@@ -893,8 +1047,13 @@ static inline int inc_recv_seg_completion(nccl_net_ofi_rdma_req_t *req,
 	return ret;
 }
 
-static inline int update_send_data_from_remote(nccl_net_ofi_rdma_send_comm_t *s_comm, nccl_net_ofi_rdma_req_t *rx_buff_req,
-				 nccl_net_ofi_rdma_req_t *req)
+/*
+ * @brief	Populate RDMA write metadata of send request from the
+ *		receiver's control message
+ */
+static inline int update_send_data_from_remote(nccl_net_ofi_rdma_send_comm_t *s_comm,
+					       nccl_net_ofi_rdma_ctrl_msg_t *ctrl_msg,
+					       nccl_net_ofi_rdma_req_t *req)
 {
 	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)s_comm->base.base.ep;
 	assert(ep != NULL);
@@ -903,16 +1062,8 @@ static inline int update_send_data_from_remote(nccl_net_ofi_rdma_send_comm_t *s_
 	nccl_net_ofi_scheduler_t *scheduler = device->scheduler;
 
 	rdma_req_send_data_t *send_data = get_send_data(req);
-	rdma_req_rx_buff_data_t *rx_buff_data = get_rx_buff_data(rx_buff_req);
-	nccl_net_ofi_rdma_ctrl_msg_t *ctrl_msg = get_rx_ctrl_msg(rx_buff_data);
 
-	for (int rail_id = 0; rail_id != ep->num_rails; ++rail_id) {
-		if (ep->use_long_rkeys) {
-			send_data->remote_mr_key[rail_id] = ctrl_msg->long_buff_mr_key[rail_id];
-		} else {
-			send_data->remote_mr_key[rail_id] = ctrl_msg->short_buff_mr_key[rail_id];
-		}
-	}
+	ep->fast_path->copy_remote_rkeys(ep, send_data, ctrl_msg);
 
 	send_data->remote_buff = ctrl_msg->buff_addr;
 	send_data->remote_len = ctrl_msg->buff_len;
@@ -970,9 +1121,9 @@ static inline int repost_rx_buff(nccl_net_ofi_rdma_ep_t *ep,
 	ret = send_progress(rx_buff_req);
 	if (ret == -FI_EAGAIN) {
 		/* Add to pending reqs queue */
-		ret = nccl_ofi_deque_insert_back(ep->pending_reqs_queue, &rx_buff_req->pending_reqs_elem);
+		ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &rx_buff_req->pending_reqs_elem);
 		if (ret != 0) {
-			NCCL_OFI_WARN("Failed to nccl_ofi_deque_insert_back: %d", ret);
+			NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
 			return ret;
 		}
 		NCCL_OFI_TRACE_PENDING_INSERT(rx_buff_req);
@@ -1006,49 +1157,36 @@ static inline int decrease_rx_buff_cnt(nccl_net_ofi_rdma_ep_t *ep,
 }
 
 /**
- * @brief	Handle receiving an RDMA control message. These are control messages
- *       	containing information about the remote buffer location which will be
- *       	used to trigger write operations.
+ * @brief	Apply a control message to a send request that was posted
+ *		before the control message arrived
+ *
+ * Initiates the RDMA write of a regular send request or accounts the
+ * control message completion of an eager send request.
  */
-static inline int handle_ctrl_recv(nccl_net_ofi_rdma_send_comm_t *s_comm,
-					    uint16_t msg_seq_num,
-					    nccl_net_ofi_rdma_req_t *rx_buff_req)
+static inline int apply_ctrl_to_send_req(nccl_net_ofi_rdma_send_comm_t *s_comm,
+					 nccl_net_ofi_rdma_req_t *req,
+					 nccl_net_ofi_rdma_ctrl_msg_t *ctrl_msg)
 {
 	int ret;
-
-	nccl_ofi_msgbuff_status_t stat;
 	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)s_comm->base.base.ep;
-	nccl_ofi_msgbuff_result_t mb_res = nccl_ofi_msgbuff_insert(s_comm->msgbuff, msg_seq_num,
-		rx_buff_req, NCCL_OFI_MSGBUFF_BUFF, &stat);
-
-	if (mb_res == NCCL_OFI_MSGBUFF_SUCCESS) {
-		/* Inserted! In this case sender has not yet called send() for this message, so
-		   return success and initiate RDMA write when sender calls send(). */
-		return decrease_rx_buff_cnt(ep, get_rx_buff_data(rx_buff_req)->rail);
-	}
-
-	if (OFI_UNLIKELY(mb_res != NCCL_OFI_MSGBUFF_INVALID_IDX || stat != NCCL_OFI_MSGBUFF_INPROGRESS)) {
-		NCCL_OFI_WARN("Unexpected message insert result (%d) (ctrl recv)", (int)mb_res);
-		return -EINVAL;
-	}
-
-	// Already a req entry here
-	void *elem;
-	nccl_ofi_msgbuff_elemtype_t type;
-	mb_res = nccl_ofi_msgbuff_retrieve(s_comm->msgbuff, msg_seq_num, &elem, &type, &stat);
-	if (OFI_UNLIKELY(mb_res != NCCL_OFI_MSGBUFF_SUCCESS || type != NCCL_OFI_MSGBUFF_REQ)) {
-		NCCL_OFI_WARN("Invalid message retrieval result for msg %hu", msg_seq_num);
-		return -EINVAL;
-	}
-
-	nccl_net_ofi_rdma_req_t *req = (nccl_net_ofi_rdma_req_t *)elem;
-	assert(req->msg_seq_num == msg_seq_num);
 	rdma_req_send_data_t *send_data = get_send_data(req);
-	rdma_req_rx_buff_data_t *rx_buff_data = get_rx_buff_data(rx_buff_req);
-	nccl_net_ofi_rdma_ctrl_msg_t *ctrl_msg = get_rx_ctrl_msg(rx_buff_data);
 
 	if (!send_data->eager) {
-		ret = update_send_data_from_remote(s_comm, rx_buff_req, req);
+		if (OFI_LIKELY(s_comm->connected.load(std::memory_order_acquire))) {
+			ret = update_send_data_from_remote(s_comm, ctrl_msg, req);
+		} else {
+			/* Either finish_connect() has not swept the
+			 * message buffer yet and posts the request, or it
+			 * is done and the request is posted here */
+			bool connected;
+			nccl_net_ofi_mutex_lock(&s_comm->conn_lock);
+			ret = update_send_data_from_remote(s_comm, ctrl_msg, req);
+			connected = s_comm->connected.load(std::memory_order_relaxed);
+			nccl_net_ofi_mutex_unlock(&s_comm->conn_lock);
+			if (ret == 0 && !connected) {
+				return 0;
+			}
+		}
 		if (OFI_UNLIKELY(ret != 0)) {
 			NCCL_OFI_WARN("Failed to copy ctrl data");
 			return ret;
@@ -1056,11 +1194,11 @@ static inline int handle_ctrl_recv(nccl_net_ofi_rdma_send_comm_t *s_comm,
 
 		/* Initiate rdma write */
 		ret = send_progress(req);
-		if (ret == -FI_EAGAIN) {
+		if (ret == -FI_EAGAIN || ret == -EINPROGRESS) {
 			/* Add to pending reqs queue */
-			ret = nccl_ofi_deque_insert_back(ep->pending_reqs_queue, &req->pending_reqs_elem);
+			ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &req->pending_reqs_elem);
 			if (ret != 0) {
-				NCCL_OFI_WARN("Failed to nccl_ofi_deque_insert_back: %d", ret);
+				NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
 				return ret;
 			}
 			NCCL_OFI_TRACE_PENDING_INSERT(req);
@@ -1090,6 +1228,71 @@ static inline int handle_ctrl_recv(nccl_net_ofi_rdma_send_comm_t *s_comm,
 		}
 	}
 
+	return 0;
+}
+
+/*
+ * @brief	Retrieve the send request of message `msg_seq_num' that is
+ *		already in the sender's message buffer
+ */
+static inline int get_inprogress_send_req(nccl_net_ofi_rdma_send_comm_t *s_comm,
+					  uint16_t msg_seq_num,
+					  nccl_net_ofi_rdma_req_t **req_p)
+{
+	void *elem;
+	nccl_ofi_msgbuff_elemtype_t type;
+	nccl_ofi_msgbuff_status_t stat;
+	nccl_ofi_msgbuff_result_t mb_res = nccl_ofi_msgbuff_retrieve(s_comm->msgbuff, msg_seq_num,
+								     &elem, &type, &stat);
+	if (OFI_UNLIKELY(mb_res != NCCL_OFI_MSGBUFF_SUCCESS || type != NCCL_OFI_MSGBUFF_REQ)) {
+		NCCL_OFI_WARN("Invalid message retrieval result for msg %hu", msg_seq_num);
+		return -EINVAL;
+	}
+
+	*req_p = (nccl_net_ofi_rdma_req_t *)elem;
+	assert((*req_p)->msg_seq_num == msg_seq_num);
+	return 0;
+}
+
+/**
+ * @brief	Handle receiving an RDMA control message. These are control messages
+ *       	containing information about the remote buffer location which will be
+ *       	used to trigger write operations.
+ */
+static inline int handle_ctrl_recv(nccl_net_ofi_rdma_send_comm_t *s_comm,
+					    uint16_t msg_seq_num,
+					    nccl_net_ofi_rdma_req_t *rx_buff_req)
+{
+	int ret;
+
+	nccl_ofi_msgbuff_status_t stat;
+	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)s_comm->base.base.ep;
+	nccl_ofi_msgbuff_result_t mb_res = nccl_ofi_msgbuff_insert(s_comm->msgbuff, msg_seq_num,
+		rx_buff_req, NCCL_OFI_MSGBUFF_BUFF, &stat);
+
+	if (mb_res == NCCL_OFI_MSGBUFF_SUCCESS) {
+		/* Inserted! In this case sender has not yet called send() for this message, so
+		   return success and initiate RDMA write when sender calls send(). */
+		return decrease_rx_buff_cnt(ep, get_rx_buff_data(rx_buff_req)->rail);
+	}
+
+	if (OFI_UNLIKELY(mb_res != NCCL_OFI_MSGBUFF_INVALID_IDX || stat != NCCL_OFI_MSGBUFF_INPROGRESS)) {
+		NCCL_OFI_WARN("Unexpected message insert result (%d) (ctrl recv)", (int)mb_res);
+		return -EINVAL;
+	}
+
+	// Already a req entry here
+	nccl_net_ofi_rdma_req_t *req = NULL;
+	ret = get_inprogress_send_req(s_comm, msg_seq_num, &req);
+	if (OFI_UNLIKELY(ret != 0)) {
+		return ret;
+	}
+
+	ret = apply_ctrl_to_send_req(s_comm, req, get_rx_ctrl_msg(get_rx_buff_data(rx_buff_req)));
+	if (OFI_UNLIKELY(ret != 0)) {
+		return ret;
+	}
+
 	/* Attempt to re-post rx buffer */
 	ret = repost_rx_buff(ep, rx_buff_req);
 	if (ret != 0) {
@@ -1100,6 +1303,62 @@ static inline int handle_ctrl_recv(nccl_net_ofi_rdma_send_comm_t *s_comm,
 	return 0;
 }
 
+/**
+ * @brief	Handle receiving a receive ring credit message
+ *
+ * Each granted message reuses the buffer advertised for its ring
+ * slot. The ring slot is inserted into the message buffer in place
+ * of a control rx buffer, or applied right away if send() has
+ * already been called for the message.
+ */
+static inline int handle_credit_recv(nccl_net_ofi_rdma_send_comm_t *s_comm,
+				     nccl_net_ofi_rdma_credit_msg_t *credit_msg,
+				     nccl_net_ofi_rdma_req_t *rx_buff_req)
+{
+	int ret;
+	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)s_comm->base.base.ep;
+	uint16_t msg_seq_num = credit_msg->msg_seq_num;
+	uint32_t num_msgs = credit_msg->num_msgs;
+
+	for (uint32_t i = 0; i != num_msgs; ++i) {
+		nccl_net_ofi_rdma_ctrl_msg_t *ctrl_msg =
+			&s_comm->recv_ring[msg_seq_num % NCCL_OFI_RDMA_RECV_RING_DEPTH];
+		nccl_ofi_msgbuff_status_t stat;
+		nccl_ofi_msgbuff_result_t mb_res = nccl_ofi_msgbuff_insert(s_comm->msgbuff, msg_seq_num,
+			ctrl_msg, NCCL_OFI_MSGBUFF_RING_SLOT, &stat);
+
+		if (mb_res != NCCL_OFI_MSGBUFF_SUCCESS) {
+			if (OFI_UNLIKELY(mb_res != NCCL_OFI_MSGBUFF_INVALID_IDX ||
+					 stat != NCCL_OFI_MSGBUFF_INPROGRESS)) {
+				NCCL_OFI_WARN("Unexpected message insert result (%d) (credit recv)", (int)mb_res);
+				return -EINVAL;
+			}
+
+			nccl_net_ofi_rdma_req_t *req = NULL;
+			ret = get_inprogress_send_req(s_comm, msg_seq_num, &req);
+			if (OFI_UNLIKELY(ret != 0)) {
+				return ret;
+			}
+
+			ret = apply_ctrl_to_send_req(s_comm, req, ctrl_msg);
+			if (OFI_UNLIKELY(ret != 0)) {
+				return ret;
+			}
+		}
+
+		msg_seq_num = (msg_seq_num + 1) & MSG_SEQ_NUM_MASK;
+	}
+
+	/* The credit message is fully consumed, re-post rx buffer */
+	ret = repost_rx_buff(ep, rx_buff_req);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Failed to repost rx buff");
+		return ret;
+	}
+
+	return 0;
+}
+
 static inline int free_eager_copy_req(nccl_net_ofi_rdma_req_t *req, bool dec_inflight_reqs)
 {
 	assert(req->type == NCCL_OFI_RDMA_EAGER_COPY);
@@ -1136,6 +1395,53 @@ static inline int alloc_eager_copy_req(nccl_net_ofi_rdma_req_t *recv_req, nccl_n
 	return 0;
 }
 
+/*
+ * @brief	True if eager data of a receive is copied by the CPU rather
+ *		than by a loopback read of an eager copy request
+ *
+ * The read costs a round trip through the NIC and a completion, which
+ * is only worth it when the destination is device memory.
+ */
+static inline bool eager_copy_on_cpu(rdma_req_recv_data_t *recv_data)
+{
+	return recv_data->dest_mr_handle != NULL &&
+		recv_data->dest_mr_handle->type == NCCL_PTR_HOST;
+}
+
+/*
+ * @brief	Copy eager data from its rx buffer into the host buffer of
+ *		a receive, and re-post the rx buffer
+ *
+ * @param	copied
+ *		Number of bytes copied
+ * @return	0, on success
+ *		non-zero, on error
+ */
+static int eager_cpu_copy(rdma_req_recv_data_t *recv_data, nccl_net_ofi_rdma_req_t *rx_buff_req,
+			  size_t *copied)
+{
+	rdma_req_rx_buff_data_t *rx_buff_data = get_rx_buff_data(rx_buff_req);
+	size_t len = rx_buff_data->recv_len;
+
+	/* Validate size of data */
+	if (recv_data->dst_len < len) {
+		NCCL_OFI_TRACE(NCCL_NET, "Recv buffer (%zu) smaller than eager send size (%zu)",
+			       recv_data->dst_len, len);
+		len = recv_data->dst_len;
+	}
+
+	memcpy(recv_data->dst_buff, rx_buff_data->rx_buff_fl_elem->ptr, len);
+
+	int ret = check_post_rx_buff_req(rx_buff_req);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Failed call to check_post_rx_buff_req");
+		return ret;
+	}
+
+	*copied = len;
+	return 0;
+}
+
 /**
  * @brief	Handle receiving an RDMA eager message.
  */
@@ -1195,6 +1501,16 @@ static inline int handle_eager_recv(nccl_net_ofi_rdma_recv_comm_t *r_comm,
 		return ret;
 	}
 
+	if (eager_copy_on_cpu(recv_data)) {
+		/* Complete the receive in this completion pass */
+		size_t copied = 0;
+		ret = eager_cpu_copy(recv_data, rx_buff_req, &copied);
+		if (ret != 0) {
+			return ret;
+		}
+		return inc_req_completion(recv_req, copied, recv_data->total_num_compls);
+	}
+
 	ret = alloc_eager_copy_req(recv_req, r_comm, rx_buff_req);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Failed call to alloc_eager_copy_req");
@@ -1211,6 +1527,9 @@ static inline int handle_eager_recv(nccl_net_ofi_rdma_recv_comm_t *r_comm,
 }
 
 static int finish_connect(nccl_net_ofi_rdma_send_comm_t *s_comm);
+static int create_rma_key_cache(nccl_net_ofi_rdma_ep_t *ep,
+				nccl_ofi_rdma_connection_info_t *conn_msg,
+				nccl_net_ofi_rdma_rma_key_cache_t **cache);
 
 static int handle_close_msg_recv(nccl_net_ofi_rdma_req_t *rx_buff_req)
 {
@@ -1251,6 +1570,7 @@ static inline int handle_rx_buff_recv(nccl_net_ofi_rdma_device_t *device, int ra
 	nccl_ofi_rdma_connection_info_t *conn_msg = NULL;
 	nccl_ofi_rdma_connection_info_t *conn_resp_msg = NULL;
 	nccl_net_ofi_rdma_ctrl_msg_t *ctrl_msg = NULL;
+	nccl_net_ofi_rdma_credit_msg_t *credit_msg = NULL;
 	nccl_net_ofi_rdma_listen_comm_t *l_comm = NULL;
 	nccl_net_ofi_rdma_send_comm_t *s_comm = NULL;
 	nccl_net_ofi_rdma_recv_comm_t *r_comm = NULL;
@@ -1332,6 +1652,13 @@ static inline int handle_rx_buff_recv(nccl_net_ofi_rdma_device_t *device, int ra
 			goto exit;
 		}
 
+		/* Initialize the remaining rails, and post the sends
+		 * issued while the response was in flight */
+		ret = finish_connect(s_comm);
+		if (OFI_UNLIKELY(ret != 0)) {
+			goto exit;
+		}
+
 		/* Attempt to re-post rx buffer */
 		ret = repost_rx_buff(ep, rx_buff_req);
 		if (OFI_UNLIKELY(ret != 0)) {
@@ -1339,11 +1666,19 @@ static inline int handle_rx_buff_recv(nccl_net_ofi_rdma_device_t *device, int ra
 			goto exit;
 		}
 		break;
+	case NCCL_OFI_RDMA_MSG_CTRL_RING_ADV:
+		/* Remember advertised buffer for later credits and
+		 * fall through to NCCL_OFI_RDMA_MSG_CTRL case */
+		ctrl_msg = get_rx_ctrl_msg(rx_buff_data);
+		s_comm = rdma_device_get_send_comm(device, ctrl_msg->remote_comm_id);
+		memcpy(&s_comm->recv_ring[ctrl_msg->msg_seq_num % NCCL_OFI_RDMA_RECV_RING_DEPTH],
+		       ctrl_msg, cq_entry->len);
+		/* fall through */
 	case NCCL_OFI_RDMA_MSG_CTRL_NO_COMPLETION:
 		/* fall through to NCCL_OFI_RDMA_MSG_CTRL case */
 	case NCCL_OFI_RDMA_MSG_CTRL:
 		/* CTRL receive completion */
-		assert(cq_entry->len == nccl_net_ofi_rdma_ctrl_msg_size(ep->num_rails, ep->use_long_rkeys));
+		assert(cq_entry->len == ep->ctrl_msg_size);
 
 		ctrl_msg = get_rx_ctrl_msg(rx_buff_data);
 		s_comm = rdma_device_get_send_comm(device, ctrl_msg->remote_comm_id);
@@ -1360,16 +1695,33 @@ static inline int handle_rx_buff_recv(nccl_net_ofi_rdma_device_t *device, int ra
 		nccl_net_ofi_mutex_unlock(&s_comm->ctrl_recv_lock);
 
 		break;
-	case NCCL_OFI_RDMA_MSG_CLOSE:
-		assert(cq_entry->len == sizeof(nccl_net_ofi_rdma_close_msg_t));
-
-		ret = handle_close_msg_recv(rx_buff_req);
+	case NCCL_OFI_RDMA_MSG_CREDIT:
+		/* Receive ring credit receive completion */
+		assert(cq_entry->len == sizeof(nccl_net_ofi_rdma_credit_msg_t));
 
-		break;
-	case NCCL_OFI_RDMA_MSG_EAGER:
-		/* Eager message receive completion */
+		credit_msg = (nccl_net_ofi_rdma_credit_msg_t *)rx_buff_data->rx_buff_fl_elem->ptr;
+		s_comm = rdma_device_get_send_comm(device, credit_msg->remote_comm_id);
 
-		r_comm = rdma_device_get_recv_comm(device, GET_COMM_ID_FROM_IMM(cq_entry->data));
+		ret = handle_credit_recv(s_comm, credit_msg, rx_buff_req);
+		if (OFI_UNLIKELY(ret != 0)) {
+			goto exit;
+		}
+
+		nccl_net_ofi_mutex_lock(&s_comm->ctrl_recv_lock);
+		s_comm->n_ctrl_received += 1;
+		nccl_net_ofi_mutex_unlock(&s_comm->ctrl_recv_lock);
+
+		break;
+	case NCCL_OFI_RDMA_MSG_CLOSE:
+		assert(cq_entry->len == sizeof(nccl_net_ofi_rdma_close_msg_t));
+
+		ret = handle_close_msg_recv(rx_buff_req);
+
+		break;
+	case NCCL_OFI_RDMA_MSG_EAGER:
+		/* Eager message receive completion */
+
+		r_comm = rdma_device_get_recv_comm(device, GET_COMM_ID_FROM_IMM(cq_entry->data));
 
 		NCCL_OFI_TRACE_EAGER_RECV(r_comm->base.base.dev_id, rail_id, r_comm,
 					  GET_SEQ_NUM_FROM_IMM(cq_entry->data));
@@ -1503,6 +1855,8 @@ static const char *req_type_str(nccl_net_ofi_rdma_req_type_t type)
 		return "SEND_CTRL";
 	case NCCL_OFI_RDMA_SEND_CLOSE:
 		return "SEND_CLOSE";
+	case NCCL_OFI_RDMA_SEND_CREDIT:
+		return "SEND_CREDIT";
 	case NCCL_OFI_RDMA_RECV_SEGMS:
 		return "RECV_SEGMS";
 	case NCCL_OFI_RDMA_EAGER_RX_BUFF:
@@ -1540,6 +1894,8 @@ static int post_rdma_ctrl(nccl_net_ofi_rdma_req_t *req);
 
 static int post_close_msg(nccl_net_ofi_rdma_req_t *req);
 
+static int post_credit_msg(nccl_net_ofi_rdma_req_t *req);
+
 static int post_flush_req(nccl_net_ofi_rdma_req_t *req);
 
 static int post_eager_copy(nccl_net_ofi_rdma_req_t *req);
@@ -1604,6 +1960,11 @@ static inline int process_completions(struct fi_cq_data_entry *cq_entry, uint64_
 				return -EINVAL;
 			}
 
+			/* Account completion before the handler may free the request */
+			if (!(comp_flags & FI_RECV)) {
+				rdma_req_cq_op_completed(req, rail_id);
+			}
+
 			if (comp_flags & FI_SEND) {
 				/* Send completions */
 
@@ -1624,6 +1985,9 @@ static inline int process_completions(struct fi_cq_data_entry *cq_entry, uint64_
 					ret = inc_req_completion(req, 0, send_data->total_num_compls);
 				} else if (req->type == NCCL_OFI_RDMA_SEND_CLOSE) {
 					ret = inc_req_completion(req, sizeof(nccl_net_ofi_rdma_close_msg_t), 1);
+				} else if (req->type == NCCL_OFI_RDMA_SEND_CREDIT) {
+					/* Receive ring credit send completion */
+					ret = set_send_credit_completed(req);
 				} else {
 					NCCL_OFI_WARN("Send completion from unexpected request type");
 					ret = -EINVAL;
@@ -1655,6 +2019,7 @@ static inline int process_completions(struct fi_cq_data_entry *cq_entry, uint64_
 				case NCCL_OFI_RDMA_RECV:
 				case NCCL_OFI_RDMA_SEND_CTRL:
 				case NCCL_OFI_RDMA_SEND_CLOSE:
+				case NCCL_OFI_RDMA_SEND_CREDIT:
 				case NCCL_OFI_RDMA_RECV_SEGMS:
 				case NCCL_OFI_RDMA_EAGER_COPY:
 				case NCCL_OFI_RDMA_CTRL_RX_BUFF:
@@ -1681,17 +2046,25 @@ static inline int process_completions(struct fi_cq_data_entry *cq_entry, uint64_
 					break;
 				}
 				case NCCL_OFI_RDMA_READ: {
-					/* Local-initiated RMA read is complete */
+					/* Local-initiated RMA read or its RMA key
+					 * table fetch is complete */
 
 					rma_op_data = req_get_rma_op_data(req, NCCL_OFI_RDMA_READ);
 					ret = inc_req_completion(req, 0, rma_op_data->total_num_compls);
 					break;
 				}
+				case NCCL_OFI_RDMA_WRITE: {
+					/* RMA key table fetch of an RMA write is complete */
+
+					rma_op_data = req_get_rma_op_data(req, NCCL_OFI_RDMA_WRITE);
+					ret = inc_req_completion(req, 0, rma_op_data->total_num_compls);
+					break;
+				}
 				case NCCL_OFI_RDMA_SEND:
-				case NCCL_OFI_RDMA_WRITE:
 				case NCCL_OFI_RDMA_RECV:
 				case NCCL_OFI_RDMA_SEND_CTRL:
 				case NCCL_OFI_RDMA_SEND_CLOSE:
+				case NCCL_OFI_RDMA_SEND_CREDIT:
 				case NCCL_OFI_RDMA_RECV_SEGMS:
 				case NCCL_OFI_RDMA_CTRL_RX_BUFF:
 				case NCCL_OFI_RDMA_EAGER_RX_BUFF:
@@ -1718,6 +2091,130 @@ exit:
 	return ret;
 }
 
+/*
+ * @brief	True if a stripe that completed with libfabric error `err'
+ *		may succeed when posted again
+ *
+ * Only errors with which the provider reports that the operation did
+ * not reach the peer qualify, as in receiver-not-ready conditions. A
+ * write or eager message that failed with FI_EIO or FI_ETIMEDOUT may
+ * still have been delivered, with only its acknowledgement lost, and
+ * the receiver would count it twice.
+ */
+static inline bool stripe_error_is_transient(int err)
+{
+	switch (err) {
+	case FI_EAGAIN:
+	case FI_EBUSY:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static inline uint64_t stripe_retry_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * @brief	Mark stripe `xfer_idx' of send request `req' to be posted
+ *		again
+ *
+ * The receiver counts the completions of writes and eager messages,
+ * so this is only safe for stripes that did not reach the peer (see
+ * stripe_error_is_transient()). The stripe moves to a rail no other
+ * stripe of the request uses, if any, so that it avoids the rail that
+ * failed while the rail of a completion still identifies its stripe. The stripe is posted by send_progress()
+ * once the backoff delay elapsed.
+ *
+ * @return	0, if the stripe is to be posted again
+ *		-EIO, if the request used up its attempts
+ */
+static int send_retry_stripe(nccl_net_ofi_rdma_req_t *req, size_t xfer_idx)
+{
+	nccl_net_ofi_rdma_ep_t *ep = rdma_req_get_ep(req);
+	nccl_net_ofi_rdma_send_comm_t *s_comm = (nccl_net_ofi_rdma_send_comm_t *)req->comm;
+	rdma_req_send_data_t *send_data = get_send_data(req);
+	nccl_net_ofi_schedule_t *schedule = send_data->schedule;
+	nccl_net_ofi_xfer_info_t *xfer_info = &schedule->rail_xfer_infos[xfer_idx];
+	uint32_t used_rails = 0;
+
+	if (send_data->num_retries >= ep->stripe_retry_max) {
+		return -EIO;
+	}
+
+	for (size_t i = 0; i != schedule->num_xfer_infos; ++i) {
+		used_rails |= 1U << schedule->rail_xfer_infos[i].rail_id;
+	}
+	for (int i = 1; i < s_comm->num_rails; ++i) {
+		int rail_id = (xfer_info->rail_id + i) % s_comm->num_rails;
+		if (!(used_rails & (1U << rail_id))) {
+			xfer_info->rail_id = rail_id;
+			break;
+		}
+	}
+
+	send_data->num_retries++;
+	send_data->retry_xfers |= 1U << xfer_idx;
+	send_data->retry_time = stripe_retry_now() +
+		(ep->stripe_retry_backoff_ns << std::min(send_data->num_retries - 1, 16U));
+
+	return 0;
+}
+
+/*
+ * @brief	Post the stripe of send request `req' that completed on
+ *		`rail_id' with a transient error again
+ *
+ * @return	0, if the stripe is to be posted again
+ *		error, if the request must fail
+ */
+static int send_retry_failed_stripe(nccl_net_ofi_rdma_req_t *req, int rail_id, int err)
+{
+	nccl_net_ofi_rdma_ep_t *ep = rdma_req_get_ep(req);
+	rdma_req_send_data_t *send_data = get_send_data(req);
+	nccl_net_ofi_schedule_t *schedule = send_data->schedule;
+	size_t xfer_idx;
+	int ret;
+
+	for (xfer_idx = 0; xfer_idx != schedule->num_xfer_infos; ++xfer_idx) {
+		if (schedule->rail_xfer_infos[xfer_idx].rail_id == rail_id &&
+		    !(send_data->retry_xfers & (1U << xfer_idx))) {
+			break;
+		}
+	}
+	if (OFI_UNLIKELY(xfer_idx == schedule->num_xfer_infos)) {
+		return -EINVAL;
+	}
+
+	/* Requests with failed stripes or stripes not posted yet are
+	 * already queued */
+	bool queued = (send_data->retry_xfers != 0 ||
+		       send_data->xferred_rail_id != schedule->num_xfer_infos);
+
+	ret = send_retry_stripe(req, xfer_idx);
+	if (ret != 0) {
+		return ret;
+	}
+
+	NCCL_OFI_INFO(NCCL_NET, "Stripe %zu of request %p failed on rail %d with error %d, attempt %u of %u",
+		      xfer_idx, req, rail_id, err, send_data->num_retries, ep->stripe_retry_max);
+
+	if (!queued) {
+		ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &req->pending_reqs_elem);
+		if (OFI_UNLIKELY(ret != 0)) {
+			NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
+			return ret;
+		}
+		NCCL_OFI_TRACE_PENDING_INSERT(req);
+	}
+
+	return 0;
+}
+
 /*
  * @brief	Process error completion entries from the CQ error queue
  *
@@ -1774,6 +2271,15 @@ static inline int process_err_completion(nccl_net_ofi_rdma_device_t *device,
 		req = rdma_op_context_get_req(err_entry.op_context, rail->rail_id);
 	}
 
+	if (req->type == NCCL_OFI_RDMA_SEND && !(err_entry.flags & FI_REMOTE_WRITE) &&
+	    stripe_error_is_transient(err_entry.err)) {
+		if (send_retry_failed_stripe(req, rail->rail_id, err_entry.err) == 0) {
+			rdma_req_cq_op_completed(req, rail->rail_id);
+			ret = 0;
+			goto exit;
+		}
+	}
+
 	NCCL_OFI_WARN("Request %p completed with error. RC: %d. Error: %d (%s). Completed length: %ld, Request: %s",
 		      req, err_entry.err,
 		      err_entry.prov_errno,
@@ -1783,6 +2289,11 @@ static inline int process_err_completion(nccl_net_ofi_rdma_device_t *device,
 		/* A rx buffer receive failed -- this is an internal error so bail out */
 		NCCL_OFI_WARN("Fatal: rx buffer recv completed with error");
 	} else {
+		if (req->type == NCCL_OFI_RDMA_WRITE || req->type == NCCL_OFI_RDMA_READ) {
+			nccl_net_ofi_mutex_lock(&req->req_lock);
+			req_get_rma_op_data(req, req->type)->num_err_compls++;
+			nccl_net_ofi_mutex_unlock(&req->req_lock);
+		}
 		/* Move user-facing request to error state */
 		set_request_state_to_error(req);
 	}
@@ -1799,27 +2310,191 @@ exit:
 	return ret;
 }
 
-static int post_rma_read(nccl_net_ofi_rdma_req_t *req)
+/*
+ * @brief	Number of transfers of `schedule'
+ *
+ * Bounded by the compile-time rail count NUM_RAILS of a fast path
+ * instance, so that stripe loops can be unrolled. The generic instance
+ * (NUM_RAILS == 0) reads the count at runtime.
+ */
+template <int NUM_RAILS>
+static inline size_t fast_path_num_xfers(nccl_net_ofi_schedule_t *schedule)
 {
-	rdma_req_rma_op_data_t *rma_op_data = req_get_rma_op_data(req, NCCL_OFI_RDMA_READ);
-	nccl_net_ofi_rdma_recv_comm_t *r_comm = (nccl_net_ofi_rdma_recv_comm_t *)req->comm;
-	int rail_id = 0;
-	nccl_net_ofi_rdma_recv_comm_rail_t *comm_rail = rdma_recv_comm_get_rail(r_comm, rail_id);
+	if (NUM_RAILS == 0) {
+		return schedule->num_xfer_infos;
+	}
+	assert(schedule->num_xfer_infos <= (size_t)NUM_RAILS);
+	return std::min(schedule->num_xfer_infos, (size_t)NUM_RAILS);
+}
 
+/*
+ * @brief	Additional flags of the next stripe of an RMA request on `rail_id'
+ *
+ * FI_MORE lets the provider defer ringing the doorbell of the rail
+ * while further stripes of the request follow on it.
+ */
+static inline uint64_t rma_stripe_flags(rdma_req_rma_op_data_t *rma_op_data, int rail_id)
+{
+	return (rma_op_data->rail_posts_left[rail_id] > 1) ? FI_MORE : 0;
+}
+
+/*
+ * @brief	Account for a stripe of an RMA request posted on `rail_id'
+ */
+static inline void rma_stripe_posted(nccl_net_ofi_rdma_req_t *req,
+				     rdma_req_rma_op_data_t *rma_op_data, int rail_id)
+{
+	assert(rma_op_data->rail_posts_left[rail_id] > 0);
+	rdma_req_cq_op_posted(req, rail_id);
+	rma_op_data->rail_posts_left[rail_id]--;
+	rma_op_data->num_posted_compls++;
+}
+
+/*
+ * @brief	Return true if all stripes of an RMA request were posted,
+ *		the last one of each rail without FI_MORE
+ */
+static inline bool rma_stripes_flushed(rdma_req_rma_op_data_t *rma_op_data)
+{
+	for (int rail_id = 0; rail_id < MAX_NUM_RAILS; rail_id++) {
+		if (rma_op_data->rail_posts_left[rail_id] != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * @brief	Post the RMA key table fetch of `req' unless there is none or
+ *		it was posted already
+ *
+ * Reads the peer's table entry of the key handle into the RMA key
+ * cache of the communicator, using rail 0.
+ */
+static int post_rma_key_fetch(nccl_net_ofi_rdma_req_t *req,
+			      rdma_req_rma_op_data_t *rma_op_data,
+			      struct fid_ep *local_ep, fi_addr_t remote_addr)
+{
+	if (rma_op_data->key_fetch_idx < 0 || rma_op_data->key_fetch_posted) {
+		return 0;
+	}
+
+	nccl_net_ofi_rdma_rma_key_cache_t *cache = rdma_req_get_rma_key_cache(req);
+	nccl_net_ofi_rdma_rma_key_entry_t *entry = &cache->entries[rma_op_data->key_fetch_idx];
+	size_t slot = rma_key_handle_slot(rma_op_data->key_fetch_handle);
+	void *desc = fi_mr_desc(cache->mr_handle->mr[0]);
 	ssize_t rc;
-	/* Post RMA read */
-	rc = fi_read(comm_rail->local_ep, rma_op_data->buff,
-		      rma_op_data->buff_len, rma_op_data->desc,
-		      comm_rail->remote_addr,
-		      rma_op_data->remote_buff,
-		     rma_op_data->remote_mr_key, (void *)&req->ctx[rail_id]);
 
+	struct iovec iov;
+	struct fi_msg_rma msg;
+	struct fi_rma_iov rma_iov;
+
+	iov.iov_base = entry;
+	iov.iov_len = sizeof(*entry);
+
+	rma_iov.addr = cache->remote_table_addr + slot * sizeof(*entry);
+	rma_iov.len = sizeof(*entry);
+	rma_iov.key = cache->remote_table_key;
+
+	msg.msg_iov = &iov;
+	msg.desc = &desc;
+	msg.iov_count = 1;
+	msg.addr = remote_addr;
+	msg.rma_iov = &rma_iov;
+	msg.rma_iov_count = 1;
+	msg.context = (void *)&req->ctx[0];
+	msg.data = 0;
+
+	rc = fi_readmsg(local_ep, &msg, FI_COMPLETION);
 	if ((rc != 0) && (rc != -FI_EAGAIN)) {
-		NCCL_OFI_WARN("fi_read failed; RC: %zd, Error: %s",
+		NCCL_OFI_WARN("fi_readmsg of RMA key table entry failed; RC: %zd, Error: %s",
 			      rc, fi_strerror(-rc));
+		return rc;
+	} else if (rc != 0) {
+		return rc;
 	}
+	rdma_req_cq_op_posted(req, 0);
+	rma_op_data->key_fetch_posted = true;
+	rma_op_data->num_posted_compls++;
 
-	return rc;
+	return 0;
+}
+
+/*
+ * @brief	Post the stripes of an RMA read that have not been posted yet
+ *
+ * Each stripe of each operation is read on its own rail and produces
+ * one completion. On -FI_EAGAIN, `op_idx' and `xferred_rail_id'
+ * record where to resume.
+ */
+template <int NUM_RAILS>
+static int fast_path_post_rma_read(nccl_net_ofi_rdma_req_t *req)
+{
+	rdma_req_rma_op_data_t *rma_op_data = req_get_rma_op_data(req, NCCL_OFI_RDMA_READ);
+	nccl_net_ofi_rdma_recv_comm_t *r_comm = (nccl_net_ofi_rdma_recv_comm_t *)req->comm;
+	nccl_net_ofi_rdma_recv_comm_rail_t *rail0 = rdma_recv_comm_get_rail(r_comm, 0);
+	ssize_t rc = 0;
+
+	rc = post_rma_key_fetch(req, rma_op_data, rail0->local_ep, rail0->remote_addr);
+	if (rc != 0) {
+		return rc;
+	}
+
+	for (; rma_op_data->op_idx < rma_op_data->num_ops; rma_op_data->op_idx++) {
+		nccl_net_ofi_rdma_rma_op_t *op = &rma_op_data->ops[rma_op_data->op_idx];
+		nccl_net_ofi_schedule_t *schedule = op->schedule;
+
+		size_t num_xfers = fast_path_num_xfers<NUM_RAILS>(schedule);
+
+		for (; rma_op_data->xferred_rail_id < num_xfers; rma_op_data->xferred_rail_id++) {
+			nccl_net_ofi_xfer_info_t *xfer_info = &schedule->rail_xfer_infos[rma_op_data->xferred_rail_id];
+			int rail_id = xfer_info->rail_id;
+			nccl_net_ofi_rdma_recv_comm_rail_t *comm_rail = rdma_recv_comm_get_rail(r_comm, rail_id);
+			void *desc = fi_mr_desc(op->buff_mr_handle->mr[rail_id]);
+
+			struct iovec iov;
+			struct fi_msg_rma msg;
+			struct fi_rma_iov rma_iov;
+
+			iov.iov_base = (void *)((uintptr_t)op->buff + xfer_info->offset);
+			iov.iov_len = xfer_info->msg_size;
+
+			rma_iov.addr = op->remote_buff + xfer_info->offset;
+			rma_iov.len = xfer_info->msg_size;
+			rma_iov.key = op->remote_mr_key[rail_id];
+
+			msg.msg_iov = &iov;
+			msg.desc = &desc;
+			msg.iov_count = 1;
+			msg.addr = comm_rail->remote_addr;
+			msg.rma_iov = &rma_iov;
+			msg.rma_iov_count = 1;
+			msg.context = (void *)&req->ctx[rail_id];
+			msg.data = 0;
+
+			/* Post RMA read */
+			rc = fi_readmsg(comm_rail->local_ep, &msg,
+					FI_COMPLETION | rma_stripe_flags(rma_op_data, rail_id));
+
+			if ((rc != 0) && (rc != -FI_EAGAIN)) {
+				NCCL_OFI_WARN("fi_readmsg failed; RC: %zd, Error: %s",
+					      rc, fi_strerror(-rc));
+				return rc;
+			} else if (rc != 0) {
+				return rc;
+			}
+			rma_stripe_posted(req, rma_op_data, rail_id);
+		}
+		rma_op_data->xferred_rail_id = 0;
+	}
+	assert(rma_stripes_flushed(rma_op_data));
+
+	return 0;
+}
+
+static int post_rma_read(nccl_net_ofi_rdma_req_t *req)
+{
+	return rdma_req_get_ep(req)->fast_path->post_rma_read(req);
 }
 
 /*
@@ -1846,6 +2521,9 @@ static int receive_progress(nccl_net_ofi_rdma_req_t *req, bool add_to_pending)
 		case NCCL_OFI_RDMA_SEND_CLOSE:
 			rc = post_close_msg(req);
 			break;
+		case NCCL_OFI_RDMA_SEND_CREDIT:
+			rc = post_credit_msg(req);
+			break;
 		case NCCL_OFI_RDMA_FLUSH:
 			rc = post_flush_req(req);
 			break;
@@ -1872,10 +2550,10 @@ static int receive_progress(nccl_net_ofi_rdma_req_t *req, bool add_to_pending)
 		/* Extract ep */
 		nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)r_comm->base.base.ep;
 		/* Place in pending requests queue for next try */
-		int ret = nccl_ofi_deque_insert_back(ep->pending_reqs_queue,
+		int ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue,
 						     &req->pending_reqs_elem);
 		if (ret != 0) {
-			NCCL_OFI_WARN("Failed to nccl_ofi_deque_insert_back: %d", ret);
+			NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
 			return ret;
 		} else {
 			rc = 0;
@@ -1898,22 +2576,38 @@ static int receive_progress(nccl_net_ofi_rdma_req_t *req, bool add_to_pending)
 static int process_pending_reqs(nccl_net_ofi_rdma_ep_t *ep)
 {
 	int rc = 0;
-	nccl_ofi_deque_elem_t *deque_elem;
-	nccl_ofi_deque_t *pending_reqs_queue = ep->pending_reqs_queue;
+	nccl_ofi_mpsc_queue_elem_t *queue_elem;
+	nccl_ofi_mpsc_queue_t *pending_reqs_queue = ep->pending_reqs_queue;
+	nccl_net_ofi_rdma_req_t *first_backoff_req = NULL;
+
+	/* Comm cleanup may progress endpoints of other threads. If another
+	 * thread is already draining the queue, leave it to that thread. */
+	if (!nccl_ofi_mpsc_queue_consumer_enter(pending_reqs_queue)) {
+		return 0;
+	}
 
 	while (true) {
-		rc = nccl_ofi_deque_remove_front(pending_reqs_queue, &deque_elem);
+		rc = nccl_ofi_mpsc_queue_pop(pending_reqs_queue, &queue_elem);
 		if (OFI_UNLIKELY(rc != 0)) {
-			NCCL_OFI_WARN("Failed to nccl_ofi_deque_remove_front: %d", rc);
-			return rc;
+			NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_pop: %d", rc);
+			goto exit;
 		}
 
-		if (deque_elem == NULL) {
-			/* Deque is empty */
+		if (queue_elem == NULL) {
+			/* Queue is empty */
 			break;
 		}
 
-		nccl_net_ofi_rdma_req_t *req = container_of(deque_elem, nccl_net_ofi_rdma_req_t, pending_reqs_elem);
+		nccl_net_ofi_rdma_req_t *req = container_of(queue_elem, nccl_net_ofi_rdma_req_t, pending_reqs_elem);
+		if (req == first_backoff_req) {
+			/* All other requests were tried once */
+			rc = nccl_ofi_mpsc_queue_push_front(pending_reqs_queue, &req->pending_reqs_elem);
+			if (rc != 0) {
+				NCCL_OFI_WARN("Failed to push_front pending request");
+			}
+			goto exit;
+		}
+
 		switch (req->type) {
 			case NCCL_OFI_RDMA_WRITE:
 			case NCCL_OFI_RDMA_SEND:
@@ -1924,6 +2618,7 @@ static int process_pending_reqs(nccl_net_ofi_rdma_ep_t *ep)
 			case NCCL_OFI_RDMA_READ:
 			case NCCL_OFI_RDMA_EAGER_COPY:
 			case NCCL_OFI_RDMA_SEND_CTRL:
+			case NCCL_OFI_RDMA_SEND_CREDIT:
 			case NCCL_OFI_RDMA_FLUSH:
 				rc = receive_progress(req, false);
 				break;
@@ -1937,35 +2632,55 @@ static int process_pending_reqs(nccl_net_ofi_rdma_ep_t *ep)
 			case NCCL_OFI_RDMA_INVALID_TYPE:
 			default:
 				NCCL_OFI_WARN("Unexpected type: %d", req->type);
-				return -EINVAL;
+				rc = -EINVAL;
+				goto exit;
 		}
 
-		if ((rc != 0) && (rc != -FI_EAGAIN)) {
+		if (rc == -EINPROGRESS) {
+			/* Failed stripes wait for their backoff delay. Requeue
+			 * the request at the tail, so that the requests behind
+			 * it are not held up. */
+			rc = nccl_ofi_mpsc_queue_push(pending_reqs_queue, &req->pending_reqs_elem);
+			if (rc != 0) {
+				NCCL_OFI_WARN("Failed to push pending request");
+				goto exit;
+			}
+			if (first_backoff_req == NULL) {
+				first_backoff_req = req;
+			}
+			continue;
+		} else if ((rc != 0) && (rc != -FI_EAGAIN)) {
 			NCCL_OFI_WARN("Unable to post request; RC: %d", rc);
 			break;
 		} else if (rc == -FI_EAGAIN) {
 			/* Put the request in the front of the queue and try again later */
-			rc = nccl_ofi_deque_insert_front(pending_reqs_queue, &req->pending_reqs_elem);
+			rc = nccl_ofi_mpsc_queue_push_front(pending_reqs_queue, &req->pending_reqs_elem);
 			if (rc != 0) {
-				NCCL_OFI_WARN("Failed to insert_front pending request");
-				return rc;
+				NCCL_OFI_WARN("Failed to push_front pending request");
+				goto exit;
 			}
 			break;
 		}
 		NCCL_OFI_TRACE_PENDING_REMOVE(req);
 	}
+
+ exit:
+	nccl_ofi_mpsc_queue_consumer_exit(pending_reqs_queue);
 	return rc;
 }
 
 static int ofi_process_cq_rail(nccl_net_ofi_rdma_ep_t *ep, nccl_net_ofi_ep_rail_t *rail)
 {
-	struct fi_cq_data_entry cqe_buffers[cq_read_count];
+	size_t read_count = ep->cq_read_count;
+	struct fi_cq_data_entry cqe_buffers[NCCL_OFI_RDMA_MAX_CQ_READ_COUNT];
 	ssize_t rc = 0;
 	int ret = 0;
 
+	assert(read_count <= NCCL_OFI_RDMA_MAX_CQ_READ_COUNT);
+
 	while (true) {
 		/* Receive completions for the given endpoint */
-		rc = fi_cq_read(rail->cq, cqe_buffers, cq_read_count);
+		rc = fi_cq_read(rail->cq, cqe_buffers, read_count);
 		if (rc > 0) {
 			ret = process_completions(cqe_buffers, rc, rdma_endpoint_get_device(ep), rail->rail_id);
 			if (OFI_UNLIKELY(ret != 0))
@@ -1994,27 +2709,230 @@ static int ofi_process_cq_rail(nccl_net_ofi_rdma_ep_t *ep, nccl_net_ofi_ep_rail_
 		}
 	}
 
-exit:
-	return ret;
+exit:
+	return ret;
+}
+
+/*
+ * @brief	Return true if the completion queue of data rail `rail_id'
+ *		may have entries to read
+ *
+ * Besides completions of local operations, in-flight receives expect
+ * RDMA writes and eager messages on every data rail and in-flight
+ * sends expect control messages on the control rails. Everything else
+ * (connection, close and unsolicited control messages) is picked up
+ * when idle rails are polled every `idle_cq_poll_interval' calls.
+ */
+static inline bool rail_cq_is_ready(nccl_net_ofi_rdma_ep_t *ep, int rail_id, bool idle_poll)
+{
+	if (idle_poll) {
+		return true;
+	}
+
+	if (rdma_endpoint_get_rail(ep, rail_id)->num_cq_ops_inflight > 0 ||
+	    ep->num_recvs_inflight > 0) {
+		return true;
+	}
+
+	return rail_id < ep->num_control_rails && ep->num_sends_inflight > 0;
+}
+
+/*
+ * @brief	Advance the drained mark of the rail's write counter
+ *
+ * A counter only tells how many writes completed, not which. Only if
+ * it caught up with the number of posted writes, all writes posted so
+ * far are known to be complete. post_rdma_write_cntr() holds back new
+ * writes once the rail has write_cntr_fence_interval undrained writes,
+ * so the counter catches up periodically even if the rail never goes
+ * idle. Writes are posted and the counter is read by the thread
+ * owning the endpoint, so reading the counter before the number of
+ * posted writes cannot miss a write.
+ *
+ * Failed writes increment the error counter instead of the counter.
+ * The failing write cannot be identified, so all writes that were not
+ * drained when the error was observed are considered failed. Writes
+ * posted afterwards are not, and once the counter drained past the
+ * failed ones, the rail is healthy again.
+ */
+static inline void update_write_cntr_rail(nccl_net_ofi_ep_rail_t *rail)
+{
+	if (rail->write_cntr_drained == rail->write_cntr_posted) {
+		return;
+	}
+
+	uint64_t errors = fi_cntr_readerr(rail->write_cntr);
+	if (OFI_UNLIKELY(errors != rail->write_cntr_errors)) {
+		NCCL_OFI_WARN("%" PRIu64 " RDMA writes tracked by write counter failed",
+			      errors - rail->write_cntr_errors);
+		if (!rail->write_cntr_failed) {
+			rail->write_cntr_failed = true;
+			rail->write_cntr_good = rail->write_cntr_drained;
+		}
+		rail->write_cntr_bad = rail->write_cntr_posted;
+		rail->write_cntr_errors = errors;
+	}
+
+	uint64_t completed = fi_cntr_read(rail->write_cntr) + errors;
+	if (completed >= rail->write_cntr_posted) {
+		rail->write_cntr_drained = rail->write_cntr_posted;
+		/* Keep the range of failed writes for requests that
+		 * were not checked yet */
+		if (rail->write_cntr_failed && rail->write_cntr_drained >= rail->write_cntr_bad) {
+			rail->write_cntr_failed = false;
+		}
+	}
+}
+
+/*
+ * @brief	Complete send request whose writes were tracked by
+ *		write counters once all its rails drained past them
+ */
+static inline int check_write_cntr_completion(nccl_net_ofi_rdma_ep_t *ep,
+					      nccl_net_ofi_rdma_req_t *req)
+{
+	rdma_req_send_data_t *send_data = get_send_data(req);
+	nccl_net_ofi_schedule_t *schedule = send_data->schedule;
+
+	/* Eager sends and sends still waiting for the control message
+	 * or for posting all writes are not tracked by counters */
+	if (send_data->eager || schedule == NULL ||
+	    send_data->xferred_rail_id != schedule->num_xfer_infos) {
+		return 0;
+	}
+
+	for (size_t i = 0; i != schedule->num_xfer_infos; ++i) {
+		int rail_id = schedule->rail_xfer_infos[i].rail_id;
+		nccl_net_ofi_ep_rail_t *rail = rdma_endpoint_get_rail(ep, rail_id);
+		uint64_t threshold = send_data->write_cntr_threshold[rail_id];
+		if (OFI_UNLIKELY(rail->write_cntr_good < threshold && threshold <= rail->write_cntr_bad)) {
+			NCCL_OFI_WARN("RDMA write of send request %p on rail %d failed", req, rail_id);
+			set_request_state_to_error(req);
+			return 0;
+		}
+		if (rail->write_cntr_drained < threshold) {
+			return 0;
+		}
+	}
+
+	/* Account one completion per write, as the completion entries
+	 * would have */
+	for (size_t i = 0; i != schedule->num_xfer_infos; ++i) {
+		NCCL_OFI_TRACE_SEND_WRITE_SEG_COMPLETE(req->dev_id, schedule->rail_xfer_infos[i].rail_id,
+						       req->comm, req->msg_seq_num, req);
+		int ret = inc_req_completion(req, 0, send_data->total_num_compls);
+		if (OFI_UNLIKELY(ret != 0)) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * @brief	Process completion entries for the given completion queue.
+ *		This also updates several request fileds like size, status, etc
+ *
+ * @return	0, on success
+ *		error, on others
+ */
+/*
+ * @brief	Set the bounds of posted rx buffers of the endpoint rails
+ *		from RDMA_{MIN,MAX}_POSTED_BOUNCE_BUFFERS
+ *
+ * The parameters account for all the rails, so scale down bounds to
+ * what a single rail would need.
+ */
+static void rdma_endpoint_set_rx_buff_bounds(nccl_net_ofi_rdma_ep_t *ep)
+{
+	size_t min_posted = (size_t)std::max(ofi_nccl_rdma_min_posted_bounce_buffers(), (int64_t)0);
+	size_t max_posted = (size_t)std::max(ofi_nccl_rdma_max_posted_bounce_buffers(), (int64_t)0);
+	nccl_net_ofi_ep_rail_t *rail;
+
+	for (int rail_id = 0; rail_id < ep->num_control_rails; ++rail_id) {
+		rail = rdma_endpoint_get_control_rail(ep, rail_id);
+		nccl_net_ofi_mutex_lock(&rail->rx_buff_mutex);
+		rail->min_rx_buff_posted = NCCL_OFI_DIV_CEIL(min_posted, ep->num_control_rails);
+		rail->max_rx_buff_posted = NCCL_OFI_DIV_CEIL(max_posted, ep->num_control_rails);
+		nccl_net_ofi_mutex_unlock(&rail->rx_buff_mutex);
+	}
+
+	/* Data rails only receive eager messages */
+	for (int rail_id = 0; rail_id < ep->num_rails; ++rail_id) {
+		rail = rdma_endpoint_get_rail(ep, rail_id);
+		nccl_net_ofi_mutex_lock(&rail->rx_buff_mutex);
+		if (ep->eager_rx_buff_size >= 0) {
+			rail->min_rx_buff_posted = NCCL_OFI_DIV_CEIL(min_posted, ep->num_rails);
+			rail->max_rx_buff_posted = NCCL_OFI_DIV_CEIL(max_posted, ep->num_rails);
+		} else {
+			rail->min_rx_buff_posted = 0;
+			rail->max_rx_buff_posted = 0;
+		}
+		nccl_net_ofi_mutex_unlock(&rail->rx_buff_mutex);
+	}
+}
+
+/*
+ * @brief	Re-derive endpoint state from dynamic parameters
+ *
+ * Eager messages must fit into the rx buffers allocated at startup and
+ * into a single stripe, so EAGER_MAX_SIZE is capped accordingly.
+ * Lowered rx buffer bounds take effect as posted buffers complete.
+ */
+static void rdma_endpoint_apply_dynamic_params(nccl_net_ofi_rdma_ep_t *ep, uint64_t param_epoch)
+{
+	nccl_net_ofi_rdma_device_t *device = rdma_endpoint_get_device(ep);
+	size_t min_stripe_size = std::max(ofi_nccl_min_stripe_size(), (uint64_t)1);
+	ssize_t eager_max_size = (ssize_t)ofi_nccl_eager_max_size();
+
+	ep->param_epoch = param_epoch;
+
+	ep->cq_read_count = (size_t)std::clamp(ofi_nccl_cq_read_count(), (int64_t)1,
+					       (int64_t)NCCL_OFI_RDMA_MAX_CQ_READ_COUNT);
+
+#ifndef NDEBUG
+	ep->inject_stripe_errors = ep->stripe_retry_max > 0 ? ofi_nccl_inject_stripe_errors() : 0;
+#endif
+
+	/* Shared by the endpoints of the device */
+	nccl_net_ofi_threshold_scheduler_set_min_stripe_size(device->scheduler, min_stripe_size);
+
+	if (ep->eager_rx_buff_size < 0 || eager_max_size < 0) {
+		ep->eager_send_size = -1;
+	} else {
+		ep->eager_send_size = std::min({eager_max_size, ep->eager_rx_buff_size,
+						(ssize_t)min_stripe_size});
+	}
+
+	rdma_endpoint_set_rx_buff_bounds(ep);
+
+	NCCL_OFI_INFO(NCCL_NET, "Endpoint %p applied parameter epoch %lu: eager size %zd, CQ read count %zu, stripe size %zu",
+		      ep, param_epoch, ep->eager_send_size, ep->cq_read_count, min_stripe_size);
 }
 
-/*
- * @brief	Process completion entries for the given completion queue.
- *		This also updates several request fileds like size, status, etc
- *
- * @return	0, on success
- *		error, on others
- */
 static int ofi_process_cq(nccl_net_ofi_rdma_ep_t *ep)
 {
 	int ret;
+	bool idle_poll = (ep->idle_cq_poll_interval == 0) ||
+		((ep->num_cq_polls++ % ep->idle_cq_poll_interval) == 0);
+
+	uint64_t param_epoch = nccl_ofi_param_get_epoch();
+	if (OFI_UNLIKELY(param_epoch != ep->param_epoch)) {
+		rdma_endpoint_apply_dynamic_params(ep, param_epoch);
+	}
 
 	for (int rail_id = 0; rail_id != ep->num_rails; ++rail_id) {
 		nccl_net_ofi_ep_rail_t *rail = rdma_endpoint_get_rail(ep, rail_id);
 
-		ret = ofi_process_cq_rail(ep, rail);
-		if (ret != 0) {
-			goto exit;
+		if (rail_cq_is_ready(ep, rail_id, idle_poll)) {
+			ret = ofi_process_cq_rail(ep, rail);
+			if (ret != 0) {
+				goto exit;
+			}
+		}
+
+		if (rail->write_cntr != NULL) {
+			update_write_cntr_rail(rail);
 		}
 	}
 
@@ -2050,12 +2968,11 @@ static inline void zero_nccl_ofi_req(nccl_net_ofi_rdma_req_t *req)
  * @brief	Free request by returning request back into freelist
  */
 static inline int free_base_req(uint64_t *num_inflight_reqs,
-					 nccl_ofi_freelist_t *nccl_ofi_reqs_fl,
+					 nccl_net_ofi_rdma_req_fl_t *nccl_ofi_reqs_fl,
 					 nccl_net_ofi_rdma_req_t *req,
 					 bool dec_inflight_reqs)
 {
 	int ret = 0;
-	nccl_ofi_freelist_elem_t *elem = NULL;
 	
 	if (OFI_UNLIKELY(req == NULL)) {
 		ret = -EINVAL;
@@ -2070,12 +2987,10 @@ static inline int free_base_req(uint64_t *num_inflight_reqs,
 		goto exit;
 	}
 
-	elem = req->elem;
-
 	/* Zero out buffer */
 	zero_nccl_ofi_req(req);
 
-	nccl_ofi_freelist_entry_free(nccl_ofi_reqs_fl, elem);
+	nccl_ofi_reqs_fl->entry_free(req);
 
 	/* Reduce inflight commands */
 	if (OFI_LIKELY(dec_inflight_reqs == true) && (num_inflight_reqs != NULL))
@@ -2085,6 +3000,58 @@ static inline int free_base_req(uint64_t *num_inflight_reqs,
 	return ret;
 }
 
+/*
+ * @brief	Return true if all posted operations of a one-sided RMA
+ *		request completed, successfully or not
+ */
+static inline bool rma_req_drained(nccl_net_ofi_rdma_req_t *req)
+{
+	rdma_req_rma_op_data_t *rma_op_data = req_get_rma_op_data(req, req->type);
+	bool drained;
+
+	nccl_net_ofi_mutex_lock(&req->req_lock);
+	drained = (req->ncompls + rma_op_data->num_err_compls >= rma_op_data->num_posted_compls);
+	nccl_net_ofi_mutex_unlock(&req->req_lock);
+
+	return drained;
+}
+
+/*
+ * @brief	Release the rail schedules and batch of a one-sided RMA request
+ */
+static inline void release_rma_op_data(nccl_net_ofi_rdma_req_t *req,
+				       nccl_net_ofi_rdma_req_type_t type)
+{
+	rdma_req_rma_op_data_t *rma_op_data = req_get_rma_op_data(req, type);
+	nccl_net_ofi_rdma_device_t *device = rdma_req_get_device(req);
+
+	/* The fetched key table entry is usable once the request
+	 * completed, and only if it still belonged to the key handle */
+	if (rma_op_data->key_fetch_idx >= 0) {
+		nccl_net_ofi_rdma_rma_key_cache_t *cache = rdma_req_get_rma_key_cache(req);
+		int idx = rma_op_data->key_fetch_idx;
+
+		if (rma_op_data->key_fetch_posted && req->state == NCCL_OFI_RDMA_REQ_COMPLETED &&
+		    cache->entries[idx].handle == rma_op_data->key_fetch_handle) {
+			cache->state[idx] = NCCL_OFI_RDMA_RMA_KEY_CACHE_VALID;
+		} else {
+			cache->state[idx] = NCCL_OFI_RDMA_RMA_KEY_CACHE_EMPTY;
+		}
+		rma_op_data->key_fetch_idx = -1;
+	}
+
+	for (size_t i = 0; i < rma_op_data->num_ops; i++) {
+		nccl_net_ofi_release_schedule(device->scheduler, rma_op_data->ops[i].schedule);
+	}
+	rma_op_data->num_ops = 0;
+
+	if (rma_op_data->batch) {
+		nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)req->comm->ep;
+		ep->rma_batch_fl->entry_free(rma_op_data->batch);
+		rma_op_data->batch = NULL;
+	}
+}
+
 /*
  * @brief	Free write request
  */
@@ -2094,6 +3061,9 @@ static inline int free_write_req(nccl_net_ofi_rdma_req_t *req,
 	assert(req->type == NCCL_OFI_RDMA_WRITE);
 	nccl_net_ofi_rdma_send_comm_t *s_comm =
 		(nccl_net_ofi_rdma_send_comm_t *)req->comm;
+
+	release_rma_op_data(req, NCCL_OFI_RDMA_WRITE);
+
 	return free_base_req(&s_comm->num_inflight_reqs, s_comm->nccl_ofi_reqs_fl,
 			req, dec_inflight_reqs);
 }
@@ -2108,6 +3078,8 @@ static inline int free_read_req(nccl_net_ofi_rdma_req_t *req,
 	nccl_net_ofi_rdma_recv_comm_t *r_comm =
 		(nccl_net_ofi_rdma_recv_comm_t *)req->comm;
 
+	release_rma_op_data(req, NCCL_OFI_RDMA_READ);
+
 	return free_base_req(&r_comm->num_inflight_reqs, r_comm->nccl_ofi_reqs_fl,
 			req, dec_inflight_reqs);
 }
@@ -2137,6 +3109,12 @@ static inline int free_send_req(nccl_net_ofi_rdma_req_t *req,
 		(s_comm->num_inflight_writes)--;
 	}
 
+	if (dec_inflight_reqs) {
+		nccl_net_ofi_rdma_ep_t *ep = rdma_req_get_ep(req);
+		assert(ep->num_sends_inflight > 0);
+		(ep->num_sends_inflight)--;
+	}
+
 	if (send_data->schedule) {
 		nccl_net_ofi_rdma_device_t *device = rdma_req_get_device(req);
 		nccl_net_ofi_release_schedule(device->scheduler, send_data->schedule);
@@ -2147,6 +3125,94 @@ static inline int free_send_req(nccl_net_ofi_rdma_req_t *req,
 			req, dec_inflight_reqs);
 }
 
+/*
+ * @brief	Determine how the destination buffer of a receive is
+ *		announced to the sender
+ *
+ * A buffer that matches the advertisement of its ring slot, which is
+ * known to the sender, only requires a credit. A slot without
+ * receives in flight is (re-)advertised with a full control message.
+ */
+static inline nccl_net_ofi_rdma_recv_ring_mode_t recv_ring_get_mode(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+								   uint16_t msg_seq_num, void *buff,
+								   size_t size,
+								   nccl_net_ofi_rdma_mr_handle_t *mr_handle,
+								   bool recv_completion_optional)
+{
+	if (!r_comm->recv_ring_enabled || recv_completion_optional) {
+		return NCCL_OFI_RDMA_RECV_RING_NONE;
+	}
+
+	nccl_net_ofi_rdma_recv_ring_slot_t *slot =
+		&r_comm->recv_ring[msg_seq_num % NCCL_OFI_RDMA_RECV_RING_DEPTH];
+
+	if (slot->adv_completed && slot->mr_handle == mr_handle &&
+	    slot->buff == buff && slot->buff_len == size) {
+		return NCCL_OFI_RDMA_RECV_RING_CREDIT;
+	}
+
+	if (slot->num_inflight == 0) {
+		return NCCL_OFI_RDMA_RECV_RING_ADV;
+	}
+
+	return NCCL_OFI_RDMA_RECV_RING_NONE;
+}
+
+/*
+ * @brief	Account a posted receive to its ring slot
+ */
+static inline void recv_ring_acquire(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+				     nccl_net_ofi_rdma_req_t *req)
+{
+	rdma_req_recv_data_t *recv_data = get_recv_data(req);
+	nccl_net_ofi_rdma_recv_ring_slot_t *slot =
+		&r_comm->recv_ring[req->msg_seq_num % NCCL_OFI_RDMA_RECV_RING_DEPTH];
+
+	if (recv_data->ring_mode == NCCL_OFI_RDMA_RECV_RING_NONE) {
+		return;
+	}
+
+	if (recv_data->ring_mode == NCCL_OFI_RDMA_RECV_RING_ADV) {
+		slot->buff = recv_data->dst_buff;
+		slot->buff_len = recv_data->dst_len;
+		slot->mr_handle = recv_data->dest_mr_handle;
+		slot->adv_completed = false;
+	}
+	slot->num_inflight++;
+}
+
+/*
+ * @brief	Release a receive from its ring slot
+ *
+ * The advertisement is only usable for credits once the sender is
+ * known to have processed it, i.e., once the advertising receive was
+ * completed by an RDMA write of the sender. Receives completed by an
+ * eager message leave the slot to be advertised again.
+ */
+static inline void recv_ring_release(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+				     nccl_net_ofi_rdma_req_t *req)
+{
+	rdma_req_recv_data_t *recv_data = get_recv_data(req);
+	nccl_net_ofi_rdma_recv_ring_slot_t *slot =
+		&r_comm->recv_ring[req->msg_seq_num % NCCL_OFI_RDMA_RECV_RING_DEPTH];
+
+	if (recv_data->ring_mode == NCCL_OFI_RDMA_RECV_RING_NONE) {
+		return;
+	}
+
+	assert(slot->num_inflight > 0);
+	slot->num_inflight--;
+
+	if (recv_data->ring_mode == NCCL_OFI_RDMA_RECV_RING_ADV &&
+	    req->state == NCCL_OFI_RDMA_REQ_COMPLETED &&
+	    recv_data->recv_segms_req != NULL &&
+	    recv_data->recv_segms_req->state == NCCL_OFI_RDMA_REQ_COMPLETED &&
+	    slot->mr_handle == recv_data->dest_mr_handle &&
+	    slot->buff == recv_data->dst_buff) {
+		slot->adv_completed = true;
+	}
+}
+
 /*
  * @brief	Free receive request
  */
@@ -2162,6 +3228,14 @@ static inline int free_recv_req(nccl_net_ofi_rdma_req_t *req,
 	nccl_net_ofi_rdma_req_t *recv_segms_req = recv_data->recv_segms_req;
 	nccl_net_ofi_rdma_req_t *eager_copy_req = recv_data->eager_copy_req;
 
+	recv_ring_release(r_comm, req);
+
+	if (dec_inflight_reqs) {
+		nccl_net_ofi_rdma_ep_t *ep = rdma_req_get_ep(req);
+		assert(ep->num_recvs_inflight > 0);
+		(ep->num_recvs_inflight)--;
+	}
+
 	if (send_ctrl_req) {
 		ret = send_ctrl_req->free(send_ctrl_req, false);
 		if (ret) {
@@ -2256,6 +3330,26 @@ static inline int free_send_close_req(nccl_net_ofi_rdma_req_t *req,
 			     req, dec_inflight_reqs);
 }
 
+/*
+ * @brief	Free send credit request
+ */
+static inline int free_send_credit_req(nccl_net_ofi_rdma_req_t *req,
+				       bool dec_inflight_reqs)
+{
+	assert(req->type == NCCL_OFI_RDMA_SEND_CREDIT);
+	nccl_net_ofi_rdma_recv_comm_t *r_comm =
+		(nccl_net_ofi_rdma_recv_comm_t *)req->comm;
+	rdma_req_send_credit_data_t *send_credit_data = req_get_send_credit_data(req);
+
+	if (send_credit_data->ctrl_fl_elem) {
+		nccl_ofi_freelist_entry_free(r_comm->ctrl_buff_fl, send_credit_data->ctrl_fl_elem);
+		send_credit_data->ctrl_fl_elem = NULL;
+	}
+
+	return free_base_req(&r_comm->num_inflight_reqs, r_comm->nccl_ofi_reqs_fl,
+			     req, dec_inflight_reqs);
+}
+
 /*
  * @brief	Free send connect and receive connect response request of send communicator
  */
@@ -2389,9 +3483,9 @@ static inline int handle_rx_eagain(nccl_net_ofi_rdma_ep_t *ep,
 				       nccl_net_ofi_rdma_req_t *req, size_t num_buffs_failed)
 {
 	/* Add to pending reqs queue */
-	int ret = nccl_ofi_deque_insert_back(ep->pending_reqs_queue, &req->pending_reqs_elem);
+	int ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &req->pending_reqs_elem);
 	if (ret != 0) {
-		NCCL_OFI_WARN("Failed to nccl_ofi_deque_insert_back: %d", ret);
+		NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
 		return ret;
 	}
 	NCCL_OFI_TRACE_PENDING_INSERT(req);
@@ -2413,9 +3507,12 @@ static inline int post_rx_buffs_on_rail(nccl_net_ofi_rdma_ep_t *ep,
 
 	nccl_net_ofi_mutex_lock(&rail->rx_buff_mutex);
 
-	size_t buffers_needed = rail->max_rx_buff_posted -
-				rail->num_rx_buff_posted;
-	rail->num_rx_buff_posted = rail->max_rx_buff_posted;
+	/* The maximum may have been lowered below the posted count */
+	size_t buffers_needed = 0;
+	if (rail->num_rx_buff_posted < rail->max_rx_buff_posted) {
+		buffers_needed = rail->max_rx_buff_posted - rail->num_rx_buff_posted;
+		rail->num_rx_buff_posted = rail->max_rx_buff_posted;
+	}
 
 	nccl_net_ofi_mutex_unlock(&rail->rx_buff_mutex);
 
@@ -2565,11 +3662,122 @@ static int init_send_comm_rails(nccl_net_ofi_rdma_send_comm_t *s_comm,
 				      dev_id, fi_strerror(-ret));
 			return -EINVAL;
 		}
+
+		if (s_comm->ll_rails == NULL) {
+			continue;
+		}
+
+		/* The low-latency endpoint writes to the same remote
+		 * data endpoint, only its traffic class differs */
+		comm_rail = &s_comm->ll_rails[rail_id];
+		ep_rail = &ep->ll_rails[rail_id];
+
+		comm_rail->local_ep = ep_rail->ofi_ep;
+
+		ret = fi_av_insert(ep_rail->av, (void *)remote_rdma_ep_name->ep_name, 1,
+				   &comm_rail->remote_addr, 0, NULL);
+		if (OFI_UNLIKELY(ret != 1)) {
+			NCCL_OFI_WARN("Unable to insert remote address into low-latency address vector "
+				      "for device %d. RC: %s",
+				      dev_id, fi_strerror(-ret));
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * @brief	Post the send requests issued before the connect response
+ *		arrived
+ *
+ * The requests wait in the message buffer. Eager requests and
+ * requests whose control message arrived are posted now, after their
+ * immediate data is built again with the communicator ID of the
+ * receiver, which was unknown until now. The others are posted when
+ * their control message arrives. Caller must hold conn_lock.
+ */
+static int send_comm_post_early_sends(nccl_net_ofi_rdma_send_comm_t *s_comm)
+{
+	int ret = 0;
+	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)s_comm->base.base.ep;
+
+	/* Sends issued before the connection advanced
+	 * next_msg_seq_num under conn_lock, later ones post
+	 * themselves */
+	uint16_t end_msg_seq_num = s_comm->next_msg_seq_num;
+
+	for (uint16_t msg_seq_num = 0; msg_seq_num != end_msg_seq_num; ++msg_seq_num) {
+		nccl_net_ofi_rdma_req_t *req = NULL;
+		ret = get_inprogress_send_req(s_comm, msg_seq_num, &req);
+		if (OFI_UNLIKELY(ret != 0)) {
+			return ret;
+		}
+
+		rdma_req_send_data_t *send_data = get_send_data(req);
+		if (send_data->schedule == NULL) {
+			continue;
+		}
+		send_data->wdata = GET_RDMA_WRITE_IMM_DATA(s_comm->remote_comm_id, msg_seq_num,
+							   send_data->schedule->num_xfer_infos);
+
+		ret = send_progress(req);
+		if (ret == -FI_EAGAIN || ret == -EINPROGRESS) {
+			/* Add to pending reqs queue */
+			ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &req->pending_reqs_elem);
+			if (OFI_UNLIKELY(ret != 0)) {
+				NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
+				return ret;
+			}
+			NCCL_OFI_TRACE_PENDING_INSERT(req);
+		} else if (OFI_UNLIKELY(ret != 0)) {
+			return ret;
+		}
 	}
 
 	return 0;
 }
 
+/*
+ * @brief	Return true if requests of the send communicator are posted
+ *		right away rather than by finish_connect()
+ */
+static inline bool send_comm_is_connected(nccl_net_ofi_rdma_send_comm_t *s_comm)
+{
+	if (OFI_LIKELY(s_comm->connected.load(std::memory_order_acquire))) {
+		return true;
+	}
+
+	nccl_net_ofi_mutex_lock(&s_comm->conn_lock);
+	bool connected = s_comm->connected.load(std::memory_order_relaxed);
+	nccl_net_ofi_mutex_unlock(&s_comm->conn_lock);
+
+	return connected;
+}
+
+/*
+ * @brief	Release the request of the connect message once its send
+ *		completed
+ */
+static void send_comm_release_conn_req(nccl_net_ofi_rdma_send_comm_t *s_comm)
+{
+	nccl_net_ofi_rdma_req_t *req = s_comm->conn_req;
+	nccl_net_ofi_rdma_req_state_t state;
+
+	if (req == NULL) {
+		return;
+	}
+
+	nccl_net_ofi_mutex_lock(&req->req_lock);
+	state = req->state;
+	nccl_net_ofi_mutex_unlock(&req->req_lock);
+
+	if (state == NCCL_OFI_RDMA_REQ_COMPLETED) {
+		req->free(req, false);
+		s_comm->conn_req = NULL;
+	}
+}
+
 /*
  * @brief	Execute second part of the connect functionality from listen/connect/accept
  *		connection establishment
@@ -2640,6 +3848,11 @@ static int finish_connect(nccl_net_ofi_rdma_send_comm_t *s_comm)
 	/* Set remote comm ID to remote recv comm ID */
 	s_comm->remote_comm_id = conn_resp->local_comm_id;
 
+	ret = create_rma_key_cache(ep, conn_resp, &s_comm->rma_key_cache);
+	if (ret != 0) {
+		return ret;
+	}
+
 	/* Initialize rails `1...num_rails-1' */
 	ret = init_send_comm_rails(s_comm, ep, dev_id,
 				   conn_resp->ep_names,
@@ -2656,6 +3869,14 @@ static int finish_connect(nccl_net_ofi_rdma_send_comm_t *s_comm)
 	nccl_ofi_freelist_entry_free(ep->conn_msg_fl, s_comm->conn_msg);
 	s_comm->conn_msg = NULL;
 
+	/* Post the early sends and publish the connection at once, so
+	 * that send() and control messages racing with the sweep
+	 * neither skip nor post a request twice */
+	nccl_net_ofi_mutex_lock(&s_comm->conn_lock);
+	ret = send_comm_post_early_sends(s_comm);
+	s_comm->connected.store(true, std::memory_order_release);
+	nccl_net_ofi_mutex_unlock(&s_comm->conn_lock);
+
 	return ret;
 }
 
@@ -2687,6 +3908,13 @@ static int test(nccl_net_ofi_req_t *base_req, int *done, int *size)
 		ret = ofi_process_cq(ep);
 		if (OFI_UNLIKELY(ret != 0))
 			goto exit;
+
+		if (ep->use_write_cntr && req->type == NCCL_OFI_RDMA_SEND &&
+		    req->state != NCCL_OFI_RDMA_REQ_ERROR) {
+			ret = check_write_cntr_completion(ep, req);
+			if (OFI_UNLIKELY(ret != 0))
+				goto exit;
+		}
 	}
 
 	/* Determine whether the request has finished without error and free if done */
@@ -2735,6 +3963,16 @@ static int test(nccl_net_ofi_req_t *base_req, int *done, int *size)
 		assert(req->free);
 		req->free(req, true);
 	} else if (OFI_UNLIKELY(req->state == NCCL_OFI_RDMA_REQ_ERROR)) {
+		if (req->type == NCCL_OFI_RDMA_WRITE || req->type == NCCL_OFI_RDMA_READ) {
+			/* Keep reporting the request as not done until all
+			 * its posted operations completed, then free it */
+			if (!rma_req_drained(req)) {
+				ret = ofi_process_cq(ep);
+				if (ret != 0 || !rma_req_drained(req))
+					goto exit;
+			}
+			req->free(req, true);
+		}
 		ret = -EINVAL;
 		goto exit;
 	}
@@ -2791,6 +4029,91 @@ static int prepare_recv_conn_req(nccl_net_ofi_rdma_listen_comm_t *l_comm)
 }
 
 
+/*
+ * @brief	Return the key handle of a registration, publishing the
+ *		provider keys of its rails in the RMA key table of the
+ *		device on first use
+ *
+ * If the table is full, the provider key of rail 0 is returned, which
+ * keeps one-sided operations on the registration on rail 0.
+ */
+static int get_rma_key_handle(nccl_net_ofi_rdma_device_t *device,
+			      nccl_net_ofi_rdma_mr_handle_t *mr_handle,
+			      uint64_t *mr_key)
+{
+	int ret = 0;
+	int slot;
+	uint64_t gen;
+	uint32_t keys[MAX_NUM_RAILS] = {};
+	nccl_net_ofi_rdma_rma_key_entry_t *entry = NULL;
+
+	nccl_net_ofi_mutex_lock(&device->rma_key_lock);
+
+	if (mr_handle->rma_key != 0) {
+		*mr_key = mr_handle->rma_key;
+		goto exit;
+	}
+
+	assert(mr_handle->num_rails <= MAX_NUM_RAILS);
+	for (int rail_id = 0; rail_id < mr_handle->num_rails; rail_id++) {
+		uint64_t key = fi_mr_key(mr_handle->mr[rail_id]);
+		if (OFI_UNLIKELY(key == FI_KEY_NOTAVAIL)) {
+			NCCL_OFI_WARN("Error retrieving MR key, leaking key");
+			ret = -ENOENT;
+			goto exit;
+		}
+		if (OFI_UNLIKELY(key > UINT32_MAX)) {
+			NCCL_OFI_WARN("MR key 0x%" PRIx64 " of rail %d exceeds 32 bits",
+				      key, rail_id);
+			ret = -EINVAL;
+			goto exit;
+		}
+		keys[rail_id] = (uint32_t)key;
+	}
+
+	slot = nccl_ofi_idpool_allocate_id(&device->rma_key_pool);
+	if (OFI_UNLIKELY(slot < 0)) {
+		NCCL_OFI_WARN("RMA key table is full, one-sided operations on this "
+			      "registration will use a single rail");
+		*mr_key = keys[0];
+		goto exit;
+	}
+
+	gen = ++(device->rma_key_gen[slot]) & ((1ULL << NCCL_OFI_RDMA_RMA_KEY_GEN_BITS) - 1);
+	mr_handle->rma_key = NCCL_OFI_RDMA_RMA_KEY_HANDLE_FLAG |
+		(gen << NCCL_OFI_RDMA_RMA_KEY_GEN_SHIFT) |
+		((uint64_t)slot << NCCL_OFI_RDMA_RMA_KEY_SLOT_SHIFT) | keys[0];
+
+	/* Publish the handle last. Peers only fetch the entry after
+	 * they received the handle. */
+	entry = &device->rma_key_table[slot];
+	memcpy(entry->keys, keys, sizeof(entry->keys));
+	entry->handle = mr_handle->rma_key;
+
+	*mr_key = mr_handle->rma_key;
+
+ exit:
+	nccl_net_ofi_mutex_unlock(&device->rma_key_lock);
+	return ret;
+}
+
+/*
+ * @brief	Remove the key handle of a registration from the RMA key
+ *		table of the device
+ */
+static void release_rma_key_handle(nccl_net_ofi_rdma_device_t *device,
+				   nccl_net_ofi_rdma_mr_handle_t *mr_handle)
+{
+	size_t slot = rma_key_handle_slot(mr_handle->rma_key);
+
+	device->rma_key_table[slot].handle = 0;
+	mr_handle->rma_key = 0;
+
+	if (OFI_UNLIKELY(nccl_ofi_idpool_free_id(&device->rma_key_pool, slot) != 0)) {
+		NCCL_OFI_WARN("Error freeing RMA key table slot %zu", slot);
+	}
+}
+
 /*
  * @brief	Deregister memory region
  *
@@ -2841,6 +4164,10 @@ static int dereg_mr(nccl_net_ofi_rdma_mr_handle_t *mr_handle,
 		}
 	}
 
+	if (mr_handle->rma_key != 0) {
+		release_rma_key_handle(rdma_domain_get_device(domain), mr_handle);
+	}
+
 	for (int rail_id = 0; rail_id < domain->num_rails; ++rail_id) {
 		/* No memory registration available for this rail */
 		if (mr_handle->mr[rail_id] == NULL) {
@@ -2851,6 +4178,8 @@ static int dereg_mr(nccl_net_ofi_rdma_mr_handle_t *mr_handle,
 		if (OFI_UNLIKELY(ret != 0)) {
 			NCCL_OFI_WARN("Unable to de-register memory. RC: %d, Error: %s",
 				      ret, fi_strerror(-ret));
+		} else {
+			nccl_ofi_mr_count_dereg();
 		}
 	}
 
@@ -2910,6 +4239,7 @@ static inline int reg_mr_on_device(nccl_net_ofi_rdma_domain_t *domain,
 
 	/* Register memory on each rail */
 	ret_handle->num_rails = num_rails;
+	ret_handle->type = type;
 	for (int rail_id = 0; rail_id != num_rails; ++rail_id) {
 		nccl_net_ofi_rdma_domain_rail_t *domain_rail = rdma_domain_get_rail(domain, rail_id);
 
@@ -2918,6 +4248,7 @@ static inline int reg_mr_on_device(nccl_net_ofi_rdma_domain_t *domain,
 		if (OFI_UNLIKELY(ret != 0)) {
 			goto error;
 		}
+		nccl_ofi_mr_count_reg();
 	}
 
 	*mhandle = ret_handle;
@@ -3152,6 +4483,46 @@ static int freelist_deregmr_host_fn(void *handle)
 	return 0;
 }
 
+/*
+ * @brief	Return index of control message descriptor cache entry for buffer
+ */
+static inline size_t ctrl_desc_cache_idx(void *buff)
+{
+	/* Fibonacci hashing; NCCL buffer slots are separated by large
+	 * power-of-two strides, so the low address bits are not usable
+	 * as an index */
+	uint64_t hash = (uint64_t)(uintptr_t)buff * 0x9E3779B97F4A7C15ULL;
+	return (size_t)(hash >> 32) & (NCCL_OFI_RDMA_CTRL_DESC_CACHE_SIZE - 1);
+}
+
+/*
+ * @brief	Drop all control message descriptors built from memory registration
+ */
+static inline void ctrl_desc_cache_invalidate(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+					      nccl_net_ofi_rdma_mr_handle_t *mr_handle)
+{
+	for (size_t i = 0; i < NCCL_OFI_RDMA_CTRL_DESC_CACHE_SIZE; i++) {
+		if (r_comm->ctrl_desc_cache[i].mr_handle == mr_handle) {
+			r_comm->ctrl_desc_cache[i].mr_handle = NULL;
+		}
+	}
+}
+
+/*
+ * @brief	Stop granting credits for ring slots advertising buffers of
+ *		`mr_handle'
+ */
+static inline void recv_ring_invalidate(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+					nccl_net_ofi_rdma_mr_handle_t *mr_handle)
+{
+	for (size_t i = 0; i < NCCL_OFI_RDMA_RECV_RING_DEPTH; i++) {
+		if (r_comm->recv_ring[i].mr_handle == mr_handle) {
+			r_comm->recv_ring[i].mr_handle = NULL;
+			r_comm->recv_ring[i].adv_completed = false;
+		}
+	}
+}
+
 static int dereg_mr_recv_comm(nccl_net_ofi_recv_comm_t *recv_comm,
 						nccl_net_ofi_mr_handle_t *mhandle)
 {
@@ -3163,28 +4534,71 @@ static int dereg_mr_recv_comm(nccl_net_ofi_recv_comm_t *recv_comm,
 	assert(domain != NULL);
 
 	nccl_net_ofi_rdma_mr_handle_t *mr_handle = (nccl_net_ofi_rdma_mr_handle_t *)mhandle;
+
+	/* The handle may be freed and its address reused by a later
+	 * registration, so cached rkeys must not outlive it */
+	ctrl_desc_cache_invalidate((nccl_net_ofi_rdma_recv_comm_t *)recv_comm, mr_handle);
+	recv_ring_invalidate((nccl_net_ofi_rdma_recv_comm_t *)recv_comm, mr_handle);
+
 	return dereg_mr(mr_handle, domain);
 }
 
 /*
  * @brief	Assign an allocated rdma request buffer
  */
-static inline nccl_net_ofi_rdma_req_t *allocate_req(nccl_ofi_freelist_t *fl)
+static inline nccl_net_ofi_rdma_req_t *allocate_req(nccl_net_ofi_rdma_req_fl_t *fl)
+{
+	assert(fl != NULL);
+
+	nccl_net_ofi_rdma_req_t *req = fl->entry_alloc();
+	if (OFI_UNLIKELY(req == NULL)) {
+		NCCL_OFI_WARN("No freelist items available");
+		return NULL;
+	}
+
+	return req;
+}
+
+/**
+ * @brief	Look up the pre-built control message for a receive buffer
+ *
+ * On a miss, the cache entry is (re)built from the per-rail rkeys of
+ * the memory registration. Only the buffer address, remote comm ID and
+ * rkeys of the returned message are valid; the caller must fill in the
+ * message type, sequence number and length.
+ *
+ * @param	desc_p
+ *		Returns the cache entry for (buff, buff_mr_handle)
+ * @return	0, on success
+ *		-ENOENT, if buffer is not registered on all rails
+ *		-ENOTSUP, if an rkey does not fit into the control message
+ */
+static inline int get_ctrl_desc(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+				nccl_net_ofi_rdma_ep_t *ep, void *buff,
+				nccl_net_ofi_rdma_mr_handle_t *buff_mr_handle,
+				nccl_net_ofi_rdma_ctrl_desc_t **desc_p)
 {
-	assert(fl != NULL);
+	nccl_net_ofi_rdma_ctrl_desc_t *desc = &r_comm->ctrl_desc_cache[ctrl_desc_cache_idx(buff)];
 
-	nccl_ofi_freelist_elem_t *elem = nccl_ofi_freelist_entry_alloc(fl);
-	if (OFI_UNLIKELY(elem == NULL)) {
-		NCCL_OFI_WARN("No freelist items available");
-		return NULL;
+	if (OFI_LIKELY(desc->mr_handle == buff_mr_handle && desc->buff == buff)) {
+		*desc_p = desc;
+		return 0;
 	}
 
-	nccl_net_ofi_rdma_req_t *req = (nccl_net_ofi_rdma_req_t*)elem->ptr;
-	assert(req);
+	/* Mark entry invalid until it is fully built */
+	desc->mr_handle = NULL;
+	desc->buff = buff;
+	desc->msg.remote_comm_id = r_comm->remote_comm_id;
+	desc->msg.buff_addr = (uint64_t)buff;
 
-	req->elem = elem;
+	int ret = ep->fast_path->fill_ctrl_rkeys(ep, &desc->msg, buff_mr_handle);
+	if (OFI_UNLIKELY(ret != 0)) {
+		return ret;
+	}
 
-	return req;
+	desc->mr_handle = buff_mr_handle;
+	*desc_p = desc;
+	return 0;
 }
 
 /**
@@ -3198,7 +4612,8 @@ static inline int insert_send_ctrl_req(
 				size_t size,
 				nccl_net_ofi_rdma_mr_handle_t *buff_mr_handle,
 				nccl_net_ofi_rdma_req_t *recv_req,
-				bool recv_completion_optional)
+				bool recv_completion_optional,
+				nccl_net_ofi_rdma_recv_ring_mode_t ring_mode)
 {
 	nccl_net_ofi_scheduler_t *scheduler = device->scheduler;
 	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)r_comm->base.base.ep;
@@ -3216,9 +4631,9 @@ static inline int insert_send_ctrl_req(
 	send_ctrl_req->msg_seq_num = msg_seq_num;
 
 	rdma_req_send_ctrl_data_t *send_ctrl_data = get_send_ctrl_data(send_ctrl_req);
+	size_t ctrl_msg_len = ep->ctrl_msg_size;
 
 	if (ep->num_control_rails > 1) {
-		size_t ctrl_msg_len = nccl_net_ofi_rdma_ctrl_msg_size(ep->num_rails, ep->use_long_rkeys);
 		send_ctrl_data->ctrl_schedule = scheduler->get_schedule(scheduler, ctrl_msg_len, ep->num_control_rails);
 
 		if (OFI_UNLIKELY(!(send_ctrl_data->ctrl_schedule))) {
@@ -3260,33 +4675,26 @@ static inline int insert_send_ctrl_req(
 
 	nccl_net_ofi_rdma_ctrl_msg_t *ctrl_msg = rdma_send_ctrl_get_msg(send_ctrl_data);
 
-	/* If early completion is turned on, CTRL msg type will be NCCL_OFI_RDMA_MSG_CTRL_NO_COMPLETION to influence send() behavior */
-	ctrl_msg->type = recv_completion_optional ? NCCL_OFI_RDMA_MSG_CTRL_NO_COMPLETION : NCCL_OFI_RDMA_MSG_CTRL;
-	ctrl_msg->remote_comm_id = r_comm->remote_comm_id;
-	ctrl_msg->msg_seq_num = msg_seq_num;
-	ctrl_msg->buff_addr = (uint64_t)buff;
-	ctrl_msg->buff_len = size;
-
-	int rail_id = 0;
-	for (; rail_id < r_comm->num_rails; rail_id++) {
-		uint64_t rkey = fi_mr_key(buff_mr_handle->mr[rail_id]);
+	nccl_net_ofi_rdma_ctrl_desc_t *desc = NULL;
+	int ret = get_ctrl_desc(r_comm, ep, buff, buff_mr_handle, &desc);
+	if (OFI_UNLIKELY(ret != 0)) {
+		return ret;
+	}
 
-		if (rkey == FI_KEY_NOTAVAIL) {
-			NCCL_OFI_WARN("RDMA write buffers should be pre-registered");
-			return -ENOENT;
-		}
+	/* Copy comm ID, buffer address and rkeys from the descriptor and
+	 * patch in the per-message fields */
+	memcpy(ctrl_msg, &desc->msg, ctrl_msg_len);
 
-		if (ep->use_long_rkeys) {
-			ctrl_msg->long_buff_mr_key[rail_id] = rkey;
-		} else {
-			if (rkey > (1ULL << (NCCL_NET_OFI_CTRL_MSG_SHORT_KEY_SIZE * 8)) - 1) {
-				NCCL_OFI_WARN("Libfabric returned rkey larger than declared rkey size: %" PRIu64,
-					      rkey);
-				return -ENOTSUP;
-			}
-			ctrl_msg->short_buff_mr_key[rail_id] = rkey;
-		}
+	/* If early completion is turned on, CTRL msg type will be NCCL_OFI_RDMA_MSG_CTRL_NO_COMPLETION to influence send() behavior */
+	if (recv_completion_optional) {
+		ctrl_msg->type = NCCL_OFI_RDMA_MSG_CTRL_NO_COMPLETION;
+	} else if (ring_mode == NCCL_OFI_RDMA_RECV_RING_ADV) {
+		ctrl_msg->type = NCCL_OFI_RDMA_MSG_CTRL_RING_ADV;
+	} else {
+		ctrl_msg->type = NCCL_OFI_RDMA_MSG_CTRL;
 	}
+	ctrl_msg->msg_seq_num = msg_seq_num;
+	ctrl_msg->buff_len = size;
 
 	rdma_req_recv_data_t *recv_data = get_recv_data(recv_req);
 	recv_data->send_ctrl_req = send_ctrl_req;
@@ -3342,6 +4750,9 @@ static inline int allocate_rdma_recv_req(
 {
 	int ret = 0;
 	rdma_req_recv_data_t *recv_data;
+	nccl_net_ofi_rdma_recv_ring_mode_t ring_mode =
+		recv_ring_get_mode(r_comm, msg_seq_num, buff, size, buff_mr_handle,
+				   recv_completion_optional);
 
 	/* Allocate receive request */
 	nccl_net_ofi_rdma_req_t *req = allocate_req(r_comm->nccl_ofi_reqs_fl);
@@ -3365,12 +4776,20 @@ static inline int allocate_rdma_recv_req(
 	recv_data->dst_buff = buff;
 	recv_data->dst_len = size;
 	recv_data->dest_mr_handle = buff_mr_handle;
+	recv_data->ring_mode = ring_mode;
 
-	/* TODO consolidate arguments to insert_send_ctrl_req and insert_recv_segms_req */
-	ret = insert_send_ctrl_req(r_comm, device, dev_id, msg_seq_num, buff, size, buff_mr_handle, req, recv_completion_optional);
-	if (ret) {
-		NCCL_OFI_WARN("Failed to insert send ctrl request into recv request");
-		return ret;
+	if (ring_mode == NCCL_OFI_RDMA_RECV_RING_CREDIT) {
+		/* Buffer is announced by a credit message, see
+		 * recv_ring_grant_credit() */
+		recv_data->send_ctrl_req = NULL;
+	} else {
+		/* TODO consolidate arguments to insert_send_ctrl_req and insert_recv_segms_req */
+		ret = insert_send_ctrl_req(r_comm, device, dev_id, msg_seq_num, buff, size, buff_mr_handle, req,
+					   recv_completion_optional, ring_mode);
+		if (ret) {
+			NCCL_OFI_WARN("Failed to insert send ctrl request into recv request");
+			return ret;
+		}
 	}
 
 	ret = insert_recv_segms_req(r_comm, device, dev_id, msg_seq_num, buff, size, req);
@@ -3379,6 +4798,8 @@ static inline int allocate_rdma_recv_req(
 		return ret;
 	}
 
+	recv_ring_acquire(r_comm, req);
+
 	*ret_req = req;
 
 	return 0;
@@ -3435,13 +4856,13 @@ static inline int insert_rdma_recv_req_into_msgbuff(nccl_net_ofi_rdma_recv_comm_
 static int process_cq_if_pending(nccl_net_ofi_rdma_ep_t *ep)
 {
 	/* Process the CQ if there are any pending requests */
-	if (!nccl_ofi_deque_isempty(ep->pending_reqs_queue)) {
+	if (!nccl_ofi_mpsc_queue_isempty(ep->pending_reqs_queue)) {
 		int ret = ofi_process_cq(ep);
 		if (ret != 0) {
 			return ret;
 		}
 
-		if (!nccl_ofi_deque_isempty(ep->pending_reqs_queue)) {
+		if (!nccl_ofi_mpsc_queue_isempty(ep->pending_reqs_queue)) {
 			/* Network is still busy. */
 			return -EAGAIN;
 		}
@@ -3449,6 +4870,157 @@ static int process_cq_if_pending(nccl_net_ofi_rdma_ep_t *ep)
 	return 0;
 }
 
+/*
+ * @brief	Return a batch of credits taken by recv_ring_take_credits()
+ *		whose credit message could not be posted
+ *
+ * The batch is merged back into the pending batch if both are
+ * consecutive. Otherwise the credits are lost, which leaves the
+ * sender waiting for them; the caller reports the error.
+ */
+static inline void recv_ring_return_credits(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+					    uint16_t msg_seq_num, uint16_t num_msgs)
+{
+	nccl_net_ofi_mutex_lock(&r_comm->ctrl_counter_lock);
+	assert(r_comm->num_credits_inflight > 0);
+	r_comm->num_credits_inflight--;
+	r_comm->n_ctrl_sent -= 1;
+	if (r_comm->credit_num_pending == 0) {
+		r_comm->credit_first_msg_seq_num = msg_seq_num;
+		r_comm->credit_num_pending = num_msgs;
+	} else if (((msg_seq_num + num_msgs) & MSG_SEQ_NUM_MASK) == r_comm->credit_first_msg_seq_num) {
+		r_comm->credit_first_msg_seq_num = msg_seq_num;
+		r_comm->credit_num_pending += num_msgs;
+	}
+	nccl_net_ofi_mutex_unlock(&r_comm->ctrl_counter_lock);
+}
+
+/*
+ * @brief	Allocate and post a credit message granting `num_msgs'
+ *		messages starting at `msg_seq_num'
+ *
+ * The batch must have been taken with recv_ring_take_credits(). It is
+ * returned with recv_ring_return_credits() if the message cannot be
+ * posted.
+ */
+static int recv_ring_send_credit(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+				 uint16_t msg_seq_num, uint16_t num_msgs)
+{
+	int ret;
+	nccl_net_ofi_rdma_req_t *send_credit_req = allocate_req(r_comm->nccl_ofi_reqs_fl);
+	if (OFI_UNLIKELY(send_credit_req == NULL)) {
+		NCCL_OFI_WARN("Unable to get NCCL OFI send credit request for device %d",
+			      r_comm->base.base.dev_id);
+		recv_ring_return_credits(r_comm, msg_seq_num, num_msgs);
+		return -ENOMEM;
+	}
+
+	send_credit_req->comm = &r_comm->base.base;
+	send_credit_req->dev_id = r_comm->base.base.dev_id;
+	send_credit_req->type = NCCL_OFI_RDMA_SEND_CREDIT;
+	send_credit_req->free = free_send_credit_req;
+	send_credit_req->msg_seq_num = msg_seq_num;
+
+	rdma_req_send_credit_data_t *send_credit_data = req_get_send_credit_data(send_credit_req);
+	send_credit_data->num_msgs = num_msgs;
+	send_credit_data->ctrl_fl_elem = nccl_ofi_freelist_entry_alloc(r_comm->ctrl_buff_fl);
+	if (OFI_UNLIKELY(send_credit_data->ctrl_fl_elem == NULL)) {
+		NCCL_OFI_WARN("Call to nccl_ofi_freelist_entry_alloc failed");
+		send_credit_req->free(send_credit_req, false);
+		recv_ring_return_credits(r_comm, msg_seq_num, num_msgs);
+		return -ENOMEM;
+	}
+
+	nccl_net_ofi_rdma_credit_msg_t *credit_msg = rdma_send_credit_get_msg(send_credit_data);
+	credit_msg->type = NCCL_OFI_RDMA_MSG_CREDIT;
+	credit_msg->msg_seq_num = msg_seq_num;
+	credit_msg->remote_comm_id = r_comm->remote_comm_id;
+	credit_msg->num_msgs = num_msgs;
+
+	ret = receive_progress(send_credit_req, true);
+	if (OFI_UNLIKELY(ret != 0)) {
+		send_credit_req->free(send_credit_req, false);
+		recv_ring_return_credits(r_comm, msg_seq_num, num_msgs);
+	}
+	return ret;
+}
+
+/*
+ * @brief	Take the batch of granted but unsent credits
+ *
+ * Accounts the credit message right away, so that no other thread
+ * posts credits while it is in flight. Caller must hold
+ * ctrl_counter_lock.
+ */
+static inline void recv_ring_take_credits(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+					  uint16_t *msg_seq_num, uint16_t *num_msgs)
+{
+	*msg_seq_num = r_comm->credit_first_msg_seq_num;
+	*num_msgs = r_comm->credit_num_pending;
+	r_comm->credit_num_pending = 0;
+	r_comm->num_credits_inflight++;
+	r_comm->n_ctrl_sent += 1;
+}
+
+/*
+ * @brief	Post pending credits unless a credit message is in flight
+ *
+ * Credits granted while a credit message is in flight are batched
+ * and posted when that message completes.
+ */
+static int recv_ring_post_credit(nccl_net_ofi_rdma_recv_comm_t *r_comm)
+{
+	uint16_t msg_seq_num = 0;
+	uint16_t num_msgs = 0;
+
+	nccl_net_ofi_mutex_lock(&r_comm->ctrl_counter_lock);
+	if (r_comm->credit_num_pending > 0 && r_comm->num_credits_inflight == 0) {
+		recv_ring_take_credits(r_comm, &msg_seq_num, &num_msgs);
+	}
+	nccl_net_ofi_mutex_unlock(&r_comm->ctrl_counter_lock);
+
+	if (num_msgs == 0) {
+		return 0;
+	}
+
+	return recv_ring_send_credit(r_comm, msg_seq_num, num_msgs);
+}
+
+/*
+ * @brief	Grant a credit for message `msg_seq_num'
+ *
+ * A credit message covers consecutive sequence numbers. If the
+ * pending batch cannot be extended, e.g., because a message in
+ * between was announced by a control message, the pending batch is
+ * posted right away.
+ */
+static int recv_ring_grant_credit(nccl_net_ofi_rdma_recv_comm_t *r_comm,
+				  uint16_t msg_seq_num)
+{
+	uint16_t batch_msg_seq_num = 0;
+	uint16_t batch_num_msgs = 0;
+
+	nccl_net_ofi_mutex_lock(&r_comm->ctrl_counter_lock);
+	if (r_comm->credit_num_pending > 0 &&
+	    ((r_comm->credit_first_msg_seq_num + r_comm->credit_num_pending) & MSG_SEQ_NUM_MASK) != msg_seq_num) {
+		recv_ring_take_credits(r_comm, &batch_msg_seq_num, &batch_num_msgs);
+	}
+	if (r_comm->credit_num_pending == 0) {
+		r_comm->credit_first_msg_seq_num = msg_seq_num;
+	}
+	r_comm->credit_num_pending++;
+	nccl_net_ofi_mutex_unlock(&r_comm->ctrl_counter_lock);
+
+	if (batch_num_msgs > 0) {
+		int ret = recv_ring_send_credit(r_comm, batch_msg_seq_num, batch_num_msgs);
+		if (OFI_UNLIKELY(ret != 0)) {
+			return ret;
+		}
+	}
+
+	return recv_ring_post_credit(r_comm);
+}
+
 static int recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
 			 int *sizes, int *tags, nccl_net_ofi_mr_handle_t **mhandles,
 			 nccl_net_ofi_req_t **base_req)
@@ -3464,6 +5036,7 @@ static int recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
 	nccl_net_ofi_rdma_mr_handle_t **mr_handles = (nccl_net_ofi_rdma_mr_handle_t **)mhandles;
 	uint16_t msg_seq_num = 0;
 	bool eager = false;
+	size_t eager_copied = 0;
 	int i;
 	bool recv_completion_optional = false;
 
@@ -3581,6 +5154,12 @@ static int recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
 				return ret;
 			}
 			recv_data->eager_copy_req = NULL;
+		} else if (eager_copy_on_cpu(recv_data)) {
+			ret = eager_cpu_copy(recv_data, rx_buff_req, &eager_copied);
+			if (ret != 0) {
+				goto error;
+			}
+			recv_data->eager_copy_req = NULL;
 		} else {
 			ret = alloc_eager_copy_req(req, r_comm, rx_buff_req);
 			if (ret != 0) {
@@ -3596,23 +5175,38 @@ static int recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
 
 	/* At this point, we've successfully inserted a new request, so update the num inflight. */
 	(r_comm->num_inflight_reqs)++;
+	(ep->num_recvs_inflight)++;
 
 	NCCL_OFI_TRACE_RECV(dev_id, r_comm->local_comm_id, sizes[0], req, base_req);
 
-	/* Send ctrl msg */
-	nccl_net_ofi_mutex_lock(&r_comm->ctrl_counter_lock);
-	r_comm->n_ctrl_sent += 1;
-	nccl_net_ofi_mutex_unlock(&r_comm->ctrl_counter_lock);
-	ret = receive_progress(recv_data->send_ctrl_req, true);
-	if (OFI_UNLIKELY(ret != 0)) {
-		/* TODO: Remove req from message buffer */
-		goto error;
+	if (recv_data->ring_mode == NCCL_OFI_RDMA_RECV_RING_CREDIT) {
+		/* Buffer is already known to the sender, grant credit */
+		ret = recv_ring_grant_credit(r_comm, msg_seq_num);
+		if (OFI_UNLIKELY(ret != 0)) {
+			/* The request is in the message buffer and its
+			 * credit may be granted by a later credit
+			 * message, so it cannot be freed. Fail it
+			 * through test() instead. */
+			NCCL_OFI_WARN("Failed to post credit for msg %hu", msg_seq_num);
+			set_request_state_to_error(req);
+			ret = 0;
+		}
+	} else {
+		/* Send ctrl msg */
+		nccl_net_ofi_mutex_lock(&r_comm->ctrl_counter_lock);
+		r_comm->n_ctrl_sent += 1;
+		nccl_net_ofi_mutex_unlock(&r_comm->ctrl_counter_lock);
+		ret = receive_progress(recv_data->send_ctrl_req, true);
+		if (OFI_UNLIKELY(ret != 0)) {
+			/* TODO: Remove req from message buffer */
+			goto error;
+		}
 	}
 
 	if (eager) {
 		if (recv_data->eager_copy_req == NULL) {
 			/* If we don't need to do eager copy, this recv is already complete */
-			ret = inc_req_completion(req, 0, recv_data->total_num_compls);
+			ret = inc_req_completion(req, eager_copied, recv_data->total_num_compls);
 			if (ret != 0) {
 				goto error;
 			}
@@ -3734,6 +5328,100 @@ static int alloc_and_reg_flush_buff(nccl_net_ofi_rdma_domain_t *domain, int dev_
 	return ret;
 }
 
+/*
+ * @brief	Advertise the RMA key table of the device in a connect
+ *		or connect response message
+ */
+static void set_conn_msg_rma_key_table(nccl_net_ofi_rdma_ep_t *ep,
+				       nccl_ofi_rdma_connection_info_t *conn_msg)
+{
+	nccl_net_ofi_rdma_domain_t *domain = rdma_endpoint_get_domain(ep);
+	nccl_net_ofi_rdma_device_t *device = rdma_endpoint_get_device(ep);
+
+	if (domain->rma_key_table_mr == NULL) {
+		conn_msg->rma_key_table_addr = 0;
+		conn_msg->rma_key_table_key = 0;
+		return;
+	}
+
+	conn_msg->rma_key_table_addr = (uint64_t)(uintptr_t)device->rma_key_table;
+	conn_msg->rma_key_table_key = fi_mr_key(domain->rma_key_table_mr->mr[0]);
+}
+
+/*
+ * @brief	Create the cache of RMA key table entries of the peer
+ *
+ * No cache is created unless both sides use an RMA key table. The
+ * entries are fetched with fi_read() into a registered page.
+ */
+static int create_rma_key_cache(nccl_net_ofi_rdma_ep_t *ep,
+				nccl_ofi_rdma_connection_info_t *conn_msg,
+				nccl_net_ofi_rdma_rma_key_cache_t **cache)
+{
+	int ret;
+	nccl_net_ofi_rdma_domain_t *domain = rdma_endpoint_get_domain(ep);
+	nccl_net_ofi_rdma_rma_key_cache_t *new_cache = NULL;
+
+	*cache = NULL;
+	if (domain->rma_key_table_mr == NULL || conn_msg->rma_key_table_addr == 0) {
+		return 0;
+	}
+
+	new_cache = (nccl_net_ofi_rdma_rma_key_cache_t *)calloc(1, sizeof(*new_cache));
+	if (OFI_UNLIKELY(new_cache == NULL)) {
+		NCCL_OFI_WARN("Unable to allocate RMA key cache");
+		return -ENOMEM;
+	}
+	new_cache->remote_table_addr = conn_msg->rma_key_table_addr;
+	new_cache->remote_table_key = conn_msg->rma_key_table_key;
+
+	assert(NCCL_OFI_RDMA_RMA_KEY_CACHE_SIZE * sizeof(nccl_net_ofi_rdma_rma_key_entry_t)
+	       <= system_page_size);
+	ret = nccl_net_ofi_alloc_mr_buffer(system_page_size, (void **)&new_cache->entries);
+	if (OFI_UNLIKELY(ret != 0)) {
+		NCCL_OFI_WARN("Unable to allocate RMA key cache entries (%d)", ret);
+		free(new_cache);
+		return ret;
+	}
+
+	ret = reg_internal_mr(domain, new_cache->entries, system_page_size,
+			      NCCL_PTR_HOST, &new_cache->mr_handle);
+	if (OFI_UNLIKELY(ret != 0)) {
+		NCCL_OFI_WARN("Could not register RMA key cache entries");
+		nccl_net_ofi_dealloc_mr_buffer(new_cache->entries, system_page_size);
+		free(new_cache);
+		return ret;
+	}
+
+	*cache = new_cache;
+	return 0;
+}
+
+static int destroy_rma_key_cache(nccl_net_ofi_rdma_domain_t *domain,
+				 nccl_net_ofi_rdma_rma_key_cache_t *cache)
+{
+	int ret;
+
+	if (cache == NULL) {
+		return 0;
+	}
+
+	ret = dereg_mr(cache->mr_handle, domain);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Failed to deregister RMA key cache entries");
+		return ret;
+	}
+
+	ret = nccl_net_ofi_dealloc_mr_buffer(cache->entries, system_page_size);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Unable to deallocate RMA key cache entries (%d)", ret);
+		return ret;
+	}
+
+	free(cache);
+	return 0;
+}
+
 static inline void free_rdma_recv_comm(nccl_net_ofi_rdma_recv_comm_t *r_comm) {
     if (r_comm) {
         if (r_comm->control_rails) {
@@ -3775,7 +5463,7 @@ static int recv_comm_destroy(nccl_net_ofi_rdma_recv_comm_t *r_comm)
 		return ret;
 	}
 
-	ret = nccl_ofi_freelist_fini(r_comm->nccl_ofi_reqs_fl);
+	ret = nccl_net_ofi_rdma_req_fl_t::fini(r_comm->nccl_ofi_reqs_fl);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Call to nccl_ofi_freelist_fini failed: %d", ret);
 		return ret;
@@ -3787,6 +5475,11 @@ static int recv_comm_destroy(nccl_net_ofi_rdma_recv_comm_t *r_comm)
 		return ret;
 	}
 
+	ret = destroy_rma_key_cache(rdma_endpoint_get_domain(ep), r_comm->rma_key_cache);
+	if (ret != 0) {
+		return ret;
+	}
+
 	/* Destroy domain */
 #if HAVE_NVTX_TRACING && NCCL_OFI_NVTX_TRACE_PER_COMM
 	for (int i = 0; i < NCCL_OFI_N_NVTX_DOMAIN_PER_COMM; ++i) {
@@ -3938,6 +5631,9 @@ static inline void free_rdma_send_comm(nccl_net_ofi_rdma_send_comm_t *s_comm) {
         if (s_comm->rails) {
             free(s_comm->rails);
         }
+        if (s_comm->ll_rails) {
+            free(s_comm->ll_rails);
+        }
         free(s_comm);
     }
 }
@@ -3946,14 +5642,18 @@ static int send_comm_destroy(nccl_net_ofi_rdma_send_comm_t *s_comm)
 {
 	int ret = 0;
 
-	/* Release connect response request if available */
+	/* Release connect and connect response requests if available */
+	if (s_comm->conn_req) {
+		nccl_net_ofi_rdma_req_t *req = s_comm->conn_req;
+		req->free(req, false);
+	}
 	if (s_comm->conn_resp_req) {
 		nccl_net_ofi_rdma_req_t *req = s_comm->conn_resp_req;
 		req->free(req, false);
 	}
 
 	/* Release request freelist */
-	ret = nccl_ofi_freelist_fini(s_comm->nccl_ofi_reqs_fl);
+	ret = nccl_net_ofi_rdma_req_fl_t::fini(s_comm->nccl_ofi_reqs_fl);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Call to nccl_ofi_freelist_fini failed: %d", ret);
 		return ret;
@@ -3966,6 +5666,11 @@ static int send_comm_destroy(nccl_net_ofi_rdma_send_comm_t *s_comm)
 	}
 
 	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *) s_comm->base.base.ep;
+
+	ret = destroy_rma_key_cache(rdma_endpoint_get_domain(ep), s_comm->rma_key_cache);
+	if (ret != 0) {
+		return ret;
+	}
 	nccl_net_ofi_rdma_device_t *device = rdma_endpoint_get_device(ep);
 	rdma_device_set_comm(device, s_comm->local_comm_id, NULL);
 
@@ -3988,6 +5693,11 @@ static int send_comm_destroy(nccl_net_ofi_rdma_send_comm_t *s_comm)
 		return ret;
 	}
 
+	ret = nccl_net_ofi_mutex_destroy(&s_comm->conn_lock);
+	if (ret != 0) {
+		return ret;
+	}
+
 	free_rdma_send_comm(s_comm);
 
 	ret = ep->base.release_ep(&ep->base, false, false);
@@ -4021,10 +5731,14 @@ static int send_comm_process_all_finalizing(void)
 			goto exit;
 		}
 
+		send_comm_release_conn_req(s_comm);
+
 		nccl_net_ofi_mutex_lock(&s_comm->ctrl_recv_lock);
 
 		bool ready_to_destroy = (s_comm->received_close_message) &&
-			(s_comm->n_ctrl_received == s_comm->n_ctrl_expected);
+			(s_comm->n_ctrl_received == s_comm->n_ctrl_expected) &&
+			s_comm->connected.load(std::memory_order_acquire) &&
+			(s_comm->conn_req == NULL);
 
 		nccl_net_ofi_mutex_unlock(&s_comm->ctrl_recv_lock);
 
@@ -4237,9 +5951,9 @@ static int flush(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
 		}
 	} else {
 		/* Add to pending reqs queue */
-		ret = nccl_ofi_deque_insert_back(ep->pending_reqs_queue, &req->pending_reqs_elem);
+		ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &req->pending_reqs_elem);
 		if (ret != 0) {
-			NCCL_OFI_WARN("Failed to nccl_ofi_deque_insert_back: %d", ret);
+			NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
 			goto error;
 		}
 		NCCL_OFI_TRACE_PENDING_INSERT(req);
@@ -4297,44 +6011,191 @@ error:
     return NULL;
 }
 
-static void init_rma_op_req(nccl_net_ofi_rdma_req_t *req,
-			    nccl_net_ofi_comm_t *comm,
-			    void *buff, size_t size,
-			    void *desc,
-			    uint64_t remote_buff,
-			    uint64_t remote_mr_key,
-			    uint64_t flags,
-			    nccl_net_ofi_rdma_req_type_t req_type)
+/*
+ * @brief	Initialize one-sided RMA request of up to `num_ops' operations
+ *
+ * Requests of more than one operation take their operations from the
+ * endpoint. Operations are added with add_rma_op().
+ */
+static int init_rma_op_req(nccl_net_ofi_rdma_req_t *req,
+			   nccl_net_ofi_comm_t *comm,
+			   size_t num_ops,
+			   uint64_t flags,
+			   nccl_net_ofi_rdma_req_type_t req_type)
 {
 	req->comm = comm;
 	req->dev_id = comm->dev_id;
 	req->type = req_type;
-	req->size = size;
+	req->size = 0;
 
 	rdma_req_rma_op_data_t *rma_op_data = req_get_rma_op_data(req, req_type);
-	rma_op_data->remote_buff = remote_buff;
-	rma_op_data->remote_mr_key = remote_mr_key;
+	rma_op_data->batch = NULL;
+	rma_op_data->ops = &rma_op_data->op;
+	rma_op_data->num_ops = 0;
+	rma_op_data->op_idx = 0;
 	rma_op_data->xferred_rail_id = 0;
-	rma_op_data->buff = buff;
-	rma_op_data->buff_len = size;
-	rma_op_data->desc = desc;
+	memset(rma_op_data->rail_posts_left, 0, sizeof(rma_op_data->rail_posts_left));
 	rma_op_data->flags = flags;
+	rma_op_data->key_fetch_idx = -1;
+	rma_op_data->key_fetch_handle = 0;
+	rma_op_data->key_fetch_posted = false;
+	rma_op_data->total_num_compls = 0;
+	rma_op_data->num_posted_compls = 0;
+	rma_op_data->num_err_compls = 0;
+
+	if (num_ops > 1) {
+		nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)comm->ep;
+
+		assert(num_ops <= NCCL_OFI_MAX_RMA_BATCH);
+		rma_op_data->batch = ep->rma_batch_fl->entry_alloc();
+		if (OFI_UNLIKELY(rma_op_data->batch == NULL)) {
+			NCCL_OFI_WARN("Unable to allocate RMA batch");
+			return -ENOMEM;
+		}
+		rma_op_data->ops = rma_op_data->batch->ops;
+	}
 
-	/* Set expected number of completions */
-	rma_op_data->total_num_compls = 1;
+	return 0;
+}
+
+/*
+ * @brief	Look up key handle `mr_key' in the RMA key cache of the
+ *		communicator of `req'
+ *
+ * On a hit, sets the remote keys of all rails of `op'. On a miss, the
+ * request fetches the table entry of the handle unless another
+ * request already does, and `op' stays on rail 0.
+ *
+ * @return	Number of rails `op' may be striped across
+ */
+static int rma_key_cache_lookup(nccl_net_ofi_rdma_req_t *req,
+				rdma_req_rma_op_data_t *rma_op_data,
+				nccl_net_ofi_rdma_rma_op_t *op,
+				uint64_t mr_key, int num_rails)
+{
+	nccl_net_ofi_rdma_rma_key_cache_t *cache = rdma_req_get_rma_key_cache(req);
+
+	/* The peer does not publish a key table */
+	if (cache == NULL) {
+		return 1;
+	}
+
+	int idx = rma_key_handle_slot(mr_key) % NCCL_OFI_RDMA_RMA_KEY_CACHE_SIZE;
+	nccl_net_ofi_rdma_rma_key_entry_t *entry = &cache->entries[idx];
+
+	if (cache->state[idx] == NCCL_OFI_RDMA_RMA_KEY_CACHE_VALID && entry->handle == mr_key) {
+		for (int rail_id = 0; rail_id < num_rails; rail_id++) {
+			op->remote_mr_key[rail_id] = entry->keys[rail_id];
+		}
+		return num_rails;
+	}
+
+	if (cache->state[idx] != NCCL_OFI_RDMA_RMA_KEY_CACHE_FETCHING &&
+	    rma_op_data->key_fetch_idx < 0) {
+		cache->state[idx] = NCCL_OFI_RDMA_RMA_KEY_CACHE_FETCHING;
+		rma_op_data->key_fetch_idx = idx;
+		rma_op_data->key_fetch_handle = mr_key;
+		rma_op_data->total_num_compls++;
+	}
+
+	return 1;
+}
+
+/*
+ * @brief	Set the remote key of each rail of `op' from a key returned
+ *		by get_mr_key()
+ *
+ * @return	Number of rails `op' may be striped across, at most
+ *		`num_rails'
+ */
+static int rma_op_set_remote_keys(nccl_net_ofi_rdma_req_t *req,
+				  rdma_req_rma_op_data_t *rma_op_data,
+				  nccl_net_ofi_rdma_rma_op_t *op,
+				  uint64_t mr_key, int num_rails)
+{
+	nccl_net_ofi_rdma_device_t *device = rdma_req_get_device(req);
+
+	switch (device->rma_key_mode) {
+	case NCCL_OFI_RDMA_RMA_KEY_SHARED:
+		for (int rail_id = 0; rail_id < num_rails; rail_id++) {
+			op->remote_mr_key[rail_id] = mr_key;
+		}
+		return num_rails;
+	case NCCL_OFI_RDMA_RMA_KEY_PACKED:
+		assert(device->rma_key_bits < 64);
+		for (int rail_id = 0; rail_id < num_rails; rail_id++) {
+			op->remote_mr_key[rail_id] = (mr_key >> (rail_id * device->rma_key_bits)) &
+				((1ULL << device->rma_key_bits) - 1);
+		}
+		return num_rails;
+	case NCCL_OFI_RDMA_RMA_KEY_TABLE:
+		/* Key handles and plain keys both carry the key of rail 0 */
+		op->remote_mr_key[0] = mr_key & UINT32_MAX;
+		if (num_rails == 1 || !(mr_key & NCCL_OFI_RDMA_RMA_KEY_HANDLE_FLAG)) {
+			return 1;
+		}
+		return rma_key_cache_lookup(req, rma_op_data, op, mr_key, num_rails);
+	case NCCL_OFI_RDMA_RMA_KEY_SINGLE_RAIL:
+	default:
+		op->remote_mr_key[0] = mr_key;
+		return 1;
+	}
+}
+
+/*
+ * @brief	Add an operation to a one-sided RMA request and stripe it
+ *		across rails
+ *
+ * Inline writes (`buff_mr_handle' is NULL) and operations whose
+ * remote key only covers rail 0 use a single stripe on rail 0.
+ */
+static int add_rma_op(nccl_net_ofi_rdma_req_t *req,
+		      nccl_net_ofi_rdma_req_type_t req_type,
+		      void *buff, size_t size,
+		      nccl_net_ofi_rdma_mr_handle_t *buff_mr_handle,
+		      uint64_t remote_buff,
+		      uint64_t remote_mr_key)
+{
+	nccl_net_ofi_rdma_device_t *device = rdma_req_get_device(req);
+	nccl_net_ofi_scheduler_t *scheduler = device->scheduler;
+	int num_rails = device->num_rails;
+
+	rdma_req_rma_op_data_t *rma_op_data = req_get_rma_op_data(req, req_type);
+	nccl_net_ofi_rdma_rma_op_t *op = &rma_op_data->ops[rma_op_data->num_ops];
+	op->remote_buff = remote_buff;
+	op->buff = buff;
+	op->buff_len = size;
+	op->buff_mr_handle = buff_mr_handle;
+
+	if (buff_mr_handle == NULL) {
+		num_rails = 1;
+	}
+	num_rails = rma_op_set_remote_keys(req, rma_op_data, op, remote_mr_key, num_rails);
+
+	op->schedule = scheduler->get_schedule(scheduler, size, num_rails);
+	if (OFI_UNLIKELY(op->schedule == NULL)) {
+		return -EINVAL;
+	}
+	rma_op_data->num_ops++;
+
+	/* Expect one completion for each stripe */
+	for (size_t i = 0; i < op->schedule->num_xfer_infos; i++) {
+		rma_op_data->rail_posts_left[op->schedule->rail_xfer_infos[i].rail_id]++;
+	}
+	rma_op_data->total_num_compls += op->schedule->num_xfer_infos;
+	req->size += size;
+
+	return 0;
 }
 
 static int alloc_rdma_read_req(nccl_net_ofi_rdma_recv_comm_t *r_comm,
 			       nccl_net_ofi_rdma_ep_t *ep,
-			       void *buff, size_t size,
-			       nccl_net_ofi_rdma_mr_handle_t *buff_mr_handle,
-			       uint64_t remote_buff,
-			       uint64_t remote_mr_key,
+			       const nccl_ofi_rma_desc_t *descs,
+			       size_t num_descs,
 			       nccl_net_ofi_rdma_req_t **ret_req)
 {
 	uint64_t flags = 0;
-	struct fid_mr *rail_mr_handle = buff_mr_handle->mr[0];
-	void *desc = fi_mr_desc(rail_mr_handle);
+	int ret;
 	*ret_req = NULL;
 
 	/* Allocate NCCL OFI request */
@@ -4343,10 +6204,23 @@ static int alloc_rdma_read_req(nccl_net_ofi_rdma_recv_comm_t *r_comm,
 		NCCL_OFI_WARN("Unable to get NCCL OFI request for device");
 		return -ENOMEM;
 	}
-	req->free = free_read_req;
+	req->free = free_read_req;
+
+	ret = init_rma_op_req(req, &r_comm->base.base, num_descs, flags, NCCL_OFI_RDMA_READ);
+	if (OFI_UNLIKELY(ret != 0)) {
+		req->free(req, false);
+		return ret;
+	}
 
-	init_rma_op_req(req, &r_comm->base.base, buff, size, desc, remote_buff,
-			remote_mr_key, flags, NCCL_OFI_RDMA_READ);
+	for (size_t i = 0; i < num_descs; i++) {
+		ret = add_rma_op(req, NCCL_OFI_RDMA_READ, descs[i].local, descs[i].size,
+				 (nccl_net_ofi_rdma_mr_handle_t *)descs[i].mhandle,
+				 descs[i].remote, descs[i].mr_key);
+		if (OFI_UNLIKELY(ret != 0)) {
+			req->free(req, false);
+			return ret;
+		}
+	}
 
 	*ret_req = req;
 
@@ -4354,16 +6228,13 @@ static int alloc_rdma_read_req(nccl_net_ofi_rdma_recv_comm_t *r_comm,
 }
 
 /**
- * @brief	Read data using RMA. This "interface function" is called, indirectly, from
- *       	the application
+ * @brief	Read `num_descs' buffers using RMA as a single request
  */
-
-static int rma_read(nccl_net_ofi_recv_comm_t *recv_comm, void* dest, size_t size, void* mhandle,
-		    uint64_t src, uint64_t mr_key, nccl_net_ofi_req_t ** base_req)
+static int rma_read_impl(nccl_net_ofi_recv_comm_t *recv_comm, const nccl_ofi_rma_desc_t *descs,
+			 size_t num_descs, nccl_net_ofi_req_t **base_req)
 {
 	int ret = 0;
 	nccl_net_ofi_rdma_recv_comm_t *r_comm = (nccl_net_ofi_rdma_recv_comm_t *)recv_comm;
-	nccl_net_ofi_rdma_mr_handle_t *mr_handle = (nccl_net_ofi_rdma_mr_handle_t *)mhandle;
 	nccl_net_ofi_rdma_req_t *req = NULL;
 	nccl_net_ofi_rdma_ep_t *ep = NULL;
 
@@ -4389,8 +6260,7 @@ static int rma_read(nccl_net_ofi_recv_comm_t *recv_comm, void* dest, size_t size
 		goto error;
 	}
 
-	ret = alloc_rdma_read_req(r_comm, ep, dest,
-				  size, mr_handle, src, mr_key, &req);
+	ret = alloc_rdma_read_req(r_comm, ep, descs, num_descs, &req);
 	if (OFI_UNLIKELY(ret != 0)) {
 		goto error;
 	}
@@ -4418,20 +6288,50 @@ static int rma_read(nccl_net_ofi_recv_comm_t *recv_comm, void* dest, size_t size
 	goto exit;
 
  error:
+	if (req && req_get_rma_op_data(req, req->type)->num_posted_compls > 0) {
+		/* Posted operations still reference the request. Return
+		 * it in error state, test() frees it once they completed. */
+		set_request_state_to_error(req);
+		*base_req = &req->base;
+		ret = 0;
+		goto exit;
+	}
 	if (req)
-		req->free(req, false);
+		req->free(req, true);
 	*base_req = NULL;
  exit:
 	return ret;
 }
 
+/**
+ * @brief	Read data using RMA. This "interface function" is called, indirectly, from
+ *       	the application
+ */
+
+static int rma_read(nccl_net_ofi_recv_comm_t *recv_comm, void* dest, size_t size, void* mhandle,
+		    uint64_t src, uint64_t mr_key, nccl_net_ofi_req_t ** base_req)
+{
+	nccl_ofi_rma_desc_t desc = { dest, mhandle, src, mr_key, size };
+	return rma_read_impl(recv_comm, &desc, 1, base_req);
+}
+
+/**
+ * @brief	Implementation of iread batch interface. This "interface function" is called,
+ *       	indirectly, from the application
+ */
+
+static int rma_read_batch(nccl_net_ofi_recv_comm_t *recv_comm, nccl_ofi_rma_desc_t *descs,
+			  int num_descs, nccl_net_ofi_req_t **base_req)
+{
+	return rma_read_impl(recv_comm, descs, num_descs, base_req);
+}
+
 
 /**
  * Freelist callback to initialize new RDMA request type
  */
-static int rdma_fl_req_entry_init(void *entry)
+static int rdma_fl_req_entry_init(nccl_net_ofi_rdma_req_t *req)
 {
-	auto req = static_cast<nccl_net_ofi_rdma_req_t *>(entry);
 	assert(req);
 	zero_nccl_ofi_req(req);
 	req->base.test = test;
@@ -4447,9 +6347,8 @@ static int rdma_fl_req_entry_init(void *entry)
 }
 
 
-static void rdma_fl_req_entry_fini(void *entry)
+static void rdma_fl_req_entry_fini(nccl_net_ofi_rdma_req_t *req)
 {
-	nccl_net_ofi_rdma_req_t *req = static_cast<nccl_net_ofi_rdma_req_t *>(entry);
 	assert(req);
 
 	nccl_net_ofi_mutex_destroy(&req->req_lock);
@@ -4517,6 +6416,7 @@ static nccl_net_ofi_rdma_recv_comm_t *prepare_recv_comm(nccl_net_ofi_rdma_domain
 	r_comm->base.flush = flush;
 	r_comm->base.close = recv_close_deferred;
 	r_comm->base.read = rma_read;
+	r_comm->base.read_batch = rma_read_batch;
 
 	r_comm->comm_active = true;
 	r_comm->send_close_req = NULL;
@@ -4542,6 +6442,9 @@ static nccl_net_ofi_rdma_recv_comm_t *prepare_recv_comm(nccl_net_ofi_rdma_domain
 	r_comm->remote_comm_id = conn_msg->local_comm_id;
 	r_comm->next_msg_seq_num = 0;
 
+	/* Receive ring requires support on both sides */
+	r_comm->recv_ring_enabled = (ofi_nccl_rdma_recv_ring() != 0) && conn_msg->recv_ring;
+
 	/* Find a comm to use, given the remote EP name */
 	if (ofi_nccl_endpoint_per_communicator() != 0)
 	{
@@ -4649,16 +6552,22 @@ static nccl_net_ofi_rdma_recv_comm_t *prepare_recv_comm(nccl_net_ofi_rdma_domain
 	/* Allocate request freelist */
 	/* Maximum freelist entries is 4*NCCL_OFI_MAX_REQUESTS because each receive request
 	   can have associated reqs for send_ctrl, recv_segms, and eager_copy */
-	ret = nccl_ofi_freelist_init(sizeof(nccl_net_ofi_rdma_req_t), 16, 16,
-				     4 * NCCL_OFI_MAX_REQUESTS,
-				     rdma_fl_req_entry_init, rdma_fl_req_entry_fini,
-				     &r_comm->nccl_ofi_reqs_fl);
+	ret = nccl_net_ofi_rdma_req_fl_t::init(16, 16,
+					       4 * NCCL_OFI_MAX_REQUESTS,
+					       rdma_fl_req_entry_init, rdma_fl_req_entry_fini,
+					       NULL, NULL, NULL,
+					       &r_comm->nccl_ofi_reqs_fl);
 	if (OFI_UNLIKELY(ret != 0)) {
 		NCCL_OFI_WARN("Could not allocate NCCL OFI requests free list for dev %d",
 				  dev_id);
 		goto error;
 	}
 
+	ret = create_rma_key_cache(ep, conn_msg, &r_comm->rma_key_cache);
+	if (OFI_UNLIKELY(ret != 0)) {
+		goto error;
+	}
+
 	/* Allocate connect message, will be returned after the
 	   connect response send completion */
 	r_comm->conn_msg = nccl_ofi_freelist_entry_alloc(ep->conn_msg_fl);
@@ -4702,7 +6611,9 @@ static nccl_net_ofi_rdma_recv_comm_t *prepare_recv_comm(nccl_net_ofi_rdma_domain
 
 	if (r_comm) {
 		if (r_comm->nccl_ofi_reqs_fl)
-			nccl_ofi_freelist_fini(r_comm->nccl_ofi_reqs_fl);
+			nccl_net_ofi_rdma_req_fl_t::fini(r_comm->nccl_ofi_reqs_fl);
+		if (r_comm->rma_key_cache)
+			destroy_rma_key_cache(domain, r_comm->rma_key_cache);
 		if (r_comm->msgbuff)
 			nccl_ofi_msgbuff_destroy(r_comm->msgbuff);
 		if (COMM_ID_INVALID != r_comm->local_comm_id) {
@@ -4745,6 +6656,7 @@ static int prepare_conn_resp(nccl_net_ofi_rdma_ep_t *ep,
 	assert(num_control_rails <= MAX_NUM_RAILS);
 
 	conn_resp->type = NCCL_OFI_RDMA_MSG_CONN_RESP;
+	conn_resp->recv_ring = r_comm->recv_ring_enabled;
 
 	/* Set r_comm's (local) comm ID to be sent back to remote */
 	conn_resp->local_comm_id = r_comm->local_comm_id;
@@ -4756,6 +6668,8 @@ static int prepare_conn_resp(nccl_net_ofi_rdma_ep_t *ep,
 	conn_resp->num_rails = num_rails;
 	conn_resp->num_control_rails = num_control_rails;
 
+	set_conn_msg_rma_key_table(ep, conn_resp);
+
 	/* Set libfabric endpoint names for each rail */
 	for (int rail_id = 0; rail_id != num_rails; ++rail_id) {
 		rdma_ep_name = &conn_resp->ep_names[rail_id];
@@ -4815,7 +6729,9 @@ static int post_send_conn_resp(nccl_net_ofi_rdma_recv_comm_t *r_comm,
 	rc = fi_send(comm_rail->local_ep, (void *)r_comm->conn_msg->ptr, sizeof(nccl_ofi_rdma_connection_info_t), desc,
 		     comm_rail->remote_addr, (void *)&req->ctx[rail_id]);
 
-	if (rc == -FI_EAGAIN) {
+	if (rc == 0) {
+		rdma_req_cq_op_posted(req, rail_id);
+	} else if (rc == -FI_EAGAIN) {
 		req->state = NCCL_OFI_RDMA_REQ_CREATED;
 		/*
 		 * Process completions so that you have enough
@@ -5216,13 +7132,12 @@ static int dereg_mr_send_comm(nccl_net_ofi_send_comm_t *send_comm,
 
 static int alloc_rdma_write_req(nccl_net_ofi_rdma_send_comm_t *s_comm,
 				nccl_net_ofi_rdma_ep_t *ep,
-				void *buff, size_t size,
-				void *desc,
-				uint64_t remote_buff,
-				uint64_t remote_mr_key,
+				const nccl_ofi_rma_desc_t *descs,
+				size_t num_descs,
 				uint64_t flags,
 				nccl_net_ofi_rdma_req_t **ret_req)
 {
+	int ret;
 	*ret_req = NULL;
 
 	/* Allocate NCCL OFI request */
@@ -5232,8 +7147,21 @@ static int alloc_rdma_write_req(nccl_net_ofi_rdma_send_comm_t *s_comm,
 		return -ENOMEM;
 	}
 	req->free = free_write_req;
-	init_rma_op_req(req, &s_comm->base.base, buff, size, desc, remote_buff,
-			remote_mr_key, flags, NCCL_OFI_RDMA_WRITE);
+	ret = init_rma_op_req(req, &s_comm->base.base, num_descs, flags, NCCL_OFI_RDMA_WRITE);
+	if (OFI_UNLIKELY(ret != 0)) {
+		req->free(req, false);
+		return ret;
+	}
+
+	for (size_t i = 0; i < num_descs; i++) {
+		ret = add_rma_op(req, NCCL_OFI_RDMA_WRITE, descs[i].local, descs[i].size,
+				 (nccl_net_ofi_rdma_mr_handle_t *)descs[i].mhandle,
+				 descs[i].remote, descs[i].mr_key);
+		if (OFI_UNLIKELY(ret != 0)) {
+			req->free(req, false);
+			return ret;
+		}
+	}
 
 	*ret_req = req;
 
@@ -5267,6 +7195,10 @@ static int alloc_rdma_send_req(nccl_net_ofi_rdma_send_comm_t *s_comm,
 
 	rdma_req_send_data_t *send_data = get_send_data(req);
 	send_data->xferred_rail_id = 0;
+	send_data->retry_xfers = 0;
+	send_data->num_retries = 0;
+#ifndef NDEBUG
+#endif
 	send_data->buff = buff;
 	send_data->buff_len = size;
 	send_data->buff_mr_handle = buff_mr_handle;
@@ -5338,43 +7270,154 @@ static int insert_rdma_send_req_into_msgbuff(nccl_net_ofi_rdma_send_comm_t *s_co
 	return 0;
 }
 
-static int post_rma_write(nccl_net_ofi_rdma_req_t *req)
+/*
+ * @brief	Post the stripes of an RMA write that have not been posted yet
+ *
+ * Each stripe of each operation is written on its own rail and
+ * produces one completion. On -FI_EAGAIN, `op_idx' and
+ * `xferred_rail_id' record where to resume.
+ */
+template <int NUM_RAILS>
+static int fast_path_post_rma_write(nccl_net_ofi_rdma_req_t *req)
 {
 	nccl_net_ofi_rdma_send_comm_t *s_comm = (nccl_net_ofi_rdma_send_comm_t *)req->comm;
-	size_t rail_id = 0;
-	nccl_net_ofi_rdma_send_comm_rail_t *comm_rail = rdma_send_comm_get_rail(s_comm, rail_id);
 	rdma_req_rma_op_data_t *rma_op_data = req_get_rma_op_data(req, NCCL_OFI_RDMA_WRITE);
-	ssize_t rc;
+	nccl_net_ofi_rdma_send_comm_rail_t *rail0 = rdma_send_comm_get_rail(s_comm, 0);
+	ssize_t rc = 0;
+	size_t total_size = 0;
+
+	rc = post_rma_key_fetch(req, rma_op_data, rail0->local_ep, rail0->remote_addr);
+	if (rc != 0) {
+		return rc;
+	}
+
+	/* All stripes of a request go to the same endpoint of their
+	 * rail, so that the last post of each rail flushes FI_MORE */
+	for (size_t i = 0; i < rma_op_data->num_ops; i++) {
+		total_size += rma_op_data->ops[i].buff_len;
+	}
+
+	for (; rma_op_data->op_idx < rma_op_data->num_ops; rma_op_data->op_idx++) {
+		nccl_net_ofi_rdma_rma_op_t *op = &rma_op_data->ops[rma_op_data->op_idx];
+		nccl_net_ofi_schedule_t *schedule = op->schedule;
+
+		size_t num_xfers = fast_path_num_xfers<NUM_RAILS>(schedule);
+
+		for (; rma_op_data->xferred_rail_id < num_xfers; rma_op_data->xferred_rail_id++) {
+			nccl_net_ofi_xfer_info_t *xfer_info = &schedule->rail_xfer_infos[rma_op_data->xferred_rail_id];
+			int rail_id = xfer_info->rail_id;
+			nccl_net_ofi_rdma_send_comm_rail_t *comm_rail = rdma_send_comm_get_rail_by_size(s_comm, rail_id, total_size);
+			void *desc = NULL;
+
+			struct iovec iov;
+			struct fi_msg_rma msg;
+			struct fi_rma_iov rma_iov;
+
+			if (op->buff_mr_handle != NULL) {
+				desc = fi_mr_desc(op->buff_mr_handle->mr[rail_id]);
+			}
+
+			/* Set up the iovec */
+			iov.iov_base = (void *)((uintptr_t)op->buff + xfer_info->offset);
+			iov.iov_len = xfer_info->msg_size;
+
+			/* Set up the rma_iov */
+			rma_iov.addr = op->remote_buff + xfer_info->offset;
+			rma_iov.len = xfer_info->msg_size;
+			rma_iov.key = op->remote_mr_key[rail_id];
+
+			/* Initialize the message */
+			msg.msg_iov = &iov;
+			msg.desc = &desc;
+			msg.iov_count = 1;
+			msg.addr = comm_rail->remote_addr;
+			msg.rma_iov = &rma_iov;
+			msg.rma_iov_count = 1;
+			msg.context = (void *)&req->ctx[rail_id];
+			msg.data = 0;
+
+			/* Post the message using fi_writemsg. Request a completion
+			 * entry explicitly, since data rail endpoints may use
+			 * selective completion (see RDMA_WRITE_CNTR) */
+			rc = fi_writemsg(comm_rail->local_ep, &msg,
+					 rma_op_data->flags | FI_COMPLETION |
+					 rma_stripe_flags(rma_op_data, rail_id));
+
+			if ((rc != 0) && (rc != -FI_EAGAIN)) {
+				NCCL_OFI_WARN("fi_writemsg failed; RC: %zd, Error: %s",
+					      rc, fi_strerror(-rc));
+				return rc;
+			} else if (rc != 0) {
+				return rc;
+			}
+			rma_stripe_posted(req, rma_op_data, rail_id);
+		}
+		rma_op_data->xferred_rail_id = 0;
+	}
+	assert(rma_stripes_flushed(rma_op_data));
+
+	return 0;
+}
+
+static int post_rma_write(nccl_net_ofi_rdma_req_t *req)
+{
+	return rdma_req_get_ep(req)->fast_path->post_rma_write(req);
+}
+
+/*
+ * @brief	Post RDMA write of send request without completion entry
+ *
+ * The write is only accounted by the write counter of the rail and
+ * the send request records the counter value that completes it (see
+ * check_write_cntr_completion()). Returns -FI_EAGAIN without posting
+ * if the rail already has write_cntr_fence_interval writes that were
+ * not drained, to let the counter catch up (see
+ * update_write_cntr_rail()).
+ */
+static int post_rdma_write_cntr(nccl_net_ofi_rdma_req_t *req,
+				nccl_net_ofi_rdma_ep_t *ep,
+				nccl_net_ofi_rdma_send_comm_rail_t *comm_rail,
+				nccl_net_ofi_xfer_info_t *xfer_info,
+				void *desc,
+				bool no_target_completion)
+{
+	rdma_req_send_data_t *send_data = get_send_data(req);
+	int rail_id = xfer_info->rail_id;
+	nccl_net_ofi_ep_rail_t *ep_rail = rdma_endpoint_get_rail(ep, rail_id);
+	assert(ep_rail->write_cntr != NULL);
+
+	if (ep_rail->write_cntr_posted - ep_rail->write_cntr_drained >= ep->write_cntr_fence_interval) {
+		return -FI_EAGAIN;
+	}
 
 	struct iovec iov;
 	struct fi_msg_rma msg;
 	struct fi_rma_iov rma_iov;
 
-	/* Set up the iovec */
-	iov.iov_base = rma_op_data->buff;
-	iov.iov_len = rma_op_data->buff_len;
+	iov.iov_base = (void *)((uintptr_t)send_data->buff + xfer_info->offset);
+	iov.iov_len = xfer_info->msg_size;
 
-	/* Set up the rma_iov */
-	rma_iov.addr = rma_op_data->remote_buff;
-	rma_iov.len = rma_op_data->buff_len;
-	rma_iov.key = rma_op_data->remote_mr_key;
+	rma_iov.addr = send_data->remote_buff + xfer_info->offset;
+	rma_iov.len = xfer_info->msg_size;
+	rma_iov.key = send_data->remote_mr_key[rail_id];
 
-	/* Initialize the message */
 	msg.msg_iov = &iov;
-	msg.desc = &rma_op_data->desc;
+	msg.desc = &desc;
 	msg.iov_count = 1;
 	msg.addr = comm_rail->remote_addr;
 	msg.rma_iov = &rma_iov;
 	msg.rma_iov_count = 1;
 	msg.context = (void *)&req->ctx[rail_id];
-	msg.data = 0;
-
-	/* Post the message using fi_writemsg with FI_INJECT */
-	rc = fi_writemsg(comm_rail->local_ep, &msg, rma_op_data->flags);
+	msg.data = no_target_completion ? 0 : send_data->wdata;
 
+	ssize_t rc = fi_writemsg(comm_rail->local_ep, &msg,
+				 no_target_completion ? 0 : FI_REMOTE_CQ_DATA);
 	if ((rc != 0) && (rc != -FI_EAGAIN)) {
-		NCCL_OFI_WARN("fi_write_inline failed; RC: %zd, Error: %s",
+		NCCL_OFI_WARN("fi_writemsg failed; RC: %zd, Error: %s",
 			      rc, fi_strerror(-rc));
+	} else if (rc == 0) {
+		send_data->write_cntr_threshold[rail_id] = ++(ep_rail->write_cntr_posted);
+		NCCL_OFI_TRACE_SEND_WRITE_SEG_START(req->dev_id, rail_id, xfer_info->msg_size, req->comm, req->msg_seq_num, req);
 	}
 
 	return rc;
@@ -5392,6 +7435,11 @@ static int post_rdma_write(nccl_net_ofi_rdma_req_t *req,
 	void *desc = fi_mr_desc(rail_mr_handle);
 
 	ssize_t rc;
+	nccl_net_ofi_rdma_ep_t *ep = rdma_req_get_ep(req);
+	if (ep->use_write_cntr) {
+		return post_rdma_write_cntr(req, ep, comm_rail, xfer_info, desc, no_target_completion);
+	}
+
 	/* Post RDMA write */
 	if (no_target_completion) {
 		rc = fi_write(comm_rail->local_ep, (void*)((uintptr_t)send_data->buff + xfer_info->offset),
@@ -5410,6 +7458,7 @@ static int post_rdma_write(nccl_net_ofi_rdma_req_t *req,
 		NCCL_OFI_WARN("fi_writedata failed; RC: %zd, Error: %s",
 			      rc, fi_strerror(-rc));
 	} else if (rc == 0) {
+		rdma_req_cq_op_posted(req, rail_id);
 		NCCL_OFI_TRACE_SEND_WRITE_SEG_START(req->dev_id, rail_id, xfer_info->msg_size, req->comm, req->msg_seq_num, req);
 	}
 
@@ -5421,19 +7470,40 @@ static int post_rdma_eager_send(nccl_net_ofi_rdma_req_t *req,
 				nccl_net_ofi_xfer_info_t *xfer_info)
 {
 	rdma_req_send_data_t *send_data = get_send_data(req);
+	nccl_net_ofi_rdma_ep_t *ep = rdma_req_get_ep(req);
 	assert(xfer_info->rail_id < send_data->buff_mr_handle->num_rails);
 	int rail_id = xfer_info->rail_id;
 	struct fid_mr *rail_mr_handle = send_data->buff_mr_handle->mr[rail_id];
 	void *desc = fi_mr_desc(rail_mr_handle);
+	void *buff = (void *)(((uintptr_t)send_data->buff) + xfer_info->offset);
 
 	ssize_t rc;
+
+	/* The provider copies tiny host payloads at post time, so the
+	 * send completes without a completion entry. The request still
+	 * waits for the control message if it has not arrived. */
+	if (xfer_info->msg_size <= ep->eager_inject_size &&
+	    send_data->buff_mr_handle->type == NCCL_PTR_HOST) {
+		rc = fi_injectdata(comm_rail->local_ep, buff, xfer_info->msg_size,
+				   send_data->wdata, comm_rail->remote_addr);
+		if ((rc != 0) && (rc != -FI_EAGAIN)) {
+			NCCL_OFI_WARN("fi_injectdata failed; RC: %zd, Error: %s", rc, fi_strerror(-rc));
+		} else if (rc == 0) {
+			NCCL_OFI_TRACE_EAGER_SEND_START(req->dev_id, rail_id, xfer_info->msg_size, req->comm, req->msg_seq_num, req);
+			NCCL_OFI_TRACE_EAGER_SEND_COMPLETE(req->dev_id, rail_id, req->comm, req->msg_seq_num, req);
+			rc = inc_req_completion(req, 0, send_data->total_num_compls);
+		}
+		return rc;
+	}
+
 	/* Post eager send */
-	rc = fi_senddata(comm_rail->local_ep, (void*)(((uintptr_t)send_data->buff) + xfer_info->offset), xfer_info->msg_size, desc,
+	rc = fi_senddata(comm_rail->local_ep, buff, xfer_info->msg_size, desc,
 			 send_data->wdata, comm_rail->remote_addr, (void *)&req->ctx[rail_id]);
 
 	if ((rc != 0) && (rc != -FI_EAGAIN)) {
 		NCCL_OFI_WARN("fi_senddata failed; RC: %zd, Error: %s", rc, fi_strerror(-rc));
 	} else if (rc == 0) {
+		rdma_req_cq_op_posted(req, rail_id);
 		NCCL_OFI_TRACE_EAGER_SEND_START(req->dev_id, rail_id, xfer_info->msg_size, req->comm, req->msg_seq_num, req);
 	}
 
@@ -5486,6 +7556,123 @@ static int post_rx_buffer(nccl_net_ofi_rdma_req_t *req,
 	return rc;
 }
 
+#ifndef NDEBUG
+/*
+ * @brief	Fail stripe `xfer_idx' of send request `req' instead of
+ *		posting it, if it is the N-th write stripe eligible for
+ *		error injection (see INJECT_STRIPE_ERRORS)
+ *
+ * The stripe is handled like one that completed with a transient
+ * error, i.e., send_progress() posts it again after the backoff delay.
+ *
+ * @return	true, if the stripe was failed
+ */
+static bool send_stripe_inject_error(nccl_net_ofi_rdma_req_t *req, size_t xfer_idx)
+{
+	nccl_net_ofi_rdma_ep_t *ep = rdma_req_get_ep(req);
+	rdma_req_send_data_t *send_data = get_send_data(req);
+	int rail_id = send_data->schedule->rail_xfer_infos[xfer_idx].rail_id;
+
+	if (send_data->eager || send_data->num_retries != 0 ||
+	    ++(ep->num_send_stripes) % ep->inject_stripe_errors != 0) {
+		return false;
+	}
+	if (send_retry_stripe(req, xfer_idx) != 0) {
+		return false;
+	}
+
+	NCCL_OFI_INFO(NCCL_NET, "Injected error in stripe %zu of request %p on rail %d",
+		      xfer_idx, req, rail_id);
+	return true;
+}
+#endif
+
+/*
+ * @brief	Post stripe `xfer_idx' of the schedule of send request `req'
+ */
+static int post_send_stripe(nccl_net_ofi_rdma_req_t *req, size_t xfer_idx)
+{
+	nccl_net_ofi_rdma_send_comm_t *s_comm = (nccl_net_ofi_rdma_send_comm_t *)req->comm;
+	rdma_req_send_data_t *send_data = get_send_data(req);
+	/* Get xfer information from the schedule */
+	nccl_net_ofi_xfer_info_t *xfer_info = &send_data->schedule->rail_xfer_infos[xfer_idx];
+	/* Get communicator rail information to xfer the req */
+	nccl_net_ofi_rdma_send_comm_rail_t *comm_rail =
+		rdma_send_comm_get_rail_by_size(s_comm, xfer_info->rail_id, send_data->buff_len);
+
+#ifndef NDEBUG
+	if (OFI_UNLIKELY(rdma_req_get_ep(req)->inject_stripe_errors != 0) &&
+	    send_stripe_inject_error(req, xfer_idx)) {
+		return 0;
+	}
+#endif
+
+	if (send_data->eager) {
+		return post_rdma_eager_send(req, comm_rail, xfer_info);
+	}
+	return post_rdma_write(req, comm_rail, xfer_info, send_data->no_target_completion);
+}
+
+/*
+ * @brief	Post the stripes of send request `req' that were not posted
+ *		yet, starting at `xferred_rail_id'
+ */
+template <int NUM_RAILS>
+static int fast_path_post_send_stripes(nccl_net_ofi_rdma_req_t *req)
+{
+	rdma_req_send_data_t *send_data = get_send_data(req);
+	size_t num_xfers = fast_path_num_xfers<NUM_RAILS>(send_data->schedule);
+	int ret = 0;
+
+	for (size_t rail_it = send_data->xferred_rail_id; rail_it < num_xfers; rail_it++) {
+		ret = post_send_stripe(req, rail_it);
+		if (ret != 0) {
+			break;
+		}
+		send_data->xferred_rail_id++;
+	}
+
+	return ret;
+}
+
+/*
+ * @brief	Post the stripes of send request `req' that failed, once
+ *		the backoff delay elapsed
+ *
+ * @return	0, if the failed stripes were posted or still wait for
+ *		   the delay
+ *		-FI_EAGAIN, if the provider is busy
+ *		error, on others
+ */
+static int post_send_retries(nccl_net_ofi_rdma_req_t *req)
+{
+	rdma_req_send_data_t *send_data = get_send_data(req);
+	nccl_net_ofi_schedule_t *schedule = send_data->schedule;
+	int ret;
+
+	if (stripe_retry_now() < send_data->retry_time) {
+		return 0;
+	}
+
+	for (size_t i = 0; i != schedule->num_xfer_infos; ++i) {
+		uint32_t mask = 1U << i;
+		if (!(send_data->retry_xfers & mask)) {
+			continue;
+		}
+
+		send_data->retry_xfers &= ~mask;
+		ret = post_send_stripe(req, i);
+		if (ret != 0) {
+			if (ret == -FI_EAGAIN) {
+				send_data->retry_xfers |= mask;
+			}
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 /*
  * @brief	This function helps progress the send request by submitting it
  *		to the network. This can be invoked when submitting a new request
@@ -5494,12 +7681,13 @@ static int post_rx_buffer(nccl_net_ofi_rdma_req_t *req,
  * @return	0, if successfully sent
  *              -EINVAL   Invalid request
  * 		-FI_EAGAIN, if need to retry the xfer
+ *		-EINPROGRESS, if failed stripes of a send request wait
+ *		   for their backoff delay
  * 		-1, error
  */
 static int send_progress(nccl_net_ofi_rdma_req_t *req)
 {
 	ssize_t ret = 0;;
-	nccl_net_ofi_rdma_send_comm_t *s_comm = (nccl_net_ofi_rdma_send_comm_t *)req->comm;
 
 	assert(req != NULL);
 
@@ -5515,40 +7703,23 @@ static int send_progress(nccl_net_ofi_rdma_req_t *req)
 
 		assert(!(send_data->eager) || schedule->num_xfer_infos == 1);
 
-		nccl_net_ofi_xfer_info_t *xfers = schedule->rail_xfer_infos;
-
-		if (send_data->eager) {
-			/* Get xfer information from the schedule */
-			nccl_net_ofi_xfer_info_t *xfer_info = &xfers[0];
+		/* Post stripes that failed again */
+		if (OFI_UNLIKELY(send_data->retry_xfers != 0)) {
+			ret = post_send_retries(req);
+			if (ret != 0) {
+				return ret;
+			}
+		}
 
-			/* Get communicator rail information to xfer the req */
-			nccl_net_ofi_rdma_send_comm_rail_t *comm_rail =
-				rdma_send_comm_get_rail(s_comm, xfer_info->rail_id);
+		ret = rdma_req_get_ep(req)->fast_path->post_send_stripes(req);
 
-			ret = post_rdma_eager_send(req, comm_rail, xfer_info);
-		} else {
-			for (size_t rail_it = send_data->xferred_rail_id; rail_it < schedule->num_xfer_infos; rail_it++) {
-				/* Get xfer information from the schedule */
-				nccl_net_ofi_xfer_info_t *xfer_info = &xfers[rail_it];
-				/* Get communicator rail information to xfer the req */
-				nccl_net_ofi_rdma_send_comm_rail_t *comm_rail =
-					rdma_send_comm_get_rail(s_comm, xfer_info->rail_id);
-
-				ret = post_rdma_write(req, comm_rail, xfer_info, send_data->no_target_completion);
-
-				if (ret == 0) // Successfully sent the xfer with this rail
-					send_data->xferred_rail_id++;
-				else
-					break;
-			}
+		/* Failed stripes are posted again from the pending
+		 * requests queue once their delay elapsed */
+		if (ret == 0 && OFI_UNLIKELY(send_data->retry_xfers != 0)) {
+			ret = -EINPROGRESS;
 		}
 	} else if (req->type == NCCL_OFI_RDMA_WRITE) { // Post RMA write
 		ret = post_rma_write(req);
-		if (ret == 0) {
-			rdma_req_rma_op_data_t *rma_op_data = req_get_rma_op_data(req, NCCL_OFI_RDMA_WRITE);
-			// Successfully sent the xfer with this rail
-			rma_op_data->xferred_rail_id++;
-		}
 	} else if (req->type == NCCL_OFI_RDMA_CTRL_RX_BUFF ||
 		   req->type == NCCL_OFI_RDMA_EAGER_RX_BUFF) { // Post rx Buffer
 		rdma_req_rx_buff_data_t *rx_buff_data = get_rx_buff_data(req);
@@ -5586,6 +7757,8 @@ static ssize_t send_ctrl_post(nccl_net_ofi_rdma_recv_comm_t *r_comm,
 	if ((rc != 0) && (rc != -FI_EAGAIN)) {
 		NCCL_OFI_WARN("Error posting RDMA %s request. RC: %zd, Error: %s",
 			      nccl_net_ofi_req_str(req), rc, fi_strerror(-rc));
+	} else if (rc == 0) {
+		rdma_req_cq_op_posted(req, rail_id);
 	}
 	return rc;
 }
@@ -5611,7 +7784,7 @@ static int post_rdma_ctrl(nccl_net_ofi_rdma_req_t *req)
 		rail_id = 0;
 	}
 
-	size_t ctrl_msg_len = nccl_net_ofi_rdma_ctrl_msg_size(ep->num_rails, ep->use_long_rkeys);
+	size_t ctrl_msg_len = ep->ctrl_msg_size;
 
 	ssize_t rc = send_ctrl_post(r_comm, ctrl_fl_elem, rail_id, ctrl_msg_len, req);
 
@@ -5646,6 +7819,21 @@ static int post_close_msg(nccl_net_ofi_rdma_req_t *req)
 	return rc;
 }
 
+static int post_credit_msg(nccl_net_ofi_rdma_req_t *req)
+{
+	assert(req->type == NCCL_OFI_RDMA_SEND_CREDIT);
+	nccl_net_ofi_rdma_recv_comm_t *r_comm = (nccl_net_ofi_rdma_recv_comm_t *)req->comm;
+	rdma_req_send_credit_data_t *send_credit_data = req_get_send_credit_data(req);
+
+	req->state = NCCL_OFI_RDMA_REQ_PENDING;
+
+	/* Always use control rail 0 for credit message. Credits are
+	 * only granted for slots whose advertisement was already
+	 * consumed by the sender, so rail ordering does not matter. */
+	return send_ctrl_post(r_comm, send_credit_data->ctrl_fl_elem, 0,
+			      sizeof(nccl_net_ofi_rdma_credit_msg_t), req);
+}
+
 static int post_eager_copy(nccl_net_ofi_rdma_req_t *req)
 {
 	nccl_net_ofi_rdma_recv_comm_t *r_comm = (nccl_net_ofi_rdma_recv_comm_t *)req->comm;
@@ -5689,12 +7877,73 @@ static int post_eager_copy(nccl_net_ofi_rdma_req_t *req)
 	if ((rc != 0) && (rc != -FI_EAGAIN)) {
 		NCCL_OFI_WARN("Error posting RDMA ctrl request. RC: %zd, Error: %s",
 			      rc, fi_strerror(-rc));
+	} else if (rc == 0) {
+		rdma_req_cq_op_posted(req, rx_rail_id);
 	}
 
 	return rc;
 }
 
-static int post_flush_req(nccl_net_ofi_rdma_req_t *req)
+/*
+ * @brief	Number of rails of a fast path instance
+ *
+ * Returns the compile-time rail count NUM_RAILS, or the runtime rail
+ * count of the endpoint for the generic instance (NUM_RAILS == 0).
+ */
+template <int NUM_RAILS>
+static inline int fast_path_num_rails(nccl_net_ofi_rdma_ep_t *ep)
+{
+	return (NUM_RAILS != 0) ? NUM_RAILS : ep->num_rails;
+}
+
+template <int NUM_RAILS, bool LONG_RKEYS>
+static int fast_path_fill_ctrl_rkeys(nccl_net_ofi_rdma_ep_t *ep,
+				     nccl_net_ofi_rdma_ctrl_msg_t *msg,
+				     nccl_net_ofi_rdma_mr_handle_t *mr_handle)
+{
+	int num_rails = fast_path_num_rails<NUM_RAILS>(ep);
+
+	for (int rail_id = 0; rail_id < num_rails; rail_id++) {
+		uint64_t rkey = fi_mr_key(mr_handle->mr[rail_id]);
+
+		if (OFI_UNLIKELY(rkey == FI_KEY_NOTAVAIL)) {
+			NCCL_OFI_WARN("RDMA write buffers should be pre-registered");
+			return -ENOENT;
+		}
+
+		if (LONG_RKEYS) {
+			msg->long_buff_mr_key[rail_id] = rkey;
+		} else {
+			if (OFI_UNLIKELY(rkey > (1ULL << (NCCL_NET_OFI_CTRL_MSG_SHORT_KEY_SIZE * 8)) - 1)) {
+				NCCL_OFI_WARN("Libfabric returned rkey larger than declared rkey size: %" PRIu64,
+					      rkey);
+				return -ENOTSUP;
+			}
+			msg->short_buff_mr_key[rail_id] = rkey;
+		}
+	}
+
+	return 0;
+}
+
+template <int NUM_RAILS, bool LONG_RKEYS>
+static void fast_path_copy_remote_rkeys(nccl_net_ofi_rdma_ep_t *ep,
+					rdma_req_send_data_t *send_data,
+					const nccl_net_ofi_rdma_ctrl_msg_t *msg)
+{
+	int num_rails = fast_path_num_rails<NUM_RAILS>(ep);
+
+	for (int rail_id = 0; rail_id < num_rails; rail_id++) {
+		if (LONG_RKEYS) {
+			send_data->remote_mr_key[rail_id] = msg->long_buff_mr_key[rail_id];
+		} else {
+			send_data->remote_mr_key[rail_id] = msg->short_buff_mr_key[rail_id];
+		}
+	}
+}
+
+template <int NUM_RAILS>
+static int fast_path_post_flush(nccl_net_ofi_rdma_req_t *req)
 {
  	nccl_net_ofi_rdma_recv_comm_t *r_comm = (nccl_net_ofi_rdma_recv_comm_t *)req->comm;
 	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)r_comm->base.base.ep;
@@ -5702,10 +7951,11 @@ static int post_flush_req(nccl_net_ofi_rdma_req_t *req)
 	nccl_net_ofi_rdma_flush_buffer_t *f_buff = &domain->flush_buff;
 	rdma_req_flush_data_t *flush_data = get_flush_data(req);
 	nccl_net_ofi_rdma_recv_comm_rail_t *comm_rail;
+	int num_rails = fast_path_num_rails<NUM_RAILS>(ep);
 	ssize_t rc = 0;
 
 	/* iterate all rails and post RDMA local read */
-	for (int rail_id = 0; rail_id < ep->num_rails; rail_id++) {
+	for (int rail_id = 0; rail_id < num_rails; rail_id++) {
 		comm_rail = rdma_recv_comm_get_rail(r_comm, rail_id);
 
 		void *desc = fi_mr_desc(f_buff->mr_handle->mr[rail_id]);
@@ -5735,6 +7985,8 @@ static int post_flush_req(nccl_net_ofi_rdma_req_t *req)
 			NCCL_OFI_WARN("Error posting flush request. RC: %zd, Error: %s",
 				      rc, fi_strerror(-rc));
 			goto exit;
+		} else if (rc == 0) {
+			rdma_req_cq_op_posted(req, rail_id);
 		}
 	}
 
@@ -5742,6 +7994,49 @@ static int post_flush_req(nccl_net_ofi_rdma_req_t *req)
 	return (int)rc;
 }
 
+#define FAST_PATH_INSTANCE(num_rails, long_rkeys)			\
+	{								\
+		fast_path_fill_ctrl_rkeys<(num_rails), (long_rkeys)>,	\
+		fast_path_copy_remote_rkeys<(num_rails), (long_rkeys)>,	\
+		fast_path_post_flush<(num_rails)>,			\
+		fast_path_post_send_stripes<(num_rails)>,		\
+		fast_path_post_rma_write<(num_rails)>,			\
+		fast_path_post_rma_read<(num_rails)>			\
+	}
+
+/* Fast path instances, indexed by [use_long_rkeys][index]. Index 0 is
+ * the generic instance, index i > 0 is specialized for 2^(i-1) rails. */
+static const nccl_net_ofi_rdma_fast_path_t fast_paths[2][4] = {
+	{ FAST_PATH_INSTANCE(0, false), FAST_PATH_INSTANCE(1, false),
+	  FAST_PATH_INSTANCE(2, false), FAST_PATH_INSTANCE(4, false) },
+	{ FAST_PATH_INSTANCE(0, true), FAST_PATH_INSTANCE(1, true),
+	  FAST_PATH_INSTANCE(2, true), FAST_PATH_INSTANCE(4, true) },
+};
+
+/*
+ * @brief	Select the fast path instance for a rail count and rkey width
+ */
+static const nccl_net_ofi_rdma_fast_path_t *select_fast_path(int num_rails, bool use_long_rkeys)
+{
+	switch (num_rails) {
+	case 1:
+		return &fast_paths[use_long_rkeys][1];
+	case 2:
+		return &fast_paths[use_long_rkeys][2];
+	case 4:
+		return &fast_paths[use_long_rkeys][3];
+	default:
+		return &fast_paths[use_long_rkeys][0];
+	}
+}
+
+static int post_flush_req(nccl_net_ofi_rdma_req_t *req)
+{
+	nccl_net_ofi_rdma_ep_t *ep = (nccl_net_ofi_rdma_ep_t *)req->comm->ep;
+
+	return ep->fast_path->post_flush(req);
+}
+
 static inline int check_post_rx_buff_req(nccl_net_ofi_rdma_req_t *rx_buff_req)
 {
 	int ret = 0;
@@ -5765,9 +8060,9 @@ static inline int check_post_rx_buff_req(nccl_net_ofi_rdma_req_t *rx_buff_req)
 		ret = send_progress(rx_buff_req);
 		if (ret == -FI_EAGAIN) {
 			/* Place in pending requests queue for next try */
-			ret = nccl_ofi_deque_insert_back(ep->pending_reqs_queue, &rx_buff_req->pending_reqs_elem);
+			ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &rx_buff_req->pending_reqs_elem);
 			if (ret != 0) {
-				NCCL_OFI_WARN("Failed to nccl_ofi_deque_insert_back: %d", ret);
+				NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
 				return ret;
 			}
 			NCCL_OFI_TRACE_PENDING_INSERT(rx_buff_req);
@@ -5843,6 +8138,8 @@ static int send(nccl_net_ofi_send_comm_t *send_comm, void *data, int size, int t
 		goto error;
 	}
 
+	send_comm_release_conn_req(s_comm);
+
 	/*
 	 * TODO: Use NCCL provided tags when using grouped receives aka
 	 * props->maxRecvs > 1.
@@ -5861,10 +8158,11 @@ retry:
 	mb_res = nccl_ofi_msgbuff_retrieve(s_comm->msgbuff, msg_seq_num, &elem,
 					   &type, &msg_stat);
 	if (mb_res == NCCL_OFI_MSGBUFF_SUCCESS) {
-		if (OFI_LIKELY(type == NCCL_OFI_MSGBUFF_BUFF)) {
+		if (OFI_LIKELY(type == NCCL_OFI_MSGBUFF_BUFF || type == NCCL_OFI_MSGBUFF_RING_SLOT)) {
 			/*
-			 * Received RDMA control message from receiver so
-			 * allocate request and initiate RDMA write
+			 * Received RDMA control message or credit from
+			 * receiver so allocate request and initiate RDMA
+			 * write
 			 */
 			have_ctrl = true;
 		} else if (type == NCCL_OFI_MSGBUFF_REQ) {
@@ -5940,19 +8238,30 @@ retry:
 	if (have_ctrl) {
 		/*
 		 * For already received RDMA control message, populate
-		 * the RDMA write metadata from the rx buffer
+		 * the RDMA write metadata from the rx buffer, or from
+		 * the receive ring slot if the message was granted by a
+		 * credit
 		 */
-		nccl_net_ofi_rdma_req_t *rx_buff_req = (nccl_net_ofi_rdma_req_t *)elem;
-		ret = update_send_data_from_remote(s_comm, rx_buff_req, req);
-		if (OFI_UNLIKELY(ret != 0)) {
-			NCCL_OFI_WARN("Failed to copy ctrl data");
-			goto error;
-		}
+		if (type == NCCL_OFI_MSGBUFF_RING_SLOT) {
+			ret = update_send_data_from_remote(s_comm, (nccl_net_ofi_rdma_ctrl_msg_t *)elem, req);
+			if (OFI_UNLIKELY(ret != 0)) {
+				NCCL_OFI_WARN("Failed to copy ctrl data");
+				goto error;
+			}
+		} else {
+			nccl_net_ofi_rdma_req_t *rx_buff_req = (nccl_net_ofi_rdma_req_t *)elem;
+			ret = update_send_data_from_remote(s_comm, get_rx_ctrl_msg(get_rx_buff_data(rx_buff_req)),
+							   req);
+			if (OFI_UNLIKELY(ret != 0)) {
+				NCCL_OFI_WARN("Failed to copy ctrl data");
+				goto error;
+			}
 
-		/* Post if needed */
-		ret = check_post_rx_buff_req(rx_buff_req);
-		if (OFI_UNLIKELY(ret != 0)) {
-			goto error;
+			/* Post if needed */
+			ret = check_post_rx_buff_req(rx_buff_req);
+			if (OFI_UNLIKELY(ret != 0)) {
+				goto error;
+			}
 		}
 	}
 
@@ -5966,6 +8275,7 @@ retry:
 	 * so update the num inflight
 	 */
 	(s_comm->num_inflight_reqs)++;
+	(ep->num_sends_inflight)++;
 
 	if (!eager) {
 		(s_comm->num_inflight_writes)++;
@@ -5973,15 +8283,30 @@ retry:
 
 	NCCL_OFI_TRACE_SEND(req->dev_id, size, s_comm, msg_seq_num, req, base_req);
 
+	/* Until the connect response arrived, the request waits in the
+	 * message buffer for finish_connect() to post it. The sweep of
+	 * finish_connect() covers it once next_msg_seq_num is advanced
+	 * under conn_lock. */
+	if (OFI_UNLIKELY(!s_comm->connected.load(std::memory_order_acquire))) {
+		nccl_net_ofi_mutex_lock(&s_comm->conn_lock);
+		if (!s_comm->connected.load(std::memory_order_relaxed)) {
+			s_comm->next_msg_seq_num = (s_comm->next_msg_seq_num + 1) & MSG_SEQ_NUM_MASK;
+			nccl_net_ofi_mutex_unlock(&s_comm->conn_lock);
+			*base_req = &req->base;
+			goto exit;
+		}
+		nccl_net_ofi_mutex_unlock(&s_comm->conn_lock);
+	}
+
 	/* Try posting RDMA write for received RDMA control messages */
 	if (have_ctrl || eager) {
 
 		ret = send_progress(req);
-		if (ret == -FI_EAGAIN) {
+		if (ret == -FI_EAGAIN || ret == -EINPROGRESS) {
 			/* Add to pending reqs queue */
-			ret = nccl_ofi_deque_insert_back(ep->pending_reqs_queue, &req->pending_reqs_elem);
+			ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &req->pending_reqs_elem);
 			if (OFI_UNLIKELY(ret != 0)) {
-				NCCL_OFI_WARN("Failed to nccl_ofi_deque_insert_back: %d", ret);
+				NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
 				goto error;
 			}
 			NCCL_OFI_TRACE_PENDING_INSERT(req);
@@ -6074,6 +8399,7 @@ static void prepare_send_connect_message(nccl_net_ofi_rdma_ep_t *ep, int dev_id,
 	int num_control_rails = ep->num_control_rails;
 
 	conn_msg->type = NCCL_OFI_RDMA_MSG_CONN;
+	conn_msg->recv_ring = (ofi_nccl_rdma_recv_ring() != 0);
 
 	/* Send s_comm's local comm ID to be transferred to receiver */
 	conn_msg->local_comm_id = local_comm_id;
@@ -6085,6 +8411,8 @@ static void prepare_send_connect_message(nccl_net_ofi_rdma_ep_t *ep, int dev_id,
 	conn_msg->num_rails = num_rails;
 	conn_msg->num_control_rails = num_control_rails;
 
+	set_conn_msg_rma_key_table(ep, conn_msg);
+
 	/* Set libfabric endpoint names for each control rail */
 	for (int rail_id = 0; rail_id != num_control_rails; ++rail_id) {
 		memcpy(conn_msg->control_ep_names[rail_id].ep_name,
@@ -6114,7 +8442,8 @@ static void prepare_send_connect_message(nccl_net_ofi_rdma_ep_t *ep, int dev_id,
  * @return	communicator, on success
  *		NULL, on error
  */
-static inline nccl_net_ofi_rdma_send_comm_t *calloc_rdma_send_comm(int num_rails, int num_control_rails)
+static inline nccl_net_ofi_rdma_send_comm_t *calloc_rdma_send_comm(int num_rails, int num_control_rails,
+								   bool low_latency)
 {
 	nccl_net_ofi_rdma_send_comm_t *s_comm = (nccl_net_ofi_rdma_send_comm_t *)calloc(1, sizeof(nccl_net_ofi_rdma_send_comm_t));
 	if (OFI_UNLIKELY(!s_comm)) {
@@ -6134,6 +8463,14 @@ static inline nccl_net_ofi_rdma_send_comm_t *calloc_rdma_send_comm(int num_rails
         goto error;
     }
 
+	if (low_latency) {
+		s_comm->ll_rails = (nccl_net_ofi_rdma_send_comm_rail_t *)calloc(num_rails, sizeof(nccl_net_ofi_rdma_send_comm_rail_t));
+		if (OFI_UNLIKELY(!s_comm->ll_rails)) {
+			NCCL_OFI_WARN("Unable to allocate send communicator low-latency rails array");
+			goto error;
+		}
+	}
+
     return s_comm;
 
 error:
@@ -6157,10 +8494,10 @@ static inline int init_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 	nccl_net_ofi_ep_rail_t *rail;
 	nccl_net_ofi_rdma_domain_t *domain = rdma_endpoint_get_domain(ep);
 
-	ret = nccl_ofi_freelist_init(sizeof(nccl_net_ofi_rdma_req_t),
-				     ofi_nccl_rdma_min_posted_bounce_buffers(), 16, 0,
-				     rdma_fl_req_entry_init, rdma_fl_req_entry_fini,
-				     &ep->rx_buff_reqs_fl);
+	ret = nccl_net_ofi_rdma_req_fl_t::init(ofi_nccl_rdma_min_posted_bounce_buffers(), 16, 0,
+					       rdma_fl_req_entry_init, rdma_fl_req_entry_fini,
+					       NULL, NULL, NULL,
+					       &ep->rx_buff_reqs_fl);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Failed to init rx_buff_reqs_fl");
 		return ret;
@@ -6173,7 +8510,7 @@ static inline int init_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 					domain, 1, &ep->ctrl_rx_buff_fl);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Failed to init ctrl_rx_buff_fl");
-		if (nccl_ofi_freelist_fini(ep->rx_buff_reqs_fl))
+		if (nccl_net_ofi_rdma_req_fl_t::fini(ep->rx_buff_reqs_fl))
 			NCCL_OFI_WARN("Also failed to freelist_fini rx_buff_reqs_fl");
 		return ret;
 	}
@@ -6187,7 +8524,7 @@ static inline int init_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 		if (ret != 0) {
 			NCCL_OFI_WARN("Failed to init eager_rx_buff_size");
 			nccl_ofi_freelist_fini(ep->ctrl_rx_buff_fl);
-			nccl_ofi_freelist_fini(ep->rx_buff_reqs_fl);
+			nccl_net_ofi_rdma_req_fl_t::fini(ep->rx_buff_reqs_fl);
 			return ret;
 		}
 	} else {
@@ -6204,7 +8541,20 @@ static inline int init_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 			nccl_ofi_freelist_fini(ep->eager_rx_buff_fl);
 		}
 		nccl_ofi_freelist_fini(ep->ctrl_rx_buff_fl);
-		nccl_ofi_freelist_fini(ep->rx_buff_reqs_fl);
+		nccl_net_ofi_rdma_req_fl_t::fini(ep->rx_buff_reqs_fl);
+		return ret;
+	}
+
+	ret = nccl_net_ofi_rdma_rma_batch_fl_t::init(1, 1, 0, NULL, NULL, NULL, NULL, NULL,
+						     &ep->rma_batch_fl);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Failed to init rma_batch_fl");
+		nccl_ofi_freelist_fini(ep->conn_msg_fl);
+		if (ep->eager_rx_buff_fl != NULL) {
+			nccl_ofi_freelist_fini(ep->eager_rx_buff_fl);
+		}
+		nccl_ofi_freelist_fini(ep->ctrl_rx_buff_fl);
+		nccl_net_ofi_rdma_req_fl_t::fini(ep->rx_buff_reqs_fl);
 		return ret;
 	}
 
@@ -6216,12 +8566,6 @@ static inline int init_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 	 */
 	for (int rail_id = 0; rail_id < ep->num_control_rails; ++rail_id) {
 		rail = rdma_endpoint_get_control_rail(ep, rail_id);
-		rail->min_rx_buff_posted = NCCL_OFI_DIV_CEIL(
-			ofi_nccl_rdma_min_posted_bounce_buffers(), ep->num_control_rails
-		);
-		rail->max_rx_buff_posted = NCCL_OFI_DIV_CEIL(
-			ofi_nccl_rdma_max_posted_bounce_buffers(), ep->num_control_rails
-		);
 		rail->num_rx_buff_posted = 0;
 		nccl_net_ofi_mutex_init(&rail->rx_buff_mutex, NULL);
 		rail->rx_buff_req_alloc = ctrl_rx_buff_req_alloc;
@@ -6229,22 +8573,13 @@ static inline int init_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 
 	for (int rail_id = 0; rail_id < ep->num_rails; ++rail_id) {
 		rail = rdma_endpoint_get_rail(ep, rail_id);
-		if (ep->eager_rx_buff_size >= 0) {
-			rail->min_rx_buff_posted = NCCL_OFI_DIV_CEIL(
-				ofi_nccl_rdma_min_posted_bounce_buffers(), ep->num_rails
-				);
-			rail->max_rx_buff_posted = NCCL_OFI_DIV_CEIL(
-				ofi_nccl_rdma_max_posted_bounce_buffers(), ep->num_rails
-				);
-		} else {
-			rail->min_rx_buff_posted = 0;
-			rail->max_rx_buff_posted = 0;
-		}
 		rail->num_rx_buff_posted = 0;
 		nccl_net_ofi_mutex_init(&rail->rx_buff_mutex, NULL);
 		rail->rx_buff_req_alloc = eager_rx_buff_req_alloc;
 	}
 
+	rdma_endpoint_set_rx_buff_bounds(ep);
+
 	return ret;
 }
 
@@ -6276,7 +8611,7 @@ static inline int fini_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 		}
 	}
 
-	ret = nccl_ofi_freelist_fini(ep->rx_buff_reqs_fl);
+	ret = nccl_net_ofi_rdma_req_fl_t::fini(ep->rx_buff_reqs_fl);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Failed to fini rx_buff_reqs_fl");
 		return ret;
@@ -6288,6 +8623,12 @@ static inline int fini_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 		return ret;
 	}
 
+	ret = nccl_net_ofi_rdma_rma_batch_fl_t::fini(ep->rma_batch_fl);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Failed to fini rma_batch_fl");
+		return ret;
+	}
+
 	for (int rail_id = 0; rail_id < ep->num_rails; ++rail_id) {
 		rail = rdma_endpoint_get_rail(ep, rail_id);
 		nccl_net_ofi_mutex_destroy(&rail->rx_buff_mutex);
@@ -6301,28 +8642,58 @@ static inline int fini_rx_buffers(nccl_net_ofi_rdma_ep_t *ep)
 	return ret;
 }
 
+/*
+ * @brief	Return the remote key of a registration for iwrite/iread
+ *
+ * In NCCL_OFI_RDMA_RMA_KEY_PACKED mode, the provider keys of all
+ * rails are packed into the returned key, rail 0 in the least
+ * significant bits. In NCCL_OFI_RDMA_RMA_KEY_TABLE mode, a key handle
+ * is returned, see get_rma_key_handle(). Otherwise the key of rail 0
+ * is returned, which is either valid on all rails or only used on
+ * rail 0.
+ */
 static int get_mr_key(nccl_net_ofi_device_t *base_dev, void *mhandle,
 		      uint64_t *mr_key)
 {
-	int ret = 0;
+	nccl_net_ofi_rdma_device_t *device = (nccl_net_ofi_rdma_device_t *)base_dev;
 	nccl_net_ofi_rdma_mr_handle_t *mr_handle = (nccl_net_ofi_rdma_mr_handle_t *)mhandle;
+	int num_keys = 1;
+	uint64_t packed_key = 0;
 
-	uint64_t key = fi_mr_key(mr_handle->mr[0]);
-	if (OFI_UNLIKELY(key == FI_KEY_NOTAVAIL)) {
-		ret = -ENOENT;
-		NCCL_OFI_WARN("Error retrieving MR key, leaking key");
-	} else {
-		*mr_key = key;
+	if (device->rma_key_mode == NCCL_OFI_RDMA_RMA_KEY_TABLE) {
+		return get_rma_key_handle(device, mr_handle, mr_key);
 	}
 
-	return ret;
+	if (device->rma_key_mode == NCCL_OFI_RDMA_RMA_KEY_PACKED) {
+		num_keys = mr_handle->num_rails;
+	}
+
+	for (int rail_id = 0; rail_id < num_keys; rail_id++) {
+		uint64_t key = fi_mr_key(mr_handle->mr[rail_id]);
+		if (OFI_UNLIKELY(key == FI_KEY_NOTAVAIL)) {
+			NCCL_OFI_WARN("Error retrieving MR key, leaking key");
+			return -ENOENT;
+		}
+		if (num_keys > 1) {
+			if (OFI_UNLIKELY(key >> device->rma_key_bits != 0)) {
+				NCCL_OFI_WARN("MR key 0x%" PRIx64 " of rail %d exceeds %u bits",
+					      key, rail_id, device->rma_key_bits);
+				return -EINVAL;
+			}
+			key <<= rail_id * device->rma_key_bits;
+		}
+		packed_key |= key;
+	}
+
+	*mr_key = packed_key;
+	return 0;
 }
 
 /**
  * @brief	Write using DMA writemsg
  */
-static int rma_write_impl(nccl_net_ofi_send_comm_t *send_comm, void* src, size_t size, void* desc,
-			  uint64_t dest, uint64_t mr_key, uint64_t flags, nccl_net_ofi_req_t ** base_req)
+static int rma_write_impl(nccl_net_ofi_send_comm_t *send_comm, const nccl_ofi_rma_desc_t *descs,
+			  size_t num_descs, uint64_t flags, nccl_net_ofi_req_t ** base_req)
 {
 	int ret = 0;
 	nccl_net_ofi_rdma_send_comm_t *s_comm = (nccl_net_ofi_rdma_send_comm_t *)send_comm;
@@ -6352,7 +8723,15 @@ static int rma_write_impl(nccl_net_ofi_send_comm_t *send_comm, void* src, size_t
 		goto error;
 	}
 
-	ret = alloc_rdma_write_req(s_comm, ep, src, size, desc, dest, mr_key, flags, &req);
+	if (OFI_UNLIKELY(!send_comm_is_connected(s_comm))) {
+		/* Rails to the receiver are not up yet. Poll for the
+		 * connect response and return NULL to NCCL. */
+		ret = ofi_process_cq(ep);
+		*base_req = NULL;
+		goto error;
+	}
+
+	ret = alloc_rdma_write_req(s_comm, ep, descs, num_descs, flags, &req);
 	if (OFI_UNLIKELY(ret != 0)) {
 		goto error;
 	}
@@ -6370,9 +8749,9 @@ static int rma_write_impl(nccl_net_ofi_send_comm_t *send_comm, void* src, size_t
 	ret = send_progress(req);
 	if (ret == -FI_EAGAIN) {
 		/* Add to pending reqs queue */
-		ret = nccl_ofi_deque_insert_back(ep->pending_reqs_queue, &req->pending_reqs_elem);
+		ret = nccl_ofi_mpsc_queue_push(ep->pending_reqs_queue, &req->pending_reqs_elem);
 		if (OFI_UNLIKELY(ret != 0)) {
-			NCCL_OFI_WARN("Failed to nccl_ofi_deque_insert_back: %d", ret);
+			NCCL_OFI_WARN("Failed to nccl_ofi_mpsc_queue_push: %d", ret);
 			goto error;
 		}
 		NCCL_OFI_TRACE_PENDING_INSERT(req);
@@ -6387,8 +8766,16 @@ static int rma_write_impl(nccl_net_ofi_send_comm_t *send_comm, void* src, size_t
 	goto exit;
 
  error:
+	if (req && req_get_rma_op_data(req, req->type)->num_posted_compls > 0) {
+		/* Posted operations still reference the request. Return
+		 * it in error state, test() frees it once they completed. */
+		set_request_state_to_error(req);
+		*base_req = &req->base;
+		ret = 0;
+		goto exit;
+	}
 	if (req)
-		req->free(req, false);
+		req->free(req, true);
 	*base_req = NULL;
  exit:
 	return ret;
@@ -6402,11 +8789,9 @@ static int rma_write_impl(nccl_net_ofi_send_comm_t *send_comm, void* src, size_t
 static int rma_write(nccl_net_ofi_send_comm_t *send_comm, void* src, size_t size, void* mhandle,
 		     uint64_t dest, uint64_t mr_key, nccl_net_ofi_req_t ** base_req)
 {
-	nccl_net_ofi_rdma_mr_handle_t *mr_handle = (nccl_net_ofi_rdma_mr_handle_t *)mhandle;
-	struct fid_mr *rail_mr_handle = mr_handle->mr[0];
-	void *desc = fi_mr_desc(rail_mr_handle);
+	nccl_ofi_rma_desc_t desc = { src, mhandle, dest, mr_key, size };
 	uint64_t flags = 0;
-	return rma_write_impl(send_comm, src, size, desc, dest, mr_key, flags, base_req);
+	return rma_write_impl(send_comm, &desc, 1, flags, base_req);
 }
 
 /**
@@ -6417,9 +8802,21 @@ static int rma_write(nccl_net_ofi_send_comm_t *send_comm, void* src, size_t size
 static int rma_write_inline(nccl_net_ofi_send_comm_t *send_comm, void* src, size_t size,
 			  uint64_t dest, uint64_t mr_key, nccl_net_ofi_req_t ** base_req)
 {
-	void * desc = NULL;
+	nccl_ofi_rma_desc_t desc = { src, NULL, dest, mr_key, size };
 	uint64_t flags = FI_INJECT;
-	return rma_write_impl(send_comm, src, size, desc, dest, mr_key, flags, base_req);
+	return rma_write_impl(send_comm, &desc, 1, flags, base_req);
+}
+
+/**
+ * @brief	Implementation of iwrite batch interface. This "interface function" is called,
+ *       	indirectly, from the application
+ */
+
+static int rma_write_batch(nccl_net_ofi_send_comm_t *send_comm, nccl_ofi_rma_desc_t *descs,
+			   int num_descs, nccl_net_ofi_req_t **base_req)
+{
+	uint64_t flags = 0;
+	return rma_write_impl(send_comm, descs, num_descs, flags, base_req);
 }
 
 /*
@@ -6467,7 +8864,7 @@ static inline int create_send_comm(nccl_net_ofi_conn_handle_t *handle,
 	int dev_id = device->base.dev_id;
 
 	/* Allocate and initialize send_comm */
-	ret_s_comm = calloc_rdma_send_comm(num_rails, num_control_rails);
+	ret_s_comm = calloc_rdma_send_comm(num_rails, num_control_rails, ep->ll_rails != NULL);
 	if (OFI_UNLIKELY(ret_s_comm == NULL)) {
 		NCCL_OFI_WARN("Couldn't allocate send comm object for dev %d", dev_id);
 		return -ENOMEM;
@@ -6479,6 +8876,13 @@ static inline int create_send_comm(nccl_net_ofi_conn_handle_t *handle,
 		return ret;
 	}
 
+	ret = nccl_net_ofi_mutex_init(&ret_s_comm->conn_lock, NULL);
+	if (ret != 0) {
+		nccl_net_ofi_mutex_destroy(&ret_s_comm->ctrl_recv_lock);
+		free_rdma_send_comm(ret_s_comm);
+		return ret;
+	}
+
 	ret_s_comm->base.base.type = NCCL_NET_OFI_SEND_COMM;
 	ret_s_comm->base.base.ep = &ep->base;
 	ret_s_comm->base.base.dev_id = dev_id;
@@ -6488,8 +8892,11 @@ static inline int create_send_comm(nccl_net_ofi_conn_handle_t *handle,
 	ret_s_comm->base.close = send_close_deferred;
 	ret_s_comm->base.write = rma_write;
 	ret_s_comm->base.write_inline = rma_write_inline;
+	ret_s_comm->base.write_batch = rma_write_batch;
 
 	ret_s_comm->comm_active = true;
+	ret_s_comm->connected = false;
+	ret_s_comm->conn_req = NULL;
 	ret_s_comm->next_msg_seq_num = 0;
 	memset(&ret_s_comm->cleanup_list_elem, 0, sizeof(ret_s_comm->cleanup_list_elem));
 
@@ -6542,10 +8949,11 @@ static inline int create_send_comm(nccl_net_ofi_conn_handle_t *handle,
 	ret_s_comm->num_init_control_rails = 1;
 
 	/* Allocate request free list */
-	ret = nccl_ofi_freelist_init(sizeof(nccl_net_ofi_rdma_req_t), 16, 16,
-				     NCCL_OFI_MAX_SEND_REQUESTS,
-				     rdma_fl_req_entry_init, rdma_fl_req_entry_fini,
-				     &ret_s_comm->nccl_ofi_reqs_fl);
+	ret = nccl_net_ofi_rdma_req_fl_t::init(16, 16,
+					       NCCL_OFI_MAX_SEND_REQUESTS,
+					       rdma_fl_req_entry_init, rdma_fl_req_entry_fini,
+					       NULL, NULL, NULL,
+					       &ret_s_comm->nccl_ofi_reqs_fl);
 	if (OFI_UNLIKELY(ret != 0)) {
 		NCCL_OFI_WARN("Could not allocate NCCL OFI request free list for dev %d rail %d",
 			      dev_id, rail_id);
@@ -6591,6 +8999,7 @@ static inline int create_send_comm(nccl_net_ofi_conn_handle_t *handle,
 			}
 		}
 		nccl_net_ofi_mutex_destroy(&ret_s_comm->ctrl_recv_lock);
+		nccl_net_ofi_mutex_destroy(&ret_s_comm->conn_lock);
 		free_rdma_send_comm(ret_s_comm);
 	}
 
@@ -6681,7 +9090,9 @@ static int post_send_conn(nccl_net_ofi_rdma_send_comm_t *s_comm,
 	rc = fi_send(comm_rail->local_ep, (void *)s_comm->conn_msg->ptr, sizeof(nccl_ofi_rdma_connection_info_t), desc,
 		     comm_rail->remote_addr, (void *)&req->ctx[rail_id]);
 
-	if (rc == -FI_EAGAIN) {
+	if (rc == 0) {
+		rdma_req_cq_op_posted(req, rail_id);
+	} else if (rc == -FI_EAGAIN) {
 		/*
 		 * Process completions so that you have enough
 		 * resources for sending connect message
@@ -6704,19 +9115,20 @@ static int post_send_conn(nccl_net_ofi_rdma_send_comm_t *s_comm,
  * The connect functionality does the following: (a) create send communicator
  * with only the first communicator rail being initalized, (b) post send
  * operation to send connect message to remote, containing local endpoint
- * addresses, (c) wait until message is delivered, (d) waits for the connect
- * response message, and (e) calls finish_connect.
+ * addresses, (c) wait until message is delivered, and (d) waits for the
+ * connect response message. With RDMA_ZERO_RTT_CONNECT, the communicator
+ * is returned right after (b), and sends issued before the response
+ * arrives wait in the message buffer.
  *
- * The `finish_connect' method completes the initialization of the remaining
- * communicator rails using the received connect responce message.
+ * The `finish_connect' method, called by the completion handler of the
+ * connect response message, completes the initialization of the remaining
+ * communicator rails and posts the waiting sends.
  */
 static int connect(nccl_net_ofi_ep_t *base_ep,
 			    nccl_net_ofi_conn_handle_t *handle,
 			    nccl_net_ofi_send_comm_t **send_comm)
 {
 	int ret = 0;
-	nccl_net_ofi_rdma_req_state_t conn_resp_req_state;
-	nccl_net_ofi_rdma_req_state_t conn_msg_state;
 	*send_comm = NULL;
 	nccl_net_ofi_rdma_ep_t *ep =
 		(nccl_net_ofi_rdma_ep_t *)base_ep;
@@ -6801,12 +9213,22 @@ static int connect(nccl_net_ofi_ep_t *base_ep,
 			return ret;
 		}
 
+		/* The communicator releases the request once the
+		 * connect message is sent */
+		s_comm->conn_req = req;
+		comm_state->req = NULL;
+		req = NULL;
+
 		comm_state->stage = COMM_CONN_REQ_PENDING;
 		fallthrough;
 	case COMM_CONN_REQ_PENDING:
 		/* COMM_CONN_REQ_PENDING: Wait until connect message
-		 * has been sent. Afterwards, reset previously used
-		 * request. */
+		 * has been sent, unless the communicator is returned
+		 * before the handshake completes. */
+		if (ofi_nccl_rdma_zero_rtt_connect() != 0) {
+			comm_state->stage = COMM_CONNECTED;
+			break;
+		}
 
 		/* Progress our engine to get completions */
 		ret = ofi_process_cq(ep);
@@ -6817,21 +9239,12 @@ static int connect(nccl_net_ofi_ep_t *base_ep,
 			return ret;
 		}
 
-		/* Check if the connect message is sent */
-		nccl_net_ofi_mutex_lock(&req->req_lock);
-		conn_msg_state = req->state;
-		nccl_net_ofi_mutex_unlock(&req->req_lock);
-
 		/* Wait until connect message is sent */
-		if (conn_msg_state != NCCL_OFI_RDMA_REQ_COMPLETED) {
+		send_comm_release_conn_req(s_comm);
+		if (s_comm->conn_req != NULL) {
 			return 0;
 		}
 
-		/* Release connect message request */
-		req->free(req, false);
-		comm_state->req = NULL;
-		req = NULL;
-
 		comm_state->stage = COMM_RECV_CONN;
 		fallthrough;
 	case COMM_RECV_CONN:
@@ -6851,20 +9264,11 @@ static int connect(nccl_net_ofi_ep_t *base_ep,
 			return ret;
 		}
 
-		nccl_net_ofi_mutex_lock(&s_comm->conn_resp_req->req_lock);
-		conn_resp_req_state = s_comm->conn_resp_req->state;
-		nccl_net_ofi_mutex_unlock(&s_comm->conn_resp_req->req_lock);
-
 		/* Wait until conn resp message is received */
-		if (conn_resp_req_state != NCCL_OFI_RDMA_REQ_COMPLETED) {
+		if (!send_comm_is_connected(s_comm)) {
 			return 0;
 		}
 
-		ret = finish_connect(s_comm);
-		if (OFI_UNLIKELY(ret != 0)) {
-			return ret;
-		}
-
 		comm_state->stage = COMM_CONNECTED;
 
 		break;
@@ -6899,6 +9303,12 @@ static void ep_rail_release(nccl_net_ofi_ep_rail_t *rail, int dev_id, struct fid
 	rail->ofi_ep = NULL;
 	rail->av = NULL;
 	rail->cq = NULL;
+
+	/* Counter must outlive the endpoint it is bound to */
+	if (rail->write_cntr != NULL) {
+		fi_close(&rail->write_cntr->fid);
+		rail->write_cntr = NULL;
+	}
 }
 
 
@@ -6914,6 +9324,12 @@ static void release_rdma_ep_resources(nccl_net_ofi_rdma_ep_t *ep, int dev_id)
 		ep_rail_release(rail, dev_id, NULL);
 	}
 
+	if (ep->ll_rails != NULL) {
+		for (int rail_id = 0; rail_id != ep->num_rails; ++rail_id) {
+			ep_rail_release(&ep->ll_rails[rail_id], dev_id, NULL);
+		}
+	}
+
 	for (int rail_id = 0; rail_id != ep->num_rails; ++rail_id) {
 		rail = rdma_endpoint_get_rail(ep, rail_id);
 		ep_rail_release(rail, dev_id, rail->cq);
@@ -6958,10 +9374,12 @@ static int ep_rail_init(nccl_net_ofi_rdma_ep_t *ep,
 			nccl_net_ofi_rdma_device_rail_t *dev_rail,
 			nccl_net_ofi_rdma_domain_rail_t *domain_rail,
 			nccl_net_ofi_ep_rail_t *ep_rail,
-			uint32_t tclass)
+			uint32_t tclass,
+			bool use_write_cntr)
 {
 	int ret = 0;
 	struct fi_info *rail_info = dev_rail->info;
+	bool dup_info = (tclass != FI_TC_UNSPEC) || use_write_cntr;
 
 	if (ep_rail->cq == NULL) {
 		/* cq will be NULL most of the time, but there's a
@@ -6982,25 +9400,60 @@ static int ep_rail_init(nccl_net_ofi_rdma_ep_t *ep,
 	}
 #endif
 
-	if (tclass != FI_TC_UNSPEC) {
+	if (dup_info) {
 		rail_info = fi_dupinfo(rail_info);
 		if (rail_info == NULL) {
 			NCCL_OFI_WARN("Could not allocate new fi_info struct");
 			return -ENOMEM;
 		}
 
-		rail_info->tx_attr->tclass = tclass;
+		if (tclass != FI_TC_UNSPEC) {
+			rail_info->tx_attr->tclass = tclass;
+		}
+		if (use_write_cntr) {
+			/* Transmit operations keep generating completion
+			 * entries unless posted without FI_COMPLETION */
+			rail_info->tx_attr->op_flags |= FI_COMPLETION;
+		}
+	}
+
+	ep_rail->write_cntr = NULL;
+	ep_rail->write_cntr_posted = 0;
+	ep_rail->write_cntr_drained = 0;
+	ep_rail->write_cntr_errors = 0;
+	ep_rail->write_cntr_good = 0;
+	ep_rail->write_cntr_bad = 0;
+	ep_rail->write_cntr_failed = false;
+	if (use_write_cntr) {
+		struct fi_cntr_attr cntr_attr = {};
+		cntr_attr.events = FI_CNTR_EVENTS_COMP;
+
+		ret = fi_cntr_open(domain_rail->domain, &cntr_attr, &ep_rail->write_cntr, NULL);
+		if (ret != 0) {
+			NCCL_OFI_WARN("Couldn't open write counter. RC: %d, ERROR: %s",
+				      ret, fi_strerror(-ret));
+			ep_rail->write_cntr = NULL;
+			if (dup_info) {
+				fi_freeinfo(rail_info);
+			}
+			return ret;
+		}
 	}
 
 	ret = nccl_ofi_ofiutils_init_connection(rail_info,
 						domain_rail->domain,
 						&ep_rail->ofi_ep,
 						&ep_rail->av,
-						&ep_rail->cq);
-	if (tclass != FI_TC_UNSPEC) {
+						&ep_rail->cq,
+						ep_rail->write_cntr);
+	if (dup_info) {
 		fi_freeinfo(rail_info);
 	}
 	if (ret != 0) {
+		if (ep_rail->write_cntr != NULL) {
+			fi_close(&ep_rail->write_cntr->fid);
+			ep_rail->write_cntr = NULL;
+		}
 		return ret;
 	}
 
@@ -7037,7 +9490,8 @@ static int init_rail_ofi_resources(nccl_net_ofi_rdma_device_t *device,
 		domain_rail = rdma_domain_get_rail(domain, rail_id);
 		rail = rdma_endpoint_get_rail(ep, rail_id);
 
-		ret = ep_rail_init(ep, dev_id, rail_id, rail_dev, domain_rail, rail, FI_TC_UNSPEC);
+		ret = ep_rail_init(ep, dev_id, rail_id, rail_dev, domain_rail, rail, FI_TC_UNSPEC,
+				   ep->use_write_cntr);
 		if (ret != 0) {
 			NCCL_OFI_WARN("Initializing rail %d failed", rail_id);
 			goto exit;
@@ -7052,13 +9506,28 @@ static int init_rail_ofi_resources(nccl_net_ofi_rdma_device_t *device,
 		control_rail = rdma_endpoint_get_control_rail(ep, rail_id);
 
 		control_rail->cq = rail->cq;
-		ret = ep_rail_init(ep, dev_id, rail_id, rail_dev, domain_rail, control_rail, tc);
+		ret = ep_rail_init(ep, dev_id, rail_id, rail_dev, domain_rail, control_rail, tc, false);
 		if (ret != 0) {
 			NCCL_OFI_WARN("Initializing control rail %d failed", rail_id);
 			goto exit;
 		}
 	}
 
+	/* Initialize libfabric resources of endpoint low-latency data rails */
+	for (int rail_id = 0; ep->ll_rails != NULL && rail_id != ep->num_rails; ++rail_id) {
+		rail_dev = rdma_device_get_rail(device, rail_id);
+		domain_rail = rdma_domain_get_rail(domain, rail_id);
+		rail = rdma_endpoint_get_rail(ep, rail_id);
+
+		ep->ll_rails[rail_id].cq = rail->cq;
+		ret = ep_rail_init(ep, dev_id, rail_id, rail_dev, domain_rail, &ep->ll_rails[rail_id],
+				   FI_TC_LOW_LATENCY, false);
+		if (ret != 0) {
+			NCCL_OFI_WARN("Initializing low-latency data rail %d failed", rail_id);
+			goto exit;
+		}
+	}
+
  exit:
 	if (ret != 0) {
 		release_rdma_ep_resources(ep, dev_id);
@@ -7152,12 +9621,13 @@ static int nccl_net_ofi_rdma_endpoint_free(nccl_net_ofi_ep_t *base_ep)
 		return ret;
 	}
 
-	ret = nccl_ofi_deque_finalize(ep->pending_reqs_queue);
+	ret = nccl_ofi_mpsc_queue_finalize(ep->pending_reqs_queue);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Failed to finalize pending_reqs_queue: %d", ret);
 		return ret;
 	}
 
+	free(ep->ll_rails);
 	free(ep->control_rails);
 	free(ep->rails);
 	free(ep);
@@ -7242,6 +9712,21 @@ static int nccl_net_ofi_rdma_domain_create_endpoint(nccl_net_ofi_domain_t *base_
 	}
 
 	ep->use_long_rkeys = device->use_long_rkeys;
+	ep->fast_path = select_fast_path(ep->num_rails, ep->use_long_rkeys);
+	ep->ctrl_msg_size = nccl_net_ofi_rdma_ctrl_msg_size(ep->num_rails, ep->use_long_rkeys);
+	ep->use_write_cntr = (ofi_nccl_rdma_write_cntr() != 0);
+	ep->write_cntr_fence_interval = std::max<uint64_t>(ofi_nccl_rdma_write_cntr_fence_interval(), 1);
+	ep->stripe_retry_max = ep->use_write_cntr ? 0 :
+		(unsigned int)std::min(ofi_nccl_stripe_retry_max(), (uint64_t)UINT16_MAX);
+	ep->stripe_retry_backoff_ns = ofi_nccl_stripe_retry_backoff_us() * 1000;
+#ifndef NDEBUG
+	ep->inject_stripe_errors = ep->stripe_retry_max > 0 ? ofi_nccl_inject_stripe_errors() : 0;
+	ep->num_send_stripes = 0;
+#endif
+	ep->idle_cq_poll_interval = ofi_nccl_rdma_idle_cq_poll_interval();
+	ep->num_cq_polls = 0;
+	ep->num_recvs_inflight = 0;
+	ep->num_sends_inflight = 0;
 
 	ep->rails = (nccl_net_ofi_ep_rail_t *)calloc(ep->num_rails,
 		sizeof(nccl_net_ofi_ep_rail_t));
@@ -7258,7 +9743,23 @@ static int nccl_net_ofi_rdma_domain_create_endpoint(nccl_net_ofi_domain_t *base_
 		goto error;
 	}
 
-	ret = nccl_ofi_deque_init(&ep->pending_reqs_queue);
+	ep->ll_data_max_size = ofi_nccl_low_lat_data_max_size();
+	if (ep->ll_data_max_size > 0 && ep->use_write_cntr) {
+		/* Writes must complete through the data rail counters */
+		NCCL_OFI_INFO(NCCL_INIT | NCCL_NET,
+			      "Low-latency data endpoints are not supported with write counters, disabling them");
+		ep->ll_data_max_size = 0;
+	}
+	if (ep->ll_data_max_size > 0) {
+		ep->ll_rails = (nccl_net_ofi_ep_rail_t *)calloc(ep->num_rails, sizeof(nccl_net_ofi_ep_rail_t));
+		if (!ep->ll_rails) {
+			NCCL_OFI_WARN("Unable to allocate rdma low-latency data rails");
+			ret = -ENOMEM;
+			goto error;
+		}
+	}
+
+	ret = nccl_ofi_mpsc_queue_init(&ep->pending_reqs_queue);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Failed to init pending_reqs_queue: %d", ret);
 		goto error;
@@ -7274,6 +9775,20 @@ static int nccl_net_ofi_rdma_domain_create_endpoint(nccl_net_ofi_domain_t *base_
 	ep->eager_rx_buff_size = (ep->eager_send_size == 0) ?
 		EAGER_RX_BUFFER_ALIGNMENT : ep->eager_send_size;
 
+	/* Eager messages may be posted on any rail */
+	ep->eager_inject_size = 0;
+	if (ofi_nccl_eager_inject() != 0) {
+		ep->eager_inject_size = SIZE_MAX;
+		for (int rail_id = 0; rail_id != device->num_rails; ++rail_id) {
+			ep->eager_inject_size = std::min(ep->eager_inject_size,
+							 device->device_rails[rail_id].info->tx_attr->inject_size);
+		}
+	}
+
+	ep->cq_read_count = (size_t)std::clamp(ofi_nccl_cq_read_count(), (int64_t)1,
+					       (int64_t)NCCL_OFI_RDMA_MAX_CQ_READ_COUNT);
+	ep->param_epoch = nccl_ofi_param_get_epoch();
+
 	ep->is_endpoint_per_communicator_ep = false;
 
 	ret = init_rail_ofi_resources(device, domain, ep);
@@ -7324,6 +9839,15 @@ nccl_net_ofi_rdma_domain_free(nccl_net_ofi_domain_t *base_domain)
 		return ret;
 	}
 
+	if (domain->rma_key_table_mr != NULL) {
+		ret = dereg_mr(domain->rma_key_table_mr, domain);
+		if (ret != 0) {
+			NCCL_OFI_WARN("Failed to deregister RMA key table");
+			return ret;
+		}
+		domain->rma_key_table_mr = NULL;
+	}
+
 	for (int i = 0 ; i < domain->num_rails ; ++i) {
 		if (domain->domain_rails[i].cq != NULL) {
 			fi_close(&domain->domain_rails[i].cq->fid);
@@ -7431,6 +9955,17 @@ static nccl_net_ofi_domain_t *nccl_net_ofi_rdma_device_create_domain(nccl_net_of
 		goto error;
 	}
 
+	/* Peers read the RMA key table through this domain */
+	if (device->rma_key_table != NULL) {
+		ret = reg_internal_mr(domain, device->rma_key_table, rma_key_table_size(),
+				      NCCL_PTR_HOST, &domain->rma_key_table_mr);
+		if (OFI_UNLIKELY(ret != 0)) {
+			NCCL_OFI_WARN("Could not register RMA key table, dev: %d",
+				      device->base.dev_id);
+			goto error;
+		}
+	}
+
 error:
 	if (ret != 0) {
 		domain->base.release(&(domain->base), false, false);
@@ -7561,6 +10096,72 @@ error:
 	return NULL;
 }
 
+/*
+ * @brief	Allocate the RMA key table of a device
+ *
+ * The table is registered in each domain of the device, see
+ * nccl_net_ofi_rdma_device_create_domain().
+ */
+static int alloc_rma_key_table(nccl_net_ofi_rdma_device_t *device)
+{
+	int ret;
+
+	ret = nccl_net_ofi_mutex_init(&device->rma_key_lock, NULL);
+	if (OFI_UNLIKELY(ret != 0)) {
+		NCCL_OFI_WARN("Unable to initialize RMA key table mutex");
+		return -ret;
+	}
+
+	ret = nccl_net_ofi_alloc_mr_buffer(rma_key_table_size(), (void **)&device->rma_key_table);
+	if (OFI_UNLIKELY(ret != 0)) {
+		NCCL_OFI_WARN("Unable to allocate RMA key table (%d)", ret);
+		nccl_net_ofi_mutex_destroy(&device->rma_key_lock);
+		device->rma_key_table = NULL;
+		return ret;
+	}
+
+	/* From here on, free_rma_key_table() cleans up */
+	device->rma_key_gen = (uint16_t *)calloc(NCCL_OFI_RDMA_RMA_KEY_TABLE_SIZE, sizeof(uint16_t));
+	if (OFI_UNLIKELY(device->rma_key_gen == NULL)) {
+		NCCL_OFI_WARN("Unable to allocate RMA key table generations");
+		return -ENOMEM;
+	}
+
+	return nccl_ofi_idpool_init(&device->rma_key_pool, NCCL_OFI_RDMA_RMA_KEY_TABLE_SIZE);
+}
+
+/*
+ * @brief	Free the RMA key table of a device, if any
+ */
+static int free_rma_key_table(nccl_net_ofi_rdma_device_t *device)
+{
+	int ret = 0;
+
+	if (device->rma_key_table == NULL) {
+		return 0;
+	}
+
+	if (nccl_ofi_idpool_active(&device->rma_key_pool)) {
+		ret = nccl_ofi_idpool_fini(&device->rma_key_pool);
+		if (ret != 0) {
+			NCCL_OFI_WARN("Failed to free RMA key table idpool");
+		}
+	}
+	free(device->rma_key_gen);
+	device->rma_key_gen = NULL;
+
+	int rc = nccl_net_ofi_dealloc_mr_buffer(device->rma_key_table, rma_key_table_size());
+	if (rc != 0) {
+		NCCL_OFI_WARN("Unable to deallocate RMA key table (%d)", rc);
+		ret = (ret != 0) ? ret : rc;
+	}
+	device->rma_key_table = NULL;
+
+	nccl_net_ofi_mutex_destroy(&device->rma_key_lock);
+
+	return ret;
+}
+
 /**
  * Destroy an rdma device object
  */
@@ -7618,6 +10219,11 @@ nccl_net_ofi_rdma_device_release(nccl_net_ofi_device_t *base_device)
 		device->comm_idpool = NULL;
 	}
 
+	ret = free_rma_key_table(device);
+	if (ret != 0 && first_error == 0) {
+		first_error = ret;
+	}
+
 	ret = nccl_net_ofi_device_fini(base_device);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Cleanup of device failed, device_fini returned %s",
@@ -7635,12 +10241,19 @@ nccl_net_ofi_rdma_device_release(nccl_net_ofi_device_t *base_device)
 
 /**
  * Create an rdma device object
+ *
+ * @param	num_nics
+ *		Number of NICs in info_list
+ * @param	target_length
+ *		Number of rails to force (see OFI_NCCL_FORCE_NUM_RAILS),
+ *		0 for one rail per entry of info_list
  */
 static nccl_net_ofi_rdma_device_t *nccl_net_ofi_rdma_device_create(
-	nccl_net_ofi_plugin_t *plugin, int dev_id, struct fi_info *info_list, nccl_ofi_topo_t *topo, size_t min_strip_size)
+	nccl_net_ofi_plugin_t *plugin, int dev_id, struct fi_info *info_list, int num_nics,
+	int target_length, size_t min_strip_size)
 {
 	int ret = 0;
-	int length = 0, target_length;
+	int length = 0;
 	nccl_net_ofi_rdma_device_t *device =
 		(nccl_net_ofi_rdma_device_t *)calloc(1, sizeof(nccl_net_ofi_rdma_device_t));
 	if (device == NULL) {
@@ -7663,13 +10276,8 @@ static nccl_net_ofi_rdma_device_t *nccl_net_ofi_rdma_device_create(
 	/* at this point, we can safely call the destructor to clean
 	 * up */
 
-	/* Ensure that number of rails are the same across devices */
 	length = ofi_info_list_length(info_list);
-	if (topo->max_group_size != length) {
-		NCCL_OFI_WARN("Wrong number of NICs for device %i. Expected %i but got %i",
-			      dev_id, topo->max_group_size, length);
-		goto error;
-	}
+	device->num_nics = num_nics;
 
 	/* allow the user to force the number of rails used by the
 	 * device.  If the target number is smaller than the number of
@@ -7683,7 +10291,6 @@ static nccl_net_ofi_rdma_device_t *nccl_net_ofi_rdma_device_create(
 	 * between NICs, rather than sending target_length/length
 	 * messages on the same NIC before moving to the next NIC.
 	 */
-	target_length = ofi_nccl_force_num_rails();
 	if (target_length != 0) {
 		int original_length = length;
 		if (length > target_length) {
@@ -7746,6 +10353,30 @@ static nccl_net_ofi_rdma_device_t *nccl_net_ofi_rdma_device_create(
 		device->use_long_rkeys = true;
 	}
 
+	/* One-sided RMA operations are striped across rails only if the
+	 * single key handed out by get_mr_key() is valid on all of them,
+	 * or refers to the per-rail keys of an RMA key table entry */
+	if (device->base.need_mr_rkey_pool || length == 1) {
+		device->rma_key_mode = NCCL_OFI_RDMA_RMA_KEY_SHARED;
+	} else if (info_list->domain_attr->mr_key_size > 0 &&
+		   length * info_list->domain_attr->mr_key_size <= sizeof(uint64_t)) {
+		device->rma_key_mode = NCCL_OFI_RDMA_RMA_KEY_PACKED;
+		device->rma_key_bits = info_list->domain_attr->mr_key_size * 8;
+	} else if (info_list->domain_attr->mr_key_size > 0 &&
+		   info_list->domain_attr->mr_key_size <= sizeof(uint32_t)) {
+		ret = alloc_rma_key_table(device);
+		if (ret != 0) {
+			goto error;
+		}
+		device->rma_key_mode = NCCL_OFI_RDMA_RMA_KEY_TABLE;
+		NCCL_OFI_INFO(NCCL_NET, "MR keys of %d rails do not fit into one RMA key, "
+			      "one-sided operations will use an RMA key table", length);
+	} else {
+		device->rma_key_mode = NCCL_OFI_RDMA_RMA_KEY_SINGLE_RAIL;
+		NCCL_OFI_INFO(NCCL_NET, "MR keys of %d rails do not fit into one RMA key, "
+			      "one-sided operations will use a single rail", length);
+	}
+
 	device->num_comm_ids = (uint32_t)NCCL_OFI_RDMA_MAX_COMMS;
 
 	/* Initialize libfabric resources of rdma device */
@@ -7902,11 +10533,20 @@ static inline int nccl_net_ofi_rdma_plugin_complete_init(nccl_net_ofi_plugin_t *
 			return -EINVAL;
 		}
 
+		/* Ensure that number of rails are the same across devices */
+		int length = ofi_info_list_length(info_list);
+		if (rdma_plugin->topo->max_group_size != length) {
+			NCCL_OFI_WARN("Wrong number of NICs for device %zu. Expected %i but got %i",
+				      dev_id, rdma_plugin->topo->max_group_size, length);
+			return -EINVAL;
+		}
+
 		/* Allocate device */
 		nccl_net_ofi_rdma_device_t *device = nccl_net_ofi_rdma_device_create(&rdma_plugin->base,
 		                                                                     (int)dev_id,
 		                                                                     info_list,
-		                                                                     rdma_plugin->topo,
+		                                                                     length,
+		                                                                     ofi_nccl_force_num_rails(),
 		                                                                     ofi_nccl_min_stripe_size());
 		if (device == NULL) {
 			NCCL_OFI_WARN("Device creation failed");
@@ -7924,6 +10564,116 @@ static inline int nccl_net_ofi_rdma_plugin_complete_init(nccl_net_ofi_plugin_t *
 }
 
 
+/*
+ * @brief	Create a device whose rails are the rails of all member
+ *		devices
+ *
+ * Members must be physical devices of the same provider, and the fused
+ * device may not exceed MAX_NUM_RAILS rails. The rails are not forced,
+ * as the members already applied OFI_NCCL_FORCE_NUM_RAILS.
+ */
+static int nccl_net_ofi_rdma_plugin_make_virtual_device(nccl_net_ofi_plugin_t *plugin,
+							const int *dev_ids, int num_devs,
+							int *dev_id)
+{
+	nccl_net_ofi_rdma_device_t *members[NCCL_OFI_MAX_DEVS_PER_VDEV];
+	nccl_net_ofi_rdma_device_t *device = NULL;
+	struct fi_info *info_list = NULL;
+	struct fi_info **tail = &info_list;
+	int num_rails = 0, num_nics = 0;
+	int new_id = (int)plugin->get_num_devices(plugin);
+	int ret = 0;
+
+	if (num_devs <= 0 || num_devs > NCCL_OFI_MAX_DEVS_PER_VDEV) {
+		NCCL_OFI_WARN("Invalid number of member devices %d", num_devs);
+		return -EINVAL;
+	}
+
+	for (int i = 0; i < num_devs; i++) {
+		if (dev_ids[i] < 0 || dev_ids[i] >= new_id) {
+			NCCL_OFI_WARN("Invalid member device %d", dev_ids[i]);
+			return -EINVAL;
+		}
+		for (int j = 0; j < i; j++) {
+			if (dev_ids[j] == dev_ids[i]) {
+				NCCL_OFI_WARN("Device %d is fused twice", dev_ids[i]);
+				return -EINVAL;
+			}
+		}
+
+		members[i] = (nccl_net_ofi_rdma_device_t *)plugin->get_device(plugin, dev_ids[i]);
+		if (members[i] == NULL) {
+			NCCL_OFI_WARN("Invalid member device %d", dev_ids[i]);
+			return -EINVAL;
+		}
+		if (members[i]->base.num_member_devs > 0) {
+			NCCL_OFI_WARN("Device %d is a virtual device and cannot be fused",
+				      dev_ids[i]);
+			return -EINVAL;
+		}
+		if (strcmp(members[i]->base.name, members[0]->base.name) != 0) {
+			NCCL_OFI_WARN("Unable to fuse devices of providers %s and %s",
+				      members[0]->base.name, members[i]->base.name);
+			return -EINVAL;
+		}
+
+		num_rails += members[i]->num_rails;
+		num_nics += members[i]->num_nics;
+	}
+
+	if (num_rails > MAX_NUM_RAILS) {
+		NCCL_OFI_WARN("Virtual device would have %d rails, more than the maximum of %d",
+			      num_rails, MAX_NUM_RAILS);
+		return -EINVAL;
+	}
+
+	/* Chain copies of the member rails, the NIC info list the device
+	 * is created from */
+	for (int i = 0; i < num_devs; i++) {
+		for (int r = 0; r < members[i]->num_rails; r++) {
+			*tail = fi_dupinfo(members[i]->device_rails[r].info);
+			if (*tail == NULL) {
+				NCCL_OFI_WARN("Unable to duplicate NIC info of device %d", dev_ids[i]);
+				ret = -ENOMEM;
+				goto exit;
+			}
+			(*tail)->next = NULL;
+			tail = &(*tail)->next;
+		}
+	}
+
+	device = nccl_net_ofi_rdma_device_create(plugin, new_id, info_list, num_nics, 0,
+						 ofi_nccl_min_stripe_size());
+	if (device == NULL) {
+		NCCL_OFI_WARN("Virtual device creation failed");
+		ret = -ENOMEM;
+		goto exit;
+	}
+
+	device->base.num_member_devs = num_devs;
+	for (int i = 0; i < num_devs; i++) {
+		device->base.member_devs[i] = dev_ids[i];
+	}
+
+	ret = plugin->assign_device(plugin, new_id, &device->base);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Assigning virtual device %d failed", new_id);
+		device->base.release(&device->base);
+		goto exit;
+	}
+
+	NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "Created virtual device %d of %d devices with %d rails",
+		      new_id, num_devs, num_rails);
+	*dev_id = new_id;
+
+ exit:
+	if (info_list != NULL) {
+		fi_freeinfo(info_list);
+	}
+	return ret;
+}
+
+
 static inline int nccl_net_ofi_rdma_plugin_create(size_t num_devices,
 						  nccl_ofi_topo_t *topo,
 						  nccl_net_ofi_rdma_plugin_t **plugin_p)
@@ -7961,6 +10711,7 @@ static inline int nccl_net_ofi_rdma_plugin_create(size_t num_devices,
 
 	plugin->base.release_plugin = nccl_net_ofi_rdma_plugin_fini;
 	plugin->base.complete_init = nccl_net_ofi_rdma_plugin_complete_init;
+	plugin->base.make_virtual_device = nccl_net_ofi_rdma_plugin_make_virtual_device;
 
 	*plugin_p = plugin;
 
@@ -7975,6 +10726,27 @@ error:
 }
 
 
+int nccl_net_ofi_rdma_send(nccl_net_ofi_send_comm_t *send_comm, void *data, int size, int tag,
+			   nccl_net_ofi_mr_handle_t *mhandle, nccl_net_ofi_req_t **base_req)
+{
+	return send(send_comm, data, size, tag, mhandle, base_req);
+}
+
+
+int nccl_net_ofi_rdma_recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
+			   int *sizes, int *tags, nccl_net_ofi_mr_handle_t **mhandles,
+			   nccl_net_ofi_req_t **base_req)
+{
+	return recv(recv_comm, n, buffers, sizes, tags, mhandles, base_req);
+}
+
+
+int nccl_net_ofi_rdma_req_test(nccl_net_ofi_req_t *base_req, int *done, int *size)
+{
+	return test(base_req, done, size);
+}
+
+
 int nccl_net_ofi_rdma_init(const char *provider_filter,
 			   nccl_net_ofi_plugin_t **plugin_p,
 			   bool *found_multiple_rails)
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include "nccl_ofi_log.h"
+#include "nccl_ofi_reduce.h"
+
+/*
+ * Kernels are compiled once per SIMD extension and the loader picks
+ * the best clone for the CPU. Other architectures rely on the
+ * vectorizer for their baseline extension.
+ */
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define REDUCE_TARGETS __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef REDUCE_TARGETS
+#define REDUCE_TARGETS
+#endif
+
+typedef void (*reduce_fn_t)(void *dst, const void *src, size_t count);
+
+/*
+ * Operators. Sums and products of signed integers are computed on the
+ * unsigned type, so that they wrap around instead of overflowing.
+ */
+template <typename T>
+using arith_t = typename std::conditional<std::is_integral<T>::value,
+					  std::make_unsigned<T>, std::common_type<T>>::type::type;
+
+struct op_sum {
+	template <typename T> static inline T apply(T a, T b)
+	{
+		return (T)((arith_t<T>)a + (arith_t<T>)b);
+	}
+};
+
+struct op_prod {
+	template <typename T> static inline T apply(T a, T b)
+	{
+		return (T)((arith_t<T>)a * (arith_t<T>)b);
+	}
+};
+
+struct op_max {
+	template <typename T> static inline T apply(T a, T b)
+	{
+		return (a > b) ? a : b;
+	}
+};
+
+struct op_min {
+	template <typename T> static inline T apply(T a, T b)
+	{
+		return (a < b) ? a : b;
+	}
+};
+
+static inline float bits_to_float(uint32_t bits)
+{
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+static inline uint32_t float_to_bits(float f)
+{
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+
+/*
+ * Conversions of 16-bit floating point types. Written without
+ * F16C/BF16 instructions, so that they vectorize with every
+ * extension.
+ */
+struct conv_bf16 {
+	static inline float to_float(uint16_t h)
+	{
+		return bits_to_float((uint32_t)h << 16);
+	}
+
+	static inline uint16_t from_float(float f)
+	{
+		uint32_t bits = float_to_bits(f);
+
+		/* Quiet NaNs instead of rounding them to infinity */
+		if ((bits & 0x7fffffff) > 0x7f800000) {
+			return (uint16_t)((bits >> 16) | 0x40);
+		}
+		/* Round to nearest even */
+		bits += 0x7fff + ((bits >> 16) & 1);
+		return (uint16_t)(bits >> 16);
+	}
+};
+
+struct conv_fp16 {
+	static inline float to_float(uint16_t h)
+	{
+		uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+		uint32_t exp = (h >> 10) & 0x1f;
+		uint32_t mant = h & 0x3ff;
+
+		if (exp == 0x1f) {
+			/* Infinity or NaN */
+			return bits_to_float(sign | 0x7f800000 | (mant << 13));
+		} else if (exp != 0) {
+			/* Normal, rebias exponent from 15 to 127 */
+			return bits_to_float(sign | ((exp + 112) << 23) | (mant << 13));
+		}
+		/* Zero or subnormal, mant * 2^-24 */
+		return bits_to_float(sign | float_to_bits((float)mant * 0x1p-24f));
+	}
+
+	static inline uint16_t from_float(float f)
+	{
+		uint32_t bits = float_to_bits(f);
+		uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+		uint32_t abs = bits & 0x7fffffff;
+
+		if (abs > 0x7f800000) {
+			/* NaN */
+			return sign | 0x7e00;
+		} else if (abs >= 0x477ff000) {
+			/* Rounds to a value above 65504 */
+			return sign | 0x7c00;
+		} else if (abs < 0x38800000) {
+			/* Subnormal result. Adding 0.5 aligns the mantissa
+			 * so that the FPU rounds to nearest even. */
+			uint32_t r = float_to_bits(bits_to_float(abs) + 0.5f);
+			return sign | (uint16_t)(r - 0x3f000000);
+		}
+		/* Normal, rebias exponent from 127 to 15 and round to
+		 * nearest even */
+		abs += 0xc8000fff + ((abs >> 13) & 1);
+		return sign | (uint16_t)(abs >> 13);
+	}
+};
+
+template <typename T, typename Op>
+static inline void reduce_native(void *dst, const void *src, size_t count)
+{
+	T *__restrict d = (T *)dst;
+	const T *__restrict s = (const T *)src;
+
+	for (size_t i = 0; i < count; i++) {
+		d[i] = Op::apply(d[i], s[i]);
+	}
+}
+
+template <typename Conv, typename Op>
+static inline void reduce_half(void *dst, const void *src, size_t count)
+{
+	uint16_t *__restrict d = (uint16_t *)dst;
+	const uint16_t *__restrict s = (const uint16_t *)src;
+
+	for (size_t i = 0; i < count; i++) {
+		d[i] = Conv::from_float(Op::apply(Conv::to_float(d[i]), Conv::to_float(s[i])));
+	}
+}
+
+#define REDUCE_KERNEL(name, impl)						\
+	REDUCE_TARGETS static void name(void *dst, const void *src, size_t count) \
+	{									\
+		impl(dst, src, count);						\
+	}
+
+#define REDUCE_KERNELS(suffix, impl, type)					\
+	REDUCE_KERNEL(reduce_sum_##suffix, (impl<type, op_sum>))		\
+	REDUCE_KERNEL(reduce_prod_##suffix, (impl<type, op_prod>))		\
+	REDUCE_KERNEL(reduce_max_##suffix, (impl<type, op_max>))		\
+	REDUCE_KERNEL(reduce_min_##suffix, (impl<type, op_min>))
+
+REDUCE_KERNELS(i8, reduce_native, int8_t)
+REDUCE_KERNELS(u8, reduce_native, uint8_t)
+REDUCE_KERNELS(i32, reduce_native, int32_t)
+REDUCE_KERNELS(u32, reduce_native, uint32_t)
+REDUCE_KERNELS(i64, reduce_native, int64_t)
+REDUCE_KERNELS(u64, reduce_native, uint64_t)
+REDUCE_KERNELS(f16, reduce_half, conv_fp16)
+REDUCE_KERNELS(f32, reduce_native, float)
+REDUCE_KERNELS(f64, reduce_native, double)
+REDUCE_KERNELS(bf16, reduce_half, conv_bf16)
+
+#define REDUCE_ROW(suffix)							\
+	{ reduce_sum_##suffix, reduce_prod_##suffix, reduce_max_##suffix, reduce_min_##suffix }
+
+/* Indexed by dtype and op */
+static const reduce_fn_t reduce_kernels[NCCL_OFI_REDUCE_NUM_DTYPES][NCCL_OFI_REDUCE_NUM_OPS] = {
+	REDUCE_ROW(i8),
+	REDUCE_ROW(u8),
+	REDUCE_ROW(i32),
+	REDUCE_ROW(u32),
+	REDUCE_ROW(i64),
+	REDUCE_ROW(u64),
+	REDUCE_ROW(f16),
+	REDUCE_ROW(f32),
+	REDUCE_ROW(f64),
+	REDUCE_ROW(bf16),
+};
+
+size_t nccl_ofi_reduce_dtype_size(nccl_ofi_reduce_dtype_t dtype)
+{
+	switch (dtype) {
+	case NCCL_OFI_REDUCE_INT8:
+	case NCCL_OFI_REDUCE_UINT8:
+		return 1;
+	case NCCL_OFI_REDUCE_FLOAT16:
+	case NCCL_OFI_REDUCE_BFLOAT16:
+		return 2;
+	case NCCL_OFI_REDUCE_INT32:
+	case NCCL_OFI_REDUCE_UINT32:
+	case NCCL_OFI_REDUCE_FLOAT32:
+		return 4;
+	case NCCL_OFI_REDUCE_INT64:
+	case NCCL_OFI_REDUCE_UINT64:
+	case NCCL_OFI_REDUCE_FLOAT64:
+		return 8;
+	case NCCL_OFI_REDUCE_NUM_DTYPES:
+	default:
+		return 0;
+	}
+}
+
+int nccl_ofi_reduce(void *dst, const void *src, size_t count,
+		    nccl_ofi_reduce_dtype_t dtype, nccl_ofi_reduce_op_t op)
+{
+	if (OFI_UNLIKELY((unsigned int)dtype >= NCCL_OFI_REDUCE_NUM_DTYPES ||
+			 (unsigned int)op >= NCCL_OFI_REDUCE_NUM_OPS)) {
+		NCCL_OFI_WARN("Unsupported reduction of type %d with operator %d", dtype, op);
+		return -EINVAL;
+	}
+
+	reduce_kernels[dtype][op](dst, src, count);
+	return 0;
+}
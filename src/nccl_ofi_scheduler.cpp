@@ -44,8 +44,9 @@ static inline size_t sizeof_schedule(int num_rails)
 static int get_num_stripes(nccl_net_ofi_threshold_scheduler_t *scheduler_p, size_t size, int num_rails)
 {
 	/* Number of stripes is atleast 1 for zero-sized messages and at most equal to num of rails */
+	size_t min_stripe_size = __atomic_load_n(&scheduler_p->min_stripe_size, __ATOMIC_RELAXED);
 	int num_stripes = (int)std::max(1UL, std::min(NCCL_OFI_DIV_CEIL(size,
-									scheduler_p->min_stripe_size),
+									min_stripe_size),
 						      static_cast<long unsigned>(num_rails)));
 
 	/* Start the loop from num_stripes and skip 1, as num_rails % 1 is always true.
@@ -87,8 +88,9 @@ static inline int set_schedule_by_threshold(nccl_net_ofi_threshold_scheduler_t *
 	int curr_rail_id, next_rail_id;
 	nccl_net_ofi_mutex_lock(&scheduler->rr_lock);
 
-	/* Retieve and increment multiplex-round-robin counter; wrap around if required */
-	curr_rail_id = scheduler->rr_counter;
+	/* Retieve and increment multiplex-round-robin counter; wrap around if required.
+	 * Callers may schedule over fewer rails than the counter was last wrapped to. */
+	curr_rail_id = scheduler->rr_counter % num_rails;
 	next_rail_id = (curr_rail_id + num_stripes) % num_rails;
 	scheduler->rr_counter = next_rail_id;
 
@@ -287,7 +289,7 @@ int nccl_net_ofi_threshold_scheduler_init(int num_rails, size_t min_stripe_size,
 	scheduler->rr_counter = 0;
 	scheduler->min_stripe_size = min_stripe_size;
 
-	ret = nccl_net_ofi_mutex_init(&scheduler->rr_lock, NULL);
+	ret = nccl_net_ofi_mutex_init(&scheduler->rr_lock, NCCL_NET_OFI_LOCK_CLASS_SCHEDULER);
 	if (ret) {
 		NCCL_OFI_WARN("Could not initialize mutex for round robin counter");
 		scheduler_fini(&scheduler->base);
@@ -299,3 +301,14 @@ int nccl_net_ofi_threshold_scheduler_init(int num_rails, size_t min_stripe_size,
 
 	return ret;
 }
+
+void nccl_net_ofi_threshold_scheduler_set_min_stripe_size(nccl_net_ofi_scheduler_t *scheduler_p,
+							  size_t min_stripe_size)
+{
+	nccl_net_ofi_threshold_scheduler_t *scheduler =
+		(nccl_net_ofi_threshold_scheduler_t *)scheduler_p;
+
+	assert(scheduler_p->get_schedule == get_threshold_schedule);
+	assert(min_stripe_size > 0);
+	__atomic_store_n(&scheduler->min_stripe_size, min_stripe_size, __ATOMIC_RELAXED);
+}
@@ -33,6 +33,15 @@
 /* Indicates if provider supports FI_RMA */
 bool support_fi_rma = false;
 
+/* Indicates if receives NCCL marks as NCCL_NET_OPTIONAL_RECV_COMPLETION
+ * are completed when posted */
+static bool early_completion = false;
+
+static inline int sendrecv_recv_comm_free_req(nccl_net_ofi_sendrecv_recv_comm_t *r_comm,
+					      int dev_id,
+					      nccl_net_ofi_sendrecv_req_t *req,
+					      bool dec_inflight_reqs);
+
 static nccl_net_ofi_sendrecv_domain_t *sendrecv_endpoint_get_domain(nccl_net_ofi_sendrecv_ep_t *ep)
 {
 	return (nccl_net_ofi_sendrecv_domain_t*)ep->base.domain;
@@ -124,6 +133,29 @@ static inline void sendrecv_req_update(nccl_net_ofi_sendrecv_req_t *req, nccl_ne
 	req->state = state;
 }
 
+/*
+ * @brief	Update nccl_ofi_req on completion of its operation
+ *
+ *		Receives already reported complete to NCCL are released
+ *		instead, and a failure is recorded on their communicator.
+ */
+static inline void sendrecv_req_complete(nccl_net_ofi_sendrecv_req_t *req,
+					 nccl_net_ofi_sendrecv_req_state_t state, size_t size)
+{
+	if (OFI_LIKELY(!req->recv_completion_optional)) {
+		sendrecv_req_update(req, state, size);
+		return;
+	}
+
+	nccl_net_ofi_sendrecv_recv_comm_t *r_comm =
+		(nccl_net_ofi_sendrecv_recv_comm_t *)req->comm;
+	if (OFI_UNLIKELY(state == NCCL_OFI_SENDRECV_REQ_ERROR)) {
+		r_comm->optional_recv_error = true;
+	}
+	r_comm->num_optional_recvs--;
+	sendrecv_recv_comm_free_req(r_comm, req->dev_id, req, true);
+}
+
 /*
  * @brief	Processes completion entries from CQ
  *
@@ -164,9 +196,9 @@ static inline int sendrecv_process_completions(struct fi_cq_tagged_entry *cq_ent
 		}
 
 		if (comp_flags & FI_RECV) {
-			sendrecv_req_update(req, NCCL_OFI_SENDRECV_REQ_COMPLETED, cq_entry[comp_idx].len);
+			sendrecv_req_complete(req, NCCL_OFI_SENDRECV_REQ_COMPLETED, cq_entry[comp_idx].len);
 		} else {
-			sendrecv_req_update(req, NCCL_OFI_SENDRECV_REQ_COMPLETED, req->size);
+			sendrecv_req_complete(req, NCCL_OFI_SENDRECV_REQ_COMPLETED, req->size);
 		}
 	}
 
@@ -272,7 +304,7 @@ static int sendrecv_cq_process(struct fid_cq *cq, uint64_t max_tag)
 						     err_buffer.err_data, NULL, 0),
 				      (long)err_buffer.len,
 				      nccl_net_ofi_req_str(req));
-			sendrecv_req_update(req, NCCL_OFI_SENDRECV_REQ_ERROR, err_buffer.len);
+			sendrecv_req_complete(req, NCCL_OFI_SENDRECV_REQ_ERROR, err_buffer.len);
 		}
 		else if (rc == -FI_EAGAIN) {
 			/* No completions to process */
@@ -305,6 +337,13 @@ static inline void sendrecv_req_zero(nccl_net_ofi_sendrecv_req_t *req)
 	req->state = NCCL_OFI_SENDRECV_REQ_CREATED;
 
 	req->direction = NCCL_OFI_SENDRECV_INVALID_DIRECTION;
+
+	req->recv_completion_optional = false;
+
+	req->shm_next = NULL;
+	req->shm_buff = NULL;
+	req->shm_offset = 0;
+	req->shm_msg_size = 0;
 }
 
 /*
@@ -406,6 +445,149 @@ static inline int sendrecv_comm_free_req(nccl_net_ofi_comm_t *base_comm,
 
 #define __compiler_barrier() do { asm volatile ("" : : : "memory"); } while(0)
 
+/*
+ * @brief	True if connections to peers on the same host may use the
+ *		shared-memory transport
+ *
+ * Data is copied by the CPU, so the transport is only used when NCCL
+ * passes host buffers, i.e. without GPUDirect RDMA support.
+ */
+static inline bool sendrecv_shm_enabled(void)
+{
+	return ofi_nccl_shm_transport() && support_gdr == GDR_UNSUPPORTED;
+}
+
+/*
+ * @brief	Copy posted requests of a shared-memory communicator
+ *		through its channel, oldest first, until the channel is
+ *		full (send) or empty (receive)
+ *
+ * @return	0, on success
+ *		error, on others
+ */
+static int sendrecv_shm_progress(nccl_net_ofi_sendrecv_shm_t *shm)
+{
+	nccl_net_ofi_sendrecv_req_t *req = NULL;
+	const size_t hdr_size = sizeof(req->shm_msg_size);
+
+	while ((req = shm->head) != NULL) {
+		bool is_send = (req->direction == NCCL_OFI_SENDRECV_SEND);
+		size_t len, copied;
+		char *buff;
+
+		/* Message length */
+		if (req->shm_offset < hdr_size) {
+			buff = (char *)&req->shm_msg_size + req->shm_offset;
+			len = hdr_size - req->shm_offset;
+			copied = is_send ? nccl_ofi_shm_chan_write(&shm->chan, buff, len) :
+				nccl_ofi_shm_chan_read(&shm->chan, buff, len);
+			req->shm_offset += copied;
+			if (copied < len) {
+				break;
+			}
+
+			/* req->size holds the buffer size until completion */
+			if (!is_send && OFI_UNLIKELY(req->shm_msg_size > req->size)) {
+				NCCL_OFI_WARN("Received message of %" PRIu64 " bytes larger than receive buffer of %zu bytes",
+					      req->shm_msg_size, req->size);
+				shm->head = req->shm_next;
+				if (shm->head == NULL) {
+					shm->tail = NULL;
+				}
+				sendrecv_req_update(req, NCCL_OFI_SENDRECV_REQ_ERROR, 0);
+				/* The stream cannot be resynchronized */
+				return -EMSGSIZE;
+			}
+		}
+
+		/* Payload */
+		buff = (char *)req->shm_buff + (req->shm_offset - hdr_size);
+		len = req->shm_msg_size - (req->shm_offset - hdr_size);
+		if (len > 0) {
+			copied = is_send ? nccl_ofi_shm_chan_write(&shm->chan, buff, len) :
+				nccl_ofi_shm_chan_read(&shm->chan, buff, len);
+			req->shm_offset += copied;
+			if (copied < len) {
+				break;
+			}
+		}
+
+		shm->head = req->shm_next;
+		if (shm->head == NULL) {
+			shm->tail = NULL;
+		}
+		sendrecv_req_update(req, NCCL_OFI_SENDRECV_REQ_COMPLETED, req->shm_msg_size);
+	}
+
+	return 0;
+}
+
+/*
+ * @brief	Queue a request on a shared-memory communicator
+ *
+ * @param	buff
+ *		User buffer
+ * @param	size
+ *		Message size (send) or buffer size (receive)
+ */
+static void sendrecv_shm_post(nccl_net_ofi_sendrecv_shm_t *shm, nccl_net_ofi_sendrecv_req_t *req,
+			      void *buff, size_t size)
+{
+	req->shm_next = NULL;
+	req->shm_buff = buff;
+	req->shm_offset = 0;
+	req->shm_msg_size = size;
+	req->size = size;
+	req->state = NCCL_OFI_SENDRECV_REQ_PENDING;
+
+	if (shm->tail != NULL) {
+		shm->tail->shm_next = req;
+	} else {
+		shm->head = req;
+	}
+	shm->tail = req;
+}
+
+/*
+ * @brief	Copy a whole message into the channel of a send
+ *		communicator at post time
+ *
+ * Only done when no earlier send is queued and the channel can take
+ * the message, so that nothing is left to track and the send can
+ * return nccl_net_ofi_req_complete.
+ *
+ * @return	true, if the message was copied
+ *		false, if it must be queued
+ */
+static inline bool sendrecv_shm_send_inline(nccl_net_ofi_sendrecv_shm_t *shm, void *buff,
+					    size_t size)
+{
+	uint64_t msg_size = size;
+
+	if (shm->head != NULL ||
+	    nccl_ofi_shm_chan_space(&shm->chan) < sizeof(msg_size) + size) {
+		return false;
+	}
+
+	nccl_ofi_shm_chan_write(&shm->chan, &msg_size, sizeof(msg_size));
+	nccl_ofi_shm_chan_write(&shm->chan, buff, size);
+	return true;
+}
+
+/*
+ * @brief	Shared-memory transport of the communicator of a request,
+ *		NULL if it goes through the NIC
+ */
+static inline nccl_net_ofi_sendrecv_shm_t *sendrecv_req_get_shm(nccl_net_ofi_sendrecv_req_t *req)
+{
+	if (req->direction == NCCL_OFI_SENDRECV_SEND) {
+		return ((nccl_net_ofi_sendrecv_send_comm_t *)req->comm)->shm;
+	} else if (req->direction == NCCL_OFI_SENDRECV_RECV) {
+		return ((nccl_net_ofi_sendrecv_recv_comm_t *)req->comm)->shm;
+	}
+	return NULL;
+}
+
 static int sendrecv_req_test(nccl_net_ofi_req_t *base_req, int *done, int *size)
 {
 	int ret = 0;
@@ -430,7 +612,12 @@ static int sendrecv_req_test(nccl_net_ofi_req_t *base_req, int *done, int *size)
 
 	/* Process more completions unless the current request is completed */
 	if (req->state != NCCL_OFI_SENDRECV_REQ_COMPLETED) {
-		ret = sendrecv_cq_process(ep->cq, ep->max_tag);
+		nccl_net_ofi_sendrecv_shm_t *shm = sendrecv_req_get_shm(req);
+		if (shm != NULL) {
+			ret = sendrecv_shm_progress(shm);
+		} else {
+			ret = sendrecv_cq_process(ep->cq, ep->max_tag);
+		}
 		if (OFI_UNLIKELY(ret != 0))
 			goto exit;
 	}
@@ -618,6 +805,7 @@ static int sendrecv_mr_buffers_register(struct fid_domain *domain,
 			      type, dev_id, ret, fi_strerror(-ret));
 		goto exit;
 	}
+	nccl_ofi_mr_count_reg();
 
 	if (endpoint_mr) {
 		ret = fi_mr_bind(*mr_handle, &ep->fid, 0);
@@ -770,6 +958,8 @@ static int sendrecv_comm_mr_base_dereg(struct fid_mr *mr_handle,
 	if (OFI_UNLIKELY(ret != 0)) {
 		NCCL_OFI_WARN("Unable to de-register memory. RC: %d, Error: %s",
 			      ret, fi_strerror(-ret));
+	} else {
+		nccl_ofi_mr_count_dereg();
 	}
 
  exit:
@@ -995,6 +1185,10 @@ static int sendrecv_recv_comm_recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, v
 		(nccl_net_ofi_sendrecv_recv_comm_t *)recv_comm;
 	int dev_id = r_comm->base.base.dev_id;
 	struct fid_mr **mr_handles = (struct fid_mr **)mhandles;
+	/* NCCL checks data arrival itself. Only done through the NIC, as
+	 * the shared-memory transport is progressed by these calls. */
+	bool recv_completion_optional = early_completion && r_comm->shm == NULL &&
+		*base_req == (void *)NCCL_NET_OPTIONAL_RECV_COMPLETION;
 
 	/* Retrieve and validate endpoint */
 	ep = (nccl_net_ofi_sendrecv_ep_t *)r_comm->base.base.ep;
@@ -1004,6 +1198,26 @@ static int sendrecv_recv_comm_recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, v
 		goto error;
 	}
 
+	if (OFI_UNLIKELY(r_comm->optional_recv_error)) {
+		ret = -EIO;
+		NCCL_OFI_WARN("Receive completed early for NCCL failed on device %d", dev_id);
+		goto error;
+	}
+
+	/* Receives completed early hold their request until their
+	 * completion entry is processed */
+	if (OFI_UNLIKELY(r_comm->num_inflight_reqs == NCCL_OFI_MAX_REQUESTS &&
+			 r_comm->num_optional_recvs > 0)) {
+		ret = sendrecv_cq_process(ep->cq, ep->max_tag);
+		if (OFI_UNLIKELY(ret != 0))
+			goto error;
+		if (r_comm->num_inflight_reqs == NCCL_OFI_MAX_REQUESTS) {
+			/* Return NULL request */
+			*base_req = NULL;
+			goto exit;
+		}
+	}
+
 	/* Support only NCCL_OFI_MAX_REQUESTS inflight reqs. */
 	if (OFI_UNLIKELY(r_comm->num_inflight_reqs == NCCL_OFI_MAX_REQUESTS)) {
 		ret = -EINVAL;
@@ -1031,6 +1245,17 @@ static int sendrecv_recv_comm_recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, v
 	req->direction = NCCL_OFI_SENDRECV_RECV;
 
 	req->num_recvs = n;
+	req->recv_completion_optional = false;
+
+	if (r_comm->shm != NULL) {
+		/* Host copy out of the channel, no registration needed */
+		assert(n == 1);
+		sendrecv_shm_post(r_comm->shm, req, buffers[0], sizes[0]);
+		(r_comm->num_inflight_reqs)++;
+		*base_req = (nccl_net_ofi_req_t *)req;
+		ret = sendrecv_shm_progress(r_comm->shm);
+		goto exit;
+	}
 
 	if (OFI_UNLIKELY(mr_handles == NULL)) {
 		ret = -EINVAL;
@@ -1073,6 +1298,14 @@ static int sendrecv_recv_comm_recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, v
 
 	(r_comm->num_inflight_reqs)++;
 
+	if (recv_completion_optional) {
+		/* Released when its completion entry is processed */
+		req->recv_completion_optional = true;
+		(r_comm->num_optional_recvs)++;
+		*base_req = &nccl_net_ofi_req_complete;
+		goto exit;
+	}
+
 	/* Return request to NCCL */
 	*base_req = (nccl_net_ofi_req_t *)req;
 
@@ -1100,6 +1333,16 @@ static int sendrecv_recv_comm_close(nccl_net_ofi_recv_comm_t *recv_comm)
 		goto exit;
 	}
 
+	/* NCCL saw the data of receives completed early, so their
+	 * completion entries are due */
+	while (r_comm->num_optional_recvs > 0) {
+		nccl_net_ofi_sendrecv_ep_t *ep = (nccl_net_ofi_sendrecv_ep_t *)base_ep;
+		ret = sendrecv_cq_process(ep->cq, ep->max_tag);
+		if (OFI_UNLIKELY(ret != 0)) {
+			goto exit;
+		}
+	}
+
 	if (!ofi_nccl_gdr_flush_disable() && support_gdr == GDR_SUPPORTED && !cuda_flush) {
 		NCCL_OFI_TRACE(NCCL_NET, "De-registering buffer for flush operations");
 		/* Deregister Flush buffer memory region */
@@ -1111,6 +1354,7 @@ static int sendrecv_recv_comm_close(nccl_net_ofi_recv_comm_t *recv_comm)
 					      ret, fi_strerror(-ret));
 				goto exit;
 			}
+			nccl_ofi_mr_count_dereg();
 		}
 		ret = nccl_net_ofi_dealloc_mr_buffer(r_comm->flush_buff.host_buffer,
 						    system_page_size);
@@ -1121,6 +1365,11 @@ static int sendrecv_recv_comm_close(nccl_net_ofi_recv_comm_t *recv_comm)
 		r_comm->flush_buff.host_buffer = MAP_FAILED;
 	}
 
+	if (r_comm->shm != NULL) {
+		nccl_ofi_shm_chan_close(&r_comm->shm->chan);
+		free(r_comm->shm);
+	}
+
 	nccl_ofi_freelist_fini(r_comm->nccl_ofi_reqs_fl);
 	free(recv_comm);
 
@@ -1350,7 +1599,7 @@ static int sendrecv_fl_req_entry_init(void *entry)
  * 		prepares plugin to receive messages from the given peer.
  *
  * @param	Valid listen communicator object
- * 		Peer address
+ * 		Connect message of the peer
  *
  * @return	Receive communicator object, on success
  * 		NULL, on error
@@ -1359,8 +1608,9 @@ static nccl_net_ofi_sendrecv_recv_comm_t *sendrecv_recv_comm_prepare(nccl_net_of
 								     nccl_net_ofi_sendrecv_device_t *device,
 								     nccl_net_ofi_sendrecv_domain_t *domain,
 								     nccl_net_ofi_sendrecv_ep_t *ep,
-								     char *remote_ep_addr)
+								     nccl_ofi_connection_info_t *conn_info)
 {
+	char *remote_ep_addr = conn_info->ep_name;
 	int ret = 0;
 	fi_addr_t remote_ep;
 	struct fid_domain *ofi_domain;
@@ -1397,6 +1647,7 @@ static nccl_net_ofi_sendrecv_recv_comm_t *sendrecv_recv_comm_prepare(nccl_net_of
 	r_comm->base.flush = sendrecv_recv_comm_flush;
 	r_comm->base.close = sendrecv_recv_comm_close;
 	r_comm->base.read = NULL;
+	r_comm->base.read_batch = NULL;
 	r_comm->tag = l_comm->tag;
 	r_comm->local_ep = l_comm->local_ep;
 	r_comm->local_ep_addr = l_comm->local_ep_addr;
@@ -1414,6 +1665,30 @@ static nccl_net_ofi_sendrecv_recv_comm_t *sendrecv_recv_comm_prepare(nccl_net_of
 		return NULL;
 	}
 
+	/* The peer runs on the same host and created a channel */
+	if (conn_info->shm_name[0] != '\0') {
+		r_comm->shm = (nccl_net_ofi_sendrecv_shm_t *)
+			calloc(1, sizeof(nccl_net_ofi_sendrecv_shm_t));
+		if (OFI_UNLIKELY(r_comm->shm == NULL)) {
+			NCCL_OFI_WARN("Couldn't allocate shared-memory transport for dev %d",
+				      dev_id);
+			nccl_ofi_freelist_fini(r_comm->nccl_ofi_reqs_fl);
+			free(r_comm);
+			return NULL;
+		}
+
+		conn_info->shm_name[NCCL_OFI_SHM_NAME_LEN - 1] = '\0';
+		ret = nccl_ofi_shm_chan_attach(&r_comm->shm->chan, conn_info->shm_name);
+		if (OFI_UNLIKELY(ret != 0)) {
+			NCCL_OFI_WARN("Unable to attach to shared-memory channel of peer for dev %d. Set OFI_NCCL_SHM_TRANSPORT=0 on both sides to communicate through the NIC",
+				      dev_id);
+			free(r_comm->shm);
+			nccl_ofi_freelist_fini(r_comm->nccl_ofi_reqs_fl);
+			free(r_comm);
+			return NULL;
+		}
+	}
+
 	ofi_domain = sendrecv_endpoint_get_ofi_domain(ep);
 
 	/*
@@ -1425,6 +1700,10 @@ static nccl_net_ofi_sendrecv_recv_comm_t *sendrecv_recv_comm_prepare(nccl_net_of
 		ret = sendrecv_recv_comm_alloc_and_reg_flush_buff(ofi_domain, ep->ofi_ep, key_pool,
 								  &r_comm->flush_buff, dev_id);
 		if (OFI_UNLIKELY(ret != 0)) {
+			if (r_comm->shm != NULL) {
+				nccl_ofi_shm_chan_close(&r_comm->shm->chan);
+				free(r_comm->shm);
+			}
 			free(r_comm);
 			return NULL;
 		}
@@ -1590,7 +1869,7 @@ static int sendrecv_listen_comm_accept(nccl_net_ofi_listen_comm_t *listen_comm,
 	}
 
 	/* Prepare receive communicator object for the received peer connection */
-	r_comm = sendrecv_recv_comm_prepare(l_comm, device, domain, ep, conn_info->ep_name);
+	r_comm = sendrecv_recv_comm_prepare(l_comm, device, domain, ep, conn_info);
 	if (OFI_UNLIKELY(r_comm == NULL)) {
 		return -ENOMEM;
 	}
@@ -1681,6 +1960,11 @@ static int sendrecv_endpoint_listen(nccl_net_ofi_ep_t *base_ep,
 	/* Zero-out the handle */
 	memset(handle, 0, sizeof(nccl_net_ofi_conn_handle_t));
 
+	/* Let peers on the same host connect through shared memory */
+	if (sendrecv_shm_enabled()) {
+		handle->shm_host_id = nccl_ofi_shm_host_id();
+	}
+
 	/* Increase tag ID */
 	if (ep->tag + 1 >=
 	    device->max_tag) {
@@ -1825,6 +2109,11 @@ static int sendrecv_send_comm_send(nccl_net_ofi_send_comm_t *send_comm, void *da
 	 * props->maxRecvs > 1.
 	 */
 
+	if (s_comm->shm != NULL && sendrecv_shm_send_inline(s_comm->shm, data, size)) {
+		*base_req = &nccl_net_ofi_req_complete;
+		goto exit;
+	}
+
 	/* Allocate NCCL OFI request */
 	req = sendrecv_allocate_req(s_comm->nccl_ofi_reqs_fl);
 	if (OFI_UNLIKELY(req == NULL)) {
@@ -1838,6 +2127,15 @@ static int sendrecv_send_comm_send(nccl_net_ofi_send_comm_t *send_comm, void *da
 	req->dev_id = dev_id;
 	req->direction = NCCL_OFI_SENDRECV_SEND;
 
+	if (s_comm->shm != NULL) {
+		/* Host copy into the channel, no registration needed */
+		sendrecv_shm_post(s_comm->shm, req, data, size);
+		(s_comm->num_inflight_reqs)++;
+		*base_req = &req->base;
+		ret = sendrecv_shm_progress(s_comm->shm);
+		goto exit;
+	}
+
 	if (mr_handle != NULL)
 		desc = fi_mr_desc(mr_handle);
 
@@ -1894,6 +2192,11 @@ static int sendrecv_send_comm_close(nccl_net_ofi_send_comm_t *send_comm)
 		goto exit;
 	}
 
+	if (s_comm->shm != NULL) {
+		nccl_ofi_shm_chan_close(&s_comm->shm->chan);
+		free(s_comm->shm);
+	}
+
 	nccl_ofi_freelist_fini(s_comm->nccl_ofi_reqs_fl);
 	if (s_comm->conn_info != NULL) {
 		nccl_ofi_freelist_entry_free(((nccl_net_ofi_sendrecv_ep_t *)base_ep)->conn_msg_fl,
@@ -1977,6 +2280,7 @@ static inline int sendrecv_send_comm_create(nccl_net_ofi_conn_handle_t *handle,
 	ret_s_comm->base.close = sendrecv_send_comm_close;
 	ret_s_comm->base.write = NULL;
 	ret_s_comm->base.write_inline = NULL;
+	ret_s_comm->base.write_batch = NULL;
 	ret_s_comm->tag = tag;
 	ret_s_comm->local_ep = ep->ofi_ep;
 	ret_s_comm->remote_ep = remote_addr;
@@ -2008,6 +2312,38 @@ static inline int sendrecv_send_comm_create(nccl_net_ofi_conn_handle_t *handle,
 	conn_info->connect_to_self =
 		(0 == memcmp(conn_info->ep_name, remote_ep_addr, conn_info->ep_namelen)) ? 1 : 0;
 
+	/*
+	 * The listener advertises its host only if it accepts the
+	 * shared-memory transport. Creating the channel here and sending
+	 * its name along with the connect message lets both sides agree
+	 * on the transport without another round trip.
+	 */
+	conn_info->shm_name[0] = '\0';
+	if (sendrecv_shm_enabled() && handle->shm_host_id != 0 &&
+	    handle->shm_host_id == nccl_ofi_shm_host_id()) {
+		ret_s_comm->shm = (nccl_net_ofi_sendrecv_shm_t *)
+			calloc(1, sizeof(nccl_net_ofi_sendrecv_shm_t));
+		if (OFI_UNLIKELY(ret_s_comm->shm == NULL)) {
+			NCCL_OFI_WARN("Couldn't allocate shared-memory transport for dev %d",
+				      device->base.dev_id);
+			ret = -ENOMEM;
+			goto out;
+		}
+
+		ret = nccl_ofi_shm_chan_create(&ret_s_comm->shm->chan, ofi_nccl_shm_ring_size());
+		if (OFI_UNLIKELY(ret != 0)) {
+			NCCL_OFI_WARN("Unable to create shared-memory channel for dev %d. Set OFI_NCCL_SHM_TRANSPORT=0 to communicate through the NIC",
+				      device->base.dev_id);
+			free(ret_s_comm->shm);
+			ret_s_comm->shm = NULL;
+			goto out;
+		}
+		strcpy(conn_info->shm_name, ret_s_comm->shm->chan.name);
+
+		NCCL_OFI_INFO(NCCL_NET, "Using shared-memory channel %s for peer on the same host",
+			      conn_info->shm_name);
+	}
+
 	/* Pre-allocated buffers for data path */
 	ret = nccl_ofi_freelist_init(req_size, 16, 16, NCCL_OFI_MAX_SEND_REQUESTS,
 				     sendrecv_fl_req_entry_init, NULL,
@@ -2020,8 +2356,13 @@ static inline int sendrecv_send_comm_create(nccl_net_ofi_conn_handle_t *handle,
 
 	*s_comm = ret_s_comm;
 out:
-	if (ret)
+	if (ret) {
+		if (ret_s_comm->shm != NULL) {
+			nccl_ofi_shm_chan_close(&ret_s_comm->shm->chan);
+			free(ret_s_comm->shm);
+		}
 		free(ret_s_comm);
+	}
 
 	return ret;
 }
@@ -2312,7 +2653,7 @@ static int nccl_net_ofi_sendrecv_domain_create_endpoint(nccl_net_ofi_domain_t *b
 	ret = nccl_ofi_ofiutils_init_connection(device->info,
 						ofi_domain,
 						&ep->ofi_ep,
-						&ep->av, &ep->cq);
+						&ep->av, &ep->cq, NULL);
 	if (ret != 0) {
 		return ret;
 	}
@@ -2658,6 +2999,27 @@ static int nccl_net_ofi_sendrecv_plugin_create(size_t num_devices,
 }
 
 
+int nccl_net_ofi_sendrecv_send(nccl_net_ofi_send_comm_t *send_comm, void *data, int size, int tag,
+			       nccl_net_ofi_mr_handle_t *mhandle, nccl_net_ofi_req_t **base_req)
+{
+	return sendrecv_send_comm_send(send_comm, data, size, tag, mhandle, base_req);
+}
+
+
+int nccl_net_ofi_sendrecv_recv(nccl_net_ofi_recv_comm_t *recv_comm, int n, void **buffers,
+			       int *sizes, int *tags, nccl_net_ofi_mr_handle_t **mhandles,
+			       nccl_net_ofi_req_t **base_req)
+{
+	return sendrecv_recv_comm_recv(recv_comm, n, buffers, sizes, tags, mhandles, base_req);
+}
+
+
+int nccl_net_ofi_sendrecv_req_test(nccl_net_ofi_req_t *base_req, int *done, int *size)
+{
+	return sendrecv_req_test(base_req, done, size);
+}
+
+
 int nccl_net_ofi_sendrecv_init(const char *provider_filter,
 			       nccl_net_ofi_plugin_t **plugin_p)
 {
@@ -2836,6 +3198,27 @@ found:
 		goto error;
 	}
 
+	/*
+	 * NCCL_NET_OPTIONAL_RECV_COMPLETION receives (LL/LL128) are
+	 * reported complete to NCCL when posted, as NCCL validates data
+	 * arrival through the flags of the protocol. Their completion
+	 * entries are only processed to release the request. The
+	 * provider must place the data without being progressed by the
+	 * plugin, hence the FI_PROGRESS_AUTO requirement.
+	 */
+	if (ofi_nccl_early_completion() < 0) {
+		early_completion = data_progress_auto;
+	} else if (ofi_nccl_early_completion() == 0) {
+		early_completion = false;
+	} else {
+		if (!data_progress_auto) {
+			NCCL_OFI_WARN("Failed configuration of EARLY_COMPLETION due to provider data progress model is not FI_PROGRESS_AUTO");
+			ret = -ENOTSUP;
+			goto error;
+		}
+		early_completion = true;
+	}
+
 	ret = nccl_net_ofi_sendrecv_plugin_create(num_providers, provider_list, &plugin);
 	if (ret != 0) {
 		NCCL_OFI_WARN("Unable to allocate nccl_net_ofi_plugin_t");
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "nccl_ofi.h"
+#include "nccl_ofi_log.h"
+#include "nccl_ofi_math.h"
+#include "nccl_ofi_shm.h"
+
+/*
+ * Shared ring layout. Producer and consumer indices are free-running
+ * byte counters on separate cache lines; the number of bytes in the
+ * ring is head - tail.
+ */
+struct nccl_ofi_shm_ring {
+	alignas(NCCL_OFI_DEFAULT_CPU_CACHE_LINE_SIZE) std::atomic<uint64_t> head;
+	alignas(NCCL_OFI_DEFAULT_CPU_CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+	alignas(NCCL_OFI_DEFAULT_CPU_CACHE_LINE_SIZE) uint64_t size;
+	alignas(NCCL_OFI_DEFAULT_CPU_CACHE_LINE_SIZE) char data[];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+	      "Ring indices must be lock-free to be shared across processes");
+
+/* Number of channels created by this process, used to build unique names */
+static std::atomic<unsigned int> num_chans_created(0);
+
+/* FNV-1a */
+static uint64_t hash_bytes(uint64_t hash, const char *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (unsigned char)buf[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+uint64_t nccl_ofi_shm_host_id(void)
+{
+	static std::atomic<uint64_t> host_id(0);
+	uint64_t id = host_id.load(std::memory_order_relaxed);
+	char buf[128];
+	ssize_t len;
+	FILE *file;
+
+	if (id != 0) {
+		return id;
+	}
+
+	/* Kernel instance */
+	file = fopen("/proc/sys/kernel/random/boot_id", "r");
+	if (file == NULL) {
+		NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "Unable to read boot id: %s", strerror(errno));
+		return 0;
+	}
+	len = fread(buf, 1, sizeof(buf), file);
+	fclose(file);
+	if (len <= 0) {
+		return 0;
+	}
+	id = hash_bytes(0xcbf29ce484222325ULL, buf, len);
+
+	/* IPC namespace, which scopes POSIX shared memory objects */
+	len = readlink("/proc/self/ns/ipc", buf, sizeof(buf));
+	if (len <= 0) {
+		NCCL_OFI_INFO(NCCL_INIT | NCCL_NET, "Unable to read IPC namespace: %s", strerror(errno));
+		return 0;
+	}
+	id = hash_bytes(id, buf, len);
+
+	/* Reserve 0 for unknown */
+	id = std::max(id, (uint64_t)1);
+	host_id.store(id, std::memory_order_relaxed);
+	return id;
+}
+
+static int shm_chan_map(nccl_ofi_shm_chan_t *chan, int fd, size_t map_size)
+{
+	void *addr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED) {
+		int ret = -errno;
+		NCCL_OFI_WARN("Unable to map shared memory object %s: %s", chan->name, strerror(errno));
+		return ret;
+	}
+
+	chan->ring = (nccl_ofi_shm_ring_t *)addr;
+	chan->map_size = map_size;
+	return 0;
+}
+
+int nccl_ofi_shm_chan_create(nccl_ofi_shm_chan_t *chan, size_t ring_size)
+{
+	int ret = 0;
+	int fd = -1;
+
+	memset(chan, 0, sizeof(*chan));
+
+	ring_size = std::max(ring_size, (size_t)system_page_size);
+	ring_size = (size_t)1 << (64 - __builtin_clzll(ring_size - 1));
+	size_t map_size = NCCL_OFI_ROUND_UP(sizeof(nccl_ofi_shm_ring_t) + ring_size, system_page_size);
+
+	ret = snprintf(chan->name, sizeof(chan->name), "/nccl-ofi-%d-%u", (int)getpid(),
+		       num_chans_created.fetch_add(1, std::memory_order_relaxed));
+	if (ret < 0 || (size_t)ret >= sizeof(chan->name)) {
+		NCCL_OFI_WARN("Unable to build shared memory object name");
+		return -EINVAL;
+	}
+
+	fd = shm_open(chan->name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd < 0) {
+		ret = -errno;
+		NCCL_OFI_WARN("Unable to create shared memory object %s: %s", chan->name, strerror(errno));
+		return ret;
+	}
+	chan->owner = true;
+
+	if (ftruncate(fd, map_size) != 0) {
+		ret = -errno;
+		NCCL_OFI_WARN("Unable to size shared memory object %s: %s", chan->name, strerror(errno));
+		goto error;
+	}
+
+	ret = shm_chan_map(chan, fd, map_size);
+	if (ret != 0) {
+		goto error;
+	}
+	close(fd);
+
+	/* The object is zero-filled, so only the size is left to set */
+	chan->ring->size = ring_size;
+	chan->ring_size = ring_size;
+
+	return 0;
+
+ error:
+	close(fd);
+	shm_unlink(chan->name);
+	chan->owner = false;
+	return ret;
+}
+
+int nccl_ofi_shm_chan_attach(nccl_ofi_shm_chan_t *chan, const char *name)
+{
+	int ret = 0;
+	int fd = -1;
+	struct stat st;
+
+	memset(chan, 0, sizeof(*chan));
+
+	if (strnlen(name, NCCL_OFI_SHM_NAME_LEN) == NCCL_OFI_SHM_NAME_LEN) {
+		NCCL_OFI_WARN("Invalid shared memory object name");
+		return -EINVAL;
+	}
+	strcpy(chan->name, name);
+
+	fd = shm_open(chan->name, O_RDWR, 0);
+	if (fd < 0) {
+		ret = -errno;
+		NCCL_OFI_WARN("Unable to open shared memory object %s: %s", chan->name, strerror(errno));
+		return ret;
+	}
+
+	/* Both sides hold a mapping now */
+	shm_unlink(chan->name);
+
+	if (fstat(fd, &st) != 0) {
+		ret = -errno;
+		NCCL_OFI_WARN("Unable to query shared memory object %s: %s", chan->name, strerror(errno));
+		goto exit;
+	}
+
+	ret = shm_chan_map(chan, fd, st.st_size);
+	if (ret != 0) {
+		goto exit;
+	}
+
+	chan->ring_size = chan->ring->size;
+	if (!NCCL_OFI_IS_POWER_OF_TWO(chan->ring_size) ||
+	    sizeof(nccl_ofi_shm_ring_t) + chan->ring_size > chan->map_size) {
+		NCCL_OFI_WARN("Shared memory object %s has an invalid ring size %zu",
+			      chan->name, chan->ring_size);
+		munmap(chan->ring, chan->map_size);
+		chan->ring = NULL;
+		ret = -EINVAL;
+	}
+
+ exit:
+	close(fd);
+	return ret;
+}
+
+int nccl_ofi_shm_chan_close(nccl_ofi_shm_chan_t *chan)
+{
+	int ret = 0;
+
+	if (chan->owner) {
+		/* The peer may never have attached */
+		if (shm_unlink(chan->name) != 0 && errno != ENOENT) {
+			ret = -errno;
+			NCCL_OFI_WARN("Unable to remove shared memory object %s: %s",
+				      chan->name, strerror(errno));
+		}
+		chan->owner = false;
+	}
+
+	if (chan->ring != NULL) {
+		if (munmap(chan->ring, chan->map_size) != 0) {
+			ret = -errno;
+			NCCL_OFI_WARN("Unable to unmap shared memory object %s: %s",
+				      chan->name, strerror(errno));
+		}
+		chan->ring = NULL;
+	}
+
+	return ret;
+}
+
+size_t nccl_ofi_shm_chan_write(nccl_ofi_shm_chan_t *chan, const void *buf, size_t len)
+{
+	nccl_ofi_shm_ring_t *ring = chan->ring;
+	uint64_t head = ring->head.load(std::memory_order_relaxed);
+	uint64_t tail = ring->tail.load(std::memory_order_acquire);
+
+	len = std::min(len, (size_t)(chan->ring_size - (head - tail)));
+	if (len == 0) {
+		return 0;
+	}
+
+	size_t offset = head & (chan->ring_size - 1);
+	size_t first = std::min(len, chan->ring_size - offset);
+	memcpy(ring->data + offset, buf, first);
+	memcpy(ring->data, (const char *)buf + first, len - first);
+
+	ring->head.store(head + len, std::memory_order_release);
+	return len;
+}
+
+size_t nccl_ofi_shm_chan_space(const nccl_ofi_shm_chan_t *chan)
+{
+	nccl_ofi_shm_ring_t *ring = chan->ring;
+	uint64_t head = ring->head.load(std::memory_order_relaxed);
+	uint64_t tail = ring->tail.load(std::memory_order_acquire);
+
+	return chan->ring_size - (head - tail);
+}
+
+size_t nccl_ofi_shm_chan_read(nccl_ofi_shm_chan_t *chan, void *buf, size_t len)
+{
+	nccl_ofi_shm_ring_t *ring = chan->ring;
+	uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+	uint64_t head = ring->head.load(std::memory_order_acquire);
+
+	len = std::min(len, (size_t)(head - tail));
+	if (len == 0) {
+		return 0;
+	}
+
+	size_t offset = tail & (chan->ring_size - 1);
+	size_t first = std::min(len, chan->ring_size - offset);
+	memcpy(buf, ring->data + offset, first);
+	memcpy((char *)buf + first, ring->data, len - first);
+
+	ring->tail.store(tail + len, std::memory_order_release);
+	return len;
+}
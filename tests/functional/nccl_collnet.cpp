@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+/*
+ * This test runs allreduces through the software collective network
+ * (COLLNET) across all ranks, e.g., two ranks of one host over the
+ * loopback path, and checks the results. The element counts are not
+ * multiples of the number of ranks and span several segments of the
+ * ring, and one allreduce runs in place. Finally, several allreduces
+ * are issued before any of them is tested, and tested newest first.
+ */
+
+#include "config.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nccl_ofi_collnet.h"
+#include "test-common.h"
+
+#define COLLNET_SYMBOL	ncclCollNetPlugin_v8
+
+/* Spans several segments with up to 8 ranks */
+#define COLLNET_COUNT	(8 * NCCL_OFI_COLLNET_CHUNK_SIZE / 4 * 2 + 1001)
+
+/* Number and size of the overlapping allreduces */
+#define COLLNET_NUM_OVERLAP	(3)
+#define COLLNET_OVERLAP_COUNT	(NCCL_OFI_COLLNET_CHUNK_SIZE / 4 * 3 + 7)
+
+static ncclCollNet_v8_t *get_collNet(void)
+{
+	void *netPluginLib = dlopen("libnccl-net.so", RTLD_NOW | RTLD_LOCAL);
+	if (netPluginLib == NULL) {
+		NCCL_OFI_WARN("Unable to load libnccl-net.so: %s", dlerror());
+		return NULL;
+	}
+
+	ncclCollNet_v8_t *collNet = (ncclCollNet_v8_t *)dlsym(netPluginLib, STR(COLLNET_SYMBOL));
+	if (collNet == NULL) {
+		NCCL_OFI_WARN("NetPlugin, could not find %s symbol", STR(COLLNET_SYMBOL));
+	}
+
+	return collNet;
+}
+
+static ncclResult_t allreduce(ncclCollNet_v8_t *collNet, void *collComm, void *sendbuf,
+			      void *recvbuf, int count, ncclDataType_t dtype, ncclRedOp_t op,
+			      void *mhandle)
+{
+	ncclResult_t res = ncclSuccess;
+	void *req = NULL;
+	int done = 0, size = 0;
+
+	while (req == NULL) {
+		OFINCCLCHECKGOTO(collNet->iallreduce(collComm, sendbuf, recvbuf, count, dtype, op,
+						     mhandle, mhandle, &req), res, exit);
+	}
+	while (!done) {
+		OFINCCLCHECKGOTO(collNet->test(req, &done, &size), res, exit);
+	}
+	if ((size_t)size != (size_t)count * (dtype == ncclFloat32 ? sizeof(float) : sizeof(int32_t))) {
+		NCCL_OFI_WARN("Allreduce completed with size %d", size);
+		res = ncclInternalError;
+	}
+
+ exit:
+	return res;
+}
+
+/*
+ * @brief	Issue COLLNET_NUM_OVERLAP int32 sums on the buffers of
+ *		`bufs' before testing any of them, newest first
+ */
+static ncclResult_t overlapping_allreduces(ncclCollNet_v8_t *collNet, void *collComm,
+					   int32_t **bufs, void *mhandle)
+{
+	ncclResult_t res = ncclSuccess;
+	void *reqs[COLLNET_NUM_OVERLAP] = {};
+	int num_done = 0;
+
+	for (int i = 0; i < COLLNET_NUM_OVERLAP; i++) {
+		while (reqs[i] == NULL) {
+			OFINCCLCHECKGOTO(collNet->iallreduce(collComm, bufs[i], bufs[i],
+							     COLLNET_OVERLAP_COUNT, ncclInt32, ncclSum,
+							     mhandle, mhandle, &reqs[i]), res, exit);
+		}
+	}
+
+	while (num_done < COLLNET_NUM_OVERLAP) {
+		for (int i = COLLNET_NUM_OVERLAP - 1; i >= 0; i--) {
+			int done = 0, size = 0;
+
+			if (reqs[i] == NULL) {
+				continue;
+			}
+			OFINCCLCHECKGOTO(collNet->test(reqs[i], &done, &size), res, exit);
+			if (!done) {
+				continue;
+			}
+			if ((size_t)size != COLLNET_OVERLAP_COUNT * sizeof(int32_t)) {
+				NCCL_OFI_WARN("Allreduce %d completed with size %d", i, size);
+				res = ncclInternalError;
+				goto exit;
+			}
+			reqs[i] = NULL;
+			num_done++;
+		}
+	}
+
+ exit:
+	return res;
+}
+
+int main(int argc, char* argv[])
+{
+	ncclResult_t res = ncclSuccess;
+	int rank, nranks;
+
+	int ndev, dev = 0, supported = 0;
+	test_nccl_net_t *extNet = NULL;
+	ncclCollNet_v8_t *collNet = NULL;
+	void *lComm = NULL, *collComm = NULL;
+	char handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	char *all_handles = NULL;
+	void **handles = NULL;
+	void *mhandle = NULL;
+	int32_t *sendbuf = NULL, *recvbuf = NULL;
+	int32_t *obufs[COLLNET_NUM_OVERLAP] = {};
+	float *fbuf = NULL;
+
+	ofi_log_function = logger;
+
+	MPI_Init(&argc, &argv);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+	/* Read by the plugin during init */
+	setenv("OFI_NCCL_COLLNET", "1", 1);
+
+	extNet = get_extNet();
+	collNet = get_collNet();
+	if (extNet == NULL || collNet == NULL) {
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	/* NCCL initializes the point-to-point network first */
+	OFINCCLCHECKGOTO(extNet->init(logger), res, exit);
+	OFINCCLCHECKGOTO(collNet->init(logger), res, exit);
+
+	OFINCCLCHECKGOTO(collNet->devices(&ndev), res, exit);
+	if (ndev <= 0) {
+		NCCL_OFI_WARN("No collective network device");
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	OFINCCLCHECKGOTO(collNet->reduceSupport(ncclInt32, ncclMax, &supported), res, exit);
+	if (!supported) {
+		NCCL_OFI_WARN("Max of int32 not supported");
+		res = ncclInternalError;
+		goto exit;
+	}
+	OFINCCLCHECKGOTO(collNet->reduceSupport(ncclFloat32, ncclAvg, &supported), res, exit);
+	if (supported) {
+		NCCL_OFI_WARN("Average reported as supported");
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	OFINCCLCHECKGOTO(collNet->listen(dev, handle, &lComm), res, exit);
+
+	all_handles = (char *)malloc((size_t)nranks * NCCL_NET_HANDLE_MAXSIZE);
+	handles = (void **)malloc((size_t)nranks * sizeof(void *));
+	sendbuf = (int32_t *)malloc(COLLNET_COUNT * sizeof(int32_t));
+	recvbuf = (int32_t *)malloc(COLLNET_COUNT * sizeof(int32_t));
+	fbuf = (float *)malloc(COLLNET_COUNT * sizeof(float));
+	if (all_handles == NULL || handles == NULL || sendbuf == NULL || recvbuf == NULL || fbuf == NULL) {
+		res = ncclSystemError;
+		goto exit;
+	}
+	for (int j = 0; j < COLLNET_NUM_OVERLAP; j++) {
+		obufs[j] = (int32_t *)malloc(COLLNET_OVERLAP_COUNT * sizeof(int32_t));
+		if (obufs[j] == NULL) {
+			res = ncclSystemError;
+			goto exit;
+		}
+	}
+
+	MPI_Allgather(handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR,
+		      all_handles, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, MPI_COMM_WORLD);
+	for (int i = 0; i < nranks; i++) {
+		handles[i] = all_handles + (size_t)i * NCCL_NET_HANDLE_MAXSIZE;
+	}
+
+	OFINCCLCHECKGOTO(collNet->connect(handles, nranks, rank, lComm, &collComm), res, exit);
+	OFINCCLCHECKGOTO(collNet->regMr(collComm, recvbuf, COLLNET_COUNT * sizeof(int32_t),
+					NCCL_PTR_HOST, &mhandle), res, exit);
+
+	/* Sum of int32 */
+	for (int i = 0; i < COLLNET_COUNT; i++) {
+		sendbuf[i] = (rank + 1) * (i % 1000);
+	}
+	OFINCCLCHECKGOTO(allreduce(collNet, collComm, sendbuf, recvbuf, COLLNET_COUNT,
+				   ncclInt32, ncclSum, mhandle), res, exit);
+	for (int i = 0; i < COLLNET_COUNT; i++) {
+		int32_t expected = nranks * (nranks + 1) / 2 * (i % 1000);
+		if (recvbuf[i] != expected) {
+			NCCL_OFI_WARN("Sum mismatch at %d: %d, expected %d", i, recvbuf[i], expected);
+			res = ncclInternalError;
+			goto exit;
+		}
+	}
+
+	/* Max of int32, in place */
+	for (int i = 0; i < COLLNET_COUNT; i++) {
+		recvbuf[i] = (i + rank) % nranks;
+	}
+	OFINCCLCHECKGOTO(allreduce(collNet, collComm, recvbuf, recvbuf, COLLNET_COUNT,
+				   ncclInt32, ncclMax, mhandle), res, exit);
+	for (int i = 0; i < COLLNET_COUNT; i++) {
+		if (recvbuf[i] != nranks - 1) {
+			NCCL_OFI_WARN("Max mismatch at %d: %d, expected %d", i, recvbuf[i], nranks - 1);
+			res = ncclInternalError;
+			goto exit;
+		}
+	}
+
+	/* Sum of float32, exact for small integers */
+	for (int i = 0; i < COLLNET_COUNT; i++) {
+		fbuf[i] = (float)(rank + (i % 3));
+	}
+	OFINCCLCHECKGOTO(allreduce(collNet, collComm, fbuf, fbuf, COLLNET_COUNT,
+				   ncclFloat32, ncclSum, mhandle), res, exit);
+	for (int i = 0; i < COLLNET_COUNT; i++) {
+		float expected = (float)(nranks * (nranks - 1) / 2 + nranks * (i % 3));
+		if (fbuf[i] != expected) {
+			NCCL_OFI_WARN("Float sum mismatch at %d: %f, expected %f", i, fbuf[i], expected);
+			res = ncclInternalError;
+			goto exit;
+		}
+	}
+
+	/* Overlapping sums of int32, a different one per allreduce */
+	for (int j = 0; j < COLLNET_NUM_OVERLAP; j++) {
+		for (int i = 0; i < COLLNET_OVERLAP_COUNT; i++) {
+			obufs[j][i] = (rank + 1) * (j + 1) + (i % 100);
+		}
+	}
+	OFINCCLCHECKGOTO(overlapping_allreduces(collNet, collComm, obufs, mhandle), res, exit);
+	for (int j = 0; j < COLLNET_NUM_OVERLAP; j++) {
+		for (int i = 0; i < COLLNET_OVERLAP_COUNT; i++) {
+			int32_t expected = nranks * (nranks + 1) / 2 * (j + 1) + nranks * (i % 100);
+			if (obufs[j][i] != expected) {
+				NCCL_OFI_WARN("Overlapping sum %d mismatch at %d: %d, expected %d",
+					      j, i, obufs[j][i], expected);
+				res = ncclInternalError;
+				goto exit;
+			}
+		}
+	}
+
+	OFINCCLCHECKGOTO(collNet->deregMr(collComm, mhandle), res, exit);
+	OFINCCLCHECKGOTO(collNet->closeColl(collComm), res, exit);
+	collComm = NULL;
+	OFINCCLCHECKGOTO(collNet->closeListen(lComm), res, exit);
+	lComm = NULL;
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Finalize();
+	NCCL_OFI_INFO(NCCL_NET, "Test completed successfully for rank %d", rank);
+
+exit:
+	free(all_handles);
+	free(handles);
+	free(sendbuf);
+	free(recvbuf);
+	free(fbuf);
+	for (int j = 0; j < COLLNET_NUM_OVERLAP; j++) {
+		free(obufs[j]);
+	}
+
+	return res;
+}
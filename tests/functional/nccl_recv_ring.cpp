@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+/*
+ * This test exchanges messages in both directions with the receive ring
+ * (RDMA_RECV_RING) enabled. Every receive reuses the buffer of its ring
+ * slot, so after the first round the receivers grant credits instead of
+ * sending control messages. All receives of a round are posted at once,
+ * which batches the credits granted while a credit message is in
+ * flight, and the rounds run past the wraparound of the message
+ * sequence numbers. With the "mismatch" argument, the second rank
+ * disables the ring, and both directions must fall back to control
+ * messages during the connection handshake.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test-common.h"
+
+#define RING_MSG_SIZE	(256 * 1024)
+/* Number of ring slots (NCCL_OFI_RDMA_RECV_RING_DEPTH) */
+#define RING_DEPTH	(8)
+/* Twice the range of message sequence numbers */
+#define RING_ROUNDS	(2 * (1 << 10) / RING_DEPTH + 1)
+
+int main(int argc, char* argv[])
+{
+	ncclResult_t res = ncclSuccess;
+	int rank, size;
+	bool mismatch = (argc > 1 && strcmp(argv[1], "mismatch") == 0);
+
+	/* Plugin defines */
+	int ndev, dev = 0;
+	nccl_net_ofi_send_comm_t *sComm = NULL;
+	nccl_net_ofi_listen_comm_t *lComm = NULL;
+	nccl_net_ofi_recv_comm_t *rComm = NULL;
+	test_nccl_net_device_handle_t *s_ignore, *r_ignore;
+	char src_handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	char handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	test_nccl_net_t *extNet = NULL;
+
+	nccl_net_ofi_req_t *send_req[RING_DEPTH] = {NULL};
+	nccl_net_ofi_req_t *recv_req[RING_DEPTH] = {NULL};
+	void *send_mhandle[RING_DEPTH] = {NULL};
+	void *recv_mhandle[RING_DEPTH] = {NULL};
+	char *send_buf[RING_DEPTH] = {NULL};
+	char *recv_buf[RING_DEPTH] = {NULL};
+	char *expected_buf = NULL;
+	int tag = 1, nrecv = 1;
+	size_t sizes[1] = {RING_MSG_SIZE};
+	int tags[1] = {tag};
+	int done, received_size;
+
+	ofi_log_function = logger;
+
+	MPI_Init(&argc, &argv);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	/* Read by the plugin during init */
+	setenv("OFI_NCCL_RDMA_RECV_RING", (mismatch && rank == 1) ? "0" : "1", 1);
+	if (size != 2) {
+		NCCL_OFI_WARN("Expected two ranks but got %d. "
+			"The nccl_recv_ring functional test should be run with exactly two ranks.",
+			size);
+		res = ncclInvalidArgument;
+		goto exit;
+	}
+
+	/* Get external Network from NCCL-OFI library */
+	extNet = get_extNet();
+	if (extNet == NULL) {
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	/* Init API */
+	OFINCCLCHECKGOTO(extNet->init(logger), res, exit);
+
+	/* Devices API */
+	OFINCCLCHECKGOTO(extNet->devices(&ndev), res, exit);
+	NCCL_OFI_INFO(NCCL_INIT, "Received %d network devices", ndev);
+
+	/* Listen API */
+	OFINCCLCHECKGOTO(extNet->listen(dev, (void *)&handle, (void **)&lComm), res, exit);
+
+	MPI_Sendrecv(handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, 1 - rank, 0,
+		     src_handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, 1 - rank, 0,
+		     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+	while (sComm == NULL || rComm == NULL) {
+		/* Connect API */
+		if (sComm == NULL) {
+			OFINCCLCHECKGOTO(extNet->connect(dev, (void *)src_handle, (void **)&sComm, &s_ignore), res, exit);
+		}
+
+		/* Accept API */
+		if (rComm == NULL) {
+			OFINCCLCHECKGOTO(extNet->accept((void *)lComm, (void **)&rComm, &r_ignore), res, exit);
+		}
+	}
+
+	OFINCCLCHECKGOTO(allocate_buff((void **)&expected_buf, RING_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(initialize_buff((void *)expected_buf, RING_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+
+	for (int idx = 0; idx < RING_DEPTH; idx++) {
+		OFINCCLCHECKGOTO(allocate_buff((void **)&send_buf[idx], RING_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+		OFINCCLCHECKGOTO(initialize_buff((void *)send_buf[idx], RING_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+		OFINCCLCHECKGOTO(extNet->regMr((void *)sComm, (void *)send_buf[idx], RING_MSG_SIZE,
+					       NCCL_PTR_HOST, &send_mhandle[idx]), res, exit);
+		OFINCCLCHECKGOTO(allocate_buff((void **)&recv_buf[idx], RING_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+		OFINCCLCHECKGOTO(extNet->regMr((void *)rComm, (void *)recv_buf[idx], RING_MSG_SIZE,
+					       NCCL_PTR_HOST, &recv_mhandle[idx]), res, exit);
+	}
+
+	for (int round = 0; round < RING_ROUNDS; round++) {
+		int inflight_reqs = 2 * RING_DEPTH;
+
+		/* Message `msg_seq_num' always lands in the buffer of slot
+		 * `msg_seq_num % RING_DEPTH', as rounds are full rings */
+		for (int idx = 0; idx < RING_DEPTH; idx++) {
+			memset(recv_buf[idx], 0, RING_MSG_SIZE);
+			recv_req[idx] = NULL;
+			while (recv_req[idx] == NULL) {
+				OFINCCLCHECKGOTO(extNet->irecv((void *)rComm, nrecv, (void **)&recv_buf[idx], sizes,
+							       tags, &recv_mhandle[idx], (void **)&recv_req[idx]), res, exit);
+			}
+		}
+
+		for (int idx = 0; idx < RING_DEPTH; idx++) {
+			send_req[idx] = NULL;
+			while (send_req[idx] == NULL) {
+				OFINCCLCHECKGOTO(extNet->isend((void *)sComm, (void *)send_buf[idx], RING_MSG_SIZE,
+							       tag, send_mhandle[idx], (void **)&send_req[idx]), res, exit);
+			}
+		}
+
+		/* Test for completions */
+		while (inflight_reqs > 0) {
+			for (int idx = 0; idx < RING_DEPTH; idx++) {
+				if (send_req[idx] != NULL) {
+					OFINCCLCHECKGOTO(extNet->test((void *)send_req[idx], &done, &received_size), res, exit);
+					if (done) {
+						inflight_reqs--;
+						send_req[idx] = NULL;
+					}
+				}
+
+				if (recv_req[idx] == NULL)
+					continue;
+
+				OFINCCLCHECKGOTO(extNet->test((void *)recv_req[idx], &done, &received_size), res, exit);
+				if (!done)
+					continue;
+
+				inflight_reqs--;
+				recv_req[idx] = NULL;
+				if (received_size != RING_MSG_SIZE) {
+					NCCL_OFI_WARN("Wrong received size %d in round %d", received_size, round);
+					res = ncclInternalError;
+					goto exit;
+				}
+				OFINCCLCHECKGOTO(validate_data(recv_buf[idx], expected_buf, RING_MSG_SIZE,
+							       NCCL_PTR_HOST), res, exit);
+			}
+		}
+	}
+
+	for (int idx = 0; idx < RING_DEPTH; idx++) {
+		OFINCCLCHECKGOTO(extNet->deregMr((void *)sComm, send_mhandle[idx]), res, exit);
+		OFINCCLCHECKGOTO(extNet->deregMr((void *)rComm, recv_mhandle[idx]), res, exit);
+	}
+
+	OFINCCLCHECKGOTO(extNet->closeListen((void *)lComm), res, exit);
+	lComm = NULL;
+	OFINCCLCHECKGOTO(extNet->closeSend((void *)sComm), res, exit);
+	sComm = NULL;
+	OFINCCLCHECKGOTO(extNet->closeRecv((void *)rComm), res, exit);
+	rComm = NULL;
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Finalize();
+	NCCL_OFI_INFO(NCCL_NET, "Test completed successfully for rank %d", rank);
+
+exit:
+	for (int idx = 0; idx < RING_DEPTH; idx++) {
+		if (send_buf[idx]) {
+			deallocate_buffer(send_buf[idx], NCCL_PTR_HOST);
+		}
+		if (recv_buf[idx]) {
+			deallocate_buffer(recv_buf[idx], NCCL_PTR_HOST);
+		}
+	}
+	if (expected_buf) {
+		deallocate_buffer(expected_buf, NCCL_PTR_HOST);
+	}
+
+	return res;
+}
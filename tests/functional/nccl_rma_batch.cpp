@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+/*
+ * This test exercises batched one-sided writes and reads of the RDMA
+ * protocol (iwriteBatch/ireadBatch) between two ranks. Each rank writes
+ * a full batch into the buffer of its peer, in reverse order of the
+ * remote offsets, and reads a full batch from another buffer of its
+ * peer, then checks both. The operations are large enough to be striped
+ * across all rails, so that each rail gets several stripes of a request
+ * and only its last one is posted without FI_MORE. Debug builds of the
+ * plugin assert that the last stripe of each rail flushed FI_MORE.
+ * Several rounds run so that RMA key table entries, if used, are both
+ * fetched and found in the cache. A batch with a descriptor lacking its
+ * memory handle must be rejected.
+ *
+ * The batch functions are called through the internal API, since the
+ * exported table is only part of the Neuron interface.
+ */
+
+#include "config.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nccl_ofi_api.h"
+#include "test-common.h"
+
+#define BATCH_OP_SIZE	(128 * 1024)
+#define BATCH_NUM_OPS	(NCCL_OFI_MAX_RMA_BATCH)
+#define BATCH_BUF_SIZE	(BATCH_OP_SIZE * BATCH_NUM_OPS)
+#define BATCH_ROUNDS	(3)
+
+/* Buffers of the peer, exchanged after registration */
+typedef struct {
+	uint64_t write_dst;
+	uint64_t write_dst_key;
+	uint64_t read_src;
+	uint64_t read_src_key;
+} batch_peer_bufs_t;
+
+static inline char batch_pattern(int rank, int round, size_t i, bool is_read)
+{
+	return (char)(rank * 31 + round * 7 + (i / 4096) * 3 + (is_read ? 1 : 0));
+}
+
+static void fill_buff(char *buf, int rank, int round, bool is_read)
+{
+	for (size_t i = 0; i < BATCH_BUF_SIZE; i++) {
+		buf[i] = batch_pattern(rank, round, i, is_read);
+	}
+}
+
+static ncclResult_t check_buff(const char *buf, int rank, int round, bool is_read)
+{
+	for (size_t i = 0; i < BATCH_BUF_SIZE; i++) {
+		if (buf[i] != batch_pattern(rank, round, i, is_read)) {
+			NCCL_OFI_WARN("%s of round %d corrupted at byte %zu",
+				      is_read ? "Read" : "Write", round, i);
+			return ncclInternalError;
+		}
+	}
+	return ncclSuccess;
+}
+
+static ncclResult_t wait_req(void *req)
+{
+	int done = 0, size = 0;
+
+	while (!done) {
+		OFINCCLCHECK(nccl_net_ofi_test(req, &done, &size));
+	}
+	return ncclSuccess;
+}
+
+int main(int argc, char* argv[])
+{
+	ncclResult_t res = ncclSuccess;
+	int rank, size, peer;
+
+	int ndev, dev = 0;
+	void *sComm = NULL, *lComm = NULL, *rComm = NULL;
+	char src_handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	char handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+
+	char *write_src = NULL, *write_dst = NULL, *read_src = NULL, *read_dst = NULL;
+	void *write_src_mh = NULL, *write_dst_mh = NULL, *read_src_mh = NULL, *read_dst_mh = NULL;
+	batch_peer_bufs_t local_bufs = {}, peer_bufs = {};
+	nccl_ofi_rma_desc_t descs[BATCH_NUM_OPS];
+
+	ofi_log_function = logger;
+
+	MPI_Init(&argc, &argv);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	peer = 1 - rank;
+
+	/* Read by the plugin during init */
+	setenv("OFI_NCCL_PROTOCOL", "RDMA", 1);
+	setenv("OFI_NCCL_MIN_STRIPE_SIZE", "4096", 1);
+	if (size != 2) {
+		NCCL_OFI_WARN("Expected two ranks but got %d. "
+			"The nccl_rma_batch functional test should be run with exactly two ranks.",
+			size);
+		res = ncclInvalidArgument;
+		goto exit;
+	}
+
+	OFINCCLCHECKGOTO(nccl_net_ofi_init(logger), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_devices(&ndev), res, exit);
+	NCCL_OFI_INFO(NCCL_INIT, "Received %d network devices", ndev);
+
+	OFINCCLCHECKGOTO(nccl_net_ofi_listen(dev, (void *)&handle, &lComm), res, exit);
+
+	MPI_Sendrecv(handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, peer, 0,
+		     src_handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, peer, 0,
+		     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+	while (sComm == NULL || rComm == NULL) {
+		if (sComm == NULL) {
+			OFINCCLCHECKGOTO(nccl_net_ofi_connect(dev, (void *)src_handle, &sComm), res, exit);
+		}
+		if (rComm == NULL) {
+			OFINCCLCHECKGOTO(nccl_net_ofi_accept(lComm, &rComm), res, exit);
+		}
+	}
+
+	/* Writes go from the send communicator to memory of the peer's
+	 * receive communicator, reads the other way around */
+	OFINCCLCHECKGOTO(allocate_buff((void **)&write_src, BATCH_BUF_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(allocate_buff((void **)&write_dst, BATCH_BUF_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(allocate_buff((void **)&read_src, BATCH_BUF_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(allocate_buff((void **)&read_dst, BATCH_BUF_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_regMr(sComm, write_src, BATCH_BUF_SIZE, NCCL_PTR_HOST, &write_src_mh), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_regMr(rComm, write_dst, BATCH_BUF_SIZE, NCCL_PTR_HOST, &write_dst_mh), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_regMr(sComm, read_src, BATCH_BUF_SIZE, NCCL_PTR_HOST, &read_src_mh), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_regMr(rComm, read_dst, BATCH_BUF_SIZE, NCCL_PTR_HOST, &read_dst_mh), res, exit);
+
+	local_bufs.write_dst = (uint64_t)(uintptr_t)write_dst;
+	local_bufs.read_src = (uint64_t)(uintptr_t)read_src;
+	OFINCCLCHECKGOTO(nccl_net_ofi_get_mr_key(write_dst_mh, &local_bufs.write_dst_key), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_get_mr_key(read_src_mh, &local_bufs.read_src_key), res, exit);
+
+	MPI_Sendrecv(&local_bufs, sizeof(local_bufs), MPI_CHAR, peer, 0,
+		     &peer_bufs, sizeof(peer_bufs), MPI_CHAR, peer, 0,
+		     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+	/* Descriptors without memory handle are rejected */
+	{
+		void *req = NULL;
+		nccl_ofi_rma_desc_t desc = { write_src, NULL, peer_bufs.write_dst,
+					     peer_bufs.write_dst_key, BATCH_OP_SIZE };
+		if (nccl_net_ofi_iwrite_batch(sComm, &desc, 1, &req) != ncclInvalidArgument ||
+		    req != NULL) {
+			NCCL_OFI_WARN("Write batch with NULL memory handle was not rejected");
+			res = ncclInternalError;
+			goto exit;
+		}
+	}
+
+	for (int round = 0; round < BATCH_ROUNDS; round++) {
+		void *req = NULL;
+
+		fill_buff(write_src, rank, round, false);
+		fill_buff(read_src, rank, round, true);
+		memset(write_dst, 0, BATCH_BUF_SIZE);
+		memset(read_dst, 0, BATCH_BUF_SIZE);
+		MPI_Barrier(MPI_COMM_WORLD);
+
+		/* Remote offsets in reverse order of the local ones */
+		for (int i = 0; i < BATCH_NUM_OPS; i++) {
+			int j = BATCH_NUM_OPS - 1 - i;
+			descs[i].local = write_src + (size_t)j * BATCH_OP_SIZE;
+			descs[i].mhandle = write_src_mh;
+			descs[i].remote = peer_bufs.write_dst + (uint64_t)j * BATCH_OP_SIZE;
+			descs[i].mr_key = peer_bufs.write_dst_key;
+			descs[i].size = BATCH_OP_SIZE;
+		}
+		while (req == NULL) {
+			OFINCCLCHECKGOTO(nccl_net_ofi_iwrite_batch(sComm, descs, BATCH_NUM_OPS, &req), res, exit);
+		}
+		OFINCCLCHECKGOTO(wait_req(req), res, exit);
+
+		req = NULL;
+		for (int i = 0; i < BATCH_NUM_OPS; i++) {
+			descs[i].local = read_dst + (size_t)i * BATCH_OP_SIZE;
+			descs[i].mhandle = read_dst_mh;
+			descs[i].remote = peer_bufs.read_src + (uint64_t)i * BATCH_OP_SIZE;
+			descs[i].mr_key = peer_bufs.read_src_key;
+			descs[i].size = BATCH_OP_SIZE;
+		}
+		while (req == NULL) {
+			OFINCCLCHECKGOTO(nccl_net_ofi_iread_batch(rComm, descs, BATCH_NUM_OPS, &req), res, exit);
+		}
+		OFINCCLCHECKGOTO(wait_req(req), res, exit);
+
+		/* The peer's writes into `write_dst' completed */
+		MPI_Barrier(MPI_COMM_WORLD);
+
+		OFINCCLCHECKGOTO(check_buff(write_dst, peer, round, false), res, exit);
+		OFINCCLCHECKGOTO(check_buff(read_dst, peer, round, true), res, exit);
+		NCCL_OFI_INFO(NCCL_NET, "Rank %d round %d passed", rank, round);
+	}
+
+	OFINCCLCHECKGOTO(nccl_net_ofi_deregMr(sComm, write_src_mh), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_deregMr(rComm, write_dst_mh), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_deregMr(sComm, read_src_mh), res, exit);
+	OFINCCLCHECKGOTO(nccl_net_ofi_deregMr(rComm, read_dst_mh), res, exit);
+
+	OFINCCLCHECKGOTO(nccl_net_ofi_closeListen(lComm), res, exit);
+	lComm = NULL;
+	OFINCCLCHECKGOTO(nccl_net_ofi_closeSend(sComm), res, exit);
+	sComm = NULL;
+	OFINCCLCHECKGOTO(nccl_net_ofi_closeRecv(rComm), res, exit);
+	rComm = NULL;
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Finalize();
+	NCCL_OFI_INFO(NCCL_NET, "Test completed successfully for rank %d", rank);
+
+exit:
+	if (write_src) {
+		deallocate_buffer(write_src, NCCL_PTR_HOST);
+	}
+	if (write_dst) {
+		deallocate_buffer(write_dst, NCCL_PTR_HOST);
+	}
+	if (read_src) {
+		deallocate_buffer(read_src, NCCL_PTR_HOST);
+	}
+	if (read_dst) {
+		deallocate_buffer(read_dst, NCCL_PTR_HOST);
+	}
+
+	return res;
+}
@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+/*
+ * Host-only scale test
+ *
+ * Creates a growing number of loopback communicator pairs inside a
+ * single process and drives randomized traffic over them, to observe
+ * memory and CPU behavior of the plugin at communicator counts that
+ * are hard to reproduce with real jobs. Each worker thread uses its
+ * own plugin endpoint and owns an equal share of the pairs; every
+ * pair is one listen/connect/accept sequence on the selected device.
+ *
+ * No MPI or GPU is required. Run against any provider that supports
+ * loopback, e.g. FI_PROVIDER=tcp, or against the real provider on a
+ * single host.
+ *
+ * For every step the test reports the connection setup rate, resident
+ * memory growth per pair, libfabric memory registrations issued by the
+ * plugin during the step and still registered after it, including the
+ * plugin's internal ones, and process CPU time per message.
+ *
+ * Usage: nccl_scale [-n pairs[,pairs...]] [-t threads] [-m messages]
+ *                   [-w window] [-s max_size] [-d dev]
+ */
+
+#include "config.h"
+
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "test-common.h"
+
+#define DEFAULT_STEPS		"16,64,256,1024,4096"
+#define DEFAULT_THREADS		(1)
+#define DEFAULT_MESSAGES	(10000)
+#define DEFAULT_WINDOW		(16)
+#define DEFAULT_MAX_SIZE	(64 * 1024)
+
+typedef struct {
+	void *s_comm;
+	void *r_comm;
+	char *send_buf;
+	char *recv_buf;
+	void *s_mhandle;
+	void *r_mhandle;
+} scale_pair_t;
+
+typedef enum {
+	SCALE_PHASE_CONNECT,
+	SCALE_PHASE_TRAFFIC,
+	SCALE_PHASE_CLOSE,
+	SCALE_PHASE_EXIT,
+} scale_phase_t;
+
+typedef struct {
+	pthread_t thread;
+	unsigned int seed;
+	/* Number of pairs this thread should own after the connect phase */
+	size_t target_pairs;
+	std::vector<scale_pair_t> pairs;
+	uint64_t messages;
+	ncclResult_t res;
+} scale_thread_t;
+
+static test_nccl_net_t *extNet = NULL;
+
+typedef void (*mr_reg_counts_fn_t)(uint64_t *num_regs, uint64_t *num_live);
+static mr_reg_counts_fn_t mr_reg_counts = NULL;
+static int dev = 0;
+static size_t max_size = DEFAULT_MAX_SIZE;
+static size_t messages_per_step = DEFAULT_MESSAGES;
+static size_t window = DEFAULT_WINDOW;
+
+static scale_phase_t phase;
+static pthread_barrier_t start_barrier;
+static pthread_barrier_t done_barrier;
+
+static uint64_t clock_ns(clockid_t clock)
+{
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static size_t resident_bytes(void)
+{
+	size_t pages = 0, resident = 0;
+	FILE *statm = fopen("/proc/self/statm", "r");
+
+	if (statm == NULL) {
+		return 0;
+	}
+	if (fscanf(statm, "%zu %zu", &pages, &resident) != 2) {
+		resident = 0;
+	}
+	fclose(statm);
+
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+static ncclResult_t connect_pair(scale_pair_t *pair)
+{
+	ncclResult_t res = ncclSuccess;
+	char handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	void *l_comm = NULL;
+	test_nccl_net_device_handle_t *s_ignore, *r_ignore;
+
+	OFINCCLCHECK(extNet->listen(dev, (void *)handle, &l_comm));
+
+	while (pair->s_comm == NULL || pair->r_comm == NULL) {
+		if (pair->s_comm == NULL) {
+			OFINCCLCHECKGOTO(extNet->connect(dev, (void *)handle, &pair->s_comm, &s_ignore),
+					 res, exit);
+		}
+		if (pair->r_comm == NULL) {
+			OFINCCLCHECKGOTO(extNet->accept(l_comm, &pair->r_comm, &r_ignore), res, exit);
+		}
+	}
+
+	if (posix_memalign((void **)&pair->send_buf, sysconf(_SC_PAGESIZE), max_size) != 0 ||
+	    posix_memalign((void **)&pair->recv_buf, sysconf(_SC_PAGESIZE), max_size) != 0) {
+		NCCL_OFI_WARN("Failed to allocate buffers");
+		res = ncclSystemError;
+		goto exit;
+	}
+	memset(pair->send_buf, '1', max_size);
+
+	OFINCCLCHECKGOTO(extNet->regMr(pair->s_comm, pair->send_buf, max_size, NCCL_PTR_HOST,
+				       &pair->s_mhandle), res, exit);
+	OFINCCLCHECKGOTO(extNet->regMr(pair->r_comm, pair->recv_buf, max_size, NCCL_PTR_HOST,
+				       &pair->r_mhandle), res, exit);
+
+exit:
+	extNet->closeListen(l_comm);
+	return res;
+}
+
+static ncclResult_t close_pair(scale_pair_t *pair)
+{
+	if (pair->s_mhandle != NULL) {
+		OFINCCLCHECK(extNet->deregMr(pair->s_comm, pair->s_mhandle));
+	}
+	if (pair->r_mhandle != NULL) {
+		OFINCCLCHECK(extNet->deregMr(pair->r_comm, pair->r_mhandle));
+	}
+	if (pair->s_comm != NULL) {
+		OFINCCLCHECK(extNet->closeSend(pair->s_comm));
+	}
+	if (pair->r_comm != NULL) {
+		OFINCCLCHECK(extNet->closeRecv(pair->r_comm));
+	}
+	free(pair->send_buf);
+	free(pair->recv_buf);
+
+	return ncclSuccess;
+}
+
+/*
+ * Send one message of random size on each of `window' consecutive
+ * pairs starting at a random pair, and wait for all of them
+ */
+static ncclResult_t run_batch(scale_thread_t *ctx)
+{
+	size_t num_pairs = ctx->pairs.size();
+	size_t batch = std::min(window, num_pairs);
+	size_t first = rand_r(&ctx->seed) % num_pairs;
+	std::vector<void *> send_reqs(batch, NULL), recv_reqs(batch, NULL);
+	std::vector<size_t> sizes(batch);
+	size_t pending = 2 * batch;
+	int tag = 1;
+
+	for (size_t i = 0; i < batch; i++) {
+		scale_pair_t *pair = &ctx->pairs[(first + i) % num_pairs];
+		size_t recv_size = max_size;
+
+		sizes[i] = 1 + rand_r(&ctx->seed) % max_size;
+
+		while (recv_reqs[i] == NULL) {
+			OFINCCLCHECK(extNet->irecv(pair->r_comm, 1, (void **)&pair->recv_buf, &recv_size,
+						   &tag, &pair->r_mhandle, &recv_reqs[i]));
+		}
+		while (send_reqs[i] == NULL) {
+			OFINCCLCHECK(extNet->isend(pair->s_comm, pair->send_buf, sizes[i], tag,
+						   pair->s_mhandle, &send_reqs[i]));
+		}
+	}
+
+	while (pending > 0) {
+		for (size_t i = 0; i < batch; i++) {
+			int done = 0, size = 0;
+
+			if (send_reqs[i] != NULL) {
+				OFINCCLCHECK(extNet->test(send_reqs[i], &done, NULL));
+				if (done) {
+					send_reqs[i] = NULL;
+					pending--;
+				}
+			}
+			if (recv_reqs[i] != NULL) {
+				OFINCCLCHECK(extNet->test(recv_reqs[i], &done, &size));
+				if (done) {
+					if ((size_t)size != sizes[i]) {
+						NCCL_OFI_WARN("Received %d bytes, expected %zu", size, sizes[i]);
+						return ncclSystemError;
+					}
+					recv_reqs[i] = NULL;
+					pending--;
+				}
+			}
+		}
+	}
+
+	ctx->messages += batch;
+	return ncclSuccess;
+}
+
+static ncclResult_t run_phase(scale_thread_t *ctx)
+{
+	switch (phase) {
+	case SCALE_PHASE_CONNECT:
+		while (ctx->pairs.size() < ctx->target_pairs) {
+			ctx->pairs.push_back({});
+			OFINCCLCHECK(connect_pair(&ctx->pairs.back()));
+		}
+		break;
+	case SCALE_PHASE_TRAFFIC:
+		ctx->messages = 0;
+		while (!ctx->pairs.empty() && ctx->messages < messages_per_step) {
+			OFINCCLCHECK(run_batch(ctx));
+		}
+		break;
+	case SCALE_PHASE_CLOSE:
+		for (scale_pair_t &pair : ctx->pairs) {
+			OFINCCLCHECK(close_pair(&pair));
+		}
+		ctx->pairs.clear();
+		break;
+	case SCALE_PHASE_EXIT:
+		break;
+	}
+
+	return ncclSuccess;
+}
+
+static void *worker(void *arg)
+{
+	scale_thread_t *ctx = (scale_thread_t *)arg;
+
+	while (true) {
+		pthread_barrier_wait(&start_barrier);
+		if (phase == SCALE_PHASE_EXIT) {
+			break;
+		}
+		/* Pairs are closed even after a failure */
+		if (ctx->res == ncclSuccess || phase == SCALE_PHASE_CLOSE) {
+			ncclResult_t res = run_phase(ctx);
+			if (ctx->res == ncclSuccess) {
+				ctx->res = res;
+			}
+		}
+		pthread_barrier_wait(&done_barrier);
+	}
+
+	return NULL;
+}
+
+/* Run one phase on all workers and return the wall time in ns */
+static uint64_t run_all(scale_phase_t next_phase)
+{
+	uint64_t start = clock_ns(CLOCK_MONOTONIC);
+
+	phase = next_phase;
+	pthread_barrier_wait(&start_barrier);
+	if (next_phase != SCALE_PHASE_EXIT) {
+		pthread_barrier_wait(&done_barrier);
+	}
+
+	return clock_ns(CLOCK_MONOTONIC) - start;
+}
+
+/*
+ * Look up the registration counters of the plugin, which are not part
+ * of the net API
+ */
+static mr_reg_counts_fn_t get_mr_reg_counts(void)
+{
+	void *netPluginLib = dlopen("libnccl-net.so", RTLD_NOW | RTLD_LOCAL);
+	if (netPluginLib == NULL) {
+		NCCL_OFI_WARN("Unable to load libnccl-net.so: %s", dlerror());
+		return NULL;
+	}
+
+	mr_reg_counts_fn_t fn = (mr_reg_counts_fn_t)dlsym(netPluginLib, "nccl_ofi_mr_get_reg_counts");
+	if (fn == NULL) {
+		NCCL_OFI_WARN("NetPlugin, could not find nccl_ofi_mr_get_reg_counts symbol");
+	}
+
+	return fn;
+}
+
+int main(int argc, char *argv[])
+{
+	ncclResult_t res = ncclSuccess;
+	const char *steps_str = DEFAULT_STEPS;
+	size_t num_threads = DEFAULT_THREADS;
+	std::vector<size_t> steps;
+	std::vector<scale_thread_t> threads;
+	size_t prev_pairs = 0;
+	int opt;
+
+	ofi_log_function = logger;
+
+	while ((opt = getopt(argc, argv, "n:t:m:w:s:d:")) != -1) {
+		switch (opt) {
+		case 'n':
+			steps_str = optarg;
+			break;
+		case 't':
+			num_threads = strtoul(optarg, NULL, 0);
+			break;
+		case 'm':
+			messages_per_step = strtoul(optarg, NULL, 0);
+			break;
+		case 'w':
+			window = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			max_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			dev = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-n pairs[,pairs...]] [-t threads] [-m messages] "
+				"[-w window] [-s max_size] [-d dev]\n", argv[0]);
+			return ncclInvalidArgument;
+		}
+	}
+
+	for (const char *p = steps_str; *p != '\0';) {
+		char *end;
+		size_t pairs = strtoul(p, &end, 0);
+		if (end == p || pairs <= prev_pairs) {
+			NCCL_OFI_WARN("Pair counts must be increasing: %s", steps_str);
+			return ncclInvalidArgument;
+		}
+		steps.push_back(pairs);
+		prev_pairs = pairs;
+		p = (*end == ',') ? end + 1 : end;
+	}
+	if (num_threads == 0 || window == 0 || max_size == 0 || max_size > INT_MAX) {
+		NCCL_OFI_WARN("Invalid thread count, window or message size");
+		return ncclInvalidArgument;
+	}
+
+	extNet = get_extNet();
+	mr_reg_counts = get_mr_reg_counts();
+	if (extNet == NULL || mr_reg_counts == NULL) {
+		return ncclInternalError;
+	}
+	OFINCCLCHECK(extNet->init(logger));
+
+	test_nccl_properties_t props = {};
+	OFINCCLCHECK(extNet->getProperties(dev, &props));
+	print_dev_props(dev, &props);
+	if (props.maxComms > 0 && 2 * steps.back() > (size_t)props.maxComms) {
+		NCCL_OFI_WARN("%zu pairs exceed the %d comms supported by device %d",
+			      steps.back(), props.maxComms, dev);
+	}
+
+	pthread_barrier_init(&start_barrier, NULL, num_threads + 1);
+	pthread_barrier_init(&done_barrier, NULL, num_threads + 1);
+
+	threads.resize(num_threads);
+	for (size_t t = 0; t < num_threads; t++) {
+		threads[t].seed = t + 1;
+		threads[t].res = ncclSuccess;
+		if (pthread_create(&threads[t].thread, NULL, worker, &threads[t]) != 0) {
+			NCCL_OFI_WARN("Failed to create worker thread");
+			return ncclSystemError;
+		}
+	}
+
+	printf("%10s %8s %14s %12s %14s %14s %12s %14s %14s\n",
+	       "pairs", "threads", "setup/s", "rss_MiB", "rss_KiB/pair",
+	       "registrations", "live_mrs", "cpu_ns/msg", "msgs/s");
+
+	prev_pairs = 0;
+	for (size_t pairs : steps) {
+		size_t rss_before = resident_bytes();
+		uint64_t regs_before, regs_after, live_mrs;
+		mr_reg_counts(&regs_before, &live_mrs);
+
+		for (size_t t = 0; t < num_threads; t++) {
+			threads[t].target_pairs = pairs / num_threads + (t < pairs % num_threads ? 1 : 0);
+		}
+		uint64_t setup_ns = run_all(SCALE_PHASE_CONNECT);
+		size_t rss_after = resident_bytes();
+
+		uint64_t cpu_start = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+		uint64_t traffic_ns = run_all(SCALE_PHASE_TRAFFIC);
+		uint64_t cpu_ns = clock_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu_start;
+		mr_reg_counts(&regs_after, &live_mrs);
+
+		uint64_t messages = 0;
+		for (scale_thread_t &ctx : threads) {
+			if (ctx.res != ncclSuccess) {
+				res = ctx.res;
+			}
+			messages += ctx.messages;
+		}
+		if (res != ncclSuccess) {
+			NCCL_OFI_WARN("Scale step with %zu pairs failed: %d", pairs, res);
+			break;
+		}
+
+		size_t new_pairs = pairs - prev_pairs;
+		printf("%10zu %8zu %14.1f %12.1f %14.1f %14" PRIu64 " %12" PRIu64 " %14.1f %14.1f\n",
+		       pairs, num_threads,
+		       new_pairs * 1e9 / setup_ns,
+		       rss_after / (1024.0 * 1024.0),
+		       ((double)rss_after - (double)rss_before) / 1024.0 / new_pairs,
+		       regs_after - regs_before, live_mrs,
+		       messages ? (double)cpu_ns / messages : 0.0,
+		       messages * 1e9 / traffic_ns);
+		fflush(stdout);
+		prev_pairs = pairs;
+	}
+
+	run_all(SCALE_PHASE_CLOSE);
+	for (scale_thread_t &ctx : threads) {
+		if (ctx.res != ncclSuccess) {
+			res = ctx.res;
+		}
+	}
+	run_all(SCALE_PHASE_EXIT);
+	for (scale_thread_t &ctx : threads) {
+		pthread_join(ctx.thread, NULL);
+	}
+	pthread_barrier_destroy(&start_barrier);
+	pthread_barrier_destroy(&done_barrier);
+
+	if (res == ncclSuccess) {
+		NCCL_OFI_INFO(NCCL_NET, "Test completed successfully");
+	}
+
+	return res;
+}
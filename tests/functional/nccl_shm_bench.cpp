@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+/*
+ * This benchmark measures the ping-pong latency and bandwidth of SENDRECV
+ * communicators between two ranks of the same host, over the
+ * shared-memory transport (SHM_TRANSPORT) by default, or over the NIC
+ * loopback path with the "nic" argument. Run it both ways to compare
+ * the two transports.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test-common.h"
+
+#define BENCH_MIN_SIZE	(8)
+#define BENCH_MAX_SIZE	(4 * 1024 * 1024)
+#define BENCH_WARMUP	(10)
+#define BENCH_ITERS	(100)
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Post a request and wait for its completion
+ */
+static ncclResult_t transfer(test_nccl_net_t *extNet, nccl_net_ofi_send_comm_t *sComm,
+			     nccl_net_ofi_recv_comm_t *rComm, bool is_send, void *buf,
+			     size_t size, void *mhandle)
+{
+	ncclResult_t res = ncclSuccess;
+	nccl_net_ofi_req_t *req = NULL;
+	int tag = 1, nrecv = 1;
+	size_t sizes[1] = {size};
+	int tags[1] = {tag};
+	int done = 0, received_size;
+
+	while (req == NULL) {
+		if (is_send) {
+			OFINCCLCHECKGOTO(extNet->isend((void *)sComm, buf, size, tag, mhandle,
+						       (void **)&req), res, exit);
+		} else {
+			OFINCCLCHECKGOTO(extNet->irecv((void *)rComm, nrecv, &buf, sizes, tags,
+						       &mhandle, (void **)&req), res, exit);
+		}
+	}
+
+	while (!done) {
+		OFINCCLCHECKGOTO(extNet->test((void *)req, &done, &received_size), res, exit);
+	}
+
+ exit:
+	return res;
+}
+
+int main(int argc, char* argv[])
+{
+	ncclResult_t res = ncclSuccess;
+	int rank, size;
+	bool use_nic = (argc > 1 && strcmp(argv[1], "nic") == 0);
+
+	/* Plugin defines */
+	int ndev, dev = 0;
+	nccl_net_ofi_send_comm_t *sComm = NULL;
+	nccl_net_ofi_listen_comm_t *lComm = NULL;
+	nccl_net_ofi_recv_comm_t *rComm = NULL;
+	test_nccl_net_device_handle_t *s_ignore, *r_ignore;
+	char src_handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	char handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	test_nccl_net_t *extNet = NULL;
+
+	void *send_mhandle = NULL, *recv_mhandle = NULL;
+	char *send_buf = NULL, *recv_buf = NULL;
+	char name[MPI_MAX_PROCESSOR_NAME] = {};
+	char peer_name[MPI_MAX_PROCESSOR_NAME] = {};
+	int name_len;
+
+	ofi_log_function = logger;
+
+	MPI_Init(&argc, &argv);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	/* Read by the plugin during init */
+	setenv("OFI_NCCL_PROTOCOL", "SENDRECV", 1);
+	setenv("OFI_NCCL_SHM_TRANSPORT", use_nic ? "0" : "1", 1);
+	if (size != 2) {
+		NCCL_OFI_WARN("Expected two ranks but got %d. "
+			"The nccl_shm_bench functional test should be run with exactly two ranks.",
+			size);
+		res = ncclInvalidArgument;
+		goto exit;
+	}
+
+	MPI_Get_processor_name(name, &name_len);
+	MPI_Sendrecv(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, 1 - rank, 0,
+		     peer_name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, 1 - rank, 0,
+		     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+	if (strcmp(name, peer_name) != 0) {
+		NCCL_OFI_WARN("Ranks run on %s and %s. "
+			"The nccl_shm_bench functional test should be run on a single host.",
+			name, peer_name);
+		res = ncclInvalidArgument;
+		goto exit;
+	}
+
+	/* Get external Network from NCCL-OFI library */
+	extNet = get_extNet();
+	if (extNet == NULL) {
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	/* Init API */
+	OFINCCLCHECKGOTO(extNet->init(logger), res, exit);
+
+	/* Devices API */
+	OFINCCLCHECKGOTO(extNet->devices(&ndev), res, exit);
+	NCCL_OFI_INFO(NCCL_INIT, "Received %d network devices", ndev);
+
+	/* Listen API */
+	OFINCCLCHECKGOTO(extNet->listen(dev, (void *)&handle, (void **)&lComm), res, exit);
+
+	MPI_Sendrecv(handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, 1 - rank, 0,
+		     src_handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, 1 - rank, 0,
+		     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+	while (sComm == NULL || rComm == NULL) {
+		/* Connect API */
+		if (sComm == NULL) {
+			OFINCCLCHECKGOTO(extNet->connect(dev, (void *)src_handle, (void **)&sComm, &s_ignore), res, exit);
+		}
+
+		/* Accept API */
+		if (rComm == NULL) {
+			OFINCCLCHECKGOTO(extNet->accept((void *)lComm, (void **)&rComm, &r_ignore), res, exit);
+		}
+	}
+
+	OFINCCLCHECKGOTO(allocate_buff((void **)&send_buf, BENCH_MAX_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(initialize_buff((void *)send_buf, BENCH_MAX_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(allocate_buff((void **)&recv_buf, BENCH_MAX_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(extNet->regMr((void *)sComm, (void *)send_buf, BENCH_MAX_SIZE,
+				       NCCL_PTR_HOST, &send_mhandle), res, exit);
+	OFINCCLCHECKGOTO(extNet->regMr((void *)rComm, (void *)recv_buf, BENCH_MAX_SIZE,
+				       NCCL_PTR_HOST, &recv_mhandle), res, exit);
+
+	if (rank == 0) {
+		printf("Transport: %s\n", use_nic ? "NIC loopback" : "shared memory");
+		printf("%12s %14s %14s\n", "Size (B)", "Latency (us)", "BW (MB/s)");
+	}
+
+	for (size_t msg_size = BENCH_MIN_SIZE; msg_size <= BENCH_MAX_SIZE; msg_size *= 2) {
+		double start = 0.0;
+
+		MPI_Barrier(MPI_COMM_WORLD);
+		for (int iter = 0; iter < BENCH_WARMUP + BENCH_ITERS; iter++) {
+			if (iter == BENCH_WARMUP) {
+				start = now_sec();
+			}
+
+			/* Rank 0 sends first, rank 1 answers */
+			for (int turn = 0; turn < 2; turn++) {
+				bool is_send = (turn == rank);
+				OFINCCLCHECKGOTO(transfer(extNet, sComm, rComm, is_send,
+							  is_send ? send_buf : recv_buf, msg_size,
+							  is_send ? send_mhandle : recv_mhandle), res, exit);
+			}
+		}
+
+		/* Half of a round trip */
+		double latency = (now_sec() - start) / BENCH_ITERS / 2;
+		if (rank == 0) {
+			printf("%12zu %14.2f %14.1f\n", msg_size, latency * 1e6,
+			       (double)msg_size / latency / 1e6);
+		}
+	}
+
+	OFINCCLCHECKGOTO(validate_data(recv_buf, send_buf, BENCH_MAX_SIZE, NCCL_PTR_HOST), res, exit);
+
+	OFINCCLCHECKGOTO(extNet->deregMr((void *)sComm, send_mhandle), res, exit);
+	OFINCCLCHECKGOTO(extNet->deregMr((void *)rComm, recv_mhandle), res, exit);
+
+	OFINCCLCHECKGOTO(extNet->closeListen((void *)lComm), res, exit);
+	lComm = NULL;
+	OFINCCLCHECKGOTO(extNet->closeSend((void *)sComm), res, exit);
+	sComm = NULL;
+	OFINCCLCHECKGOTO(extNet->closeRecv((void *)rComm), res, exit);
+	rComm = NULL;
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Finalize();
+	NCCL_OFI_INFO(NCCL_NET, "Test completed successfully for rank %d", rank);
+
+exit:
+	if (send_buf) {
+		deallocate_buffer(send_buf, NCCL_PTR_HOST);
+	}
+	if (recv_buf) {
+		deallocate_buffer(recv_buf, NCCL_PTR_HOST);
+	}
+
+	return res;
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+/*
+ * This test measures the bandwidth of striped RDMA sends, then injects
+ * errors into their writes through the control file and checks that
+ * the messages are still delivered intact and that the bandwidth stays
+ * above a fraction of the error-free one. Error injection is only
+ * honored by debug builds of the plugin.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "test-common.h"
+
+#define RETRY_MSG_SIZE	(1024 * 1024)
+#define RETRY_ROUNDS	(10)
+/* Minimum bandwidth with injected errors, relative to the baseline */
+#define RETRY_MIN_BW_RATIO	(0.5)
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int write_control_file(const char *path, const char *contents)
+{
+	FILE *file = fopen(path, "w");
+	if (file == NULL || fputs(contents, file) < 0 || fclose(file) != 0) {
+		NCCL_OFI_WARN("Unable to write control file %s", path);
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	ncclResult_t res = ncclSuccess;
+	int rank, size;
+
+	/* Plugin defines */
+	int ndev, dev = 0;
+	nccl_net_ofi_send_comm_t *sComm = NULL;
+	nccl_net_ofi_listen_comm_t *lComm = NULL;
+	nccl_net_ofi_recv_comm_t *rComm = NULL;
+	test_nccl_net_device_handle_t *s_ignore, *r_ignore;
+	char src_handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	char handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	test_nccl_net_t *extNet = NULL;
+
+	nccl_net_ofi_req_t *req[NUM_REQUESTS] = {NULL};
+	void *mhandle[NUM_REQUESTS] = {NULL};
+	char *buf[NUM_REQUESTS] = {NULL};
+	char *expected_buf = NULL;
+	int tag = 1, nrecv = 1;
+	size_t sizes[1] = {RETRY_MSG_SIZE};
+	int tags[1] = {tag};
+	int done, received_size;
+	char control_file[64];
+	double elapsed[2] = {0.0, 0.0};
+
+	ofi_log_function = logger;
+
+	MPI_Init(&argc, &argv);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	/* Errors are enabled through the control file after the baseline */
+	snprintf(control_file, sizeof(control_file), "/tmp/nccl-ofi-stripe-retry-%d", (int)getpid());
+	unlink(control_file);
+	setenv("OFI_NCCL_CONTROL_FILE", control_file, 1);
+	setenv("OFI_NCCL_CONTROL_FILE_INTERVAL_MS", "10", 1);
+	if (size != 2) {
+		NCCL_OFI_WARN("Expected two ranks but got %d. "
+			"The nccl_stripe_retry functional test should be run with exactly two ranks.",
+			size);
+		res = ncclInvalidArgument;
+		goto exit;
+	}
+
+	/* Get external Network from NCCL-OFI library */
+	extNet = get_extNet();
+	if (extNet == NULL) {
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	/* Init API */
+	OFINCCLCHECKGOTO(extNet->init(logger), res, exit);
+
+	/* Devices API */
+	OFINCCLCHECKGOTO(extNet->devices(&ndev), res, exit);
+	NCCL_OFI_INFO(NCCL_INIT, "Received %d network devices", ndev);
+
+	/* Listen API */
+	OFINCCLCHECKGOTO(extNet->listen(dev, (void *)&handle, (void **)&lComm), res, exit);
+
+	MPI_Sendrecv(handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, 1 - rank, 0,
+		     src_handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, 1 - rank, 0,
+		     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+	while (sComm == NULL || rComm == NULL) {
+		/* Connect API */
+		if (sComm == NULL) {
+			OFINCCLCHECKGOTO(extNet->connect(dev, (void *)src_handle, (void **)&sComm, &s_ignore), res, exit);
+		}
+
+		/* Accept API */
+		if (rComm == NULL) {
+			OFINCCLCHECKGOTO(extNet->accept((void *)lComm, (void **)&rComm, &r_ignore), res, exit);
+		}
+	}
+
+	OFINCCLCHECKGOTO(allocate_buff((void **)&expected_buf, RETRY_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(initialize_buff((void *)expected_buf, RETRY_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+
+	for (int idx = 0; idx < NUM_REQUESTS; idx++) {
+		OFINCCLCHECKGOTO(allocate_buff((void **)&buf[idx], RETRY_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+		if (rank == 0) {
+			OFINCCLCHECKGOTO(initialize_buff((void *)buf[idx], RETRY_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+			OFINCCLCHECKGOTO(extNet->regMr((void *)sComm, (void *)buf[idx], RETRY_MSG_SIZE,
+						       NCCL_PTR_HOST, &mhandle[idx]), res, exit);
+		} else {
+			OFINCCLCHECKGOTO(extNet->regMr((void *)rComm, (void *)buf[idx], RETRY_MSG_SIZE,
+						       NCCL_PTR_HOST, &mhandle[idx]), res, exit);
+		}
+	}
+
+	/* Round 0 warms up, baseline rounds follow, then rounds with
+	 * one write out of seven failing */
+	for (int round = 0; round < 2 * RETRY_ROUNDS + 1; round++) {
+		int inflight_reqs = NUM_REQUESTS;
+		bool inject = (round > RETRY_ROUNDS);
+
+		if (round == RETRY_ROUNDS + 1) {
+			if (write_control_file(control_file, "OFI_NCCL_INJECT_STRIPE_ERRORS=7\n") != 0) {
+				res = ncclSystemError;
+				goto exit;
+			}
+			/* Let the watcher apply it */
+			usleep(200 * 1000);
+			MPI_Barrier(MPI_COMM_WORLD);
+		}
+
+		double start = now_sec();
+
+		for (int idx = 0; idx < NUM_REQUESTS; idx++) {
+			req[idx] = NULL;
+			while (req[idx] == NULL) {
+				if (rank == 0) {
+					OFINCCLCHECKGOTO(extNet->isend((void *)sComm, (void *)buf[idx], RETRY_MSG_SIZE,
+								       tag, mhandle[idx], (void **)&req[idx]), res, exit);
+				} else {
+					OFINCCLCHECKGOTO(extNet->irecv((void *)rComm, nrecv, (void **)&buf[idx], sizes,
+								       tags, &mhandle[idx], (void **)&req[idx]), res, exit);
+				}
+			}
+		}
+
+		/* Test for completions */
+		while (inflight_reqs > 0) {
+			for (int idx = 0; idx < NUM_REQUESTS; idx++) {
+				if (req[idx] == NULL)
+					continue;
+
+				OFINCCLCHECKGOTO(extNet->test((void *)req[idx], &done, &received_size), res, exit);
+				if (!done)
+					continue;
+
+				inflight_reqs--;
+				req[idx] = NULL;
+				if (rank == 1) {
+					if (received_size != RETRY_MSG_SIZE) {
+						NCCL_OFI_WARN("Wrong received size %d", received_size);
+						res = ncclInternalError;
+						goto exit;
+					}
+					OFINCCLCHECKGOTO(validate_data(buf[idx], expected_buf, RETRY_MSG_SIZE,
+								       NCCL_PTR_HOST), res, exit);
+				}
+			}
+		}
+
+		double round_time = now_sec() - start;
+		NCCL_OFI_INFO(NCCL_NET, "Rank %d round %d%s: %.1f MB/s", rank, round,
+			      inject ? " with errors" : "",
+			      (double)NUM_REQUESTS * RETRY_MSG_SIZE / round_time / 1e6);
+		if (round > 0) {
+			elapsed[inject] += round_time;
+		}
+		MPI_Barrier(MPI_COMM_WORLD);
+	}
+
+	/* Both phases moved the same amount of data */
+	NCCL_OFI_INFO(NCCL_NET, "Rank %d: %.1f MB/s without errors, %.1f MB/s with errors", rank,
+		      (double)RETRY_ROUNDS * NUM_REQUESTS * RETRY_MSG_SIZE / elapsed[0] / 1e6,
+		      (double)RETRY_ROUNDS * NUM_REQUESTS * RETRY_MSG_SIZE / elapsed[1] / 1e6);
+	if (elapsed[0] < RETRY_MIN_BW_RATIO * elapsed[1]) {
+		NCCL_OFI_WARN("Bandwidth with errors below %.0f%% of the baseline",
+			      RETRY_MIN_BW_RATIO * 100);
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	for (int idx = 0; idx < NUM_REQUESTS; idx++) {
+		if (rank == 0) {
+			OFINCCLCHECKGOTO(extNet->deregMr((void *)sComm, mhandle[idx]), res, exit);
+		} else {
+			OFINCCLCHECKGOTO(extNet->deregMr((void *)rComm, mhandle[idx]), res, exit);
+		}
+	}
+
+	OFINCCLCHECKGOTO(extNet->closeListen((void *)lComm), res, exit);
+	lComm = NULL;
+	OFINCCLCHECKGOTO(extNet->closeSend((void *)sComm), res, exit);
+	sComm = NULL;
+	OFINCCLCHECKGOTO(extNet->closeRecv((void *)rComm), res, exit);
+	rComm = NULL;
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Finalize();
+	NCCL_OFI_INFO(NCCL_NET, "Test completed successfully for rank %d", rank);
+
+exit:
+	unlink(control_file);
+	for (int idx = 0; idx < NUM_REQUESTS; idx++) {
+		if (buf[idx]) {
+			deallocate_buffer(buf[idx], NCCL_PTR_HOST);
+		}
+	}
+	if (expected_buf) {
+		deallocate_buffer(expected_buf, NCCL_PTR_HOST);
+	}
+
+	return res;
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+/*
+ * This test fuses the devices of the node into a virtual device and
+ * transfers messages large enough to be striped across its rails
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include "test-common.h"
+
+#define VDEV_MSG_SIZE	(1024 * 1024)
+
+int main(int argc, char* argv[])
+{
+	ncclResult_t res = ncclSuccess;
+	int rank, size;
+
+	/* Plugin defines */
+	int ndev, vdev = -1;
+	nccl_net_ofi_send_comm_t *sComm = NULL;
+	nccl_net_ofi_listen_comm_t *lComm = NULL;
+	nccl_net_ofi_recv_comm_t *rComm = NULL;
+	test_nccl_net_device_handle_t *s_ignore, *r_ignore;
+	char src_handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	char handle[NCCL_NET_HANDLE_MAXSIZE] = {};
+	test_nccl_net_t *extNet = NULL;
+	ncclNetVDeviceProps_v9_t vprops = {};
+	test_nccl_properties_t props = {};
+
+	nccl_net_ofi_req_t *req[NUM_REQUESTS] = {NULL};
+	void *mhandle[NUM_REQUESTS] = {NULL};
+	char *buf[NUM_REQUESTS] = {NULL};
+	char *expected_buf = NULL;
+	int req_completed[NUM_REQUESTS] = {};
+	int inflight_reqs = NUM_REQUESTS;
+	int tag = 1, nrecv = 1;
+	size_t sizes[1] = {VDEV_MSG_SIZE};
+	int tags[1] = {tag};
+	int done, received_size;
+
+	ofi_log_function = logger;
+
+	MPI_Init(&argc, &argv);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	if (size != 2) {
+		NCCL_OFI_WARN("Expected two ranks but got %d. "
+			"The nccl_vdevice functional test should be run with exactly two ranks.",
+			size);
+		res = ncclInvalidArgument;
+		goto exit;
+	}
+
+	/* Get external Network from NCCL-OFI library */
+	extNet = get_extNet();
+	if (extNet == NULL) {
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	/* Init API */
+	OFINCCLCHECKGOTO(extNet->init(logger), res, exit);
+
+	/* Devices API */
+	OFINCCLCHECKGOTO(extNet->devices(&ndev), res, exit);
+	NCCL_OFI_INFO(NCCL_INIT, "Received %d network devices", ndev);
+
+	/* Fuse as many devices as a virtual device takes */
+	vprops.ndevs = std::min(ndev, NCCL_NET_MAX_DEVS_PER_NIC_V9);
+	for (int i = 0; i < vprops.ndevs; i++) {
+		vprops.devs[i] = i;
+	}
+
+	res = extNet->makeVDevice(&vdev, &vprops);
+	if (res == ncclInvalidUsage) {
+		NCCL_OFI_INFO(NCCL_NET, "Virtual devices are not supported, skipping test");
+		res = ncclSuccess;
+		MPI_Finalize();
+		goto exit;
+	} else if (res != ncclSuccess) {
+		NCCL_OFI_WARN("Unable to create virtual device of %d devices", vprops.ndevs);
+		goto exit;
+	}
+
+	OFINCCLCHECKGOTO(extNet->devices(&ndev), res, exit);
+	if (vdev != ndev - 1) {
+		NCCL_OFI_WARN("Virtual device %d is not the last of %d devices", vdev, ndev);
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	OFINCCLCHECKGOTO(extNet->getProperties(vdev, &props), res, exit);
+	print_dev_props(vdev, &props);
+	if (props.vProps.ndevs != vprops.ndevs) {
+		NCCL_OFI_WARN("Virtual device reports %d devices instead of %d",
+			      props.vProps.ndevs, vprops.ndevs);
+		res = ncclInternalError;
+		goto exit;
+	}
+	for (int i = 0; i < vprops.ndevs; i++) {
+		if (props.vProps.devs[i] != vprops.devs[i]) {
+			NCCL_OFI_WARN("Virtual device reports device %d instead of %d",
+				      props.vProps.devs[i], vprops.devs[i]);
+			res = ncclInternalError;
+			goto exit;
+		}
+	}
+
+	/* Virtual devices cannot be fused again */
+	{
+		ncclNetVDeviceProps_v9_t nested_vprops = {};
+		int nested_vdev = -1;
+
+		nested_vprops.ndevs = 1;
+		nested_vprops.devs[0] = vdev;
+		if (extNet->makeVDevice(&nested_vdev, &nested_vprops) == ncclSuccess) {
+			NCCL_OFI_WARN("Virtual device %d was fused into virtual device %d",
+				      vdev, nested_vdev);
+			res = ncclInternalError;
+			goto exit;
+		}
+	}
+
+	/* Listen API */
+	OFINCCLCHECKGOTO(extNet->listen(vdev, (void *)&handle, (void **)&lComm), res, exit);
+
+	MPI_Sendrecv(handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, 1 - rank, 0,
+		     src_handle, NCCL_NET_HANDLE_MAXSIZE, MPI_CHAR, 1 - rank, 0,
+		     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+	while (sComm == NULL || rComm == NULL) {
+		/* Connect API */
+		if (sComm == NULL) {
+			OFINCCLCHECKGOTO(extNet->connect(vdev, (void *)src_handle, (void **)&sComm, &s_ignore), res, exit);
+		}
+
+		/* Accept API */
+		if (rComm == NULL) {
+			OFINCCLCHECKGOTO(extNet->accept((void *)lComm, (void **)&rComm, &r_ignore), res, exit);
+		}
+	}
+	NCCL_OFI_INFO(NCCL_NET, "Rank %d connected on virtual device %d", rank, vdev);
+
+	OFINCCLCHECKGOTO(allocate_buff((void **)&expected_buf, VDEV_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+	OFINCCLCHECKGOTO(initialize_buff((void *)expected_buf, VDEV_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+
+	for (int idx = 0; idx < NUM_REQUESTS; idx++) {
+		OFINCCLCHECKGOTO(allocate_buff((void **)&buf[idx], VDEV_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+		if (rank == 0) {
+			OFINCCLCHECKGOTO(initialize_buff((void *)buf[idx], VDEV_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+			OFINCCLCHECKGOTO(extNet->regMr((void *)sComm, (void *)buf[idx], VDEV_MSG_SIZE,
+						       NCCL_PTR_HOST, &mhandle[idx]), res, exit);
+			while (req[idx] == NULL) {
+				OFINCCLCHECKGOTO(extNet->isend((void *)sComm, (void *)buf[idx], VDEV_MSG_SIZE,
+							       tag, mhandle[idx], (void **)&req[idx]), res, exit);
+			}
+		} else {
+			OFINCCLCHECKGOTO(extNet->regMr((void *)rComm, (void *)buf[idx], VDEV_MSG_SIZE,
+						       NCCL_PTR_HOST, &mhandle[idx]), res, exit);
+			while (req[idx] == NULL) {
+				OFINCCLCHECKGOTO(extNet->irecv((void *)rComm, nrecv, (void **)&buf[idx], sizes,
+							       tags, &mhandle[idx], (void **)&req[idx]), res, exit);
+			}
+		}
+	}
+
+	/* Test for completions */
+	while (inflight_reqs > 0) {
+		for (int idx = 0; idx < NUM_REQUESTS; idx++) {
+			if (req_completed[idx])
+				continue;
+
+			OFINCCLCHECKGOTO(extNet->test((void *)req[idx], &done, &received_size), res, exit);
+			if (!done)
+				continue;
+
+			inflight_reqs--;
+			req_completed[idx] = 1;
+			if (rank == 1) {
+				if (received_size != VDEV_MSG_SIZE) {
+					NCCL_OFI_WARN("Wrong received size %d", received_size);
+					res = ncclInternalError;
+					goto exit;
+				}
+				OFINCCLCHECKGOTO(validate_data(buf[idx], expected_buf, VDEV_MSG_SIZE,
+							       NCCL_PTR_HOST), res, exit);
+				OFINCCLCHECKGOTO(extNet->deregMr((void *)rComm, mhandle[idx]), res, exit);
+			} else {
+				OFINCCLCHECKGOTO(extNet->deregMr((void *)sComm, mhandle[idx]), res, exit);
+			}
+		}
+	}
+
+	MPI_Barrier(MPI_COMM_WORLD);
+
+	OFINCCLCHECKGOTO(extNet->closeListen((void *)lComm), res, exit);
+	lComm = NULL;
+	OFINCCLCHECKGOTO(extNet->closeSend((void *)sComm), res, exit);
+	sComm = NULL;
+	OFINCCLCHECKGOTO(extNet->closeRecv((void *)rComm), res, exit);
+	rComm = NULL;
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Finalize();
+	NCCL_OFI_INFO(NCCL_NET, "Test completed successfully for rank %d", rank);
+
+exit:
+	for (int idx = 0; idx < NUM_REQUESTS; idx++) {
+		if (buf[idx]) {
+			deallocate_buffer(buf[idx], NCCL_PTR_HOST);
+		}
+	}
+	if (expected_buf) {
+		deallocate_buffer(expected_buf, NCCL_PTR_HOST);
+	}
+
+	return res;
+}
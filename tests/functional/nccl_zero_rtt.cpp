@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+/*
+ * This test exercises RDMA send communicators returned before the
+ * connect handshake completes (RDMA_ZERO_RTT_CONNECT). Rank 0 opens two
+ * connections and issues eager and regular sends on both right away,
+ * so they are queued until the connect response arrives. Rank 1 accepts
+ * the connections in the opposite order, so the communicator IDs of the
+ * two sides differ and data only lands in the right receive
+ * communicator if the immediate data of the queued sends is rebuilt
+ * with the remote communicator ID. Rank 0 does not progress until rank
+ * 1 posted its receives, so the control messages of the receives are
+ * processed together with the connect responses. A third connection is
+ * closed by rank 0 before its handshake completes.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test-common.h"
+
+#define ZRTT_NUM_COMMS	(2)
+#define ZRTT_NUM_MSGS	(4)
+#define ZRTT_MSG_SIZE	(256 * 1024)
+/* Size of the first message of each communicator, sent eagerly */
+#define ZRTT_EAGER_SIZE	(64)
+
+static inline size_t msg_size(int msg)
+{
+	return (msg == 0) ? ZRTT_EAGER_SIZE : ZRTT_MSG_SIZE;
+}
+
+static inline char msg_pattern(int comm, int msg)
+{
+	return (char)('A' + comm * ZRTT_NUM_MSGS + msg);
+}
+
+int main(int argc, char* argv[])
+{
+	ncclResult_t res = ncclSuccess;
+	int rank, size;
+
+	/* Plugin defines */
+	int ndev, dev = 0;
+	nccl_net_ofi_send_comm_t *sComm[ZRTT_NUM_COMMS + 1] = {NULL};
+	nccl_net_ofi_listen_comm_t *lComm[ZRTT_NUM_COMMS + 1] = {NULL};
+	nccl_net_ofi_recv_comm_t *rComm[ZRTT_NUM_COMMS + 1] = {NULL};
+	test_nccl_net_device_handle_t *s_ignore, *r_ignore;
+	char handle[ZRTT_NUM_COMMS + 1][NCCL_NET_HANDLE_MAXSIZE] = {};
+	test_nccl_net_t *extNet = NULL;
+
+	nccl_net_ofi_req_t *req[ZRTT_NUM_COMMS][ZRTT_NUM_MSGS] = {};
+	void *mhandle[ZRTT_NUM_COMMS][ZRTT_NUM_MSGS] = {};
+	char *buf[ZRTT_NUM_COMMS][ZRTT_NUM_MSGS] = {};
+	int tag = 1, nrecv = 1;
+	int done, received_size, inflight_reqs;
+
+	ofi_log_function = logger;
+
+	MPI_Init(&argc, &argv);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	/* Read by the plugin during init */
+	setenv("OFI_NCCL_PROTOCOL", "RDMA", 1);
+	setenv("OFI_NCCL_RDMA_ZERO_RTT_CONNECT", "1", 1);
+	if (size != 2) {
+		NCCL_OFI_WARN("Expected two ranks but got %d. "
+			"The nccl_zero_rtt functional test should be run with exactly two ranks.",
+			size);
+		res = ncclInvalidArgument;
+		goto exit;
+	}
+
+	/* Get external Network from NCCL-OFI library */
+	extNet = get_extNet();
+	if (extNet == NULL) {
+		res = ncclInternalError;
+		goto exit;
+	}
+
+	/* Init API */
+	OFINCCLCHECKGOTO(extNet->init(logger), res, exit);
+
+	/* Devices API */
+	OFINCCLCHECKGOTO(extNet->devices(&ndev), res, exit);
+	NCCL_OFI_INFO(NCCL_INIT, "Received %d network devices", ndev);
+
+	/* Rank 1 listens, rank 0 connects */
+	if (rank == 1) {
+		for (int c = 0; c < ZRTT_NUM_COMMS + 1; c++) {
+			OFINCCLCHECKGOTO(extNet->listen(dev, (void *)handle[c], (void **)&lComm[c]), res, exit);
+		}
+		MPI_Send(handle, sizeof(handle), MPI_CHAR, 0, 0, MPI_COMM_WORLD);
+	} else {
+		MPI_Recv(handle, sizeof(handle), MPI_CHAR, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+	}
+
+	for (int c = 0; c < ZRTT_NUM_COMMS; c++) {
+		for (int m = 0; m < ZRTT_NUM_MSGS; m++) {
+			OFINCCLCHECKGOTO(allocate_buff((void **)&buf[c][m], ZRTT_MSG_SIZE, NCCL_PTR_HOST), res, exit);
+			memset(buf[c][m], (rank == 0) ? msg_pattern(c, m) : 0, ZRTT_MSG_SIZE);
+		}
+	}
+
+	if (rank == 0) {
+		/* The communicators are returned before the handshake
+		 * completes. Queue all sends right away. */
+		for (int c = 0; c < ZRTT_NUM_COMMS; c++) {
+			while (sComm[c] == NULL) {
+				OFINCCLCHECKGOTO(extNet->connect(dev, (void *)handle[c], (void **)&sComm[c], &s_ignore), res, exit);
+			}
+			for (int m = 0; m < ZRTT_NUM_MSGS; m++) {
+				OFINCCLCHECKGOTO(extNet->regMr((void *)sComm[c], (void *)buf[c][m], ZRTT_MSG_SIZE,
+							       NCCL_PTR_HOST, &mhandle[c][m]), res, exit);
+				while (req[c][m] == NULL) {
+					OFINCCLCHECKGOTO(extNet->isend((void *)sComm[c], (void *)buf[c][m], msg_size(m),
+								       tag, mhandle[c][m], (void **)&req[c][m]), res, exit);
+				}
+			}
+		}
+
+		/* Closed before its connect response is processed */
+		while (sComm[ZRTT_NUM_COMMS] == NULL) {
+			OFINCCLCHECKGOTO(extNet->connect(dev, (void *)handle[ZRTT_NUM_COMMS],
+							 (void **)&sComm[ZRTT_NUM_COMMS], &s_ignore), res, exit);
+		}
+		OFINCCLCHECKGOTO(extNet->closeSend((void *)sComm[ZRTT_NUM_COMMS]), res, exit);
+		sComm[ZRTT_NUM_COMMS] = NULL;
+
+		/* Wait for the receives of rank 1 without progressing */
+		MPI_Barrier(MPI_COMM_WORLD);
+	} else {
+		/* Accept in reverse order of the connections */
+		for (int c = ZRTT_NUM_COMMS; c >= 0; c--) {
+			while (rComm[c] == NULL) {
+				OFINCCLCHECKGOTO(extNet->accept((void *)lComm[c], (void **)&rComm[c], &r_ignore), res, exit);
+			}
+		}
+		OFINCCLCHECKGOTO(extNet->closeRecv((void *)rComm[ZRTT_NUM_COMMS]), res, exit);
+		rComm[ZRTT_NUM_COMMS] = NULL;
+
+		for (int c = 0; c < ZRTT_NUM_COMMS; c++) {
+			for (int m = 0; m < ZRTT_NUM_MSGS; m++) {
+				size_t sizes[1] = {ZRTT_MSG_SIZE};
+				int tags[1] = {tag};
+				OFINCCLCHECKGOTO(extNet->regMr((void *)rComm[c], (void *)buf[c][m], ZRTT_MSG_SIZE,
+							       NCCL_PTR_HOST, &mhandle[c][m]), res, exit);
+				while (req[c][m] == NULL) {
+					OFINCCLCHECKGOTO(extNet->irecv((void *)rComm[c], nrecv, (void **)&buf[c][m], sizes,
+								       tags, &mhandle[c][m], (void **)&req[c][m]), res, exit);
+				}
+			}
+		}
+
+		MPI_Barrier(MPI_COMM_WORLD);
+	}
+
+	/* Test for completions */
+	inflight_reqs = ZRTT_NUM_COMMS * ZRTT_NUM_MSGS;
+	while (inflight_reqs > 0) {
+		for (int c = 0; c < ZRTT_NUM_COMMS; c++) {
+			for (int m = 0; m < ZRTT_NUM_MSGS; m++) {
+				if (req[c][m] == NULL)
+					continue;
+
+				OFINCCLCHECKGOTO(extNet->test((void *)req[c][m], &done, &received_size), res, exit);
+				if (!done)
+					continue;
+
+				inflight_reqs--;
+				req[c][m] = NULL;
+				if (rank == 0)
+					continue;
+
+				if ((size_t)received_size != msg_size(m)) {
+					NCCL_OFI_WARN("Wrong size %d of message %d of communicator %d",
+						      received_size, m, c);
+					res = ncclInternalError;
+					goto exit;
+				}
+				for (size_t i = 0; i < msg_size(m); i++) {
+					if (buf[c][m][i] != msg_pattern(c, m)) {
+						NCCL_OFI_WARN("Message %d of communicator %d corrupted at byte %zu",
+							      m, c, i);
+						res = ncclInternalError;
+						goto exit;
+					}
+				}
+			}
+		}
+	}
+
+	for (int c = 0; c < ZRTT_NUM_COMMS; c++) {
+		for (int m = 0; m < ZRTT_NUM_MSGS; m++) {
+			if (rank == 0) {
+				OFINCCLCHECKGOTO(extNet->deregMr((void *)sComm[c], mhandle[c][m]), res, exit);
+			} else {
+				OFINCCLCHECKGOTO(extNet->deregMr((void *)rComm[c], mhandle[c][m]), res, exit);
+			}
+		}
+	}
+
+	for (int c = 0; c < ZRTT_NUM_COMMS + 1; c++) {
+		if (lComm[c] != NULL) {
+			OFINCCLCHECKGOTO(extNet->closeListen((void *)lComm[c]), res, exit);
+			lComm[c] = NULL;
+		}
+		if (sComm[c] != NULL) {
+			OFINCCLCHECKGOTO(extNet->closeSend((void *)sComm[c]), res, exit);
+			sComm[c] = NULL;
+		}
+		if (rComm[c] != NULL) {
+			OFINCCLCHECKGOTO(extNet->closeRecv((void *)rComm[c]), res, exit);
+			rComm[c] = NULL;
+		}
+	}
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Finalize();
+	NCCL_OFI_INFO(NCCL_NET, "Test completed successfully for rank %d", rank);
+
+exit:
+	for (int c = 0; c < ZRTT_NUM_COMMS; c++) {
+		for (int m = 0; m < ZRTT_NUM_MSGS; m++) {
+			if (buf[c][m]) {
+				deallocate_buffer(buf[c][m], NCCL_PTR_HOST);
+			}
+		}
+	}
+
+	return res;
+}
@@ -4,7 +4,9 @@
 
 #include "config.h"
 
+#include <pthread.h>
 #include <stdio.h>
+#include <vector>
 
 #include "test-common.h"
 #include "nccl_ofi_deque.h"
@@ -30,6 +32,163 @@
 	} \
 }
 
+#define MPSC_NUM_PRODUCERS (4)
+#define MPSC_ELEMS_PER_PRODUCER (100000)
+
+struct mpsc_elem_t {
+	nccl_ofi_mpsc_queue_elem_t qe;
+	int producer;
+	int seq;
+};
+
+struct mpsc_producer_arg_t {
+	nccl_ofi_mpsc_queue_t *queue;
+	mpsc_elem_t *elems;
+};
+
+static void *mpsc_producer(void *arg)
+{
+	mpsc_producer_arg_t *producer_arg = static_cast<mpsc_producer_arg_t *>(arg);
+
+	for (int i = 0; i < MPSC_ELEMS_PER_PRODUCER; ++i) {
+		nccl_ofi_mpsc_queue_push(producer_arg->queue, &producer_arg->elems[i].qe);
+	}
+
+	return NULL;
+}
+
+/*
+ * Single-threaded ordering checks of the MPSC queue
+ */
+static void test_mpsc_queue_basic()
+{
+	const int num_elem = 8;
+	mpsc_elem_t elems[num_elem];
+	nccl_ofi_mpsc_queue_elem_t *qe;
+	nccl_ofi_mpsc_queue_t *queue;
+
+	if (nccl_ofi_mpsc_queue_init(&queue) != 0) {
+		NCCL_OFI_WARN("mpsc_queue_init failed");
+		exit(1);
+	}
+
+	if (!nccl_ofi_mpsc_queue_isempty(queue)) {
+		NCCL_OFI_WARN("new queue is not empty");
+		exit(1);
+	}
+	nccl_ofi_mpsc_queue_pop(queue, &qe);
+	if (qe != NULL) {
+		NCCL_OFI_WARN("pop from empty queue unexpectedly succeeded");
+		exit(1);
+	}
+
+	/* Push front on an empty queue, then FIFO behind it */
+	for (int i = 0; i < num_elem; ++i) {
+		elems[i].seq = i;
+	}
+	nccl_ofi_mpsc_queue_push_front(queue, &elems[0].qe);
+	for (int i = 1; i < num_elem; ++i) {
+		nccl_ofi_mpsc_queue_push(queue, &elems[i].qe);
+	}
+
+	for (int i = 0; i < num_elem; ++i) {
+		nccl_ofi_mpsc_queue_pop(queue, &qe);
+		if (qe == NULL) {
+			NCCL_OFI_WARN("pop unexpectedly failed");
+			exit(1);
+		}
+		int v = container_of(qe, mpsc_elem_t, qe)->seq;
+		if (v != i) {
+			NCCL_OFI_WARN("pop bad result; expected %d but got %d", i, v);
+			exit(1);
+		}
+		/* Retry every other element once */
+		if (i % 2 == 0) {
+			nccl_ofi_mpsc_queue_push_front(queue, qe);
+			nccl_ofi_mpsc_queue_pop(queue, &qe);
+			if (qe == NULL || container_of(qe, mpsc_elem_t, qe)->seq != i) {
+				NCCL_OFI_WARN("pop after push_front returned wrong element");
+				exit(1);
+			}
+		}
+	}
+
+	if (!nccl_ofi_mpsc_queue_isempty(queue)) {
+		NCCL_OFI_WARN("drained queue is not empty");
+		exit(1);
+	}
+
+	nccl_ofi_mpsc_queue_finalize(queue);
+}
+
+/*
+ * Concurrent producers and a consumer that pushes back to the front
+ * regularly. Every element must be popped exactly once, and elements of
+ * a single producer must be popped in push order.
+ */
+static void test_mpsc_queue_stress()
+{
+	nccl_ofi_mpsc_queue_t *queue;
+	pthread_t threads[MPSC_NUM_PRODUCERS];
+	mpsc_producer_arg_t args[MPSC_NUM_PRODUCERS];
+	std::vector<mpsc_elem_t> elems(MPSC_NUM_PRODUCERS * MPSC_ELEMS_PER_PRODUCER);
+	int next_seq[MPSC_NUM_PRODUCERS] = {};
+	size_t num_popped = 0, num_retried = 0;
+
+	if (nccl_ofi_mpsc_queue_init(&queue) != 0) {
+		NCCL_OFI_WARN("mpsc_queue_init failed");
+		exit(1);
+	}
+
+	for (int p = 0; p < MPSC_NUM_PRODUCERS; ++p) {
+		args[p].queue = queue;
+		args[p].elems = &elems[p * MPSC_ELEMS_PER_PRODUCER];
+		for (int i = 0; i < MPSC_ELEMS_PER_PRODUCER; ++i) {
+			args[p].elems[i].producer = p;
+			args[p].elems[i].seq = i;
+		}
+		if (pthread_create(&threads[p], NULL, mpsc_producer, &args[p]) != 0) {
+			NCCL_OFI_WARN("pthread_create failed");
+			exit(1);
+		}
+	}
+
+	while (num_popped < elems.size()) {
+		nccl_ofi_mpsc_queue_elem_t *qe;
+		nccl_ofi_mpsc_queue_pop(queue, &qe);
+		if (qe == NULL) {
+			continue;
+		}
+
+		/* Emulate an EAGAIN retry */
+		if ((num_popped + num_retried) % 7 == 0) {
+			++num_retried;
+			nccl_ofi_mpsc_queue_push_front(queue, qe);
+			continue;
+		}
+
+		mpsc_elem_t *elem = container_of(qe, mpsc_elem_t, qe);
+		if (elem->seq != next_seq[elem->producer]) {
+			NCCL_OFI_WARN("producer %d: expected %d but got %d",
+				      elem->producer, next_seq[elem->producer], elem->seq);
+			exit(1);
+		}
+		++next_seq[elem->producer];
+		++num_popped;
+	}
+
+	for (int p = 0; p < MPSC_NUM_PRODUCERS; ++p) {
+		pthread_join(threads[p], NULL);
+	}
+
+	if (!nccl_ofi_mpsc_queue_isempty(queue)) {
+		NCCL_OFI_WARN("drained queue is not empty");
+		exit(1);
+	}
+
+	nccl_ofi_mpsc_queue_finalize(queue);
+}
+
 int main(int argc, char *argv[])
 {
 	const size_t num_elem = 11;
@@ -160,6 +319,9 @@ int main(int argc, char *argv[])
 		exit(1);
 	}
 
+	test_mpsc_queue_basic();
+	test_mpsc_queue_stress();
+
 	printf("Test completed successfully!\n");
 
 	return 0;
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+
+#include "test-common.h"
+#include "nccl_ofi_freelist_typed.h"
+
+struct test_item {
+	uint64_t magic;
+	char buf[419];
+};
+
+struct alignas(128) aligned_item {
+	int value;
+};
+
+typedef nccl_ofi_freelist_typed_t<test_item> item_freelist_t;
+typedef nccl_ofi_freelist_typed_t<aligned_item> aligned_freelist_t;
+
+static void *reg_base;
+static size_t reg_size;
+static void *reg_handle;
+
+static int regmr_simple(void *opaque, void *data, size_t size, void **handle)
+{
+	*handle = reg_handle = opaque;
+	reg_base = data;
+	reg_size = size;
+
+	if (size % system_page_size != 0) {
+		return ncclSystemError;
+	}
+
+	return ncclSuccess;
+}
+
+static int deregmr_simple(void *handle)
+{
+	if (reg_handle != handle)
+		return ncclSystemError;
+
+	reg_base = NULL;
+	reg_size = 0;
+	reg_handle = NULL;
+
+	return ncclSuccess;
+}
+
+static size_t entry_init_count = 0, entry_fini_count = 0;
+
+static int entry_init_item(test_item *item)
+{
+	item->magic = 42;
+	++entry_init_count;
+
+	return 0;
+}
+
+static void entry_fini_item(test_item *item)
+{
+	if (item->magic != 42) {
+		NCCL_OFI_WARN("Unexpected entry value");
+		exit(1);
+	}
+	++entry_fini_count;
+}
+
+int main(int argc, char *argv[])
+{
+	item_freelist_t *freelist;
+	test_item *items[64];
+	int ret;
+	size_t i;
+
+	system_page_size = 4096;
+	ofi_log_function = logger;
+
+	/* Bounded growth with init/fini callbacks */
+	ret = item_freelist_t::init(8, 8, 16, entry_init_item, entry_fini_item,
+				    NULL, NULL, NULL, &freelist);
+	if (ret != 0) {
+		NCCL_OFI_WARN("freelist init failed: %d", ret);
+		exit(1);
+	}
+	for (i = 0; i < 16; i++) {
+		items[i] = freelist->entry_alloc();
+		if (items[i] == NULL) {
+			NCCL_OFI_WARN("allocation unexpectedly failed");
+			exit(1);
+		}
+		/* Init state survives until the entry is reused */
+		if (items[i]->magic != 42) {
+			NCCL_OFI_WARN("entry init state lost");
+			exit(1);
+		}
+		if (item_freelist_t::entry_mr_handle(items[i]) != NULL) {
+			NCCL_OFI_WARN("unexpected mr handle");
+			exit(1);
+		}
+	}
+	if (freelist->entry_alloc() != NULL) {
+		NCCL_OFI_WARN("allocation unexpectedly worked");
+		exit(1);
+	}
+	if (entry_init_count != 16) {
+		NCCL_OFI_WARN("Wrong number of entry_init calls: %zu", entry_init_count);
+		exit(1);
+	}
+
+	/* Returned entries are handed out again, last in first out */
+	freelist->entry_free(items[3]);
+	if (freelist->entry_alloc() != items[3]) {
+		NCCL_OFI_WARN("freed entry not reused");
+		exit(1);
+	}
+
+	item_freelist_t::fini(freelist);
+	if (entry_fini_count != 16) {
+		NCCL_OFI_WARN("Wrong number of entry_fini calls: %zu", entry_fini_count);
+		exit(1);
+	}
+
+	/* Unbounded growth and entry spacing */
+	ret = item_freelist_t::init(1, 1, 0, NULL, NULL, NULL, NULL, NULL, &freelist);
+	if (ret != 0) {
+		NCCL_OFI_WARN("freelist init failed: %d", ret);
+		exit(1);
+	}
+	for (i = 0; i < 64; i++) {
+		items[i] = freelist->entry_alloc();
+		if (items[i] == NULL) {
+			NCCL_OFI_WARN("allocation unexpectedly failed");
+			exit(1);
+		}
+		if (!NCCL_OFI_IS_PTR_ALIGNED(items[i], alignof(test_item))) {
+			NCCL_OFI_WARN("entry %p is misaligned", items[i]);
+			exit(1);
+		}
+		for (size_t j = 0; j < i; j++) {
+			if (items[i] == items[j]) {
+				NCCL_OFI_WARN("entry handed out twice");
+				exit(1);
+			}
+		}
+	}
+	if ((char *)items[0] - (char *)items[1] != (ptrdiff_t)item_freelist_t::entry_stride()) {
+		NCCL_OFI_WARN("bad spacing %td", (char *)items[0] - (char *)items[1]);
+		exit(1);
+	}
+	for (i = 0; i < 64; i++) {
+		freelist->entry_free(items[i]);
+	}
+	item_freelist_t::fini(freelist);
+
+	/* Over-aligned entries */
+	aligned_freelist_t *aligned_freelist;
+	ret = aligned_freelist_t::init(16, 16, 0, NULL, NULL, NULL, NULL, NULL, &aligned_freelist);
+	if (ret != 0) {
+		NCCL_OFI_WARN("freelist init failed: %d", ret);
+		exit(1);
+	}
+	for (i = 0; i < 64; i++) {
+		aligned_item *item = aligned_freelist->entry_alloc();
+		if (item == NULL || !NCCL_OFI_IS_PTR_ALIGNED(item, 128)) {
+			NCCL_OFI_WARN("bad aligned allocation %p", item);
+			exit(1);
+		}
+	}
+	aligned_freelist_t::fini(aligned_freelist);
+
+	/* Memory registration */
+	entry_init_count = 0;
+	entry_fini_count = 0;
+	ret = item_freelist_t::init(32, 0, 32, entry_init_item, entry_fini_item,
+				    regmr_simple, deregmr_simple, (void *)0xdeadbeaf, &freelist);
+	if (ret != 0) {
+		NCCL_OFI_WARN("freelist init failed: %d", ret);
+		exit(1);
+	}
+	if (reg_base == NULL) {
+		NCCL_OFI_WARN("looks like registration not called");
+		exit(1);
+	}
+	for (i = 0; i < 8; i++) {
+		test_item *item = freelist->entry_alloc();
+		if (item == NULL) {
+			NCCL_OFI_WARN("allocation unexpectedly failed");
+			exit(1);
+		}
+		if (item_freelist_t::entry_mr_handle(item) != reg_handle) {
+			NCCL_OFI_WARN("allocation handle mismatch %p %p",
+				      item_freelist_t::entry_mr_handle(item), reg_handle);
+			exit(1);
+		}
+		if ((char *)item < (char *)reg_base ||
+		    (char *)(item + 1) > (char *)reg_base + reg_size) {
+			NCCL_OFI_WARN("entry outside of registered memory");
+			exit(1);
+		}
+	}
+	item_freelist_t::fini(freelist);
+	if (reg_base != NULL) {
+		NCCL_OFI_WARN("looks like deregistration not called");
+		exit(1);
+	}
+	if (entry_init_count != entry_fini_count) {
+		NCCL_OFI_WARN("entry_init_count (%zu) and entry_fini_count (%zu) mismatch",
+			      entry_init_count, entry_fini_count);
+		exit(1);
+	}
+
+	printf("Test completed successfully\n");
+
+	return 0;
+}
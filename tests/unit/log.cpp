@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test-common.h"
+
+#define NUM_THREADS (4)
+#define NUM_MESSAGES (32)
+
+static std::atomic<int> num_logged(0);
+static std::atomic<int> num_suppressed_notes(0);
+
+static void counting_logger(ncclDebugLogLevel level, unsigned long flags, const char *filefunc,
+			    int line, const char *fmt, ...)
+{
+	va_list vargs;
+	char msg[1024];
+
+	va_start(vargs, fmt);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+	vsnprintf(msg, sizeof(msg), fmt, vargs);
+#pragma GCC diagnostic pop
+	va_end(vargs);
+
+	if (strstr(msg, "Suppressed") != NULL) {
+		num_suppressed_notes++;
+	} else {
+		num_logged++;
+	}
+}
+
+static void *log_thread_fn(void *arg)
+{
+	for (int i = 0; i < NUM_MESSAGES; i++) {
+		NCCL_OFI_INFO(NCCL_NET, "Message %d of thread %ld", i, (long)arg);
+	}
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	pthread_t threads[NUM_THREADS];
+
+	ofi_log_function = counting_logger;
+
+	/* Call site limited to 3 messages per second */
+	nccl_ofi_log_rate_limit.store(3);
+	for (int i = 0; i < 10; i++) {
+		NCCL_OFI_WARN("Storm %d", i);
+	}
+	if (num_logged != 3 || num_suppressed_notes != 0) {
+		logger(NCCL_LOG_WARN, NCCL_ALL, __PRETTY_FUNCTION__, __LINE__,
+		       "Rate limit let %d messages through", num_logged.load());
+		exit(1);
+	}
+	nccl_ofi_log_rate_limit.store(0);
+
+	/* Messages of all threads are logged by the drain thread */
+	setenv("OFI_NCCL_LOG_ASYNC", "1", 1);
+	setenv("OFI_NCCL_LOG_RATE_LIMIT", "0", 1);
+	setenv("NCCL_DEBUG", "INFO", 1);
+	nccl_ofi_log_init();
+	if (!nccl_ofi_log_async.load()) {
+		logger(NCCL_LOG_WARN, NCCL_ALL, __PRETTY_FUNCTION__, __LINE__,
+		       "Asynchronous logging not enabled");
+		exit(1);
+	}
+
+	num_logged = 0;
+	for (long i = 0; i < NUM_THREADS; i++) {
+		pthread_create(&threads[i], NULL, log_thread_fn, (void *)i);
+	}
+	for (int i = 0; i < NUM_THREADS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	nccl_ofi_log_fini();
+
+	if (num_logged != NUM_THREADS * NUM_MESSAGES) {
+		logger(NCCL_LOG_WARN, NCCL_ALL, __PRETTY_FUNCTION__, __LINE__,
+		       "Drained %d messages, expected %d", num_logged.load(),
+		       NUM_THREADS * NUM_MESSAGES);
+		exit(1);
+	}
+
+	printf("Test completed successfully\n");
+
+	return 0;
+}
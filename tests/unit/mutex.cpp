@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <thread>
+#include <vector>
+
+#include "test-common.h"
+#include "nccl_ofi_pthread.h"
+
+#define NUM_THREADS (4)
+#define ITERATIONS (200000)
+
+/* Counter protected by the mutex under test. Deliberately not atomic. */
+static uint64_t counter;
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Run NUM_THREADS threads incrementing a shared counter inside a
+ * short critical section and return the elapsed time in seconds
+ */
+template <typename MUTEX>
+static double run_contended(MUTEX *mutex)
+{
+	std::vector<std::thread> threads;
+	double start = now_sec();
+
+	counter = 0;
+	for (int t = 0; t < NUM_THREADS; t++) {
+		threads.emplace_back([mutex]() {
+			for (int i = 0; i < ITERATIONS; i++) {
+				nccl_net_ofi_mutex_lock(mutex);
+				counter++;
+				nccl_net_ofi_mutex_unlock(mutex);
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	double elapsed = now_sec() - start;
+	if (counter != (uint64_t)NUM_THREADS * ITERATIONS) {
+		NCCL_OFI_WARN("Lost updates: counter %lu, expected %lu",
+			      counter, (uint64_t)NUM_THREADS * ITERATIONS);
+		exit(1);
+	}
+
+	return elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+	nccl_net_ofi_adaptive_mutex_t adaptive;
+	nccl_net_ofi_adaptive_mutex_t msgbuff_class;
+	pthread_mutex_t plain;
+	int ret;
+
+	ofi_log_function = logger;
+
+	/* Must be set before the first mutex is created */
+	setenv("OFI_NCCL_ADAPTIVE_MUTEX", "freelist,scheduler", 1);
+	setenv("OFI_NCCL_ERRORCHECK_MUTEX", "0", 1);
+
+	ret = nccl_net_ofi_mutex_init(&adaptive, NCCL_NET_OFI_LOCK_CLASS_FREELIST);
+	if (ret != 0 || !adaptive.adaptive) {
+		NCCL_OFI_WARN("Adaptive mutex initialization failed: %d", ret);
+		exit(1);
+	}
+
+	/* Classes not listed fall back to a pthread mutex */
+	ret = nccl_net_ofi_mutex_init(&msgbuff_class, NCCL_NET_OFI_LOCK_CLASS_MSGBUFF);
+	if (ret != 0 || msgbuff_class.adaptive) {
+		NCCL_OFI_WARN("Unexpected mutex type for unlisted lock class: %d", ret);
+		exit(1);
+	}
+
+	ret = nccl_net_ofi_mutex_init(&plain, NULL);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Mutex initialization failed: %d", ret);
+		exit(1);
+	}
+
+	/* Trylock semantics */
+	ret = nccl_net_ofi_mutex_trylock(&adaptive);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Trylock of unlocked mutex failed");
+		exit(1);
+	}
+	ret = nccl_net_ofi_mutex_trylock(&adaptive);
+	if (ret != EBUSY) {
+		NCCL_OFI_WARN("Trylock of locked mutex succeeded");
+		exit(1);
+	}
+	if (nccl_net_ofi_mutex_destroy(&adaptive) != EBUSY) {
+		NCCL_OFI_WARN("Destroy of locked mutex succeeded");
+		exit(1);
+	}
+	nccl_net_ofi_mutex_unlock(&adaptive);
+
+	/* Mutual exclusion under contention, timed against pthread mutexes */
+	double adaptive_sec = run_contended(&adaptive);
+	double fallback_sec = run_contended(&msgbuff_class);
+	double plain_sec = run_contended(&plain);
+
+	printf("%d threads x %d lock/unlock: adaptive %.3fs, pthread %.3fs (%.3fs via fallback)\n",
+	       NUM_THREADS, ITERATIONS, adaptive_sec, plain_sec, fallback_sec);
+
+	if (nccl_net_ofi_mutex_destroy(&adaptive) != 0 ||
+	    nccl_net_ofi_mutex_destroy(&msgbuff_class) != 0 ||
+	    nccl_net_ofi_mutex_destroy(&plain) != 0) {
+		NCCL_OFI_WARN("Mutex destruction failed");
+		exit(1);
+	}
+
+	printf("Test completed successfully\n");
+
+	return 0;
+}
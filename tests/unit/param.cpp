@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "test-common.h"
+#include "nccl_ofi_param.h"
+
+static void write_control_file(const char *path, const char *contents)
+{
+	FILE *file = fopen(path, "w");
+	if (file == NULL || fputs(contents, file) < 0 || fclose(file) != 0) {
+		NCCL_OFI_WARN("Unable to write control file %s", path);
+		exit(1);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	char path[] = "/tmp/nccl-ofi-param-XXXXXX";
+	uint64_t epoch;
+	int fd, ret;
+
+	ofi_log_function = logger;
+
+	fd = mkstemp(path);
+	if (fd < 0) {
+		NCCL_OFI_WARN("Unable to create control file");
+		exit(1);
+	}
+	close(fd);
+
+	/* Comments, blank lines, optional prefix and unknown names */
+	write_control_file(path,
+			   "# Tuning\n"
+			   "\n"
+			   "OFI_NCCL_MIN_STRIPE_SIZE = 65536\n"
+			   "CQ_READ_COUNT=16 # inline comment\n"
+			   "OFI_NCCL_NIC_DUP_CONNS=2\n"
+			   "NOT_A_PARAMETER\n"
+			   "EAGER_MAX_SIZE=abc\n");
+
+	epoch = nccl_ofi_param_get_epoch();
+	ret = nccl_ofi_param_reload(path);
+	if (ret != 2) {
+		NCCL_OFI_WARN("Expected 2 changed parameters, got %d", ret);
+		exit(1);
+	}
+	if (ofi_nccl_min_stripe_size() != 65536 || ofi_nccl_cq_read_count() != 16) {
+		NCCL_OFI_WARN("Parameters not updated: stripe size %lu, CQ read count %ld",
+			      ofi_nccl_min_stripe_size(), ofi_nccl_cq_read_count());
+		exit(1);
+	}
+	if (ofi_nccl_eager_max_size() != -1) {
+		NCCL_OFI_WARN("Invalid value was applied");
+		exit(1);
+	}
+	if (nccl_ofi_param_get_epoch() != epoch + 1) {
+		NCCL_OFI_WARN("Epoch not incremented");
+		exit(1);
+	}
+
+	/* Reloading the same values is not a change */
+	ret = nccl_ofi_param_reload(path);
+	if (ret != 0 || nccl_ofi_param_get_epoch() != epoch + 1) {
+		NCCL_OFI_WARN("Unchanged values were published");
+		exit(1);
+	}
+
+	unlink(path);
+	if (nccl_ofi_param_reload(path) != -ENOENT) {
+		NCCL_OFI_WARN("Missing control file was not reported");
+		exit(1);
+	}
+
+	printf("Test completed successfully\n");
+
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test-common.h"
+#include "nccl_ofi_reduce.h"
+
+/* Not a multiple of any vector width, to cover the tail of the kernels */
+#define COUNT (1029)
+
+template <typename T>
+static void check_native(nccl_ofi_reduce_dtype_t dtype)
+{
+	static T dst[COUNT], src[COUNT], orig[COUNT];
+
+	if (nccl_ofi_reduce_dtype_size(dtype) != sizeof(T)) {
+		NCCL_OFI_WARN("Wrong size of type %d", dtype);
+		exit(1);
+	}
+
+	for (int op = 0; op < NCCL_OFI_REDUCE_NUM_OPS; op++) {
+		for (size_t i = 0; i < COUNT; i++) {
+			orig[i] = dst[i] = (T)(rand() % 64 - 16);
+			src[i] = (T)(rand() % 64 - 16);
+		}
+
+		if (nccl_ofi_reduce(dst, src, COUNT, dtype, (nccl_ofi_reduce_op_t)op) != 0) {
+			NCCL_OFI_WARN("Reduction of type %d with operator %d failed", dtype, op);
+			exit(1);
+		}
+
+		for (size_t i = 0; i < COUNT; i++) {
+			T expected;
+			switch (op) {
+			case NCCL_OFI_REDUCE_SUM:
+				expected = (T)(orig[i] + src[i]);
+				break;
+			case NCCL_OFI_REDUCE_PROD:
+				expected = (T)(orig[i] * src[i]);
+				break;
+			case NCCL_OFI_REDUCE_MAX:
+				expected = orig[i] > src[i] ? orig[i] : src[i];
+				break;
+			default:
+				expected = orig[i] < src[i] ? orig[i] : src[i];
+				break;
+			}
+			if (dst[i] != expected) {
+				NCCL_OFI_WARN("Type %d, operator %d: element %zu is wrong", dtype, op, i);
+				exit(1);
+			}
+		}
+	}
+}
+
+/* Sum of two 16-bit floating point values, given as bit patterns */
+static void check_half(nccl_ofi_reduce_dtype_t dtype, uint16_t a, uint16_t b, uint16_t expected)
+{
+	uint16_t dst[COUNT], src[COUNT];
+
+	for (size_t i = 0; i < COUNT; i++) {
+		dst[i] = a;
+		src[i] = b;
+	}
+	if (nccl_ofi_reduce(dst, src, COUNT, dtype, NCCL_OFI_REDUCE_SUM) != 0) {
+		NCCL_OFI_WARN("Reduction of type %d failed", dtype);
+		exit(1);
+	}
+	for (size_t i = 0; i < COUNT; i++) {
+		if (dst[i] != expected) {
+			NCCL_OFI_WARN("Type %d: 0x%04x + 0x%04x = 0x%04x, expected 0x%04x",
+				      dtype, a, b, dst[i], expected);
+			exit(1);
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	ofi_log_function = logger;
+	srand(42);
+
+	check_native<int8_t>(NCCL_OFI_REDUCE_INT8);
+	check_native<uint8_t>(NCCL_OFI_REDUCE_UINT8);
+	check_native<int32_t>(NCCL_OFI_REDUCE_INT32);
+	check_native<uint32_t>(NCCL_OFI_REDUCE_UINT32);
+	check_native<int64_t>(NCCL_OFI_REDUCE_INT64);
+	check_native<uint64_t>(NCCL_OFI_REDUCE_UINT64);
+	check_native<float>(NCCL_OFI_REDUCE_FLOAT32);
+	check_native<double>(NCCL_OFI_REDUCE_FLOAT64);
+
+	/* Integer sums wrap around */
+	int8_t i8_dst = 127, i8_src = 1;
+	nccl_ofi_reduce(&i8_dst, &i8_src, 1, NCCL_OFI_REDUCE_INT8, NCCL_OFI_REDUCE_SUM);
+	if (i8_dst != -128) {
+		NCCL_OFI_WARN("int8 sum did not wrap around: %d", i8_dst);
+		exit(1);
+	}
+
+	/* 1 + 2 = 3 */
+	check_half(NCCL_OFI_REDUCE_FLOAT16, 0x3c00, 0x4000, 0x4200);
+	/* Smallest subnormals */
+	check_half(NCCL_OFI_REDUCE_FLOAT16, 0x0001, 0x0001, 0x0002);
+	/* 65504 + 65504 overflows to infinity */
+	check_half(NCCL_OFI_REDUCE_FLOAT16, 0x7bff, 0x7bff, 0x7c00);
+	/* 1 + 2^-11 is a tie and rounds to even */
+	check_half(NCCL_OFI_REDUCE_FLOAT16, 0x3c00, 0x1000, 0x3c00);
+	/* -1 + 0.5 = -0.5 */
+	check_half(NCCL_OFI_REDUCE_FLOAT16, 0xbc00, 0x3800, 0xb800);
+
+	/* 1 + 1 = 2 */
+	check_half(NCCL_OFI_REDUCE_BFLOAT16, 0x3f80, 0x3f80, 0x4000);
+	/* 1 + 2^-8 is a tie and rounds to even */
+	check_half(NCCL_OFI_REDUCE_BFLOAT16, 0x3f80, 0x3b80, 0x3f80);
+	/* 1 + 3 * 2^-9 rounds up to 1 + 2^-7 */
+	check_half(NCCL_OFI_REDUCE_BFLOAT16, 0x3f80, 0x3bc0, 0x3f81);
+	/* NaN stays NaN */
+	check_half(NCCL_OFI_REDUCE_BFLOAT16, 0x7fc0, 0x3f80, 0x7fc0);
+
+	if (nccl_ofi_reduce(&i8_dst, &i8_src, 1, NCCL_OFI_REDUCE_NUM_DTYPES,
+			    NCCL_OFI_REDUCE_SUM) != -EINVAL) {
+		NCCL_OFI_WARN("Unknown type was accepted");
+		exit(1);
+	}
+
+	printf("Test completed successfully\n");
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2025 Amazon.com, Inc. or its affiliates. All rights reserved.
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test-common.h"
+#include "nccl_ofi_shm.h"
+
+/* Not a divisor of the ring size, so that copies wrap around */
+#define CHUNK (3000)
+#define NUM_CHUNKS (100)
+
+int main(int argc, char *argv[])
+{
+	nccl_ofi_shm_chan_t producer, consumer, other;
+	static char src[CHUNK * NUM_CHUNKS], dst[CHUNK * NUM_CHUNKS];
+	size_t written = 0, read = 0;
+	int ret;
+
+	ofi_log_function = logger;
+	system_page_size = 4096;
+
+	if (nccl_ofi_shm_host_id() == 0) {
+		NCCL_OFI_WARN("Unable to determine host identifier");
+		exit(1);
+	}
+
+	/* Rounded up to a power of two */
+	ret = nccl_ofi_shm_chan_create(&producer, 5000);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Unable to create channel: %d", ret);
+		exit(1);
+	}
+	if (producer.ring_size != 8192) {
+		NCCL_OFI_WARN("Unexpected ring size %zu", producer.ring_size);
+		exit(1);
+	}
+
+	ret = nccl_ofi_shm_chan_attach(&consumer, producer.name);
+	if (ret != 0) {
+		NCCL_OFI_WARN("Unable to attach to channel: %d", ret);
+		exit(1);
+	}
+	if (consumer.ring_size != producer.ring_size) {
+		NCCL_OFI_WARN("Consumer sees ring size %zu", consumer.ring_size);
+		exit(1);
+	}
+
+	/* Nothing to read yet */
+	if (nccl_ofi_shm_chan_read(&consumer, dst, CHUNK) != 0) {
+		NCCL_OFI_WARN("Read from an empty channel");
+		exit(1);
+	}
+
+	for (size_t i = 0; i < sizeof(src); i++) {
+		src[i] = (char)rand();
+	}
+
+	/* Alternate partial writes and reads until the whole buffer went through */
+	while (read < sizeof(src)) {
+		size_t len = std::min((size_t)CHUNK, sizeof(src) - written);
+		written += nccl_ofi_shm_chan_write(&producer, src + written, len);
+		if (written - read > producer.ring_size) {
+			NCCL_OFI_WARN("Channel holds %zu bytes", written - read);
+			exit(1);
+		}
+		if (nccl_ofi_shm_chan_space(&producer) != producer.ring_size - (written - read)) {
+			NCCL_OFI_WARN("Channel reports %zu free bytes while holding %zu bytes",
+				      nccl_ofi_shm_chan_space(&producer), written - read);
+			exit(1);
+		}
+
+		len = std::min((size_t)CHUNK / 2, written - read);
+		if (nccl_ofi_shm_chan_read(&consumer, dst + read, len) != len) {
+			NCCL_OFI_WARN("Short read of %zu bytes at offset %zu", len, read);
+			exit(1);
+		}
+		read += len;
+	}
+
+	if (memcmp(src, dst, sizeof(src)) != 0) {
+		NCCL_OFI_WARN("Data corrupted");
+		exit(1);
+	}
+
+	/* The name was removed at attach time */
+	if (nccl_ofi_shm_chan_attach(&other, producer.name) != -ENOENT) {
+		NCCL_OFI_WARN("Channel name still exists");
+		exit(1);
+	}
+
+	if (nccl_ofi_shm_chan_close(&consumer) != 0 ||
+	    nccl_ofi_shm_chan_close(&producer) != 0) {
+		NCCL_OFI_WARN("Unable to close channel");
+		exit(1);
+	}
+
+	printf("Test completed successfully\n");
+
+	return 0;
+}